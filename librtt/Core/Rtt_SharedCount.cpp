@@ -91,6 +91,12 @@ SharedCount::IsValid() const
 	return ( fCount ? fCount->IsValid() : false );
 }
 
+bool
+SharedCount::IsUnique() const
+{
+	return ( fCount ? 1 == fCount->GetStrongCount() : false );
+}
+
 void
 SharedCount::Log() const
 {
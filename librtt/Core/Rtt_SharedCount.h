@@ -57,6 +57,9 @@ class SharedCount
 
 	public:
 		bool IsValid() const;
+
+		// True if this is the only strong reference
+		bool IsUnique() const;
 //		bool IsNull() const { return NULL == fCount; }
 //		bool NotNull() const { return ! IsNull(); }
 
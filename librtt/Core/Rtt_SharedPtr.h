@@ -61,6 +61,9 @@ class SharedPtr
 		bool IsNull() const;
 		bool NotNull() const { return ! IsNull(); }
 
+		// True if no other SharedPtr refers to the resource
+		bool IsUnique() const { return fCount.IsUnique(); }
+
 #ifdef Rtt_DEBUG_SHARED_PTR
 		void Log( const char *label ) const;
 #endif
@@ -0,0 +1,537 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Core/Rtt_SizeClassAllocator.h"
+
+#include "Core/Rtt_Math.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined( Rtt_WIN_ENV )
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#elif defined( Rtt_EMSCRIPTEN_ENV ) || defined( Rtt_NXS_ENV )
+	// No anonymous mappings, so arenas come from the C heap
+	#define Rtt_SIZE_CLASS_ARENA_MALLOC
+#else
+	#include <sys/mman.h>
+#endif
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Pages are carved into blocks of one size class, past this header. Full
+// pages belong to no list; the others are on their class's available list.
+struct SizeClassAllocator::Page
+{
+	Page* fPrev;
+	Page* fNext;
+	void* fFreeList;
+	U8* fBumpPtr;
+	U8* fBumpEnd;
+	Arena* fArena;
+	U32 fNumLive;
+	U32 fClassIndex;
+};
+
+// Arenas are carved into pages. Pages given back are reused before untouched
+// ones, so a lightly used arena stays within a few pages. Full arenas belong
+// to no list; the others are on the allocator's list.
+struct SizeClassAllocator::Arena
+{
+	Arena* fPrev;
+	Arena* fNext;
+	U8* fBase;
+	Page* fFreePages;
+	U8* fBumpPtr;
+	U32 fNumUsed;
+};
+
+// Blocks start past the page header, keeping 16 byte alignment
+const size_t SizeClassAllocator::kPageHeaderSize = ( sizeof( SizeClassAllocator::Page ) + 15 ) & ~(size_t)15;
+
+static const size_t kPageMask = ~( SizeClassAllocator::kPageSize - 1 );
+
+// Returns memory aligned to at least kPageSize. Mapped memory is only
+// backed once touched, so untouched pages of an arena cost no RSS.
+static void*
+MapArena()
+{
+	void* result = NULL;
+
+	#if defined( Rtt_WIN_ENV )
+		result = VirtualAlloc( NULL, SizeClassAllocator::kArenaSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE );
+	#elif defined( Rtt_SIZE_CLASS_ARENA_MALLOC )
+		if ( 0 != posix_memalign( & result, SizeClassAllocator::kPageSize, SizeClassAllocator::kArenaSize ) )
+		{
+			result = NULL;
+		}
+	#else
+		result = mmap( NULL, SizeClassAllocator::kArenaSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0 );
+
+		if ( MAP_FAILED == result )
+		{
+			result = NULL;
+		}
+	#endif
+
+	return result;
+}
+
+static void
+UnmapArena( void* p )
+{
+	#if defined( Rtt_WIN_ENV )
+		VirtualFree( p, 0, MEM_RELEASE );
+	#elif defined( Rtt_SIZE_CLASS_ARENA_MALLOC )
+		free( p );
+	#else
+		munmap( p, SizeClassAllocator::kArenaSize );
+	#endif
+}
+
+template < typename T >
+static void
+Unlink( T*& head, T* item )
+{
+	if ( item->fPrev )
+	{
+		item->fPrev->fNext = item->fNext;
+	}
+	else
+	{
+		head = item->fNext;
+	}
+
+	if ( item->fNext )
+	{
+		item->fNext->fPrev = item->fPrev;
+	}
+
+	item->fPrev = NULL;
+	item->fNext = NULL;
+}
+
+template < typename T >
+static void
+PushFront( T*& head, T* item )
+{
+	item->fPrev = NULL;
+	item->fNext = head;
+
+	if ( head )
+	{
+		head->fPrev = item;
+	}
+
+	head = item;
+}
+
+// ----------------------------------------------------------------------------
+
+SizeClassAllocator::SizeClassAllocator( Rtt_Allocator* allocator )
+:	fAllocator( allocator ),
+	fArenas( NULL ),
+	fEmptyArena( NULL )
+{
+	memset( fClasses, 0, sizeof( fClasses ) );
+	memset( & fStats, 0, sizeof( fStats ) );
+}
+
+SizeClassAllocator::~SizeClassAllocator()
+{
+	// Only available and empty pages are reachable; full ones mean blocks
+	// were never freed, which Lua doesn't do on lua_close()
+	for ( size_t i = 0, iMax = sizeof( fClasses ) / sizeof( fClasses[0] ); i < iMax; i++ )
+	{
+		SizeClass& sizeClass = fClasses[i];
+
+		while ( sizeClass.fAvailable )
+		{
+			Page* page = sizeClass.fAvailable;
+			Unlink( sizeClass.fAvailable, page );
+			DeletePage( page );
+		}
+
+		if ( sizeClass.fEmpty )
+		{
+			DeletePage( sizeClass.fEmpty );
+		}
+	}
+
+	// With every page back, all that can remain is the spare arena
+	if ( fEmptyArena )
+	{
+		DeleteArena( fEmptyArena );
+	}
+
+	Rtt_ASSERT( 0 == fStats.fNumPages );
+	Rtt_ASSERT( 0 == fStats.fNumArenas );
+}
+
+void*
+SizeClassAllocator::Alloc( size_t size )
+{
+	void* result = AllocBlock( size );
+
+	if ( result )
+	{
+		fStats.fBytesInUse += size;
+		++fStats.fNumAllocations;
+		fStats.fAllocatedBytes += size;
+	}
+
+	return result;
+}
+
+void
+SizeClassAllocator::Free( void* p, size_t size )
+{
+	if ( p )
+	{
+		FreeBlock( p, size );
+		fStats.fBytesInUse -= size;
+	}
+}
+
+void*
+SizeClassAllocator::Realloc( void* p, size_t oldSize, size_t newSize )
+{
+	// Lua also frees NULL, e.g. the array part of a table that never had one
+	if ( 0 == newSize )
+	{
+		Free( p, oldSize );
+		return NULL;
+	}
+
+	if ( ! p || 0 == oldSize )
+	{
+		return Alloc( newSize );
+	}
+
+	void* result = NULL;
+
+	if ( IsSmall( oldSize ) && IsSmall( newSize ) && ClassIndex( oldSize ) == ClassIndex( newSize ) )
+	{
+		result = p;
+	}
+	else if ( ! IsSmall( oldSize ) && ! IsSmall( newSize ) )
+	{
+		result = Rtt_REALLOC( fAllocator, p, newSize );
+
+		if ( result )
+		{
+			fStats.fLargeBytes += newSize;
+			fStats.fLargeBytes -= oldSize;
+		}
+	}
+	else
+	{
+		// Crossing size classes, or into or out of the pool
+		result = AllocBlock( newSize );
+
+		if ( result )
+		{
+			memcpy( result, p, Min( oldSize, newSize ) );
+			FreeBlock( p, oldSize );
+		}
+	}
+
+	if ( result )
+	{
+		fStats.fBytesInUse += newSize;
+		fStats.fBytesInUse -= oldSize;
+
+		if ( newSize > oldSize )
+		{
+			++fStats.fNumAllocations;
+			fStats.fAllocatedBytes += newSize - oldSize;
+		}
+	}
+
+	return result;
+}
+
+void*
+SizeClassAllocator::LuaAlloc( void* ud, void* ptr, size_t osize, size_t nsize )
+{
+	return static_cast< SizeClassAllocator* >( ud )->Realloc( ptr, osize, nsize );
+}
+
+void*
+SizeClassAllocator::AllocBlock( size_t size )
+{
+	if ( IsSmall( size ) )
+	{
+		return AllocSmall( ClassIndex( size ) );
+	}
+
+	void* result = Rtt_MALLOC( fAllocator, size );
+
+	if ( result )
+	{
+		fStats.fLargeBytes += size;
+	}
+
+	return result;
+}
+
+void
+SizeClassAllocator::FreeBlock( void* p, size_t size )
+{
+	if ( IsSmall( size ) )
+	{
+		FreeSmall( p, ClassIndex( size ) );
+	}
+	else
+	{
+		Rtt_FREE( p );
+		fStats.fLargeBytes -= size;
+	}
+}
+
+void*
+SizeClassAllocator::AllocSmall( size_t index )
+{
+	SizeClass& sizeClass = fClasses[index];
+	Page* page = sizeClass.fAvailable;
+
+	if ( ! page )
+	{
+		page = sizeClass.fEmpty;
+		sizeClass.fEmpty = NULL;
+
+		if ( ! page )
+		{
+			page = NewPage( index );
+
+			if ( ! page )
+			{
+				return NULL;
+			}
+		}
+
+		PushFront( sizeClass.fAvailable, page );
+	}
+
+	void* result = NULL;
+
+	if ( page->fFreeList )
+	{
+		result = page->fFreeList;
+
+		// The contents of a free block store the next ptr in the free list
+		page->fFreeList = *((void**)result);
+	}
+	else
+	{
+		Rtt_ASSERT( page->fBumpPtr < page->fBumpEnd );
+
+		result = page->fBumpPtr;
+		page->fBumpPtr += BlockSize( index );
+	}
+
+	++page->fNumLive;
+
+	if ( ! page->fFreeList && page->fBumpPtr >= page->fBumpEnd )
+	{
+		Unlink( sizeClass.fAvailable, page );
+	}
+
+	return result;
+}
+
+void
+SizeClassAllocator::FreeSmall( void* p, size_t index )
+{
+	SizeClass& sizeClass = fClasses[index];
+	Page* page = (Page*)( (uintptr_t)p & kPageMask );
+
+	Rtt_ASSERT( page->fClassIndex == index );
+	Rtt_ASSERT( page->fNumLive > 0 );
+
+	bool wasFull = ( ! page->fFreeList && page->fBumpPtr >= page->fBumpEnd );
+
+	*((void**)p) = page->fFreeList;
+	page->fFreeList = p;
+	--page->fNumLive;
+
+	if ( wasFull )
+	{
+		PushFront( sizeClass.fAvailable, page );
+	}
+
+	if ( 0 == page->fNumLive )
+	{
+		Unlink( sizeClass.fAvailable, page );
+
+		// Reset, so a reused page hands out blocks in address order again
+		page->fFreeList = NULL;
+		page->fBumpPtr = ((U8*)page) + kPageHeaderSize;
+
+		if ( sizeClass.fEmpty )
+		{
+			DeletePage( page );
+		}
+		else
+		{
+			sizeClass.fEmpty = page;
+		}
+	}
+}
+
+SizeClassAllocator::Page*
+SizeClassAllocator::NewPage( size_t index )
+{
+	Arena* arena = fArenas;
+
+	if ( ! arena )
+	{
+		arena = fEmptyArena;
+		fEmptyArena = NULL;
+
+		if ( ! arena )
+		{
+			arena = NewArena();
+
+			if ( ! arena )
+			{
+				return NULL;
+			}
+		}
+
+		PushFront( fArenas, arena );
+	}
+
+	Page* page = arena->fFreePages;
+
+	if ( page )
+	{
+		arena->fFreePages = page->fNext;
+	}
+	else
+	{
+		page = (Page*)arena->fBumpPtr;
+		arena->fBumpPtr += kPageSize;
+	}
+
+	++arena->fNumUsed;
+
+	if ( ! arena->fFreePages && arena->fBumpPtr >= arena->fBase + kArenaSize )
+	{
+		Unlink( fArenas, arena );
+	}
+
+	size_t blockSize = BlockSize( index );
+	size_t numBlocks = ( kPageSize - kPageHeaderSize ) / blockSize;
+
+	page->fPrev = NULL;
+	page->fNext = NULL;
+	page->fFreeList = NULL;
+	page->fBumpPtr = ((U8*)page) + kPageHeaderSize;
+	page->fBumpEnd = page->fBumpPtr + numBlocks * blockSize;
+	page->fArena = arena;
+	page->fNumLive = 0;
+	page->fClassIndex = (U32)index;
+
+	++fStats.fNumPages;
+
+	return page;
+}
+
+void
+SizeClassAllocator::DeletePage( Page* page )
+{
+	Arena* arena = page->fArena;
+
+	Rtt_ASSERT( arena->fNumUsed > 0 );
+
+	bool wasFull = ( ! arena->fFreePages && arena->fBumpPtr >= arena->fBase + kArenaSize );
+
+	page->fNext = arena->fFreePages;
+	arena->fFreePages = page;
+	--arena->fNumUsed;
+
+	--fStats.fNumPages;
+
+	if ( wasFull )
+	{
+		PushFront( fArenas, arena );
+	}
+
+	if ( 0 == arena->fNumUsed )
+	{
+		Unlink( fArenas, arena );
+
+		// Reset, so a reused arena hands out pages in address order again
+		arena->fFreePages = NULL;
+		arena->fBumpPtr = arena->fBase;
+
+		if ( fEmptyArena )
+		{
+			DeleteArena( arena );
+		}
+		else
+		{
+			fEmptyArena = arena;
+		}
+	}
+}
+
+SizeClassAllocator::Arena*
+SizeClassAllocator::NewArena()
+{
+	Arena* arena = (Arena*)Rtt_MALLOC( fAllocator, sizeof( Arena ) );
+
+	if ( arena )
+	{
+		arena->fBase = (U8*)MapArena();
+
+		if ( ! arena->fBase )
+		{
+			Rtt_FREE( arena );
+			return NULL;
+		}
+
+		arena->fPrev = NULL;
+		arena->fNext = NULL;
+		arena->fFreePages = NULL;
+		arena->fBumpPtr = arena->fBase;
+		arena->fNumUsed = 0;
+
+		fStats.fPooledBytes += kArenaSize;
+		++fStats.fNumArenas;
+	}
+
+	return arena;
+}
+
+void
+SizeClassAllocator::DeleteArena( Arena* arena )
+{
+	UnmapArena( arena->fBase );
+	Rtt_FREE( arena );
+
+	fStats.fPooledBytes -= kArenaSize;
+	--fStats.fNumArenas;
+}
+
+// ----------------------------------------------------------------------------
+
+} // Rtt
+
+// ----------------------------------------------------------------------------
+
@@ -0,0 +1,117 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md 
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef Rtt_SizeClassAllocator_H
+#define Rtt_SizeClassAllocator_H
+
+#include "Core/Rtt_Types.h"
+#include "Core/Rtt_Allocator.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Carves small blocks out of pages, each page serving one size class, and
+// sends larger blocks to the system allocator. As in FixedBlockAllocator,
+// pages are aligned to their size, so a block finds its page by masking its
+// address. Pages come from arenas mapped from the system a few hundred KB at
+// a time. Pages count their live blocks and go back to their arena once
+// empty, and arenas are unmapped once all of their pages are free, so the
+// heap shrinks after a burst of garbage is collected.
+//
+// Callers pass a block's size back when freeing or resizing it, as Lua
+// does. Not thread safe; meant to back a single lua_State.
+class SizeClassAllocator
+{
+	Rtt_CLASS_NO_COPIES( SizeClassAllocator )
+
+	public:
+		struct Stats
+		{
+			size_t fBytesInUse;		// requested by callers
+			size_t fPooledBytes;	// arenas reserved for small blocks
+			size_t fLargeBytes;		// blocks too big to pool
+			U32 fNumPages;			// pages in use by size classes
+			U32 fNumArenas;
+			U64 fNumAllocations;	// allocations, including resizes that grow
+			U64 fAllocatedBytes;	// bytes added by those
+		};
+
+	public:
+		static const size_t kGranularity = 8;
+		static const size_t kMaxBlockSize = 256;
+		static const size_t kPageSize = 4096;
+		static const size_t kPagesPerArena = 64;
+		static const size_t kArenaSize = kPagesPerArena * kPageSize;
+
+	public:
+		SizeClassAllocator( Rtt_Allocator* allocator );
+		~SizeClassAllocator();
+
+	public:
+		void* Alloc( size_t size );
+		void Free( void* p, size_t size );
+
+		// Moves the block if its size class changes, so shrinking releases
+		// memory. Returns NULL, leaving 'p' valid, if no memory is left.
+		void* Realloc( void* p, size_t oldSize, size_t newSize );
+
+		const Stats& GetStats() const { return fStats; }
+
+		// Has the signature of lua_Alloc, with 'ud' the allocator
+		static void* LuaAlloc( void* ud, void* ptr, size_t osize, size_t nsize );
+
+	protected:
+		struct Page;
+		struct Arena;
+
+		struct SizeClass
+		{
+			Page* fAvailable;	// pages with free blocks
+			Page* fEmpty;		// one empty page, kept to avoid thrashing
+		};
+
+		static bool IsSmall( size_t size ) { return size <= kMaxBlockSize; }
+		static size_t ClassIndex( size_t size ) { return ( size - 1 ) / kGranularity; }
+		static size_t BlockSize( size_t index ) { return ( index + 1 ) * kGranularity; }
+
+		// Storage only; the callers keep fBytesInUse and the allocation counts
+		void* AllocBlock( size_t size );
+		void FreeBlock( void* p, size_t size );
+
+		void* AllocSmall( size_t index );
+		void FreeSmall( void* p, size_t index );
+
+		Page* NewPage( size_t index );
+		void DeletePage( Page* page );
+
+		Arena* NewArena();
+		void DeleteArena( Arena* arena );
+
+	protected:
+		static const size_t kPageHeaderSize;
+
+	private:
+		Rtt_Allocator* fAllocator;
+		SizeClass fClasses[kMaxBlockSize / kGranularity];
+		Arena* fArenas;		// arenas with free pages
+		Arena* fEmptyArena;	// one arena with no pages in use, kept to avoid thrashing
+		Stats fStats;
+};
+
+// ----------------------------------------------------------------------------
+
+} // Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // Rtt_SizeClassAllocator_H
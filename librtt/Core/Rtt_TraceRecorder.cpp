@@ -0,0 +1,335 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Core/Rtt_TraceRecorder.h"
+
+#include "Core/Rtt_FileSystem.h"
+#include "Core/Rtt_Math.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+namespace /*anonymous*/
+{
+
+struct Ring
+{
+	Ring* fNext;
+	U32 fId; // "tid" in the trace
+	std::atomic< const char* > fThreadName;
+	std::atomic< bool > fIsInUse;
+	std::atomic< U64 > fStart; // first event of the current owner
+	std::atomic< U64 > fHead; // one past the last published event
+	TraceRecorder::Event fEvents[TraceRecorder::kCapacity];
+};
+
+std::atomic< Ring* > sRings( NULL );
+std::atomic< U32 > sNextId( 1 );
+
+Ring*
+AcquireRing( const char* threadName )
+{
+	U32 id = sNextId.fetch_add( 1, std::memory_order_relaxed );
+
+	// Take over the ring of a thread that has exited...
+	for ( Ring* ring = sRings.load( std::memory_order_acquire ); ring; ring = ring->fNext )
+	{
+		bool wasInUse = false;
+
+		if ( ring->fIsInUse.compare_exchange_strong( wasInUse, true, std::memory_order_acquire ) )
+		{
+			ring->fId = id;
+			ring->fThreadName.store( threadName, std::memory_order_relaxed );
+			ring->fStart.store( ring->fHead.load( std::memory_order_relaxed ), std::memory_order_release );
+
+			return ring;
+		}
+	}
+
+	// ...or add one; rings are never freed, so readers can walk the list
+	Ring* ring = new Ring;
+	ring->fId = id;
+	ring->fThreadName.store( threadName, std::memory_order_relaxed );
+	ring->fIsInUse.store( true, std::memory_order_relaxed );
+	ring->fStart.store( 0, std::memory_order_relaxed );
+	ring->fHead.store( 0, std::memory_order_relaxed );
+
+	Ring* next = sRings.load( std::memory_order_relaxed );
+
+	do
+	{
+		ring->fNext = next;
+	}
+	while ( ! sRings.compare_exchange_weak( next, ring, std::memory_order_release, std::memory_order_relaxed ) );
+
+	return ring;
+}
+
+// Gives the ring back when its thread exits
+struct RingOwner
+{
+	RingOwner() : fRing( NULL ), fThreadName( NULL ) {}
+
+	~RingOwner()
+	{
+		if ( fRing )
+		{
+			fRing->fIsInUse.store( false, std::memory_order_release );
+		}
+	}
+
+	Ring* fRing;
+	const char* fThreadName; // kept until the thread records anything
+};
+
+thread_local RingOwner sOwner;
+
+Ring&
+ThreadRing()
+{
+	if ( ! sOwner.fRing )
+	{
+		sOwner.fRing = AcquireRing( sOwner.fThreadName );
+	}
+
+	return * sOwner.fRing;
+}
+
+U64
+Now()
+{
+	return (U64)std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+void
+WriteEscaped( FILE* file, const char* str )
+{
+	for ( ; *str; ++str )
+	{
+		unsigned char c = (unsigned char)*str;
+
+		if ( '"' == c || '\\' == c )
+		{
+			fprintf( file, "\\%c", c );
+		}
+		else if ( c < 0x20 )
+		{
+			fprintf( file, "\\u%04x", c );
+		}
+		else
+		{
+			fputc( c, file );
+		}
+	}
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+std::atomic< bool > TraceRecorder::sIsEnabled( false );
+
+void
+TraceRecorder::SetEnabled( bool newValue )
+{
+	sIsEnabled.store( newValue, std::memory_order_relaxed );
+}
+
+void
+TraceRecorder::SetThreadName( const char* name )
+{
+	sOwner.fThreadName = name;
+
+	if ( sOwner.fRing )
+	{
+		sOwner.fRing->fThreadName.store( name, std::memory_order_relaxed );
+	}
+}
+
+void
+TraceRecorder::Record( U32 phase, const char* name, const char* detail )
+{
+	Ring& ring = ThreadRing();
+	U64 head = ring.fHead.load( std::memory_order_relaxed );
+	Event& event = ring.fEvents[head & ( kCapacity - 1 )];
+
+	event.fTime = Now();
+	event.fName = name;
+	event.fPhase = phase;
+
+	if ( detail )
+	{
+		strncpy( event.fDetail, detail, sizeof( event.fDetail ) - 1 );
+		event.fDetail[sizeof( event.fDetail ) - 1] = '\0';
+	}
+	else
+	{
+		event.fDetail[0] = '\0';
+	}
+
+	ring.fHead.store( head + 1, std::memory_order_release );
+}
+
+void
+TraceRecorder::Begin( const char* name, const char* detail )
+{
+	if ( IsEnabled() )
+	{
+		Record( kBegin, name, detail );
+	}
+}
+
+void
+TraceRecorder::End()
+{
+	if ( IsEnabled() )
+	{
+		Record( kEnd, NULL, NULL );
+	}
+}
+
+void
+TraceRecorder::Mark( const char* name )
+{
+	if ( IsEnabled() )
+	{
+		Record( kMark, name, NULL );
+	}
+}
+
+void
+TraceRecorder::Frame( U32 frame )
+{
+	if ( IsEnabled() )
+	{
+		char detail[16];
+		snprintf( detail, sizeof( detail ), "%u", frame );
+
+		Record( kFrame, "Frame", detail );
+	}
+}
+
+bool
+TraceRecorder::WriteChromeTrace( const char* path )
+{
+	FILE* file = Rtt_FileOpen( path, "w" );
+
+	if ( ! file )
+	{
+		return false;
+	}
+
+	std::vector< Event > events;
+	bool isFirst = true;
+
+	fputs( "{\"traceEvents\":[\n", file );
+
+	for ( Ring* ring = sRings.load( std::memory_order_acquire ); ring; ring = ring->fNext )
+	{
+		U64 head = ring->fHead.load( std::memory_order_acquire );
+		U64 start = ring->fStart.load( std::memory_order_acquire );
+		U64 first = ( head - start > kCapacity ? head - kCapacity : start );
+
+		events.clear();
+
+		for ( U64 i = first; i < head; i++ )
+		{
+			events.push_back( ring->fEvents[i & ( kCapacity - 1 )] );
+		}
+
+		// Anything the owner may have written over while it was being copied
+		// is unreliable, including the slot it could be writing right now
+		U64 newHead = ring->fHead.load( std::memory_order_acquire );
+		U64 firstValid = ( newHead >= kCapacity ? newHead - kCapacity + 1 : 0 );
+		size_t skip = ( firstValid > first ? (size_t)Min< U64 >( firstValid - first, events.size() ) : 0 );
+
+		// Ends whose begins were overwritten would close the wrong scopes
+		while ( skip < events.size() && kEnd == events[skip].fPhase )
+		{
+			++skip;
+		}
+
+		if ( skip == events.size() )
+		{
+			continue;
+		}
+
+		const char* threadName = ring->fThreadName.load( std::memory_order_relaxed );
+
+		fprintf( file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"", isFirst ? "" : ",\n", ring->fId );
+		if ( threadName )
+		{
+			WriteEscaped( file, threadName );
+		}
+		else
+		{
+			fprintf( file, "Thread %u", ring->fId );
+		}
+		fputs( "\"}}", file );
+
+		isFirst = false;
+
+		for ( size_t i = skip; i < events.size(); i++ )
+		{
+			const Event& event = events[i];
+			static const char* kPhases[kNumPhases] = { "B", "E", "i", "i" };
+
+			fprintf( file, ",\n{\"ph\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%.3f", kPhases[event.fPhase], ring->fId, event.fTime / 1000.0 );
+
+			if ( event.fName )
+			{
+				fputs( ",\"name\":\"", file );
+				WriteEscaped( file, event.fName );
+				if ( event.fDetail[0] )
+				{
+					fputs( kFrame == event.fPhase ? " " : ": ", file );
+					WriteEscaped( file, event.fDetail );
+				}
+				fputc( '"', file );
+			}
+
+			// Frame boundaries span every thread, marks only their own
+			if ( kMark == event.fPhase )
+			{
+				fputs( ",\"s\":\"t\"", file );
+			}
+			else if ( kFrame == event.fPhase )
+			{
+				fputs( ",\"s\":\"g\"", file );
+			}
+
+			fputc( '}', file );
+		}
+	}
+
+	fputs( "\n],\"displayTimeUnit\":\"ms\"}\n", file );
+
+	bool result = ( 0 == ferror( file ) );
+
+	Rtt_FileClose( file );
+
+	return result;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,121 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_TraceRecorder_H__
+#define _Rtt_TraceRecorder_H__
+
+#include "Core/Rtt_Macros.h"
+#include "Core/Rtt_Types.h"
+
+#include <atomic>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Records begin/end scopes, marks and frame boundaries into a ring buffer per
+// thread, and writes what the rings hold as Chrome trace JSON, which
+// chrome://tracing and Perfetto open as a flame chart.
+//
+// Only the owning thread writes to a ring, so recording takes no locks: an
+// event is filled in and then published by advancing the ring's head. Rings
+// are registered once per thread and reused after their thread exits. A
+// writer may lap the reader while a trace is written; events it could have
+// overwritten are dropped rather than reported torn.
+//
+// Names must be string literals or otherwise outlive the trace; details are
+// copied, truncated to fit.
+class TraceRecorder
+{
+	public:
+		enum Phase
+		{
+			kBegin,
+			kEnd,
+			kMark,
+			kFrame,
+
+			kNumPhases
+		};
+
+		struct Event
+		{
+			U64 fTime; // nanoseconds, steady clock
+			const char* fName;
+			char fDetail[20];
+			U32 fPhase;
+		};
+
+		// Events kept per thread; a power of 2
+		static const U32 kCapacity = 16384;
+
+	public:
+		static bool IsEnabled() { return sIsEnabled.load( std::memory_order_relaxed ); }
+		static void SetEnabled( bool newValue );
+
+		// Shown as the calling thread's name in the trace; 'name' must outlive it
+		static void SetThreadName( const char* name );
+
+	public:
+		static void Begin( const char* name, const char* detail = NULL );
+		static void End();
+		static void Mark( const char* name );
+		static void Frame( U32 frame );
+
+	public:
+		// Writes every thread's events; returns false if 'path' can't be written
+		static bool WriteChromeTrace( const char* path );
+
+	private:
+		static void Record( U32 phase, const char* name, const char* detail );
+
+	private:
+		static std::atomic< bool > sIsEnabled;
+};
+
+// Begins a scope on construction and ends it on destruction
+class TraceScope
+{
+	Rtt_CLASS_NO_COPIES( TraceScope )
+
+	public:
+		TraceScope( const char* name, const char* detail = NULL )
+		:	fIsRecording( TraceRecorder::IsEnabled() )
+		{
+			if ( fIsRecording )
+			{
+				TraceRecorder::Begin( name, detail );
+			}
+		}
+
+		~TraceScope()
+		{
+			if ( fIsRecording )
+			{
+				TraceRecorder::End();
+			}
+		}
+
+	private:
+		bool fIsRecording;
+};
+
+// see Rtt_Profiling.h for the "" that ensures a string literal
+#define TRACE_SCOPE( var, name ) TraceScope var##_trace( name "" )
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_TraceRecorder_H__
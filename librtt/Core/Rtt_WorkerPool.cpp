@@ -0,0 +1,188 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Core/Rtt_WorkerPool.h"
+
+#include "Core/Rtt_TraceRecorder.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+static thread_local bool sIsWorkerThread = false;
+
+// Enough to saturate typical mobile/desktop parts without oversubscribing
+// the main and render threads
+static const U32 kMaxWorkers = 7;
+
+// Each thread claims roughly this many chunks of a ParallelFor() range;
+// more chunks balance better, fewer chunks contend less on the counter
+static const U32 kChunksPerThread = 4;
+
+static U32
+DefaultNumWorkers()
+{
+#if defined( Rtt_EMSCRIPTEN_ENV )
+	return 0;
+#else
+	U32 numCores = std::thread::hardware_concurrency();
+	U32 result = ( numCores > 1 ? numCores - 1 : 0 );
+	return ( result < kMaxWorkers ? result : kMaxWorkers );
+#endif
+}
+
+WorkerPool&
+WorkerPool::Shared()
+{
+	static WorkerPool sPool( DefaultNumWorkers() );
+	return sPool;
+}
+
+bool
+WorkerPool::IsWorkerThread()
+{
+	return sIsWorkerThread;
+}
+
+WorkerPool::WorkerPool( U32 numWorkers )
+:	fWorkers(),
+	fCallerMutex(),
+	fMutex(),
+	fWake(),
+	fDone(),
+	fJob( NULL ),
+	fUserData( NULL ),
+	fCount( 0 ),
+	fChunk( 1 ),
+	fNext( 0 ),
+	fGeneration( 0 ),
+	fNumBusy( 0 ),
+	fShouldQuit( false )
+{
+	fWorkers.reserve( numWorkers );
+	for ( U32 i = 0; i < numWorkers; i++ )
+	{
+		fWorkers.push_back( std::thread( & WorkerPool::RunWorker, this ) );
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard< std::mutex > lock( fMutex );
+		fShouldQuit = true;
+	}
+	fWake.notify_all();
+
+	for ( size_t i = 0; i < fWorkers.size(); i++ )
+	{
+		fWorkers[i].join();
+	}
+}
+
+void
+WorkerPool::ParallelFor( U32 count, Job job, void *userData )
+{
+	Rtt_ASSERT( job );
+
+	std::unique_lock< std::mutex > caller( fCallerMutex, std::defer_lock );
+
+	// Run inline when there is nothing to gain, when called from a job,
+	// or when another thread is already using the pool
+	if ( count < 2 || fWorkers.empty() || IsWorkerThread() || ! caller.try_lock() )
+	{
+		for ( U32 i = 0; i < count; i++ )
+		{
+			job( userData, i );
+		}
+		return;
+	}
+
+	{
+		std::lock_guard< std::mutex > lock( fMutex );
+
+		U32 chunk = count / ( GetConcurrency() * kChunksPerThread );
+
+		fJob = job;
+		fUserData = userData;
+		fCount = count;
+		fChunk = ( chunk > 0 ? chunk : 1 );
+		fNext.store( 0 );
+		fNumBusy = (U32)fWorkers.size();
+		++fGeneration;
+	}
+	fWake.notify_all();
+
+	RunJobs();
+
+	// Every worker checks in before returning, so none of them can still be
+	// looking at this call's job when the next one is published
+	std::unique_lock< std::mutex > lock( fMutex );
+	fDone.wait( lock, [this]{ return 0 == fNumBusy; } );
+}
+
+void
+WorkerPool::RunWorker()
+{
+	sIsWorkerThread = true;
+	TraceRecorder::SetThreadName( "Worker" );
+
+	U32 generation = 0;
+	for ( ;; )
+	{
+		{
+			std::unique_lock< std::mutex > lock( fMutex );
+			fWake.wait( lock, [&]{ return fShouldQuit || generation != fGeneration; } );
+
+			if ( fShouldQuit )
+			{
+				break;
+			}
+
+			generation = fGeneration;
+		}
+
+		RunJobs();
+
+		std::lock_guard< std::mutex > lock( fMutex );
+		if ( 0 == --fNumBusy )
+		{
+			fDone.notify_one();
+		}
+	}
+}
+
+void
+WorkerPool::RunJobs()
+{
+	TRACE_SCOPE( jobs, "WorkerPool::RunJobs" );
+
+	const U32 count = fCount;
+	const U32 chunk = fChunk;
+
+	for ( U32 begin = fNext.fetch_add( chunk ); begin < count; begin = fNext.fetch_add( chunk ) )
+	{
+		U32 end = ( count - begin > chunk ? begin + chunk : count );
+		for ( U32 i = begin; i < end; i++ )
+		{
+			fJob( fUserData, i );
+		}
+	}
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_WorkerPool_H__
+#define _Rtt_WorkerPool_H__
+
+#include "Core/Rtt_Macros.h"
+#include "Core/Rtt_Types.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Small pool of native threads for data-parallel loops over engine objects.
+//
+// ParallelFor() hands out indices in chunks from a shared counter, so threads
+// that finish early keep pulling work from the remaining range. The calling
+// thread participates and the call returns only once every index has run.
+// Jobs must not touch Lua or the GPU.
+class WorkerPool
+{
+	Rtt_CLASS_NO_COPIES( WorkerPool )
+
+	public:
+		typedef void (*Job)( void *userData, U32 index );
+
+	public:
+		// Process-wide pool, sized to the hardware. Has no workers on platforms
+		// without thread support, in which case ParallelFor() runs serially.
+		static WorkerPool& Shared();
+
+		// True on the pool's own threads. Nested ParallelFor() calls made from
+		// a job run serially on the current thread.
+		static bool IsWorkerThread();
+
+	public:
+		WorkerPool( U32 numWorkers );
+		~WorkerPool();
+
+	public:
+		// Number of threads a ParallelFor() runs on, including the caller
+		U32 GetConcurrency() const { return (U32)fWorkers.size() + 1; }
+
+		void ParallelFor( U32 count, Job job, void *userData );
+
+	private:
+		void RunWorker();
+		void RunJobs();
+
+	private:
+		std::vector< std::thread > fWorkers;
+		std::mutex fCallerMutex; // serializes concurrent callers
+		std::mutex fMutex;
+		std::condition_variable fWake;
+		std::condition_variable fDone;
+
+		Job fJob;
+		void *fUserData;
+		U32 fCount;
+		U32 fChunk;
+		std::atomic< U32 > fNext;
+
+		U32 fGeneration;
+		U32 fNumBusy;
+		bool fShouldQuit;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_WorkerPool_H__
@@ -727,6 +727,11 @@ struct CoronaObjectsInterface : public Base {
         return result;
     }
 
+    virtual bool CanUpdateConcurrently() const
+    {
+        return false; // plugin callbacks are free to use Lua
+    }
+
     virtual void DidMoveOffscreen()
     {
         OBJECT_HANDLE_SCOPE();
@@ -932,6 +937,14 @@ struct CoronaObjectsInterface : public Base {
         }
     }
 
+    virtual void SetOriginAndRotation( Rtt::Real x, Rtt::Real y, Rtt::Real rotation )
+    {
+        // Go through Translate() and Rotate(), so their callbacks still see each change
+        Super::SetGeometricProperty( Rtt::kOriginX, x );
+        Super::SetGeometricProperty( Rtt::kOriginY, y );
+        Super::SetGeometricProperty( Rtt::kRotation, rotation );
+    }
+
     virtual void Translate( Rtt::Real deltaX, Rtt::Real deltaY )
     {
         OBJECT_HANDLE_SCOPE();
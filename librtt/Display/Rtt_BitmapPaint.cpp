@@ -17,6 +17,8 @@
 #include "Display/Rtt_BitmapPaintAdapter.h"
 #include "Display/Rtt_Display.h"
 #include "Display/Rtt_DisplayDefaults.h"
+#include "Display/Rtt_ImageSheet.h"
+#include "Display/Rtt_ImageSheetPaint.h"
 #include "Renderer/Rtt_RenderData.h"
 #include "Rtt_Runtime.h"
 #include "Display/Rtt_TextureFactory.h"
@@ -40,15 +42,11 @@ BitmapPaint::NewTextureResource( Runtime& runtime, const char* filename, MPlatfo
 }
 */
 
-BitmapPaint*
-BitmapPaint::NewBitmap( Runtime& runtime, const char* filename, MPlatform::Directory baseDir, U32 flags )
+static BitmapPaint*
+NewImageBitmap( Runtime& runtime, const SharedPtr< TextureResource >& pTexture, const char* filename )
 {
 	BitmapPaint *result = NULL;
 
-	TextureFactory& factory = runtime.GetDisplay().GetTextureFactory();
-	SharedPtr< TextureResource > pTexture =
-		factory.FindOrCreate( filename, baseDir, flags, false );
-
 	if ( pTexture.NotNull() )
 	{
 		if ( pTexture->GetBitmap() == NULL || !pTexture->GetBitmap()->IsMask() )
@@ -65,6 +63,39 @@ BitmapPaint::NewBitmap( Runtime& runtime, const char* filename, MPlatform::Direc
 	return result;
 }
 
+BitmapPaint*
+BitmapPaint::NewBitmap( Runtime& runtime, const char* filename, MPlatform::Directory baseDir, U32 flags )
+{
+	TextureFactory& factory = runtime.GetDisplay().GetTextureFactory();
+	SharedPtr< TextureResource > pTexture =
+		factory.FindOrCreate( filename, baseDir, flags, false );
+
+	return NewImageBitmap( runtime, pTexture, filename );
+}
+
+BitmapPaint*
+BitmapPaint::NewImage( Runtime& runtime, const char* filename, MPlatform::Directory baseDir, U32 flags )
+{
+	TextureFactory& factory = runtime.GetDisplay().GetTextureFactory();
+
+	if ( ! factory.IsAtlasEnabled() )
+	{
+		return NewBitmap( runtime, filename, baseDir, flags );
+	}
+
+	const AutoPtr< ImageSheet > *sheet = NULL;
+	S32 frameIndex = -1;
+	SharedPtr< TextureResource > pTexture =
+		factory.FindOrCreateInAtlas( filename, baseDir, flags, sheet, frameIndex );
+
+	if ( sheet )
+	{
+		return ImageSheetPaint::NewBitmap( runtime.Allocator(), * sheet, frameIndex );
+	}
+
+	return NewImageBitmap( runtime, pTexture, filename );
+}
+
 BitmapPaint*
 BitmapPaint::NewBitmap( Runtime& runtime, const FilePath& data, U32 flags, bool isMask )
 {
@@ -39,6 +39,10 @@ class BitmapPaint : public Paint
 		// Load bitmap from file or reuse bitmap from image cache
 		static BitmapPaint* NewBitmap( Runtime& runtime, const char* filename, MPlatform::Directory baseDir, U32 flags );
 
+		// Same, but small images may share a texture atlas page, in which case
+		// the result is an ImageSheetPaint; see TextureFactory::SetAtlasMaxImageSize()
+		static BitmapPaint* NewImage( Runtime& runtime, const char* filename, MPlatform::Directory baseDir, U32 flags );
+
 		// Load bitmap mask from file or reuse bitmap from image cache
 		static BitmapPaint* NewBitmap( Runtime& runtime, const FilePath& data, U32 flags, bool isMask );
 
@@ -11,6 +11,8 @@
 
 #include "Rtt_BufferBitmap.h"
 
+#include "Display/Rtt_PixelConversion.h"
+
 // ----------------------------------------------------------------------------
 
 namespace Rtt
@@ -187,46 +189,19 @@ void
 BufferBitmap::UndoPremultipliedAlpha()
 {
 	// We're assuming 4 bytes (U32) per pixel.
-	U32 *p = static_cast< U32 * >( WriteAccess() );
-
-	Rtt_ASSERT( sizeof( *p ) == PlatformBitmap::BytesPerPixel( GetFormat() ) );
+	U8 *p = static_cast< U8 * >( WriteAccess() );
 
-	int numPixels = ( Width() * Height() );
+	Rtt_ASSERT( 4 == PlatformBitmap::BytesPerPixel( GetFormat() ) );
 
-	for( int i = 0;
-			i < numPixels;
-			++i )
-	{
-		#ifdef Rtt_OPENGLES
-			//RGBA
-			U8 a = ((U8 *)p)[3];
-		#else
-			//ARGB
-			U8 a = ((U8 *)p)[0];
-		#endif
-
-		if ( a > 0 )
-		{
-			#ifdef Rtt_OPENGLES
-				//RGBA
-				U8& r = ((U8 *)p)[0];
-				U8& g = ((U8 *)p)[1];
-				U8& b = ((U8 *)p)[2];
-			#else
-				//ARGB
-				U8& r = ((U8 *)p)[1];
-				U8& g = ((U8 *)p)[2];
-				U8& b = ((U8 *)p)[3];
-			#endif
-
-			float invAlpha = 255.f / (float)a;
-			r = invAlpha * r;
-			g = invAlpha * g;
-			b = invAlpha * b;
-		}
+	#ifdef Rtt_OPENGLES
+		//RGBA
+		const S32 alphaIndex = 3;
+	#else
+		//ARGB
+		const S32 alphaIndex = 0;
+	#endif
 
-		p++;
-	}
+	PixelConversion::Unpremultiply( p, (size_t)Width() * Height(), alphaIndex );
 }
 
 // ----------------------------------------------------------------------------
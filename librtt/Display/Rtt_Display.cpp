@@ -12,6 +12,7 @@
 #include "Display/Rtt_Display.h"
 
 #include "Core/Rtt_Geometry.h"
+#include "Core/Rtt_TraceRecorder.h"
 #include "Display/Rtt_CPUResourcePool.h"
 #include "Display/Rtt_DisplayDefaults.h"
 #include "Display/Rtt_MDisplayDelegate.h"
@@ -32,6 +33,7 @@
 #include "CoronaLua.h"
 
 #include "Renderer/Rtt_GLRenderer.h"
+#include "Renderer/Rtt_RecordingRenderer.h"
 #include "Renderer/Rtt_VulkanExports.h"
 #include "Renderer/Rtt_FrameBufferObject.h"
 #include "Renderer/Rtt_Matrix_Renderer.h"
@@ -214,6 +216,7 @@ Display::Display( Runtime& owner )
   fFactoryFunc( NULL ),
 	fDrawMode( kDefaultDrawMode ),
 	fIsAntialiased( false ),
+	fIsConcurrentTraversal( false ),
 	fIsCollecting( false ),
 	fIsRestricted( false ),
 	fAllowFeatureResult( false ), // When IsRestricted(), default to *not* allowing.
@@ -273,12 +276,25 @@ Display::Initialize( lua_State *L, int configIndex, DeviceOrientation::Type orie
 		{
 			fRenderer = VulkanExports::CreateVulkanRenderer( allocator, backendContext, &InvalidateDisplay, this );
 		}
+
+		else if (strcmp( backend, "nullBackend" ) == 0)
+		{
+			fRenderer = Rtt_NEW( allocator, RecordingRenderer( allocator ) );
+		}
 		else
 		{
 			Rtt_ASSERT_NOT_REACHED();
 		}
 #else
-		fRenderer = Rtt_NEW( allocator, GLRenderer( allocator ) );
+		if (strcmp( backend, "nullBackend" ) == 0)
+		{
+			// Headless, e.g. for benchmarking without a GPU
+			fRenderer = Rtt_NEW( allocator, RecordingRenderer( allocator ) );
+		}
+		else
+		{
+			fRenderer = Rtt_NEW( allocator, GLRenderer( allocator ) );
+		}
 #endif
 
 		fRenderer->Initialize();
@@ -396,6 +412,38 @@ Display::ReadRenderingConfig( lua_State *L, int index, ProgramHeader& programHea
     }
     lua_pop( L, 1 );
 
+    // Opt-in, see Renderer::SetBatchSortingEnabled()
+    lua_getfield( L, index, "sortedBatching" );
+    if ( lua_toboolean( L, -1 ) )
+    {
+        fRenderer->SetBatchSortingEnabled( true );
+    }
+    lua_pop( L, 1 );
+
+    // Opt-in, see DisplayObject::CanUpdateConcurrently()
+    lua_getfield( L, index, "concurrentTraversal" );
+    if ( lua_toboolean( L, -1 ) )
+    {
+        SetConcurrentTraversal( true );
+    }
+    lua_pop( L, 1 );
+
+    // Opt-in, in MB, see TextureFactory::SetRecentTexturesBudget()
+    lua_getfield( L, index, "textureCacheBudget" );
+    if ( lua_type( L, -1 ) == LUA_TNUMBER && lua_tonumber( L, -1 ) > 0 )
+    {
+        fTextureFactory->SetRecentTexturesBudget( (size_t)( lua_tonumber( L, -1 ) * 1024 * 1024 ) );
+    }
+    lua_pop( L, 1 );
+
+    // Opt-in, in pixels, see TextureFactory::SetAtlasMaxImageSize()
+    lua_getfield( L, index, "textureAtlasMaxImageSize" );
+    if ( lua_type( L, -1 ) == LUA_TNUMBER && lua_tointeger( L, -1 ) > 0 )
+    {
+        fTextureFactory->SetAtlasMaxImageSize( (U32)lua_tointeger( L, -1 ) );
+    }
+    lua_pop( L, 1 );
+
     ScaleMode scaleMode = ToScaleMode( L, index );
 
     if ( kAdaptive == scaleMode )
@@ -556,12 +604,19 @@ Display::Restart( int newWidth, int newHeight )
 void
 Display::Update()
 {
+    TRACE_SCOPE( up, "Display::Update" );
     PROFILING_BEGIN( *GetProfilingState(), up, Update );
 
     up.Add( "Display::Update Begin" );
     
     Runtime& runtime = fOwner;
     lua_State *L = fOwner.VMContext().L();
+
+    fTextureFactory->UpdateLoads();
+    fTextureFactory->TrimRecentTextures();
+
+	up.Add( "Finish texture loads" );
+
     fSpritePlayer->Run( L, Rtt_AbsoluteToMilliseconds(runtime.GetElapsedTime()) );
 
 	up.Add( "Run sprite player" );
@@ -595,6 +650,7 @@ Display::Update()
 void
 Display::Render()
 {
+    TRACE_SCOPE( rp, "Display::Render" );
     PROFILING_BEGIN( *GetProfilingState(), rp, Render );
 
     rp.Add( "Display::Render Begin" );
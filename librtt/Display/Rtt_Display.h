@@ -351,6 +351,11 @@ class Display
         bool IsAntialiased() const { return fIsAntialiased; }
         void SetAntialiased( bool newValue ) { fIsAntialiased = newValue; }
 
+        // When true, large groups update and prepare eligible children on the
+        // shared WorkerPool, see DisplayObject::CanUpdateConcurrently()
+        bool IsConcurrentTraversal() const { return fIsConcurrentTraversal; }
+        void SetConcurrentTraversal( bool newValue ) { fIsConcurrentTraversal = newValue; }
+
         void SetWireframe( bool newValue );
 
 #if defined( Rtt_ANDROID_ENV ) && TEMPORARY_HACK
@@ -414,6 +419,7 @@ class Display
 
 		U8 fDrawMode; // stores current physics drawing mode; ranges from 0-2
 		bool fIsAntialiased;
+		bool fIsConcurrentTraversal;
 		bool fIsCollecting; // guards against nested calls to Collect()
 		bool fIsRestricted;
 		mutable bool fAllowFeatureResult;
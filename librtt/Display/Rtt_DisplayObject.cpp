@@ -72,6 +72,16 @@ DisplayObject::MaskForString( const char *name )
         {
             result = kFinalizeListener;
         }
+#ifdef Rtt_PHYSICS
+        else if ( 0 == strcmp( name, CollisionEvent::kName ) )
+        {
+            result = kCollisionListener;
+        }
+        else if ( 0 == strcmp( name, PostCollisionEvent::kName ) )
+        {
+            result = kPostCollisionListener;
+        }
+#endif
     }
 
     return result;
@@ -638,6 +648,12 @@ DisplayObject::CanHitTest() const
     return true;
 }
 
+bool
+DisplayObject::CanUpdateConcurrently() const
+{
+    return false;
+}
+
 void
 DisplayObject::InitProxy( lua_State *L )
 {
@@ -760,7 +776,10 @@ DisplayObject::DispatchEventWithTarget( lua_State *L, const MEvent& e, int nresu
         luaProxy->PushTable( L );
         lua_setfield( L, -2, "target" );
 
-        return LuaContext::DoCall( L, 2, nresults );
+        int status = LuaContext::DoCall( L, 2, nresults );
+        e.DidDispatch( L );
+
+        return status;
     }
     else
     {
@@ -1146,13 +1165,14 @@ DisplayObject::Invalidate( DirtyFlags flags )
         flags &= ( ~kMaskFlag );
     }
 
-    fDirtyFlags |= flags;
-
+    // Before setting flags, so InvalidateStageBounds() still sees the old state
     if ( flags & ( kGeometryFlag | kTransformFlag | kStageBoundsFlag ) )
     {
         InvalidateStageBounds();
     }
 
+    fDirtyFlags |= flags;
+
     if ( flags & ( kGeometryFlag ) )
     {
         fTransform.Invalidate();
@@ -1192,6 +1212,13 @@ DisplayObject::SetDirty( RenderFlag mask )
 void
 DisplayObject::InvalidateStageBounds()
 {
+    // Let the parent's hit-test index know the bounds it binned are stale.
+    // Only needed on the valid -> dirty transition.
+    if ( fParent && IsValid( kStageBoundsFlag ) )
+    {
+        fParent->DidInvalidateChildStageBounds( * this );
+    }
+
     SetDirty( kStageBoundsFlag );
 
     const DisplayObject *canvas = GetStage();
@@ -1517,6 +1544,23 @@ DisplayObject::SetGeometricProperty( enum GeometricProperty p, Real newValue )
     }
 }
 
+void
+DisplayObject::SetOriginAndRotation( Real x, Real y, Real rotation )
+{
+    bool isMoved = ( x != fTransform.GetProperty( kOriginX ) || y != fTransform.GetProperty( kOriginY ) );
+    bool isRotated = ( rotation != fTransform.GetProperty( kRotation ) );
+
+    if ( isMoved || isRotated )
+    {
+        fTransform.SetProperty( kOriginX, x );
+        fTransform.SetProperty( kOriginY, y );
+        fTransform.SetProperty( kRotation, rotation );
+
+        // Union of what Translate() and Rotate() invalidate
+        Invalidate( kGeometryFlag | kTransformFlag | kMaskFlag | kStageBoundsFlag );
+    }
+}
+
 Real
 DisplayObject::GetGeometricProperty( enum GeometricProperty p ) const
 {
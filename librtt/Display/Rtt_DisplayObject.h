@@ -134,6 +134,8 @@ class DisplayObject : public MDrawable, public MLuaProxyable
             kSpriteListener = 0x4,
             kMouseListener = 0x8,
             kFinalizeListener = 0x10,
+            kCollisionListener = 0x20,
+            kPostCollisionListener = 0x40,
         };
 
         typedef U8 ListenerSet;
@@ -187,6 +189,12 @@ class DisplayObject : public MDrawable, public MLuaProxyable
 		virtual bool CanCull() const;
         virtual bool CanHitTest() const;
 
+        // True when UpdateTransform(), BuildStageBounds(), CullOffscreen() and
+        // Prepare() only write to the receiver, i.e. never reach Lua, shared
+        // factories or other objects. Parents may then run them on a worker
+        // thread, see GroupObject::UpdateTransform().
+        virtual bool CanUpdateConcurrently() const;
+
     public:
         // MLuaProxyable
         virtual void InitProxy( lua_State *L );
@@ -324,6 +332,11 @@ class DisplayObject : public MDrawable, public MLuaProxyable
         void SetGeometricProperty( enum GeometricProperty p, Real newValue );
         Real GetGeometricProperty( enum GeometricProperty p ) const;
 
+        // Same as setting kOriginX, kOriginY and kRotation, but invalidates
+        // once, and not at all if nothing changed. Leaves any physics body
+        // alone, so the world can sync objects with their bodies.
+        virtual void SetOriginAndRotation( Real x, Real y, Real rotation );
+
     protected:
         Real GetInternalAnchorX() const { return fAnchorX; }
         Real GetInternalAnchorY() const { return fAnchorY; }
@@ -31,7 +31,15 @@
 
 #include "Box2D/Box2D.h"
 #include "Rtt_LuaContainer.h"
+#include "Core/Rtt_WorkerPool.h"
 #include <algorithm>
+#include <string.h>
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+	#include <xmmintrin.h>
+#elif defined( __ARM_NEON ) && ( defined( __aarch64__ ) || defined( _M_ARM64 ) )
+	#include <arm_neon.h>
+#endif
 
 #include "Rtt_Profiling.h"
 
@@ -112,89 +120,209 @@ enum kParticleTypes
 #define GET_RANDOM_0_TO_1( ... )		( (float)rand() / (float)RAND_MAX )
 #define GET_RANDOM_MINUS_1_TO_1( ... )	( ( (float)rand() / (float)( RAND_MAX / 2 ) ) - 1.0f )
 
-// Structure used to hold particle specific information
-struct EmitterObjectParticle
+// Four-wide float operations for the particle kernels. Division and square
+// root must be exact so results match the scalar build, which rules out
+// 32-bit ARM NEON (estimates only); it uses the scalar path.
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+
+typedef __m128 Float4;
+typedef __m128 Mask4;
+static const int kParticleLanes = 4;
+
+static Rtt_FORCE_INLINE Float4 Load4( const float *p ) { return _mm_loadu_ps( p ); }
+static Rtt_FORCE_INLINE void Store4( float *p, Float4 v ) { _mm_storeu_ps( p, v ); }
+static Rtt_FORCE_INLINE Float4 Splat4( float f ) { return _mm_set1_ps( f ); }
+static Rtt_FORCE_INLINE Float4 Add4( Float4 a, Float4 b ) { return _mm_add_ps( a, b ); }
+static Rtt_FORCE_INLINE Float4 Sub4( Float4 a, Float4 b ) { return _mm_sub_ps( a, b ); }
+static Rtt_FORCE_INLINE Float4 Mul4( Float4 a, Float4 b ) { return _mm_mul_ps( a, b ); }
+static Rtt_FORCE_INLINE Float4 Div4( Float4 a, Float4 b ) { return _mm_div_ps( a, b ); }
+static Rtt_FORCE_INLINE Float4 Max4( Float4 a, Float4 b ) { return _mm_max_ps( b, a ); }
+static Rtt_FORCE_INLINE Float4 Sqrt4( Float4 a ) { return _mm_sqrt_ps( a ); }
+static Rtt_FORCE_INLINE Mask4 GreaterEqual4( Float4 a, Float4 b ) { return _mm_cmpge_ps( a, b ); }
+static Rtt_FORCE_INLINE Float4 Select4( Mask4 m, Float4 a, Float4 b ) { return _mm_or_ps( _mm_and_ps( m, a ), _mm_andnot_ps( m, b ) ); }
+
+#elif defined( __ARM_NEON ) && ( defined( __aarch64__ ) || defined( _M_ARM64 ) )
+
+typedef float32x4_t Float4;
+typedef uint32x4_t Mask4;
+static const int kParticleLanes = 4;
+
+static Rtt_FORCE_INLINE Float4 Load4( const float *p ) { return vld1q_f32( p ); }
+static Rtt_FORCE_INLINE void Store4( float *p, Float4 v ) { vst1q_f32( p, v ); }
+static Rtt_FORCE_INLINE Float4 Splat4( float f ) { return vdupq_n_f32( f ); }
+static Rtt_FORCE_INLINE Float4 Add4( Float4 a, Float4 b ) { return vaddq_f32( a, b ); }
+static Rtt_FORCE_INLINE Float4 Sub4( Float4 a, Float4 b ) { return vsubq_f32( a, b ); }
+static Rtt_FORCE_INLINE Float4 Mul4( Float4 a, Float4 b ) { return vmulq_f32( a, b ); }
+static Rtt_FORCE_INLINE Float4 Div4( Float4 a, Float4 b ) { return vdivq_f32( a, b ); }
+static Rtt_FORCE_INLINE Float4 Max4( Float4 a, Float4 b ) { return vmaxq_f32( a, b ); }
+static Rtt_FORCE_INLINE Float4 Sqrt4( Float4 a ) { return vsqrtq_f32( a ); }
+static Rtt_FORCE_INLINE Mask4 GreaterEqual4( Float4 a, Float4 b ) { return vcgeq_f32( a, b ); }
+static Rtt_FORCE_INLINE Float4 Select4( Mask4 m, Float4 a, Float4 b ) { return vbslq_f32( m, a, b ); }
+
+#else
+
+typedef float Float4;
+typedef bool Mask4;
+static const int kParticleLanes = 1;
+
+static Rtt_FORCE_INLINE Float4 Load4( const float *p ) { return *p; }
+static Rtt_FORCE_INLINE void Store4( float *p, Float4 v ) { *p = v; }
+static Rtt_FORCE_INLINE Float4 Splat4( float f ) { return f; }
+static Rtt_FORCE_INLINE Float4 Add4( Float4 a, Float4 b ) { return a + b; }
+static Rtt_FORCE_INLINE Float4 Sub4( Float4 a, Float4 b ) { return a - b; }
+static Rtt_FORCE_INLINE Float4 Mul4( Float4 a, Float4 b ) { return a * b; }
+static Rtt_FORCE_INLINE Float4 Div4( Float4 a, Float4 b ) { return a / b; }
+static Rtt_FORCE_INLINE Float4 Max4( Float4 a, Float4 b ) { return std::max( a, b ); }
+static Rtt_FORCE_INLINE Float4 Sqrt4( Float4 a ) { return sqrtf( a ); }
+static Rtt_FORCE_INLINE Mask4 GreaterEqual4( Float4 a, Float4 b ) { return a >= b; }
+static Rtt_FORCE_INLINE Float4 Select4( Mask4 m, Float4 a, Float4 b ) { return m ? a : b; }
+
+#endif
+
+// Particle state, stored as one array per field so the per-frame update
+// streams through memory and steps several particles per instruction.
+// Arrays are padded to a multiple of kParticleLanes; padding lanes hold
+// stale values that are stepped along but never emitted.
+struct EmitterObjectParticles
 {
-	void Reset();
-	void Init( EmitterObject *eo, const Matrix &spawnTimeTransform );
-	void Update( EmitterObject *eo, float time_delta );
-	void UpdateVertices( EmitterObject *eo,
-							EmitterObjectParticle &particle,
-							Geometry::Vertex *output_vertices );
-
-	Matrix fSpawnTimeTransform;
-	b2Vec2 fPosition;
-	b2Vec2 fDirection;
-//    b2Vec2 fStartPos;
-	Vector4 fColor;
-	Vector4 fDeltaColor;
-    float fRotation;
-    float fRotationDelta;
-    float fRadialAcceleration;
-    float fTangentialAcceleration;
-	float fRadius;
-	float fRadiusDelta;
-	float fRotationInRadians;
-	float fRadiansPerSecond;
-	float fParticleSize;
-	float fParticleSizeDelta;
-	float fTimeToLiveInSeconds;
+	enum Field
+	{
+		kPositionX,
+		kPositionY,
+		kDirectionX,
+		kDirectionY,
+		kColorR,
+		kColorG,
+		kColorB,
+		kColorA,
+		kDeltaColorR,
+		kDeltaColorG,
+		kDeltaColorB,
+		kDeltaColorA,
+		kRotation,
+		kRotationDelta,
+		kRadialAcceleration,
+		kTangentialAcceleration,
+		kRadius,
+		kRadiusDelta,
+		kRotationInRadians,
+		kRadiansPerSecond,
+		kParticleSize,
+		kParticleSizeDelta,
+		kTimeToLiveInSeconds,
+
+		// Scratch, written by Transform() and read by Emit()
+		kBaseX,
+		kBaseY,
+
+		kNumFields
+	};
+
+	static EmitterObjectParticles *New( Rtt_Allocator *allocator, int maxParticles );
+
+	float *operator[]( Field field ) const { return fFields[field]; }
+
+	void Init( EmitterObject *eo, int index, const Matrix &spawnTimeTransform );
+	void Copy( int dst, int src );
+
+	// Steps particles [begin, end). begin is a multiple of kParticleLanes,
+	// and so is end unless it is the rounded up particle count
+	void Step( const EmitterObject *eo, float time_delta, int begin, int end );
+
+	// Fills kBaseX/kBaseY with the content positions of particles [begin, end)
+	void Transform( const EmitterObject *eo, int begin, int end );
+
+	void Emit( const EmitterObject *eo, int begin, int end, Geometry::Vertex *output_vertices ) const;
+
+	float *fFields[kNumFields];
+	Matrix *fSpawnTimeTransforms;
+	int fCapacity;
 };
 
-void EmitterObjectParticle::Reset()
+// Particles per ParallelFor() index when an emitter is split across workers
+static const int kParticlesPerJob = 256;
+
+// Emitters with fewer live particles are not worth handing to the workers
+static const int kMinConcurrentParticles = 1024;
+
+static int
+RoundUpToLanes( int count )
 {
-	fTimeToLiveInSeconds = 0.0f;
+	return ( ( count + kParticleLanes - 1 ) / kParticleLanes ) * kParticleLanes;
 }
 
-void EmitterObjectParticle::Init( EmitterObject *eo, const Matrix &spawnTimeTransform )
+EmitterObjectParticles *
+EmitterObjectParticles::New( Rtt_Allocator *allocator, int maxParticles )
 {
-	fSpawnTimeTransform = spawnTimeTransform;
+	int capacity = RoundUpToLanes( maxParticles );
+
+	size_t fieldsSize = sizeof( float ) * capacity * kNumFields;
+	size_t size = sizeof( EmitterObjectParticles ) + fieldsSize + ( sizeof( Matrix ) * capacity );
+
+	EmitterObjectParticles *result = (EmitterObjectParticles *)Rtt_MALLOC( allocator, size );
+	memset( result, 0, size );
+
+	float *fields = (float *)( result + 1 );
+	for( int i = 0;
+			i < kNumFields;
+			++i )
+	{
+		result->fFields[i] = fields + ( i * capacity );
+	}
+
+	result->fSpawnTimeTransforms = (Matrix *)( fields + ( kNumFields * capacity ) );
+	result->fCapacity = capacity;
+
+	return result;
+}
+
+void EmitterObjectParticles::Init( EmitterObject *eo, int index, const Matrix &spawnTimeTransform )
+{
+	EmitterObjectParticles &p = *this;
+	const int i = index;
+
+	fSpawnTimeTransforms[i] = spawnTimeTransform;
 
 	// Init the position of the particle.  This is based on the source position of the particle emitter
 	// plus a configured variance.  The GET_RANDOM_MINUS_1_TO_1 macro allows the number to be both positive
 	// and negative
-	fPosition.x = eo->fSourcePositionVariance.x * GET_RANDOM_MINUS_1_TO_1();
-	fPosition.y = eo->fSourcePositionVariance.y * GET_RANDOM_MINUS_1_TO_1();
-//    fStartPos.x = 0.0f;
-//    fStartPos.y = 0.0f;
-
+	p[kPositionX][i] = eo->fSourcePositionVariance.x * GET_RANDOM_MINUS_1_TO_1();
+	p[kPositionY][i] = eo->fSourcePositionVariance.y * GET_RANDOM_MINUS_1_TO_1();
 
 	// Init the direction of the particle.  The newAngleInRadians is calculated using the angle passed in and the
 	// angle variance.
 	float newAngleInRadians = Rtt_RealDegreesToRadians(eo->fRotationInDegrees + eo->fRotationInDegreesVariance * GET_RANDOM_MINUS_1_TO_1());
 
-	// Create a new GLKVector2 using the newAngleInRadians
-	b2Vec2 vector( cosf(newAngleInRadians), sinf(newAngleInRadians) );
-
 	// Calculate the vectorSpeed using the speed and speedVariance which has been passed in
 	float vectorSpeed = std::max( 0.0f, ( eo->fSpeed + eo->fSpeedVariance * GET_RANDOM_MINUS_1_TO_1() ) );
 
-	// The particles direction vector is calculated by taking the vector calculated above and
+	// The particles direction vector is calculated by taking the unit vector for the angle above and
 	// multiplying that by the speed
-	fDirection = vector;
-	fDirection *= vectorSpeed;
+	p[kDirectionX][i] = cosf(newAngleInRadians) * vectorSpeed;
+	p[kDirectionY][i] = sinf(newAngleInRadians) * vectorSpeed;
 
     // Calculate the particles life span using the life span and variance passed in
-	fTimeToLiveInSeconds = std::max( 0.0f, ( eo->fParticleLifespanInSeconds + eo->fParticleLifespanInSecondsVariance * GET_RANDOM_MINUS_1_TO_1() ) );
+	float timeToLiveInSeconds = std::max( 0.0f, ( eo->fParticleLifespanInSeconds + eo->fParticleLifespanInSecondsVariance * GET_RANDOM_MINUS_1_TO_1() ) );
+	p[kTimeToLiveInSeconds][i] = timeToLiveInSeconds;
 
     float startRadius = std::max( 0.0f, ( eo->fMaxRadius + eo->fMaxRadiusVariance * GET_RANDOM_MINUS_1_TO_1() ) );
     float endRadius = std::max( 0.0f, ( eo->fMinRadius + eo->fMinRadiusVariance * GET_RANDOM_MINUS_1_TO_1() ) );
 
 	// Set the default diameter of the particle from the source position
-	fRadius = startRadius;
-	fRadiusDelta = (endRadius - startRadius) / fTimeToLiveInSeconds;
+	p[kRadius][i] = startRadius;
+	p[kRadiusDelta][i] = (endRadius - startRadius) / timeToLiveInSeconds;
 
-	fRotationInRadians = Rtt_RealDegreesToRadians(eo->fRotationInDegrees + eo->fRotationInDegreesVariance * GET_RANDOM_MINUS_1_TO_1());
-	fRadiansPerSecond = Rtt_RealDegreesToRadians(eo->fRotateDegreesPerSecond + eo->fRotateDegreesPerSecondVariance * GET_RANDOM_MINUS_1_TO_1());
+	p[kRotationInRadians][i] = Rtt_RealDegreesToRadians(eo->fRotationInDegrees + eo->fRotationInDegreesVariance * GET_RANDOM_MINUS_1_TO_1());
+	p[kRadiansPerSecond][i] = Rtt_RealDegreesToRadians(eo->fRotateDegreesPerSecond + eo->fRotateDegreesPerSecondVariance * GET_RANDOM_MINUS_1_TO_1());
 
-    fRadialAcceleration = eo->fRadialAcceleration + eo->fRadialAccelerationVariance * GET_RANDOM_MINUS_1_TO_1();
-    fTangentialAcceleration = eo->fTangentialAcceleration + eo->fTangentialAccelerationVariance * GET_RANDOM_MINUS_1_TO_1();
+    p[kRadialAcceleration][i] = eo->fRadialAcceleration + eo->fRadialAccelerationVariance * GET_RANDOM_MINUS_1_TO_1();
+    p[kTangentialAcceleration][i] = eo->fTangentialAcceleration + eo->fTangentialAccelerationVariance * GET_RANDOM_MINUS_1_TO_1();
 
 	// Calculate the particle size using the start and finish particle sizes
 	float particleStartSize = std::max( 0.0f, eo->fStartParticleSize + eo->fStartParticleSizeVariance * GET_RANDOM_MINUS_1_TO_1() );
 	float particleFinishSize = std::max( 0.0f, eo->fFinishParticleSize + eo->fFinishParticleSizeVariance * GET_RANDOM_MINUS_1_TO_1() );
-	fParticleSizeDelta = ((particleFinishSize - particleStartSize) / fTimeToLiveInSeconds);
-	fParticleSize = particleStartSize;
+	p[kParticleSizeDelta][i] = ((particleFinishSize - particleStartSize) / timeToLiveInSeconds);
+	p[kParticleSize][i] = particleStartSize;
 
 	// Calculate the color the particle should have when it starts its life.  All the elements
 	// of the start color passed in along with the variance are used to calculate the star color
@@ -218,88 +346,117 @@ void EmitterObjectParticle::Init( EmitterObject *eo, const Matrix &spawnTimeTran
 	// loop is using a fixed delta value we can calculate the delta color once saving cycles in the
 	// update method
 
-    fColor = start;
-	fDeltaColor.r = ((end.r - start.r) / fTimeToLiveInSeconds);
-	fDeltaColor.g = ((end.g - start.g) / fTimeToLiveInSeconds);
-	fDeltaColor.b = ((end.b - start.b) / fTimeToLiveInSeconds);
-	fDeltaColor.a = ((end.a - start.a) / fTimeToLiveInSeconds);
+	p[kColorR][i] = start.r;
+	p[kColorG][i] = start.g;
+	p[kColorB][i] = start.b;
+	p[kColorA][i] = start.a;
+	p[kDeltaColorR][i] = ((end.r - start.r) / timeToLiveInSeconds);
+	p[kDeltaColorG][i] = ((end.g - start.g) / timeToLiveInSeconds);
+	p[kDeltaColorB][i] = ((end.b - start.b) / timeToLiveInSeconds);
+	p[kDeltaColorA][i] = ((end.a - start.a) / timeToLiveInSeconds);
 
     // Calculate the rotation
     float startA = eo->fRotationStart + eo->fRotationStartVariance * GET_RANDOM_MINUS_1_TO_1();
     float endA = eo->fRotationEnd + eo->fRotationEndVariance * GET_RANDOM_MINUS_1_TO_1();
-    fRotation = startA;
-    fRotationDelta = (endA - startA) / fTimeToLiveInSeconds;
+    p[kRotation][i] = startA;
+    p[kRotationDelta][i] = (endA - startA) / timeToLiveInSeconds;
 }
 
-void EmitterObjectParticle::Update( EmitterObject *eo, float time_delta )
+void EmitterObjectParticles::Copy( int dst, int src )
 {
-    // Reduce the life span of the particle
-    fTimeToLiveInSeconds -= time_delta;
+	for( int i = 0;
+			i < kBaseX;
+			++i )
+	{
+		fFields[i][dst] = fFields[i][src];
+	}
 
-	// If the current particle is alive then update it
-	if( fTimeToLiveInSeconds <= 0.0f )
+	fSpawnTimeTransforms[dst] = fSpawnTimeTransforms[src];
+}
+
+void EmitterObjectParticles::Step( const EmitterObject *eo, float time_delta, int begin, int end )
+{
+	const EmitterObjectParticles &p = *this;
+	const Float4 dt = Splat4( time_delta );
+
+	// Reduce the life span of the particles, and update their color, size
+	// and rotation. Particles whose life ran out are removed by the caller.
+	for( int i = begin;
+			i < end;
+			i += kParticleLanes )
 	{
-		return;
+		Store4( p[kTimeToLiveInSeconds] + i, Sub4( Load4( p[kTimeToLiveInSeconds] + i ), dt ) );
+
+		Store4( p[kColorR] + i, Add4( Load4( p[kColorR] + i ), Mul4( Load4( p[kDeltaColorR] + i ), dt ) ) );
+		Store4( p[kColorG] + i, Add4( Load4( p[kColorG] + i ), Mul4( Load4( p[kDeltaColorG] + i ), dt ) ) );
+		Store4( p[kColorB] + i, Add4( Load4( p[kColorB] + i ), Mul4( Load4( p[kDeltaColorB] + i ), dt ) ) );
+		Store4( p[kColorA] + i, Add4( Load4( p[kColorA] + i ), Mul4( Load4( p[kDeltaColorA] + i ), dt ) ) );
+
+		Float4 size = Add4( Load4( p[kParticleSize] + i ), Mul4( Load4( p[kParticleSizeDelta] + i ), dt ) );
+		Store4( p[kParticleSize] + i, Max4( Splat4( 0.0f ), size ) );
+
+		Store4( p[kRotation] + i, Add4( Load4( p[kRotation] + i ), Mul4( Load4( p[kRotationDelta] + i ), dt ) ) );
 	}
 
 	// If maxRadius is greater than 0 then the particles are going to spin otherwise they are effected by speed and gravity
 	if( eo->fEmitterType == kParticleTypeRadial )
 	{
-        // FIX 2
         // Update the angle of the particle from the sourcePosition and the radius.  This is only done of the particles are rotating
-		fRotationInRadians += fRadiansPerSecond * time_delta;
-		fRadius += fRadiusDelta * time_delta;
+		for( int i = begin;
+				i < end;
+				i += kParticleLanes )
+		{
+			Store4( p[kRotationInRadians] + i, Add4( Load4( p[kRotationInRadians] + i ), Mul4( Load4( p[kRadiansPerSecond] + i ), dt ) ) );
+			Store4( p[kRadius] + i, Add4( Load4( p[kRadius] + i ), Mul4( Load4( p[kRadiusDelta] + i ), dt ) ) );
+		}
 
-		fPosition.x = - cosf(fRotationInRadians) * fRadius;
-		fPosition.y = - sinf(fRotationInRadians) * fRadius;
+		for( int i = begin;
+				i < end;
+				++i )
+		{
+			p[kPositionX][i] = - cosf( p[kRotationInRadians][i] ) * p[kRadius][i];
+			p[kPositionY][i] = - sinf( p[kRotationInRadians][i] ) * p[kRadius][i];
+		}
 	}
 	else
 	{
-		b2Vec2 tmp, radial, tangential;
-
-        radial = b2Vec2_zero;
-
-        // By default this emitters particles are moved relative to the emitter node position
-//        b2Vec2 positionDifference = fStartPos - b2Vec2_zero;
-//        fPosition = fPosition - positionDifference;
-
-        if( fPosition.x || fPosition.y )
+		const Float4 gravityX = Splat4( eo->fGravity.x );
+		const Float4 gravityY = Splat4( eo->fGravity.y );
+		const Float4 epsilon = Splat4( b2_epsilon );
+		const Float4 one = Splat4( 1.0f );
+
+		for( int i = begin;
+				i < end;
+				i += kParticleLanes )
 		{
-            radial = fPosition;
-            radial.Normalize();
+			Float4 positionX = Load4( p[kPositionX] + i );
+			Float4 positionY = Load4( p[kPositionY] + i );
+
+			// Same as b2Vec2::Normalize(), which leaves vectors shorter
+			// than b2_epsilon (including the zero vector) untouched
+			Float4 length = Sqrt4( Add4( Mul4( positionX, positionX ), Mul4( positionY, positionY ) ) );
+			Mask4 isLong = GreaterEqual4( length, epsilon );
+			Float4 invLength = Div4( one, length );
+			Float4 radialX = Select4( isLong, Mul4( positionX, invLength ), positionX );
+			Float4 radialY = Select4( isLong, Mul4( positionY, invLength ), positionY );
+
+			Float4 tangentialAcceleration = Load4( p[kTangentialAcceleration] + i );
+			Float4 tangentialX = Mul4( Sub4( Splat4( 0.0f ), radialY ), tangentialAcceleration );
+			Float4 tangentialY = Mul4( radialX, tangentialAcceleration );
+
+			Float4 radialAcceleration = Load4( p[kRadialAcceleration] + i );
+			radialX = Mul4( radialX, radialAcceleration );
+			radialY = Mul4( radialY, radialAcceleration );
+
+			Float4 directionX = Add4( Load4( p[kDirectionX] + i ), Mul4( Add4( Add4( radialX, tangentialX ), gravityX ), dt ) );
+			Float4 directionY = Add4( Load4( p[kDirectionY] + i ), Mul4( Add4( Add4( radialY, tangentialY ), gravityY ), dt ) );
+			Store4( p[kDirectionX] + i, directionX );
+			Store4( p[kDirectionY] + i, directionY );
+
+			Store4( p[kPositionX] + i, Add4( positionX, Mul4( directionX, dt ) ) );
+			Store4( p[kPositionY] + i, Add4( positionY, Mul4( directionY, dt ) ) );
 		}
-
-        tangential = radial;
-        radial *= fRadialAcceleration;
-
-        float newy = tangential.x;
-        tangential.x = ( - tangential.y );
-        tangential.y = newy;
-        tangential *= fTangentialAcceleration;
-
-		tmp = ( radial + tangential + eo->fGravity);
-        tmp *= time_delta;
-		fDirection += tmp;
-		tmp = fDirection;
-		tmp *= time_delta;
-		fPosition += tmp;
-
-        // Now apply the difference calculated early causing the particles to be relative in position to the emitter position
-//        fPosition += positionDifference;
 	}
-
-	// Update the particles color
-	fColor.r += fDeltaColor.r * time_delta;
-	fColor.g += fDeltaColor.g * time_delta;
-	fColor.b += fDeltaColor.b * time_delta;
-	fColor.a += fDeltaColor.a * time_delta;
-
-	// Update the particle size
-	fParticleSize += fParticleSizeDelta * time_delta;
-    fParticleSize = std::max(0.0f, fParticleSize);
-
-    // Update the rotation of the particle
-    fRotation += fRotationDelta * time_delta;
 }
 
 bool EmitterObject::ValidateEmitterParent()
@@ -336,27 +493,24 @@ inline void EmitterObject::TransformParticlePosition(const Matrix &spawnTimeTran
 	}
 }
 
-static void SetVertex( Geometry::Vertex& output, const Vertex2& v, const Vector4& color )
+static void EmitRect( Geometry::Vertex *output_vertices, const Vertex2& topLeft, const Vertex2& topRight, const Vertex2& bottomLeft, const Vertex2& bottomRight, const Vector4& color )
 {
-	output.SetPos( v.x, v.y );
-	Geometry::Vertex::SetColor( 1,
-								&output,
+	output_vertices[0].SetPos( bottomLeft.x, bottomLeft.y );
+	output_vertices[1].SetPos( topRight.x, topRight.y );
+	output_vertices[2].SetPos( topLeft.x, topLeft.y );
+	output_vertices[3].SetPos( bottomLeft.x, bottomLeft.y );
+	output_vertices[4].SetPos( bottomRight.x, bottomRight.y );
+	output_vertices[5].SetPos( topRight.x, topRight.y );
+
+	// All six corners share the particle's color
+	Geometry::Vertex::SetColor( VERTICES_PER_QUADS,
+								output_vertices,
 								color.r,
 								color.g,
 								color.b,
 								color.a );
 }
 
-static void EmitRect( Geometry::Vertex *output_vertices, const Vertex2& topLeft, const Vertex2& topRight, const Vertex2& bottomLeft, const Vertex2& bottomRight, const Vector4& color )
-{
-	SetVertex( output_vertices[0], bottomLeft, color );
-	SetVertex( output_vertices[1], topRight, color );
-	SetVertex( output_vertices[2], topLeft, color );
-	SetVertex( output_vertices[3], bottomLeft, color );
-	SetVertex( output_vertices[4], bottomRight, color );
-	SetVertex( output_vertices[5], topRight, color );
-}
-
 static void Legacy( Geometry::Vertex *output_vertices, const Vertex2& base_position, float rotation, float halfSize, const Vector4& color )
 {
 	Vertex2 topLeft, topRight, bottomLeft, bottomRight;
@@ -522,68 +676,106 @@ static void Rescale( Geometry::Vertex *output_vertices, EmitterObject::Mapping m
 	EmitRect( output_vertices, topLeft, topRight, bottomLeft, bottomRight, color );
 }
 
-// Rect: output_vertices, top_left, top_right, bottom_left, bottom_right, color
-// Legacy: base_position, rotation, halfSize, output_vertices, color
-
-void EmitterObjectParticle::UpdateVertices( EmitterObject *eo,
-											EmitterObjectParticle &particle,
-											Geometry::Vertex *output_vertices )
+void EmitterObjectParticles::Transform( const EmitterObject *eo, int begin, int end )
 {
+	const EmitterObjectParticles &p = *this;
 
-    // As we are rendering the particles as quads, we need to define 6 vertices for each particle
-	// We assume that all particles have a square aspect ratio.
-    float halfSize = ( fParticleSize * 0.5f );
+	// Without a parent, every particle shares the emitter's own transform
+	const Matrix *shared = ( NULL == eo->fAbsolutePositionParent ? & eo->GetSrcToDstMatrix() : NULL );
 
-	//// Base position.
-	//
-	Vertex2 base_position = {fPosition.x, fPosition.y};
-	Vertex2 right = {base_position.x + 1, base_position.y};
-	Vertex2 below = {base_position.x, base_position.y + 1};
-
-	eo->TransformParticlePosition(fSpawnTimeTransform, base_position);
-
-	//// Color.
-	//
-	Vector4 color;
-
-	float cumulative_alpha = ( (float)eo->AlphaCumulative() * ( 1.0f / 255.0f ) );
-
-	if( eo->fTextureResource->GetBitmap()->IsPremultiplied() )
+	if( shared && shared->IsIdentity() )
 	{
-		color.r = ( fColor.r * cumulative_alpha );
-		color.g = ( fColor.g * cumulative_alpha );
-		color.b = ( fColor.b * cumulative_alpha );
-		color.a = ( fColor.a * cumulative_alpha );
+		memcpy( p[kBaseX] + begin, p[kPositionX] + begin, sizeof( float ) * ( end - begin ) );
+		memcpy( p[kBaseY] + begin, p[kPositionY] + begin, sizeof( float ) * ( end - begin ) );
+	}
+	else if( shared )
+	{
+		const Real *row0 = shared->Row0();
+		const Real *row1 = shared->Row1();
+		const Float4 a = Splat4( row0[0] ), b = Splat4( row0[1] ), tx = Splat4( row0[2] );
+		const Float4 c = Splat4( row1[0] ), d = Splat4( row1[1] ), ty = Splat4( row1[2] );
+
+		for( int i = begin;
+				i < end;
+				i += kParticleLanes )
+		{
+			Float4 x = Load4( p[kPositionX] + i );
+			Float4 y = Load4( p[kPositionY] + i );
+
+			Store4( p[kBaseX] + i, Add4( Add4( Mul4( a, x ), Mul4( b, y ) ), tx ) );
+			Store4( p[kBaseY] + i, Add4( Add4( Mul4( c, x ), Mul4( d, y ) ), ty ) );
+		}
 	}
 	else
 	{
-		color.r = fColor.r;
-		color.g = fColor.g;
-		color.b = fColor.b;
-		color.a = ( fColor.a * cumulative_alpha );
+		for( int i = begin;
+				i < end;
+				++i )
+		{
+			Vertex2 v = { p[kPositionX][i], p[kPositionY][i] };
+			eo->TransformParticlePosition( fSpawnTimeTransforms[i], v );
+
+			p[kBaseX][i] = v.x;
+			p[kBaseY][i] = v.y;
+		}
 	}
+}
+
+void EmitterObjectParticles::Emit( const EmitterObject *eo,
+									int begin,
+									int end,
+									Geometry::Vertex *output_vertices ) const
+{
+	const EmitterObjectParticles &p = *this;
+
+	//// Color.
+	//
+	float cumulative_alpha = ( (float)eo->AlphaCumulative() * ( 1.0f / 255.0f ) );
+	float color_scale = ( eo->fTextureResource->GetBitmap()->IsPremultiplied() ? cumulative_alpha : 1.0f );
 	//
 	////
 
 	EmitterObject::Mapping mapping = eo->GetMapping();
 
-	if ( EmitterObject::kMapping_Legacy != mapping )
+	for( int i = begin;
+			i < end;
+			++i )
 	{
-		if ( EmitterObject::kMapping_RescaleY != mapping )
+		Geometry::Vertex *quad_vertices = &( output_vertices[ i * VERTICES_PER_QUADS ] );
+
+		// As we are rendering the particles as quads, we need to define 6 vertices for each particle
+		// We assume that all particles have a square aspect ratio.
+		float halfSize = ( p[kParticleSize][i] * 0.5f );
+
+		Vertex2 base_position = { p[kBaseX][i], p[kBaseY][i] };
+
+		Vector4 color;
+		color.r = ( p[kColorR][i] * color_scale );
+		color.g = ( p[kColorG][i] * color_scale );
+		color.b = ( p[kColorB][i] * color_scale );
+		color.a = ( p[kColorA][i] * cumulative_alpha );
+
+		if ( EmitterObject::kMapping_Legacy != mapping )
 		{
-			eo->TransformParticlePosition(fSpawnTimeTransform, right);
-		}
+			Vertex2 right = { p[kPositionX][i] + 1, p[kPositionY][i] };
+			Vertex2 below = { p[kPositionX][i], p[kPositionY][i] + 1 };
+
+			if ( EmitterObject::kMapping_RescaleY != mapping )
+			{
+				eo->TransformParticlePosition( fSpawnTimeTransforms[i], right );
+			}
+
+			if ( EmitterObject::kMapping_RescaleX != mapping )
+			{
+				eo->TransformParticlePosition( fSpawnTimeTransforms[i], below );
+			}
 
-		if ( EmitterObject::kMapping_RescaleX != mapping )
+			Rescale( quad_vertices, mapping, base_position, right, below, p[kRotation][i], halfSize, color );
+		}
+		else
 		{
-			eo->TransformParticlePosition(fSpawnTimeTransform, below);
+			Legacy( quad_vertices, base_position, p[kRotation][i], halfSize, color );
 		}
-
-		Rescale( output_vertices, mapping, base_position, right, below, fRotation, halfSize, color );
-	}
-	else
-	{
-		Legacy( output_vertices, base_position, fRotation, halfSize, color );
 	}
 }
 
@@ -766,8 +958,7 @@ bool EmitterObject::Initialize( lua_State *L, Display &display )
 	fEmissionRateInParticlesPerSeconds = ( (float)fMaxParticles / fParticleLifespanInSeconds );
 	fEmitCounter = 0.0f;
 
-	fParticles = (EmitterObjectParticle *)Rtt_MALLOC( display.GetAllocator(),
-													sizeof( EmitterObjectParticle ) * (int)fMaxParticles );
+	fParticles = EmitterObjectParticles::New( display.GetAllocator(), fMaxParticles );
 
 	// Get any mapping, else use the display default.
 	lua_getfield( L, index - 1, "emitterMapping" );
@@ -1032,7 +1223,7 @@ void EmitterObject::_AddParticle(const Matrix &spawnTimeTransform)
 	}
 
 	// Take the next particle out of the particle pool we have created and initialize it
-	fParticles[ fParticleCount ].Init( this, spawnTimeTransform );
+	fParticles->Init( this, fParticleCount, spawnTimeTransform );
 
 	// Increment the particle count
 	fParticleCount++;
@@ -1048,7 +1239,7 @@ void EmitterObject::_RemoveParticle( int particleIndex )
 	// life will only drop into this clause once
 	if( particleIndex != fParticleCount - 1 )
 	{
-		fParticles[particleIndex] = fParticles[fParticleCount - 1];
+		fParticles->Copy( particleIndex, fParticleCount - 1 );
 	}
 
 	fParticleCount--;
@@ -1095,6 +1286,14 @@ void EmitterObject::Prepare( const Display &display )
 				kProgramDataFlag );
 }
 
+struct EmitterObject::JobData
+{
+	EmitterObject *fEmitter;
+	Geometry::Vertex *fOutput;
+	float fTimeDelta;
+	int fCount;
+};
+
 void EmitterObject::_Update( const Display &display )
 {
 	//// Prevent doing more than one update per frame.
@@ -1189,33 +1388,80 @@ void EmitterObject::_Update( const Display &display )
 		}
 	}
 
-	// Reset the particle index before updating the particles in this emitter
-	int particleIndex = 0;
-
 	Geometry::Vertex *output_vertices = fData.fGeometry->GetVertexData();
 
-    // Loop through all the particles updating their location and color
-	while( particleIndex < fParticleCount )
-	{
-		// Get the particle for the current particle index
-		EmitterObjectParticle &particle = fParticles[particleIndex];
+	// Large emitters are stepped and emitted in blocks on the worker pool.
+	// Both passes only touch their own block of particles and vertices.
+	bool isConcurrent = display.IsConcurrentTraversal()
+		&& fParticleCount >= kMinConcurrentParticles
+		&& WorkerPool::Shared().GetConcurrency() > 1;
 
-		particle.Update( this, time_delta );
+	// Step every particle (padding included, so kernels never need a tail)
+	// then drop the ones whose life ran out
+	{
+		int count = RoundUpToLanes( fParticleCount );
 
-		if( particle.fTimeToLiveInSeconds > 0.0f )
+		if( isConcurrent )
 		{
-			particle.UpdateVertices( this,
-										particle,
-										&( output_vertices[ particleIndex * VERTICES_PER_QUADS ] ) );
-
-			// Update the particle and vertex counters
-			particleIndex++;
+			JobData data = { this, output_vertices, time_delta, count };
+			WorkerPool::Shared().ParallelFor( ( count + kParticlesPerJob - 1 ) / kParticlesPerJob, & StepJob, & data );
 		}
 		else
 		{
-			_RemoveParticle( particleIndex );
+			fParticles->Step( this, time_delta, 0, count );
+		}
+
+		const float *timeToLiveInSeconds = ( *fParticles )[EmitterObjectParticles::kTimeToLiveInSeconds];
+
+		// Removing moves the last particle into particleIndex, so look at it again
+		int particleIndex = 0;
+		while( particleIndex < fParticleCount )
+		{
+			if( timeToLiveInSeconds[particleIndex] > 0.0f )
+			{
+				particleIndex++;
+			}
+			else
+			{
+				_RemoveParticle( particleIndex );
+			}
 		}
 	}
+
+	// Write the quads of the surviving particles
+	if( isConcurrent )
+	{
+		JobData data = { this, output_vertices, time_delta, fParticleCount };
+		WorkerPool::Shared().ParallelFor( ( fParticleCount + kParticlesPerJob - 1 ) / kParticlesPerJob, & EmitJob, & data );
+	}
+	else
+	{
+		fParticles->Transform( this, 0, RoundUpToLanes( fParticleCount ) );
+		fParticles->Emit( this, 0, fParticleCount, output_vertices );
+	}
+}
+
+void EmitterObject::StepJob( void *userData, U32 index )
+{
+	const JobData *data = (const JobData *)userData;
+
+	int begin = (int)index * kParticlesPerJob;
+	int end = std::min( begin + kParticlesPerJob, data->fCount );
+
+	data->fEmitter->fParticles->Step( data->fEmitter, data->fTimeDelta, begin, end );
+}
+
+void EmitterObject::EmitJob( void *userData, U32 index )
+{
+	const JobData *data = (const JobData *)userData;
+	EmitterObjectParticles *particles = data->fEmitter->fParticles;
+
+	int begin = (int)index * kParticlesPerJob;
+	int end = std::min( begin + kParticlesPerJob, data->fCount );
+	int paddedEnd = std::min( begin + kParticlesPerJob, RoundUpToLanes( data->fCount ) );
+
+	particles->Transform( data->fEmitter, begin, paddedEnd );
+	particles->Emit( data->fEmitter, begin, end, data->fOutput );
 }
 
 void EmitterObject::SetEmissionRateInParticlesPerSeconds( float v )
@@ -1235,11 +1481,12 @@ void EmitterObject::Start()
 		// kState_Stopped -> kState_Playing.
 
 		// Reset all the particles.
+		float *timeToLiveInSeconds = ( *fParticles )[EmitterObjectParticles::kTimeToLiveInSeconds];
 		for( int i = 0;
 				i < fParticleCount;
 				++i )
 		{
-			fParticles[i].Reset();
+			timeToLiveInSeconds[i] = 0.0f;
 		}
 
 		fElapsedTime = 0.0f;
@@ -29,7 +29,7 @@ namespace Rtt
 {
 class LuaUserdataProxy;
 class TextureResource;
-struct EmitterObjectParticle;
+struct EmitterObjectParticles;
 
 #define EMITTER_ABSOLUTE_PARENT ((GroupObject*)-1)
 // ----------------------------------------------------------------------------
@@ -274,6 +274,10 @@ private:
 	void _Update( const Display &display );
 	void _Cleanup();
 
+	struct JobData;
+	static void StepJob( void *userData, U32 index );
+	static void EmitJob( void *userData, U32 index );
+
 	// MUpdatable
 	bool fShouldUpdate;
 
@@ -337,9 +341,9 @@ private:
 
 	std::string fTextureFileName;
 
-	friend struct EmitterObjectParticle;
+	friend struct EmitterObjectParticles;
 	//! We're also using this to determine if Initialize() has been called.
-	EmitterObjectParticle *fParticles;
+	EmitterObjectParticles *fParticles;
 
 	int fParticleCount;
 	
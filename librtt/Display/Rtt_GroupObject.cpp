@@ -13,8 +13,10 @@
 #include "Display/Rtt_BitmapMask.h"
 #include "Display/Rtt_BitmapPaint.h"
 #include "Display/Rtt_Display.h"
+#include "Display/Rtt_HitTestGrid.h"
 #include "Display/Rtt_Scene.h"
 #include "Display/Rtt_StageObject.h"
+#include "Core/Rtt_WorkerPool.h"
 #include "Renderer/Rtt_Renderer.h"
 #include "Rtt_LuaProxyVTable.h"
 
@@ -82,14 +84,46 @@ GroupObject::ReleaseChildrenLuaReferences( lua_State *L )
 
 // ----------------------------------------------------------------------------
 
+// Below this many children, waking the worker pool costs more than it saves
+static const S32 kMinConcurrentChildren = 128;
+
+// Below this many children, a linear hit-test walk is cheap enough
+static const S32 kMinHitTestGridChildren = 64;
+
+namespace /*anonymous*/
+{
+    struct UpdateTransformJobData
+    {
+        DisplayObject **children;
+        const Matrix *xform;
+        const Rect *screenBounds;
+    };
+
+    struct PrepareJobData
+    {
+        DisplayObject **children;
+        const Display *display;
+    };
+}
+
+// ----------------------------------------------------------------------------
+
 GroupObject::GroupObject( Rtt_Allocator* pAllocator, StageObject* canvas )
 :    Super(),
     fStage( canvas ),
+    fHitTestGrid( NULL ),
     fChildren( pAllocator )
 {
     SetObjectDesc("GroupObject"); // for introspection
 }
 
+GroupObject::~GroupObject()
+{
+    // Children are released after this body runs and may still notify us
+    Rtt_DELETE( fHitTestGrid );
+    fHitTestGrid = NULL;
+}
+
 GroupObject*
 GroupObject::AsGroupObject()
 {
@@ -135,39 +169,130 @@ GroupObject::UpdateTransform( const Matrix& parentToDstSpace )
 
 		SUMMED_TIMING( ed, "Group: Visit Children" );
 
-        for ( S32 i = 0, iMax = fChildren.Length(); i < iMax; i++ )
+        if ( stage && ShouldTraverseConcurrently( stage->GetDisplay() ) )
+        {
+            UpdateChildrenConcurrently( xform, screenBounds, alphaCumulativeFromAncestors, shouldUpdate );
+        }
+        else
         {
-            DisplayObject *child = fChildren[i];
+            for ( S32 i = 0, iMax = fChildren.Length(); i < iMax; i++ )
+            {
+                DisplayObject *child = fChildren[i];
 
-            child->UpdateAlphaCumulative( alphaCumulativeFromAncestors );
+                child->UpdateAlphaCumulative( alphaCumulativeFromAncestors );
 
-            if ( shouldUpdate )
-            {
-                // If receiver's matrix is out of date, then so are the children's
-                child->Invalidate( kGeometryFlag | kTransformFlag );
+                if ( shouldUpdate )
+                {
+                    // If receiver's matrix is out of date, then so are the children's
+                    child->Invalidate( kGeometryFlag | kTransformFlag );
+                }
+
+                UpdateChildTransform( * child, xform, screenBounds );
             }
+        }
+	}
+
+    return shouldUpdate;
+}
 
-            child->UpdateTransform( xform );
+void
+GroupObject::UpdateChildTransform( DisplayObject& child, const Matrix& xform, const Rect& screenBounds )
+{
+    child.UpdateTransform( xform );
 
-            // Only cull objects that are hit-testable and allow culling
-            if ( child->ShouldHitTest() && (!child->SkipsCull() && child->CanCull()) )
-            {
-                // Only leaf nodes are culled, so we only need to build stage bounds
-                // of leaf nodes to determine if they should be culled.
+    // Only cull objects that are hit-testable and allow culling
+    if ( child.ShouldHitTest() && (!child.SkipsCull() && child.CanCull()) )
+    {
+        // Only leaf nodes are culled, so we only need to build stage bounds
+        // of leaf nodes to determine if they should be culled.
 // TODO: BuildStageBounds is expensive --- accumulate iteratively if numChildren is large
-				{
-					SUMMED_TIMING( bsb, "Group: Build Child Stage Bounds" );
-				child->BuildStageBounds();
-				}
-				{
-					SUMMED_TIMING( co, "Group: Cull Offscreen" );
-				child->CullOffscreen( screenBounds );
-            }
+		{
+			SUMMED_TIMING( bsb, "Group: Build Child Stage Bounds" );
+		child.BuildStageBounds();
+		}
+		{
+			SUMMED_TIMING( co, "Group: Cull Offscreen" );
+		child.CullOffscreen( screenBounds );
+		}
+    }
+}
+
+void
+GroupObject::UpdateTransformJob( void *userData, U32 index )
+{
+    const UpdateTransformJobData *data = (const UpdateTransformJobData *)userData;
+
+    UpdateChildTransform( * data->children[index], * data->xform, * data->screenBounds );
+}
+
+void
+GroupObject::PrepareJob( void *userData, U32 index )
+{
+    const PrepareJobData *data = (const PrepareJobData *)userData;
+
+    data->children[index]->Prepare( * data->display );
+}
+
+bool
+GroupObject::ShouldTraverseConcurrently( const Display& display ) const
+{
+    // Nested groups on a worker never get here: only leaves run on workers
+    return display.IsConcurrentTraversal()
+        && fChildren.Length() >= kMinConcurrentChildren
+        && WorkerPool::Shared().GetConcurrency() > 1;
+}
+
+// Same work as the serial loop in UpdateTransform(), split in two passes.
+// The first pass runs on the calling thread, in child order, and handles
+// everything that may touch Lua, ancestors or other shared state: alpha,
+// invalidation and every child that cannot update concurrently (including
+// groups, with their cull callbacks). The remaining children only write to
+// themselves, so the second pass spreads them over the WorkerPool.
+void
+GroupObject::UpdateChildrenConcurrently( const Matrix& xform, const Rect& screenBounds, U8 alphaCumulativeFromAncestors, bool shouldUpdate )
+{
+    Array< DisplayObject* > concurrent( Allocator() );
+    concurrent.Reserve( fChildren.Length() );
+
+    bool willInvalidate = false;
+
+    for ( S32 i = 0, iMax = fChildren.Length(); i < iMax; i++ )
+    {
+        DisplayObject *child = fChildren[i];
+
+        child->UpdateAlphaCumulative( alphaCumulativeFromAncestors );
+
+        if ( shouldUpdate )
+        {
+            // If receiver's matrix is out of date, then so are the children's
+            child->Invalidate( kGeometryFlag | kTransformFlag );
+        }
+
+        if ( child->CanUpdateConcurrently() )
+        {
+            willInvalidate = willInvalidate || ! child->IsValid( kTransformFlag );
+            concurrent.Append( child );
+        }
+        else
+        {
+            UpdateChildTransform( * child, xform, screenBounds );
         }
     }
-	}
 
-    return shouldUpdate;
+    if ( concurrent.Length() > 0 )
+    {
+        // A child whose transform changes invalidates the stage bounds of its
+        // ancestors and the display. Do it up front, so on the workers the
+        // ancestor walk stops at the receiver and the scene is already invalid.
+        if ( willInvalidate )
+        {
+            InvalidateStageBounds();
+            InvalidateDisplay();
+        }
+
+        UpdateTransformJobData data = { concurrent.WriteAccess(), & xform, & screenBounds };
+        WorkerPool::Shared().ParallelFor( concurrent.Length(), & UpdateTransformJob, & data );
+    }
 }
 
 void
@@ -185,29 +310,91 @@ GroupObject::Prepare( const Display& display )
         // Propagate certain flags to children
         DirtyFlags flags = kGroupPropagationMask & GetDirtyFlags();
 
-        for ( S32 i = 0, iMax = fChildren.Length(); i < iMax; i++ )
+        if ( ShouldTraverseConcurrently( display ) )
+        {
+            PrepareChildrenConcurrently( display, flags );
+        }
+        else
         {
-            DisplayObject* child = fChildren[i];
+            for ( S32 i = 0, iMax = fChildren.Length(); i < iMax; i++ )
+            {
+                DisplayObject* child = fChildren[i];
 
-            // At least one of the following must be true:
-            // 1. child is not a group
-            // 2. (or if it's a group then), child is onscreen
-            // 3. (or if it's offscreen then), child is cullable, e.g. containers
-            Rtt_ASSERT( NULL == child->AsGroupObject() || ! child->IsOffScreen() || (!child->SkipsCull() && child->CanCull()) );
+                // At least one of the following must be true:
+                // 1. child is not a group
+                // 2. (or if it's a group then), child is onscreen
+                // 3. (or if it's offscreen then), child is cullable, e.g. containers
+                Rtt_ASSERT( NULL == child->AsGroupObject() || ! child->IsOffScreen() || (!child->SkipsCull() && child->CanCull()) );
 
-            if ( ! child->IsOffScreen() )
-            {
-                // If the parent's build was invalidated, then we need to rebuild the children
-                if ( flags > 0 )
+                if ( ! child->IsOffScreen() )
                 {
-                    child->Invalidate( flags );
+                    // If the parent's build was invalidated, then we need to rebuild the children
+                    if ( flags > 0 )
+                    {
+                        child->Invalidate( flags );
+                    }
+
+                    child->Prepare( display );
                 }
+            }
+        }
+
+        SetValid();
+    }
+}
+
+// See UpdateChildrenConcurrently()
+void
+GroupObject::PrepareChildrenConcurrently( const Display& display, DirtyFlags flags )
+{
+    Array< DisplayObject* > concurrent( Allocator() );
+    concurrent.Reserve( fChildren.Length() );
+
+    bool willPrepare = false;
+    bool willRebuild = false;
+
+    for ( S32 i = 0, iMax = fChildren.Length(); i < iMax; i++ )
+    {
+        DisplayObject* child = fChildren[i];
+
+        Rtt_ASSERT( NULL == child->AsGroupObject() || ! child->IsOffScreen() || (!child->SkipsCull() && child->CanCull()) );
 
+        if ( ! child->IsOffScreen() )
+        {
+            // If the parent's build was invalidated, then we need to rebuild the children
+            if ( flags > 0 )
+            {
+                child->Invalidate( flags );
+            }
+
+            if ( child->CanUpdateConcurrently() )
+            {
+                willPrepare = willPrepare || child->IsDirty();
+                willRebuild = willRebuild || ! child->IsValid( kGeometryFlag );
+                concurrent.Append( child );
+            }
+            else
+            {
                 child->Prepare( display );
             }
         }
+    }
+
+    if ( concurrent.Length() > 0 )
+    {
+        // Rebuilding a path can invalidate its object again
+        if ( willRebuild )
+        {
+            InvalidateStageBounds();
+        }
 
-        SetValid();
+        if ( willPrepare )
+        {
+            InvalidateDisplay();
+        }
+
+        PrepareJobData data = { concurrent.WriteAccess(), & display };
+        WorkerPool::Shared().ParallelFor( concurrent.Length(), & PrepareJob, & data );
     }
 }
 
@@ -366,6 +553,7 @@ GroupObject::Insert( S32 index, DisplayObject* newChild, bool resetTransform )
 
             newChild->SetParent( this );
             fChildren.Insert( index, newChild );
+            InvalidateHitTestGrid();
 
             // ++TransactionId();
             DidInsert( true );
@@ -390,6 +578,7 @@ GroupObject::Insert( S32 index, DisplayObject* newChild, bool resetTransform )
 
                 //++TransactionId();
                 fChildren.Insert( index, o );
+                InvalidateHitTestGrid();
                 DidInsert( false );
             }
         }
@@ -400,6 +589,7 @@ void
 GroupObject::Remove( S32 index )
 {
     fChildren.Remove( index, 1 );
+    InvalidateHitTestGrid();
 
     //++TransactionId();
     DidRemove();
@@ -414,6 +604,7 @@ GroupObject::Release( S32 index )
     {
         child = fChildren.Release( index );
         child->SetParent( NULL );
+        InvalidateHitTestGrid();
 
         //++TransactionId();
         DidRemove();
@@ -422,6 +613,32 @@ GroupObject::Release( S32 index )
     return child;
 }
 
+HitTestGrid*
+GroupObject::GetHitTestGrid()
+{
+    if ( ! fHitTestGrid && fChildren.Length() >= kMinHitTestGridChildren )
+    {
+        fHitTestGrid = Rtt_NEW( Allocator(), HitTestGrid );
+    }
+
+    return fHitTestGrid;
+}
+
+void
+GroupObject::InvalidateHitTestGrid()
+{
+    if ( fHitTestGrid )
+    {
+        fHitTestGrid->Invalidate();
+    }
+}
+
+void
+GroupObject::InvalidateHitTestGrid( DisplayObject& child )
+{
+    fHitTestGrid->InvalidateChild( child );
+}
+
 S32
 GroupObject::Find( const DisplayObject& child ) const
 {
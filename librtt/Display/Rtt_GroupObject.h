@@ -18,6 +18,7 @@
 namespace Rtt
 {
 
+class HitTestGrid;
 class Scene;
 
 // ----------------------------------------------------------------------------
@@ -36,6 +37,7 @@ class GroupObject : public DisplayObject
 
 	public:
 		GroupObject( Rtt_Allocator* pAllocator, StageObject* canvas );
+		virtual ~GroupObject();
 
 	public:
 		// Super
@@ -53,6 +55,15 @@ class GroupObject : public DisplayObject
 		virtual bool HitTest( Real contentX, Real contentY );
 		virtual bool CanCull() const;
 
+	private:
+		static void UpdateChildTransform( DisplayObject& child, const Matrix& xform, const Rect& screenBounds );
+		static void UpdateTransformJob( void *userData, U32 index );
+		static void PrepareJob( void *userData, U32 index );
+
+		bool ShouldTraverseConcurrently( const Display& display ) const;
+		void UpdateChildrenConcurrently( const Matrix& xform, const Rect& screenBounds, U8 alphaCumulativeFromAncestors, bool shouldUpdate );
+		void PrepareChildrenConcurrently( const Display& display, DirtyFlags flags );
+
 	public:
 		virtual const LuaProxyVTable& ProxyVTable() const;
 
@@ -84,8 +95,24 @@ class GroupObject : public DisplayObject
 	public:
 		Rtt_Allocator* Allocator() const { return fChildren.Allocator(); }
 
+	public:
+		// Spatial index over the children, created on demand once the group
+		// is large enough for a linear hit-test walk to matter. May be NULL.
+		HitTestGrid* GetHitTestGrid();
+
+		// Called when child's stage bounds are invalidated
+		void DidInvalidateChildStageBounds( DisplayObject& child )
+		{
+			if ( fHitTestGrid ) { InvalidateHitTestGrid( child ); }
+		}
+
+	private:
+		void InvalidateHitTestGrid();
+		void InvalidateHitTestGrid( DisplayObject& child );
+
 	private:
 		StageObject* fStage;
+		HitTestGrid* fHitTestGrid;
 
 	protected:
 		// Children are drawn in order, i.e. first child is drawn below the second
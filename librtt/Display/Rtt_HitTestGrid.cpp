@@ -0,0 +1,335 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Display/Rtt_HitTestGrid.h"
+
+#include "Display/Rtt_DisplayObject.h"
+#include "Display/Rtt_GroupObject.h"
+
+#include <algorithm>
+#include <math.h>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+static void
+InsertSorted( std::vector< S32 >& list, S32 index )
+{
+	list.insert( std::lower_bound( list.begin(), list.end(), index ), index );
+}
+
+static void
+EraseSorted( std::vector< S32 >& list, S32 index )
+{
+	std::vector< S32 >::iterator it = std::lower_bound( list.begin(), list.end(), index );
+	if ( Rtt_VERIFY( it != list.end() && index == *it ) )
+	{
+		list.erase( it );
+	}
+}
+
+static S32
+ClampCell( Real offset, Real cellSize, S32 numCells )
+{
+	S32 result = (S32)floor( offset / cellSize );
+	return Max( (S32)0, Min( result, numCells - 1 ) );
+}
+
+// Only leaves whose stage bounds are up to date can be binned; everything else
+// must be visited by every query
+static bool
+CanBin( const DisplayObject& child )
+{
+	return ! child.AsGroupObject()
+		&& child.ShouldHitTest()
+		&& child.IsStageBoundsValid();
+}
+
+// ----------------------------------------------------------------------------
+
+HitTestGrid::HitTestGrid()
+:	fEntries(),
+	fCells(),
+	fLoose(),
+	fLookup(),
+	fExtent(),
+	fColumns( 0 ),
+	fRows( 0 ),
+	fCellWidth( Rtt_REAL_1 ),
+	fCellHeight( Rtt_REAL_1 ),
+	fNumLooseSinceRebuild( 0 ),
+	fNumInvalidChildren( 0 ),
+	fIsValid( false )
+{
+}
+
+void
+HitTestGrid::InvalidateChild( DisplayObject& child )
+{
+	// Past kMaxInvalidChildren the next Query() rebuilds instead
+	U32 slot = fNumInvalidChildren.fetch_add( 1, std::memory_order_relaxed );
+	if ( slot < kMaxInvalidChildren )
+	{
+		fInvalidChildren[slot] = & child;
+	}
+}
+
+void
+HitTestGrid::Query( GroupObject& group, Real x, Real y, Array< S32 >& result )
+{
+	if ( ! fIsValid || (S32)fEntries.size() != group.NumChildren() )
+	{
+		Rebuild( group );
+	}
+	else
+	{
+		Sync( group );
+	}
+
+	static const std::vector< S32 > kEmpty;
+	const std::vector< S32 >* cell = & kEmpty;
+
+	if ( fColumns > 0 && fExtent.HitTest( x, y ) )
+	{
+		S32 col = ClampCell( x - fExtent.xMin, fCellWidth, fColumns );
+		S32 row = ClampCell( y - fExtent.yMin, fCellHeight, fRows );
+		cell = & fCells[row * fColumns + col];
+	}
+
+	// Merge both ascending lists, so callers visit children in z-order
+	size_t i = 0, iMax = cell->size();
+	size_t j = 0, jMax = fLoose.size();
+	while ( i < iMax || j < jMax )
+	{
+		if ( j >= jMax || ( i < iMax && (*cell)[i] < fLoose[j] ) )
+		{
+			result.Append( (*cell)[i++] );
+		}
+		else
+		{
+			result.Append( fLoose[j++] );
+		}
+	}
+}
+
+void
+HitTestGrid::Rebuild( GroupObject& group )
+{
+	const S32 numChildren = group.NumChildren();
+
+	Entry empty = { -1, -1, -1, -1, false };
+	fEntries.assign( numChildren, empty );
+	fLoose.clear();
+	fLookup.clear();
+	fLookup.reserve( numChildren );
+
+	fExtent.SetEmpty();
+	S32 numBinnable = 0;
+	for ( S32 i = 0; i < numChildren; i++ )
+	{
+		DisplayObject& child = group.ChildAt( i );
+		fLookup.push_back( std::make_pair( (const DisplayObject*)& child, i ) );
+
+		if ( CanBin( child ) )
+		{
+			const Rect& bounds = child.StageBounds();
+			if ( bounds.NotEmpty() )
+			{
+				fExtent.Union( bounds );
+				++numBinnable;
+			}
+		}
+	}
+	std::sort( fLookup.begin(), fLookup.end() );
+
+	fColumns = 0;
+	fRows = 0;
+	if ( numBinnable > 0 )
+	{
+		// Aim for a couple of objects per cell, with cells roughly square
+		Real w = Max( fExtent.Width(), Rtt_REAL_1 );
+		Real h = Max( fExtent.Height(), Rtt_REAL_1 );
+		Real numCells = (Real)Max( numBinnable / 2, (S32)1 );
+		S32 columns = (S32)sqrt( numCells * w / h );
+		S32 rows = (S32)( numCells / Max( columns, (S32)1 ) );
+
+		fColumns = Max( (S32)1, Min( columns, (S32)kMaxCellsPerAxis ) );
+		fRows = Max( (S32)1, Min( rows, (S32)kMaxCellsPerAxis ) );
+		fCellWidth = w / fColumns;
+		fCellHeight = h / fRows;
+	}
+
+	// Keep the capacity of cells from previous builds
+	fCells.resize( fColumns * fRows );
+	for ( size_t i = 0, iMax = fCells.size(); i < iMax; i++ )
+	{
+		fCells[i].clear();
+	}
+
+	for ( S32 i = 0; i < numChildren; i++ )
+	{
+		Bin( group.ChildAt( i ), i, true );
+	}
+
+	fNumLooseSinceRebuild = 0;
+	fNumInvalidChildren.store( 0 );
+	fIsValid = true;
+}
+
+void
+HitTestGrid::Sync( GroupObject& group )
+{
+	U32 numInvalid = fNumInvalidChildren.load();
+	if ( 0 == numInvalid )
+	{
+		return;
+	}
+
+	if ( numInvalid > kMaxInvalidChildren )
+	{
+		Rebuild( group );
+		return;
+	}
+
+	for ( U32 i = 0; i < numInvalid; i++ )
+	{
+		S32 index = Find( * fInvalidChildren[i] );
+		if ( index >= 0 )
+		{
+			Unbin( index );
+			Bin( group.ChildAt( index ), index, false );
+		}
+	}
+	fNumInvalidChildren.store( 0 );
+
+	// Objects that moved outside the extent stay loose; rebuild once enough
+	// have piled up that queries would degrade to a linear walk
+	if ( fNumLooseSinceRebuild > Max( (S32)16, (S32)fEntries.size() / 8 ) )
+	{
+		Rebuild( group );
+	}
+}
+
+bool
+HitTestGrid::GetCellRange( const Rect& bounds, Entry& entry ) const
+{
+	bool result = fColumns > 0
+		&& bounds.xMin >= fExtent.xMin && bounds.xMax <= fExtent.xMax
+		&& bounds.yMin >= fExtent.yMin && bounds.yMax <= fExtent.yMax;
+
+	if ( result )
+	{
+		entry.fCol0 = ClampCell( bounds.xMin - fExtent.xMin, fCellWidth, fColumns );
+		entry.fCol1 = ClampCell( bounds.xMax - fExtent.xMin, fCellWidth, fColumns );
+		entry.fRow0 = ClampCell( bounds.yMin - fExtent.yMin, fCellHeight, fRows );
+		entry.fRow1 = ClampCell( bounds.yMax - fExtent.yMin, fCellHeight, fRows );
+
+		S32 numCells = ( entry.fCol1 - entry.fCol0 + 1 ) * ( entry.fRow1 - entry.fRow0 + 1 );
+		result = numCells <= kMaxCellsPerEntry;
+	}
+
+	return result;
+}
+
+void
+HitTestGrid::Bin( DisplayObject& child, S32 index, bool isRebuild )
+{
+	Entry& entry = fEntries[index];
+	entry.fCol0 = -1;
+	entry.fIsLoose = false;
+
+	if ( CanBin( child ) )
+	{
+		const Rect& bounds = child.StageBounds();
+
+		// Empty bounds never hit, and become non-empty only by being invalidated
+		if ( bounds.IsEmpty() )
+		{
+			return;
+		}
+
+		if ( GetCellRange( bounds, entry ) )
+		{
+			for ( S32 row = entry.fRow0; row <= entry.fRow1; row++ )
+			{
+				for ( S32 col = entry.fCol0; col <= entry.fCol1; col++ )
+				{
+					std::vector< S32 >& cell = fCells[row * fColumns + col];
+					if ( isRebuild )
+					{
+						cell.push_back( index ); // visited in ascending order
+					}
+					else
+					{
+						InsertSorted( cell, index );
+					}
+				}
+			}
+			return;
+		}
+
+		entry.fCol0 = -1;
+	}
+
+	entry.fIsLoose = true;
+	if ( isRebuild )
+	{
+		fLoose.push_back( index );
+	}
+	else
+	{
+		InsertSorted( fLoose, index );
+		++fNumLooseSinceRebuild;
+	}
+}
+
+void
+HitTestGrid::Unbin( S32 index )
+{
+	Entry& entry = fEntries[index];
+
+	if ( entry.fIsLoose )
+	{
+		EraseSorted( fLoose, index );
+	}
+	else if ( entry.fCol0 >= 0 )
+	{
+		for ( S32 row = entry.fRow0; row <= entry.fRow1; row++ )
+		{
+			for ( S32 col = entry.fCol0; col <= entry.fCol1; col++ )
+			{
+				EraseSorted( fCells[row * fColumns + col], index );
+			}
+		}
+	}
+
+	entry.fCol0 = -1;
+	entry.fIsLoose = false;
+}
+
+S32
+HitTestGrid::Find( const DisplayObject& child ) const
+{
+	std::vector< std::pair< const DisplayObject*, S32 > >::const_iterator it =
+		std::lower_bound( fLookup.begin(), fLookup.end(), std::make_pair( & child, (S32)-1 ) );
+
+	return ( it != fLookup.end() && it->first == & child ? it->second : -1 );
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_HitTestGrid_H__
+#define _Rtt_HitTestGrid_H__
+
+#include "Core/Rtt_Array.h"
+#include "Core/Rtt_Geometry.h"
+
+#include <atomic>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+class DisplayObject;
+class GroupObject;
+
+// ----------------------------------------------------------------------------
+
+// Uniform grid over the stage bounds of a group's children, so HitEvent::Test()
+// only visits children that may contain the touch point.
+//
+// Entries are kept in sync lazily: a child whose stage bounds get invalidated
+// is queued via InvalidateChild() and re-binned at the next Query(). Inserting,
+// removing or reordering children calls Invalidate(), which forces a rebuild.
+// Children without usable bounds (groups, hidden or not yet laid out objects,
+// very large objects) are "loose" and returned by every query.
+class HitTestGrid
+{
+	Rtt_CLASS_NO_COPIES( HitTestGrid )
+
+	public:
+		typedef HitTestGrid Self;
+
+	public:
+		HitTestGrid();
+
+	public:
+		void Invalidate() { fIsValid = false; }
+
+		// Safe to call from worker threads, see GroupObject::UpdateTransform()
+		void InvalidateChild( DisplayObject& child );
+
+		// Appends to result, in ascending order, the indices of the children of
+		// group whose stage bounds may contain (x, y)
+		void Query( GroupObject& group, Real x, Real y, Array< S32 >& result );
+
+	private:
+		struct Entry
+		{
+			S32 fCol0, fRow0, fCol1, fRow1; // fCol0 < 0 when not in any cell
+			bool fIsLoose;
+		};
+
+		void Rebuild( GroupObject& group );
+		void Sync( GroupObject& group );
+
+		bool GetCellRange( const Rect& bounds, Entry& entry ) const;
+		void Bin( DisplayObject& child, S32 index, bool isRebuild );
+		void Unbin( S32 index );
+
+		S32 Find( const DisplayObject& child ) const;
+
+	private:
+		enum
+		{
+			kMaxInvalidChildren = 64,
+			kMaxCellsPerEntry = 16,
+			kMaxCellsPerAxis = 64,
+		};
+
+		std::vector< Entry > fEntries; // one per child, in child order
+		std::vector< std::vector< S32 > > fCells; // ascending child indices
+		std::vector< S32 > fLoose; // ascending child indices
+		std::vector< std::pair< const DisplayObject*, S32 > > fLookup; // sorted by object
+
+		Rect fExtent;
+		S32 fColumns;
+		S32 fRows;
+		Real fCellWidth;
+		Real fCellHeight;
+		S32 fNumLooseSinceRebuild;
+
+		DisplayObject* fInvalidChildren[kMaxInvalidChildren];
+		std::atomic< U32 > fNumInvalidChildren;
+
+		bool fIsValid;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_HitTestGrid_H__
@@ -29,6 +29,7 @@ namespace Rtt
 
 class ImageSheetUserdata;
 class PlatformBitmap;
+class TextureAtlas;
 
 // ----------------------------------------------------------------------------
 
@@ -56,7 +57,9 @@ class ImageSheet
 
 	private:
 		// Prevent subclass and
-		// Only CreateAndPush can create
+		// Only CreateAndPush and TextureAtlas can create
+		friend class TextureAtlas;
+
 		ImageSheet(
 			Rtt_Allocator *allocator,
 			const SharedPtr< TextureResource >& texture );
@@ -67,6 +70,9 @@ class ImageSheet
 	protected:
 		int Initialize( lua_State *L, int optionsIndex );
 
+		// Atlas pages gain a frame per image packed into them
+		void AppendFrame( ImageFrame *frame ) { fFrames.Append( frame ); }
+
 	public:
 		const SharedPtr< TextureResource >& GetTextureResource() const { return fResource; }
 		const ImageFrame* GetFrame( int index ) const { return fFrames[index]; }
@@ -73,6 +73,7 @@
 
 #include "Core/Rtt_StringHash.h"
 #include "Core/Rtt_String.h"
+#include "Core/Rtt_TraceRecorder.h"
 
 #include <string.h>
 
@@ -173,6 +174,11 @@ class DisplayLibrary
 		static int getStatistics( lua_State *L );
 		static int getSums( lua_State *L );
 		static int getTimings( lua_State *L );
+		static int enableTrace( lua_State *L );
+		static int writeTrace( lua_State *L );
+		static int startProfiler( lua_State *L );
+		static int stopProfiler( lua_State *L );
+		static int writeProfile( lua_State *L );
 
 		static int _initProfiling( lua_State *L );
 		static int _allocateProfile( lua_State *L );
@@ -253,6 +259,11 @@ DisplayLibrary::Open( lua_State *L )
 		{ "getStatistics", getStatistics },
 		{ "getSums", getSums },
 		{ "getTimings", getTimings },
+		{ "enableTrace", enableTrace },
+		{ "writeTrace", writeTrace },
+		{ "startProfiler", startProfiler },
+		{ "stopProfiler", stopProfiler },
+		{ "writeProfile", writeProfile },
 
 		{ "_initProfiling", _initProfiling },
 		{ "_allocateProfile", _allocateProfile },
@@ -675,6 +686,15 @@ DisplayLibrary::PushImage(
     Real width = Rtt_IntToReal( bitmap ? bitmap->UprightWidth() : texture->GetWidth() );
     Real height = Rtt_IntToReal( bitmap ? bitmap->UprightHeight() : texture->GetHeight() );
 
+    // Images packed into a texture atlas are one frame of the page
+    const ImageSheetPaint *sheetPaint = static_cast< const ImageSheetPaint * >( paint->AsPaint( Paint::kImageSheet ) );
+    if ( sheetPaint )
+    {
+        const ImageFrame *frame = sheetPaint->GetImageFrame();
+        width = Rtt_IntToReal( frame->GetWidth() );
+        height = Rtt_IntToReal( frame->GetHeight() );
+    }
+
     // Create the image object with the above dimensions.
     ShapeObject* v = PushImage( L, topLeft, paint, display, parent, width, height, replacement );
 
@@ -804,9 +824,33 @@ DisplayLibrary::newPolygon( lua_State *L )
     Real y = luaL_checkreal( L, nextArg++ );
 
     ShapePath *path = ShapePath::NewPolygon( display.GetAllocator() );
-    bool hasZ = lua_toboolean( L, nextArg + 1 );
+    bool hasZ = false;
+    int holesArg = 0;
+
+    // display.newPolygon( [parent,] x, y, vertices [, hasZ] [, holes] )
+    if ( lua_istable( L, nextArg + 1 ) )
+    {
+        holesArg = nextArg + 1;
+    }
+    else
+    {
+        hasZ = lua_toboolean( L, nextArg + 1 );
+
+        if ( lua_istable( L, nextArg + 2 ) )
+        {
+            if ( hasZ )
+            {
+                CoronaLuaWarning( L, "display.newPolygon() does not support holes in polygons with z-coordinates; holes will be ignored" );
+            }
+            else
+            {
+                holesArg = nextArg + 2;
+            }
+        }
+    }
+
     TesselatorPolygon *tesselator = (TesselatorPolygon *)path->GetTesselator();
-    if ( ShapeAdapterPolygon::InitializeContour( L, nextArg, * tesselator, hasZ ) )
+    if ( ShapeAdapterPolygon::InitializeContour( L, nextArg, * tesselator, hasZ, holesArg ) )
     {
         ShapeObject *v = polygonFactory( display.GetAllocator(), path );
 
@@ -1141,7 +1185,7 @@ DisplayLibrary::newImage( lua_State *L )
         }
 
         Runtime& runtime = library->GetDisplay().GetRuntime();
-        BitmapPaint *paint = BitmapPaint::NewBitmap( runtime, imageName, baseDir, flags );
+        BitmapPaint *paint = BitmapPaint::NewImage( runtime, imageName, baseDir, flags );
 
         if ( paint && paint->GetBitmap() && paint->GetBitmap()->NumBytes() == 0 )
         {
@@ -1255,7 +1299,7 @@ DisplayLibrary::newImageRect( lua_State *L )
             U32 flags = PlatformBitmap::kIsNearestAvailablePixelDensity | PlatformBitmap::kIsBitsFullResolution;
 
             Runtime& runtime = library->GetDisplay().GetRuntime();
-            BitmapPaint *paint = BitmapPaint::NewBitmap( runtime, imageName, baseDir, flags );
+            BitmapPaint *paint = BitmapPaint::NewImage( runtime, imageName, baseDir, flags );
 
             if ( paint && paint->GetBitmap() && paint->GetBitmap()->NumBytes() == 0 )
             {
@@ -2958,6 +3002,8 @@ int
 DisplayLibrary::getTimings( lua_State *L )
 {
 	Self* lib = (Self *)lua_touserdata( L, lua_upvalueindex( 1 ) );
+	lib->GetDisplay().GetProfilingState()->EnableEventProfiles();
+
 	if ( lua_isstring( L, 2 ) )
 	{
 		Profiling* profiling = lib->GetDisplay().GetProfilingState()->Get( lua_tostring( L, 2 ) );
@@ -2973,6 +3019,94 @@ DisplayLibrary::getTimings( lua_State *L )
 	return 1;
 }
 
+// display.enableTrace( enabled )
+int
+DisplayLibrary::enableTrace( lua_State *L )
+{
+	TraceRecorder::SetEnabled( lua_toboolean( L, 1 ) );
+
+	return 0;
+}
+
+// display.writeTrace( filename [, baseDir] )
+//
+// Writes what has been recorded since display.enableTrace( true ) as Chrome
+// trace JSON, for chrome://tracing or Perfetto. Returns true on success.
+int
+DisplayLibrary::writeTrace( lua_State *L )
+{
+	const char* filename = luaL_checkstring( L, 1 );
+	MPlatform::Directory baseDir = LuaLibSystem::ToDirectory( L, 2, MPlatform::kDocumentsDir );
+	if ( ! LuaLibSystem::IsWritableDirectory( baseDir ) )
+	{
+		baseDir = MPlatform::kDocumentsDir;
+	}
+
+	const MPlatform& platform = LuaContext::GetPlatform( L );
+	String path( LuaContext::GetAllocator( L ) );
+	platform.PathForFile( filename, baseDir, MPlatform::kDefaultPathFlags, path );
+
+	lua_pushboolean( L, TraceRecorder::WriteChromeTrace( path.GetString() ) );
+
+	return 1;
+}
+
+// display.startProfiler( [intervalMs] )
+//
+// Starts sampling Lua call stacks, by default every millisecond, discarding
+// earlier samples. Returns false if a debugger's hook is already running.
+int
+DisplayLibrary::startProfiler( lua_State *L )
+{
+	lua_Number interval = luaL_optnumber( L, 1, 1. );
+	U32 microseconds = ( interval > 0 ? (U32)( interval * 1000 ) : 0 );
+
+	lua_pushboolean( L, LuaContext::GetContext( L )->GetSampler().Start( Max< U32 >( microseconds, 1 ) ) );
+
+	return 1;
+}
+
+// display.stopProfiler()
+//
+// Returns the number of samples taken, and how many were skipped because Lua
+// was idle or the buffer was full.
+int
+DisplayLibrary::stopProfiler( lua_State *L )
+{
+	LuaSampler& sampler = LuaContext::GetContext( L )->GetSampler();
+	sampler.Stop();
+
+	const LuaSampler::Stats& stats = sampler.GetStats();
+	lua_pushinteger( L, stats.fSamples );
+	lua_pushinteger( L, stats.fIdle );
+	lua_pushinteger( L, stats.fDropped );
+
+	return 3;
+}
+
+// display.writeProfile( filename [, baseDir] )
+//
+// Writes the samples as folded stacks, for flamegraph.pl or speedscope.
+// Returns true on success.
+int
+DisplayLibrary::writeProfile( lua_State *L )
+{
+	const char* filename = luaL_checkstring( L, 1 );
+	MPlatform::Directory baseDir = LuaLibSystem::ToDirectory( L, 2, MPlatform::kDocumentsDir );
+	if ( ! LuaLibSystem::IsWritableDirectory( baseDir ) )
+	{
+		baseDir = MPlatform::kDocumentsDir;
+	}
+
+	const MPlatform& platform = LuaContext::GetPlatform( L );
+	String path( LuaContext::GetAllocator( L ) );
+	platform.PathForFile( filename, baseDir, MPlatform::kDefaultPathFlags, path );
+
+	lua_pushboolean( L, LuaContext::GetContext( L )->GetSampler().Write( path.GetString() ) );
+
+	return 1;
+}
+
 int
 DisplayLibrary::_initProfiling( lua_State *L )
 {
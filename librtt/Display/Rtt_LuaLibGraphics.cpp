@@ -32,8 +32,10 @@
 #include "Rtt_PhysicsTypes.h"
 #include "SmoothPolygon.h"
 #include "Rtt_TextureFactory.h"
+#include "Rtt_Event.h"
 #include "Rtt_LuaContext.h"
 #include "Rtt_LuaLibNative.h"
+#include "Rtt_LuaResource.h"
 #include "Renderer/Rtt_FormatExtensionList.h"
 
 
@@ -93,6 +95,7 @@ class GraphicsLibrary
         static int listEffects( lua_State *L );
         static int newOutline( lua_State *L ); // This returns an outline in texels.
         static int newTexture( lua_State *L );
+        static int loadTextures( lua_State *L );
         static int releaseTextures( lua_State *L );
         static int undefineEffect( lua_State *L );
         static int getFontMetrics( lua_State *L );
@@ -138,6 +141,7 @@ GraphicsLibrary::Open( lua_State *L )
         { "listEffects", listEffects },
         { "newOutline", newOutline }, // This returns an outline in texels.
         { "newTexture", newTexture },
+        { "loadTextures", loadTextures },
         { "releaseTextures", releaseTextures },
         { "undefineEffect", undefineEffect },
         { "getFontMetrics", getFontMetrics },
@@ -1377,8 +1381,78 @@ GraphicsLibrary::newTexture( lua_State *L )
 	return result;
 }
 
-    
-    
+// graphics.loadTextures( files, listener )
+// Each of files is a filename or a table with "filename" and optional "baseDir"
+// and "isMask" fields, as in graphics.newTexture(). The listener's "completion"
+// event lists the resulting textures in event.textures.
+int
+GraphicsLibrary::loadTextures( lua_State *L )
+{
+	if ( ! lua_istable( L, 1 ) )
+	{
+		CoronaLuaError( L, "graphics.loadTextures() requires a table of filenames" );
+		return 0;
+	}
+
+	if ( ! Lua::IsListener( L, 2, CompletionEvent::kName ) )
+	{
+		CoronaLuaError( L, "graphics.loadTextures() requires a listener" );
+		return 0;
+	}
+
+	std::vector< TextureFactory::LoadRequest > requests;
+	std::vector< std::string > filenames;
+
+	int top = lua_gettop( L );
+	for ( int i = 1, iMax = (int)lua_objlen( L, 1 ); i <= iMax; i++ )
+	{
+		TextureFactory::LoadRequest request = { NULL, MPlatform::kResourceDir, false };
+
+		lua_rawgeti( L, 1, i );
+		if ( lua_istable( L, -1 ) )
+		{
+			int index = lua_gettop( L );
+
+			lua_getfield( L, index, "baseDir" );
+			request.baseDir = LuaLibSystem::ToDirectory( L, -1, MPlatform::kResourceDir );
+			lua_pop( L, 1 );
+
+			lua_getfield( L, index, "isMask" );
+			request.isMask = lua_isboolean( L, -1 ) && lua_toboolean( L, -1 );
+			lua_pop( L, 1 );
+
+			lua_getfield( L, index, "filename" );
+		}
+		const char *filename = lua_tostring( L, -1 );
+
+		if ( ! filename )
+		{
+			CoronaLuaError( L, "graphics.loadTextures() requires a valid filename at index %d", i );
+			lua_settop( L, top );
+			return 0;
+		}
+
+		filenames.push_back( filename );
+		requests.push_back( request );
+		lua_settop( L, top );
+	}
+
+	for ( size_t i = 0; i < requests.size(); i++ )
+	{
+		requests[i].filename = filenames[i].c_str();
+	}
+
+	Self *library = ToLibrary( L );
+	Display& display = library->GetDisplay();
+
+	LuaResource *listener = Rtt_NEW( LuaContext::GetAllocator( L ),
+										LuaResource( LuaContext::GetContext( L )->LuaState(), 2 ) );
+
+	display.GetTextureFactory().LoadAsync( requests.empty() ? NULL : & requests[0], (U32)requests.size(), listener );
+
+	return 0;
+}
+
 // graphics.releaseTextures()
 int
 GraphicsLibrary::releaseTextures( lua_State *L )
@@ -0,0 +1,449 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Display/Rtt_MeshStream.h"
+
+#include "Core/Rtt_Math.h"
+#include "Rtt_LuaAux.h"
+#include "CoronaLua.h"
+#include "CoronaMemory.h"
+
+// Only the bulk setters are vectorized; see PixelConversion for the detection
+#if !defined( Rtt_REAL_FIXED )
+	#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+		#include <emmintrin.h>
+		#define MESH_USE_SSE2
+	#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ ) || defined( _M_ARM64 )
+		#include <arm_neon.h>
+		#define MESH_USE_NEON
+	#endif
+#endif
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+static bool IsValidBuffer( lua_State *L, const void* &buffer, size_t &len )
+{
+    CoronaMemoryAcquireState state;
+
+    if ( CoronaMemoryAcquireInterface( L, -1, &state ) && CORONA_MEMORY_HAS( state, getReadableBytes ) )
+    {
+        buffer = CORONA_MEMORY_GET( state, ReadableBytes );
+        len = CORONA_MEMORY_GET( state, ByteCount );
+        
+        return true;
+    }
+    
+    else
+    {
+        return false;
+    }
+}
+
+static const unsigned char* AuxGetBuffer( lua_State *L, size_t valueSize, size_t &len, U32 &n )
+{
+    const void* buffer = NULL;
+
+    if ( IsValidBuffer( L, buffer, len ) )
+    {
+        n = (U32)(len / valueSize);
+    }
+
+    return static_cast< const unsigned char * >( buffer );
+}
+
+static const unsigned char* IssueWarning( lua_State *L, const unsigned char* buffer, const char * warning )
+{
+	if (buffer)
+	{
+		CoronaLuaWarning( L, "%s", warning );
+	}
+
+	return NULL;
+}
+
+// Raises an argument error unless the first 'count' elements of the table on top of the
+// stack are numbers, so that callers can check a whole table before writing any of it
+static void
+CheckNumbers( lua_State *L, int arg, U32 count )
+{
+	for ( U32 i = 1; i <= count; i++ )
+	{
+		lua_rawgeti( L, -1, i );
+
+		bool isNumber = lua_isnumber( L, -1 );
+
+		lua_pop( L, 1 );
+
+		if ( ! isNumber )
+		{
+			luaL_argerror( L, arg, "expected an array of numbers" );
+		}
+	}
+}
+
+// Sets 'first' from the optional 1-based position after 'index', raising an
+// argument error unless it is within 'length'; returns the values left from there
+static U32
+CheckFirst( lua_State *L, int index, U32 length, U32 &first )
+{
+	first = (U32)luaL_optinteger( L, index + 1, 1 ) - 1U;
+
+	if ( first >= length )
+	{
+		luaL_argerror( L, index + 1, "index is out of bounds" );
+	}
+
+	return length - first;
+}
+
+// ----------------------------------------------------------------------------
+
+const char*
+MeshStream::InstructionSet()
+{
+#if defined( MESH_USE_SSE2 )
+	return "SSE2";
+#elif defined( MESH_USE_NEON )
+	return "NEON";
+#else
+	return "scalar";
+#endif
+}
+
+const unsigned char*
+MeshStream::GetBuffer( lua_State *L, size_t valueSize, size_t element, U32 &n, size_t &stride, const U32* outputLength )
+{
+	size_t len;
+    stride = 0;
+
+	const unsigned char* buffer = AuxGetBuffer( L, valueSize, len, n );
+
+	// A raw buffer is read in full, one value after another
+	if ( buffer )
+	{
+		stride = valueSize;
+	}
+
+	else if ( lua_istable( L, -1 ) )
+	{
+		lua_getfield( L, -1, "buffer" ); // ..., t, buffer
+
+		buffer = AuxGetBuffer( L, valueSize, len, n );
+
+		lua_pop( L, 1 ); // ..., t
+
+		if (buffer)
+		{
+			lua_getfield( L, -1, "count" ); // ..., t, count
+			lua_getfield( L, -2, "stride" ); // ..., t, count, stride
+			lua_getfield( L, -3, "offset" ); // ..., t, count, stride, offset
+
+			// Supplied own `count`? If a `stride` of 0 is not explicitly supplied, this is expected to be <= what the
+			// buffer can hold (`size` / `stride`, where the latter defaults to value size).
+			size_t count = 0;
+
+			if ( lua_type( L, -3 ) == LUA_TNUMBER )
+			{
+				count = lua_tointeger( L, -3 );
+			}
+
+			// Can it also fit in the output?
+			if ( outputLength && count > *outputLength )
+			{
+				buffer = IssueWarning( L, buffer, "Too many values to fit in output" );
+			}
+
+			// Possible strides include 0 (repeat the first element `count` times) or >= the value size.
+			// By default, the value size is used.
+			stride = 0;
+
+			bool repeatFirstValue = false;
+
+			if ( lua_type( L, -2 ) == LUA_TNUMBER )
+			{
+				stride = lua_tointeger( L, -2 );
+
+				if ( stride > 0 && stride <= valueSize )
+				{
+					buffer = IssueWarning( L, buffer, "`stride` is too low" );
+				}
+
+				else if ( 0 == stride )
+				{
+					if ( 0 == count )
+					{
+						buffer = IssueWarning( L, buffer, "Explicit zero `stride` expects `count`" );
+					}
+
+					else
+					{
+						repeatFirstValue = true;
+					}
+				}
+			}
+
+			if ( 0 == stride && !repeatFirstValue )
+			{
+				stride = valueSize;
+			}
+
+			// Get any custom `offset` and use it to find the final count, ensuring the data still fits.
+			// This will be added to any offset into the stream, e.g. starting at some vertex #3 versus
+			// right from the start. If all is well, update the buffer with respect to the offset.
+			size_t offset = element * stride;
+
+			if ( lua_type( L, -1 ) == LUA_TNUMBER )
+			{
+				offset += lua_tointeger( L, -1 );
+			}
+							
+			if ( stride > 0 )
+			{
+				n = ( len - offset ) / stride;
+
+				if ( 0 == n )
+				{
+					buffer = IssueWarning( L, buffer, "Buffer not large enough to supply any values" );
+				}
+
+				else if ( count > n )
+				{
+					buffer = IssueWarning( L, buffer, "Buffer not large enough to supply `count` values" );
+				}
+
+				else if ( count > 0 )
+				{
+					n = count;
+				}
+			}
+
+			else
+			{
+				n = count;
+
+				if ( len - offset < valueSize )
+				{
+					buffer = IssueWarning( L, buffer, "Buffer not large enough to supply (repeated) value" );
+				}
+			}
+
+			if ( buffer )
+			{
+				buffer += offset;
+			}
+
+			lua_pop( L, 3 ); // ..., t
+		}
+	}
+
+	return buffer;
+}
+
+U32
+MeshStream::ReadPairs( lua_State *L, int index, Vertex2 *to, U32 length, U32 &first )
+{
+	U32 available = CheckFirst( L, index, length, first ), n = 0;
+	size_t stride;
+
+	lua_pushvalue( L, index );
+
+	const unsigned char* from = GetBuffer( L, sizeof( Vertex2 ), 0, n, stride, &available );
+
+	if ( from )
+	{
+		if ( n > available )
+		{
+			luaL_argerror( L, index, "too many values for the mesh" );
+		}
+
+		CopyToOutput( to + first, from, n, stride );
+	}
+
+	else if ( lua_istable( L, -1 ) )
+	{
+		n = (U32)lua_objlen( L, -1 ) / 2;
+
+		if ( n > available )
+		{
+			luaL_argerror( L, index, "too many values for the mesh" );
+		}
+
+		CheckNumbers( L, index, 2 * n );
+
+		Vertex2 * out = to + first;
+
+		for ( U32 i = 0; i < n; i++ )
+		{
+			lua_rawgeti( L, -1, 2 * i + 1 );
+			lua_rawgeti( L, -2, 2 * i + 2 );
+
+			out[i].x = luaL_toreal( L, -2 );
+			out[i].y = luaL_toreal( L, -1 );
+
+			lua_pop( L, 2 );
+		}
+	}
+
+	else
+	{
+		luaL_argerror( L, index, "expected a table or buffer" );
+	}
+
+	lua_pop( L, 1 );
+
+	return n;
+}
+
+U32
+MeshStream::ReadColors( lua_State *L, int index, U32 *to, U32 length, U32 &first, float scale )
+{
+	U32 available = CheckFirst( L, index, length, first ), n = 0;
+	size_t stride;
+
+	lua_pushvalue( L, index );
+
+	const unsigned char* from = GetBuffer( L, sizeof( U32 ), 0, n, stride, &available );
+
+	if ( from )
+	{
+		if ( n > available )
+		{
+			luaL_argerror( L, index, "too many values for the mesh" );
+		}
+
+		CopyToOutput( to + first, from, n, stride );
+	}
+
+	else if ( lua_istable( L, -1 ) )
+	{
+		n = (U32)lua_objlen( L, -1 ) / 4;
+
+		if ( n > available )
+		{
+			luaL_argerror( L, index, "too many values for the mesh" );
+		}
+
+		CheckNumbers( L, index, 4 * n );
+
+		// Packed a chunk at a time, so nothing is allocated
+		const U32 kChunk = 64;
+		float channels[kChunk * 4];
+
+		for ( U32 i = 0; i < n; i += kChunk )
+		{
+			U32 count = Min( kChunk, n - i );
+
+			for ( U32 j = 0; j < count * 4; j++ )
+			{
+				lua_rawgeti( L, -1, i * 4 + j + 1 );
+				channels[j] = (float)lua_tonumber( L, -1 );
+				lua_pop( L, 1 );
+			}
+
+			PackColors( to + first + i, channels, count, scale );
+		}
+	}
+
+	else
+	{
+		luaL_argerror( L, index, "expected a table or buffer" );
+	}
+
+	lua_pop( L, 1 );
+
+	return n;
+}
+
+void
+MeshStream::SubtractOffset( Vertex2 *vertices, U32 count, const Vertex2& offset )
+{
+	Real * p = &vertices[0].x;
+	U32 i = 0, n = count * 2;
+
+#if defined( MESH_USE_SSE2 )
+	__m128 o = _mm_setr_ps( offset.x, offset.y, offset.x, offset.y );
+
+	for ( ; i + 4 <= n; i += 4 )
+	{
+		_mm_storeu_ps( p + i, _mm_sub_ps( _mm_loadu_ps( p + i ), o ) );
+	}
+#elif defined( MESH_USE_NEON )
+	const float pair[] = { offset.x, offset.y, offset.x, offset.y };
+	float32x4_t o = vld1q_f32( pair );
+
+	for ( ; i + 4 <= n; i += 4 )
+	{
+		vst1q_f32( p + i, vsubq_f32( vld1q_f32( p + i ), o ) );
+	}
+#endif
+
+	for ( ; i < n; i += 2 )
+	{
+		p[i] -= offset.x;
+		p[i + 1] -= offset.y;
+	}
+}
+
+void
+MeshStream::PackColors( U32 *to, const float *from, U32 count, float scale )
+{
+	U32 i = 0;
+
+#if defined( MESH_USE_SSE2 )
+	__m128 s = _mm_set1_ps( scale ), lo = _mm_setzero_ps(), hi = _mm_set1_ps( 255.f );
+
+	for ( ; i + 4 <= count; i += 4, from += 16 )
+	{
+		__m128i c0 = _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps( _mm_mul_ps( _mm_loadu_ps( from ), s ), lo ), hi ) );
+		__m128i c1 = _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps( _mm_mul_ps( _mm_loadu_ps( from + 4 ), s ), lo ), hi ) );
+		__m128i c2 = _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps( _mm_mul_ps( _mm_loadu_ps( from + 8 ), s ), lo ), hi ) );
+		__m128i c3 = _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps( _mm_mul_ps( _mm_loadu_ps( from + 12 ), s ), lo ), hi ) );
+
+		_mm_storeu_si128( (__m128i *)( to + i ), _mm_packus_epi16( _mm_packs_epi32( c0, c1 ), _mm_packs_epi32( c2, c3 ) ) );
+	}
+#elif defined( MESH_USE_NEON )
+	float32x4_t s = vdupq_n_f32( scale ), lo = vdupq_n_f32( 0.f ), hi = vdupq_n_f32( 255.f );
+
+	for ( ; i + 4 <= count; i += 4, from += 16 )
+	{
+		uint32x4_t c0 = vcvtq_u32_f32( vminq_f32( vmaxq_f32( vmulq_f32( vld1q_f32( from ), s ), lo ), hi ) );
+		uint32x4_t c1 = vcvtq_u32_f32( vminq_f32( vmaxq_f32( vmulq_f32( vld1q_f32( from + 4 ), s ), lo ), hi ) );
+		uint32x4_t c2 = vcvtq_u32_f32( vminq_f32( vmaxq_f32( vmulq_f32( vld1q_f32( from + 8 ), s ), lo ), hi ) );
+		uint32x4_t c3 = vcvtq_u32_f32( vminq_f32( vmaxq_f32( vmulq_f32( vld1q_f32( from + 12 ), s ), lo ), hi ) );
+		uint16x8_t c01 = vcombine_u16( vmovn_u32( c0 ), vmovn_u32( c1 ) );
+		uint16x8_t c23 = vcombine_u16( vmovn_u32( c2 ), vmovn_u32( c3 ) );
+
+		vst1q_u8( (uint8_t *)( to + i ), vcombine_u8( vmovn_u16( c01 ), vmovn_u16( c23 ) ) );
+	}
+#endif
+
+	for ( ; i < count; i++, from += 4 )
+	{
+		U8 * bytes = (U8 *)( to + i );
+
+		for ( int j = 0; j < 4; j++ )
+		{
+			bytes[j] = U8( Clamp( from[j] * scale, 0.f, 255.f ) );
+		}
+	}
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
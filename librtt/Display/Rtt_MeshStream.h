@@ -0,0 +1,99 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_MeshStream_H__
+#define _Rtt_MeshStream_H__
+
+#include "Core/Rtt_Geometry.h"
+#include "Core/Rtt_Types.h"
+
+#include <stddef.h>
+#include <string.h>
+
+struct lua_State;
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Reads the vertex, UV, color and index streams that mesh paths take from
+// Lua: flat arrays of numbers, or CoronaMemory buffers, either raw or as
+// { buffer, count, stride, offset }. The kernels behind the bulk setters use
+// SSE2 or NEON where available, and otherwise a scalar loop with identical
+// results.
+class MeshStream
+{
+	public:
+		// Name of the instruction set the kernels were built for
+		static const char* InstructionSet();
+
+	public:
+		// Gets the buffer on top of the stack, raw or described by a table,
+		// skipping 'element' values. Sets 'n' to the number of values of
+		// 'valueSize' bytes it holds and 'stride' to the bytes between them,
+		// where 0 repeats the first value. Returns NULL if there is no buffer,
+		// or after a warning if the description can't be used.
+		static const unsigned char* GetBuffer( lua_State *L, size_t valueSize, size_t element, U32 &n, size_t &stride, const U32* outputLength = NULL );
+
+		template < typename T >
+		static T GetValueFromStream( const unsigned char* &from, size_t stride )
+		{
+			T v;
+			memcpy( &v, from, sizeof( T ) );
+			from += stride;
+			return v;
+		}
+
+		template < typename T >
+		static void CopyToOutput( T * to, const unsigned char * from, U32 count, size_t stride )
+		{
+			if ( sizeof( T ) == stride )
+			{
+				memcpy( to, from, count * sizeof( T ) );
+			}
+			else
+			{
+				for ( U32 i = 0; i < count; i++ )
+				{
+					to[i] = GetValueFromStream< T >( from, stride );
+				}
+			}
+		}
+
+	public:
+		// Reads x, y pairs from the array or buffer at 'index' into 'to', which
+		// holds 'length' values, from the 1-based position at 'index' + 1 (by
+		// default, 1). Sets 'first' to that position, 0-based, and returns the
+		// number read. Nothing is written if an argument error is raised.
+		static U32 ReadPairs( lua_State *L, int index, Vertex2 *to, U32 length, U32 &first );
+
+		// As ReadPairs(), for RGBA bytes from a buffer, or r, g, b, a numbers
+		// from an array, which are multiplied by 'scale' to get bytes
+		static U32 ReadColors( lua_State *L, int index, U32 *to, U32 length, U32 &first, float scale );
+
+	public:
+		// Subtracts 'offset' from 'count' vertices, in place
+		static void SubtractOffset( Vertex2 *vertices, U32 count, const Vertex2& offset );
+
+		// Packs 'count' colors of four floats into RGBA bytes, as toColorFloat()
+		// does: each channel is scaled by 'scale', clamped to 0-255, then
+		// truncated
+		static void PackColors( U32 *to, const float *from, U32 count, float scale );
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_MeshStream_H__
@@ -0,0 +1,614 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Display/Rtt_PixelConversion.h"
+
+// Kernels are picked at compile time. AVX2 and SSSE3 are only used when the
+// build already targets them (e.g. -mavx2, /arch:AVX2), so binaries keep
+// running on any SSE2 machine. Unpremultiplying needs exact float division,
+// which 32-bit ARM NEON lacks; it uses the scalar path there.
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+	#include <emmintrin.h>
+	#define PIXEL_USE_SSE2
+	#if defined( __SSSE3__ ) || defined( __AVX__ )
+		#include <tmmintrin.h>
+		#define PIXEL_USE_SSSE3
+	#endif
+	#if defined( __AVX2__ )
+		#include <immintrin.h>
+		#define PIXEL_USE_AVX2
+	#endif
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ ) || defined( _M_ARM64 )
+	#include <arm_neon.h>
+	#define PIXEL_USE_NEON
+	#if defined( __aarch64__ ) || defined( _M_ARM64 )
+		#define PIXEL_USE_NEON_DIVIDE
+	#endif
+#endif
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Scalar kernels. These define the results; the vector kernels below match
+// them exactly and use them for leftover pixels.
+
+// round( c * a / 255 ), exact for all 8-bit inputs
+static Rtt_FORCE_INLINE U8
+MulDiv255( U32 c, U32 a )
+{
+	U32 t = c * a + 128;
+	return (U8)( ( t + ( t >> 8 ) ) >> 8 );
+}
+
+// Byte offsets of the three color channels around the alpha
+struct ColorChannels
+{
+	ColorChannels( S32 alphaIndex )
+	{
+		for ( S32 k = 0, n = 0; k < 4; k++ )
+		{
+			if ( k != alphaIndex )
+			{
+				fIndex[n++] = k;
+			}
+		}
+	}
+
+	S32 fIndex[3];
+};
+
+static void
+PremultiplyScalar( U8 *p, size_t numPixels, S32 alphaIndex )
+{
+	const ColorChannels channels( alphaIndex );
+	const S32 r = channels.fIndex[0], g = channels.fIndex[1], b = channels.fIndex[2];
+
+	for ( size_t i = 0; i < numPixels; i++, p += 4 )
+	{
+		U32 a = p[alphaIndex];
+
+		p[r] = MulDiv255( p[r], a );
+		p[g] = MulDiv255( p[g], a );
+		p[b] = MulDiv255( p[b], a );
+	}
+}
+
+static Rtt_FORCE_INLINE U8
+Unpremultiplied( U8 c, float invAlpha )
+{
+	float result = invAlpha * (float)c;
+
+	return (U8)( result < 255.f ? result : 255.f );
+}
+
+static void
+UnpremultiplyScalar( U8 *p, size_t numPixels, S32 alphaIndex )
+{
+	const ColorChannels channels( alphaIndex );
+	const S32 r = channels.fIndex[0], g = channels.fIndex[1], b = channels.fIndex[2];
+
+	for ( size_t i = 0; i < numPixels; i++, p += 4 )
+	{
+		U8 a = p[alphaIndex];
+
+		if ( a > 0 )
+		{
+			float invAlpha = 255.f / (float)a;
+
+			p[r] = Unpremultiplied( p[r], invAlpha );
+			p[g] = Unpremultiplied( p[g], invAlpha );
+			p[b] = Unpremultiplied( p[b], invAlpha );
+		}
+	}
+}
+
+static void
+RGBToRGBAScalar( const U8 *src, U8 *dst, size_t numPixels )
+{
+	for ( size_t i = 0; i < numPixels; i++, src += 3, dst += 4 )
+	{
+		dst[0] = src[0];
+		dst[1] = src[1];
+		dst[2] = src[2];
+		dst[3] = 255;
+	}
+}
+
+static void
+SwapRedBlueScalar( const U8 *src, U8 *dst, size_t numPixels )
+{
+	for ( size_t i = 0; i < numPixels; i++, src += 4, dst += 4 )
+	{
+		U8 r = src[0];
+		U8 b = src[2];
+
+		dst[0] = b;
+		dst[1] = src[1];
+		dst[2] = r;
+		dst[3] = src[3];
+	}
+}
+
+static void
+ExtractChannelScalar( const U8 *src, U8 *dst, size_t numPixels, S32 channel )
+{
+	src += channel;
+
+	for ( size_t i = 0; i < numPixels; i++, src += 4 )
+	{
+		dst[i] = *src;
+	}
+}
+
+// ----------------------------------------------------------------------------
+
+#if defined( PIXEL_USE_SSE2 )
+
+// Eight 16-bit round( c * a / 255 )
+static Rtt_FORCE_INLINE __m128i
+MulDiv255_SSE2( __m128i c, __m128i a )
+{
+	__m128i t = _mm_add_epi16( _mm_mullo_epi16( c, a ), _mm_set1_epi16( 128 ) );
+	return _mm_srli_epi16( _mm_add_epi16( t, _mm_srli_epi16( t, 8 ) ), 8 );
+}
+
+static void
+PremultiplySSE2( U8 *p, size_t numPixels, S32 alphaIndex )
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lowByte = _mm_set1_epi32( 0xFF );
+	const __m128i shift = _mm_cvtsi32_si128( alphaIndex * 8 );
+	const __m128i alphaMask = _mm_sll_epi32( lowByte, shift );
+	const __m128i colorMask = _mm_andnot_si128( alphaMask, _mm_set1_epi8( -1 ) );
+
+	size_t i = 0;
+	for ( ; i + 4 <= numPixels; i += 4, p += 16 )
+	{
+		__m128i v = _mm_loadu_si128( (const __m128i *)p );
+
+		// Opaque runs are common in atlases, and unchanged
+		if ( 0xFFFF == _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_or_si128( v, colorMask ), _mm_set1_epi8( -1 ) ) ) )
+		{
+			continue;
+		}
+
+		// Broadcast each pixel's alpha to its 4 bytes
+		__m128i a = _mm_and_si128( _mm_srl_epi32( v, shift ), lowByte );
+		a = _mm_or_si128( a, _mm_slli_epi32( a, 8 ) );
+		a = _mm_or_si128( a, _mm_slli_epi32( a, 16 ) );
+
+		__m128i lo = MulDiv255_SSE2( _mm_unpacklo_epi8( v, zero ), _mm_unpacklo_epi8( a, zero ) );
+		__m128i hi = MulDiv255_SSE2( _mm_unpackhi_epi8( v, zero ), _mm_unpackhi_epi8( a, zero ) );
+		__m128i c = _mm_packus_epi16( lo, hi );
+
+		c = _mm_or_si128( _mm_and_si128( colorMask, c ), _mm_and_si128( alphaMask, v ) );
+		_mm_storeu_si128( (__m128i *)p, c );
+	}
+
+	PremultiplyScalar( p, numPixels - i, alphaIndex );
+}
+
+// One pixel, as four 32-bit channels
+template < int kAlpha >
+static Rtt_FORCE_INLINE __m128i
+UnpremultiplyPixel_SSE2( __m128i c )
+{
+	const __m128 k255 = _mm_set1_ps( 255.f );
+
+	__m128 f = _mm_cvtepi32_ps( c );
+	__m128 a = _mm_shuffle_ps( f, f, _MM_SHUFFLE( kAlpha, kAlpha, kAlpha, kAlpha ) );
+	__m128 r = _mm_min_ps( _mm_mul_ps( _mm_div_ps( k255, a ), f ), k255 );
+
+	// Fully transparent pixels keep their values
+	__m128 isTransparent = _mm_cmpeq_ps( a, _mm_setzero_ps() );
+	r = _mm_or_ps( _mm_and_ps( isTransparent, f ), _mm_andnot_ps( isTransparent, r ) );
+
+	return _mm_cvttps_epi32( r );
+}
+
+template < int kAlpha >
+static void
+UnpremultiplySSE2( U8 *p, size_t numPixels )
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaMask = _mm_set1_epi32( (int)( 0xFFu << ( kAlpha * 8 ) ) );
+
+	size_t i = 0;
+	for ( ; i + 4 <= numPixels; i += 4, p += 16 )
+	{
+		__m128i v = _mm_loadu_si128( (const __m128i *)p );
+		__m128i lo = _mm_unpacklo_epi8( v, zero );
+		__m128i hi = _mm_unpackhi_epi8( v, zero );
+
+		__m128i c0 = UnpremultiplyPixel_SSE2< kAlpha >( _mm_unpacklo_epi16( lo, zero ) );
+		__m128i c1 = UnpremultiplyPixel_SSE2< kAlpha >( _mm_unpackhi_epi16( lo, zero ) );
+		__m128i c2 = UnpremultiplyPixel_SSE2< kAlpha >( _mm_unpacklo_epi16( hi, zero ) );
+		__m128i c3 = UnpremultiplyPixel_SSE2< kAlpha >( _mm_unpackhi_epi16( hi, zero ) );
+		__m128i c = _mm_packus_epi16( _mm_packs_epi32( c0, c1 ), _mm_packs_epi32( c2, c3 ) );
+
+		c = _mm_or_si128( _mm_andnot_si128( alphaMask, c ), _mm_and_si128( alphaMask, v ) );
+		_mm_storeu_si128( (__m128i *)p, c );
+	}
+
+	UnpremultiplyScalar( p, numPixels - i, kAlpha );
+}
+
+static void
+SwapRedBlueSSE2( const U8 *src, U8 *dst, size_t numPixels )
+{
+	const __m128i greenAlpha = _mm_set1_epi32( (int)0xFF00FF00 );
+	const __m128i redBlue = _mm_set1_epi32( 0x00FF00FF );
+
+	size_t i = 0;
+	for ( ; i + 4 <= numPixels; i += 4, src += 16, dst += 16 )
+	{
+		__m128i v = _mm_loadu_si128( (const __m128i *)src );
+		__m128i rb = _mm_and_si128( v, redBlue );
+
+		rb = _mm_or_si128( _mm_slli_epi32( rb, 16 ), _mm_srli_epi32( rb, 16 ) );
+		_mm_storeu_si128( (__m128i *)dst, _mm_or_si128( _mm_and_si128( v, greenAlpha ), rb ) );
+	}
+
+	SwapRedBlueScalar( src, dst, numPixels - i );
+}
+
+static void
+ExtractChannelSSE2( const U8 *src, U8 *dst, size_t numPixels, S32 channel )
+{
+	const __m128i lowByte = _mm_set1_epi32( 0xFF );
+	const __m128i shift = _mm_cvtsi32_si128( channel * 8 );
+
+	size_t i = 0;
+	for ( ; i + 16 <= numPixels; i += 16, src += 64, dst += 16 )
+	{
+		__m128i c0 = _mm_and_si128( _mm_srl_epi32( _mm_loadu_si128( (const __m128i *)src ), shift ), lowByte );
+		__m128i c1 = _mm_and_si128( _mm_srl_epi32( _mm_loadu_si128( (const __m128i *)( src + 16 ) ), shift ), lowByte );
+		__m128i c2 = _mm_and_si128( _mm_srl_epi32( _mm_loadu_si128( (const __m128i *)( src + 32 ) ), shift ), lowByte );
+		__m128i c3 = _mm_and_si128( _mm_srl_epi32( _mm_loadu_si128( (const __m128i *)( src + 48 ) ), shift ), lowByte );
+
+		_mm_storeu_si128( (__m128i *)dst, _mm_packus_epi16( _mm_packs_epi32( c0, c1 ), _mm_packs_epi32( c2, c3 ) ) );
+	}
+
+	ExtractChannelScalar( src, dst, numPixels - i, channel );
+}
+
+#if defined( PIXEL_USE_SSSE3 )
+
+static void
+RGBToRGBASSSE3( const U8 *src, U8 *dst, size_t numPixels )
+{
+	const __m128i expand = _mm_setr_epi8( 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1 );
+	const __m128i opaque = _mm_set1_epi32( (int)0xFF000000 );
+
+	// Each load reads 16 bytes for 12, so stop while 2 more pixels remain
+	size_t i = 0;
+	for ( ; i + 6 <= numPixels; i += 4, src += 12, dst += 16 )
+	{
+		__m128i v = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i *)src ), expand );
+
+		_mm_storeu_si128( (__m128i *)dst, _mm_or_si128( v, opaque ) );
+	}
+
+	RGBToRGBAScalar( src, dst, numPixels - i );
+}
+
+#endif // PIXEL_USE_SSSE3
+
+#if defined( PIXEL_USE_AVX2 )
+
+static Rtt_FORCE_INLINE __m256i
+MulDiv255_AVX2( __m256i c, __m256i a )
+{
+	__m256i t = _mm256_add_epi16( _mm256_mullo_epi16( c, a ), _mm256_set1_epi16( 128 ) );
+	return _mm256_srli_epi16( _mm256_add_epi16( t, _mm256_srli_epi16( t, 8 ) ), 8 );
+}
+
+static void
+PremultiplyAVX2( U8 *p, size_t numPixels, S32 alphaIndex )
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i lowByte = _mm256_set1_epi32( 0xFF );
+	const __m128i shift = _mm_cvtsi32_si128( alphaIndex * 8 );
+	const __m256i alphaMask = _mm256_sll_epi32( lowByte, shift );
+	const __m256i colorMask = _mm256_andnot_si256( alphaMask, _mm256_set1_epi8( -1 ) );
+
+	// Unpacking and packing both work within 128-bit lanes, so pixels keep
+	// their order
+	size_t i = 0;
+	for ( ; i + 8 <= numPixels; i += 8, p += 32 )
+	{
+		__m256i v = _mm256_loadu_si256( (const __m256i *)p );
+
+		if ( -1 == _mm256_movemask_epi8( _mm256_cmpeq_epi8( _mm256_or_si256( v, colorMask ), _mm256_set1_epi8( -1 ) ) ) )
+		{
+			continue;
+		}
+
+		__m256i a = _mm256_and_si256( _mm256_srl_epi32( v, shift ), lowByte );
+		a = _mm256_or_si256( a, _mm256_slli_epi32( a, 8 ) );
+		a = _mm256_or_si256( a, _mm256_slli_epi32( a, 16 ) );
+
+		__m256i lo = MulDiv255_AVX2( _mm256_unpacklo_epi8( v, zero ), _mm256_unpacklo_epi8( a, zero ) );
+		__m256i hi = MulDiv255_AVX2( _mm256_unpackhi_epi8( v, zero ), _mm256_unpackhi_epi8( a, zero ) );
+		__m256i c = _mm256_packus_epi16( lo, hi );
+
+		c = _mm256_or_si256( _mm256_and_si256( colorMask, c ), _mm256_and_si256( alphaMask, v ) );
+		_mm256_storeu_si256( (__m256i *)p, c );
+	}
+
+	PremultiplySSE2( p, numPixels - i, alphaIndex );
+}
+
+static void
+SwapRedBlueAVX2( const U8 *src, U8 *dst, size_t numPixels )
+{
+	const __m256i greenAlpha = _mm256_set1_epi32( (int)0xFF00FF00 );
+	const __m256i redBlue = _mm256_set1_epi32( 0x00FF00FF );
+
+	size_t i = 0;
+	for ( ; i + 8 <= numPixels; i += 8, src += 32, dst += 32 )
+	{
+		__m256i v = _mm256_loadu_si256( (const __m256i *)src );
+		__m256i rb = _mm256_and_si256( v, redBlue );
+
+		rb = _mm256_or_si256( _mm256_slli_epi32( rb, 16 ), _mm256_srli_epi32( rb, 16 ) );
+		_mm256_storeu_si256( (__m256i *)dst, _mm256_or_si256( _mm256_and_si256( v, greenAlpha ), rb ) );
+	}
+
+	SwapRedBlueSSE2( src, dst, numPixels - i );
+}
+
+#endif // PIXEL_USE_AVX2
+
+#endif // PIXEL_USE_SSE2
+
+// ----------------------------------------------------------------------------
+
+#if defined( PIXEL_USE_NEON )
+
+static void
+PremultiplyNEON( U8 *p, size_t numPixels, S32 alphaIndex )
+{
+	size_t i = 0;
+	for ( ; i + 8 <= numPixels; i += 8, p += 32 )
+	{
+		uint8x8x4_t v = vld4_u8( p );
+		uint8x8_t a = v.val[alphaIndex];
+
+		for ( S32 k = 0; k < 4; k++ )
+		{
+			if ( k != alphaIndex )
+			{
+				// ( t + 128 + ( ( t + 128 ) >> 8 ) ) >> 8, as in MulDiv255()
+				uint16x8_t t = vmull_u8( v.val[k], a );
+				v.val[k] = vrshrn_n_u16( vrsraq_n_u16( t, t, 8 ), 8 );
+			}
+		}
+
+		vst4_u8( p, v );
+	}
+
+	PremultiplyScalar( p, numPixels - i, alphaIndex );
+}
+
+#if defined( PIXEL_USE_NEON_DIVIDE )
+
+// Four channel values, given their pixels' alpha and 255 / alpha
+static Rtt_FORCE_INLINE uint32x4_t
+UnpremultiplyChannel_NEON( uint16x4_t c, float32x4_t a, float32x4_t invAlpha )
+{
+	const float32x4_t k255 = vdupq_n_f32( 255.f );
+
+	float32x4_t f = vcvtq_f32_u32( vmovl_u16( c ) );
+	float32x4_t r = vminq_f32( vmulq_f32( invAlpha, f ), k255 );
+
+	// Fully transparent pixels keep their values
+	r = vbslq_f32( vceqq_f32( a, vdupq_n_f32( 0.f ) ), f, r );
+
+	return vcvtq_u32_f32( r );
+}
+
+static void
+UnpremultiplyNEON( U8 *p, size_t numPixels, S32 alphaIndex )
+{
+	const float32x4_t k255 = vdupq_n_f32( 255.f );
+
+	size_t i = 0;
+	for ( ; i + 8 <= numPixels; i += 8, p += 32 )
+	{
+		uint8x8x4_t v = vld4_u8( p );
+		uint16x8_t a16 = vmovl_u8( v.val[alphaIndex] );
+		float32x4_t aLo = vcvtq_f32_u32( vmovl_u16( vget_low_u16( a16 ) ) );
+		float32x4_t aHi = vcvtq_f32_u32( vmovl_u16( vget_high_u16( a16 ) ) );
+		float32x4_t invLo = vdivq_f32( k255, aLo );
+		float32x4_t invHi = vdivq_f32( k255, aHi );
+
+		for ( S32 k = 0; k < 4; k++ )
+		{
+			if ( k != alphaIndex )
+			{
+				uint16x8_t c16 = vmovl_u8( v.val[k] );
+				uint32x4_t lo = UnpremultiplyChannel_NEON( vget_low_u16( c16 ), aLo, invLo );
+				uint32x4_t hi = UnpremultiplyChannel_NEON( vget_high_u16( c16 ), aHi, invHi );
+
+				v.val[k] = vmovn_u16( vcombine_u16( vmovn_u32( lo ), vmovn_u32( hi ) ) );
+			}
+		}
+
+		vst4_u8( p, v );
+	}
+
+	UnpremultiplyScalar( p, numPixels - i, alphaIndex );
+}
+
+#endif // PIXEL_USE_NEON_DIVIDE
+
+static void
+RGBToRGBANEON( const U8 *src, U8 *dst, size_t numPixels )
+{
+	size_t i = 0;
+	for ( ; i + 16 <= numPixels; i += 16, src += 48, dst += 64 )
+	{
+		uint8x16x3_t rgb = vld3q_u8( src );
+		uint8x16x4_t rgba;
+
+		rgba.val[0] = rgb.val[0];
+		rgba.val[1] = rgb.val[1];
+		rgba.val[2] = rgb.val[2];
+		rgba.val[3] = vdupq_n_u8( 255 );
+		vst4q_u8( dst, rgba );
+	}
+
+	RGBToRGBAScalar( src, dst, numPixels - i );
+}
+
+static void
+SwapRedBlueNEON( const U8 *src, U8 *dst, size_t numPixels )
+{
+	size_t i = 0;
+	for ( ; i + 16 <= numPixels; i += 16, src += 64, dst += 64 )
+	{
+		uint8x16x4_t v = vld4q_u8( src );
+		uint8x16_t r = v.val[0];
+
+		v.val[0] = v.val[2];
+		v.val[2] = r;
+		vst4q_u8( dst, v );
+	}
+
+	SwapRedBlueScalar( src, dst, numPixels - i );
+}
+
+static void
+ExtractChannelNEON( const U8 *src, U8 *dst, size_t numPixels, S32 channel )
+{
+	size_t i = 0;
+	for ( ; i + 16 <= numPixels; i += 16, src += 64, dst += 16 )
+	{
+		uint8x16x4_t v = vld4q_u8( src );
+
+		vst1q_u8( dst, v.val[channel] );
+	}
+
+	ExtractChannelScalar( src, dst, numPixels - i, channel );
+}
+
+#endif // PIXEL_USE_NEON
+
+// ----------------------------------------------------------------------------
+
+const char*
+PixelConversion::InstructionSet()
+{
+#if defined( PIXEL_USE_AVX2 )
+	return "AVX2";
+#elif defined( PIXEL_USE_SSSE3 )
+	return "SSSE3";
+#elif defined( PIXEL_USE_SSE2 )
+	return "SSE2";
+#elif defined( PIXEL_USE_NEON )
+	return "NEON";
+#else
+	return "scalar";
+#endif
+}
+
+void
+PixelConversion::Premultiply( U8 *pixels, size_t numPixels, S32 alphaIndex )
+{
+	Rtt_ASSERT( alphaIndex >= 0 && alphaIndex < 4 );
+
+#if defined( PIXEL_USE_AVX2 )
+	PremultiplyAVX2( pixels, numPixels, alphaIndex );
+#elif defined( PIXEL_USE_SSE2 )
+	PremultiplySSE2( pixels, numPixels, alphaIndex );
+#elif defined( PIXEL_USE_NEON )
+	PremultiplyNEON( pixels, numPixels, alphaIndex );
+#else
+	PremultiplyScalar( pixels, numPixels, alphaIndex );
+#endif
+}
+
+void
+PixelConversion::Unpremultiply( U8 *pixels, size_t numPixels, S32 alphaIndex )
+{
+	Rtt_ASSERT( alphaIndex >= 0 && alphaIndex < 4 );
+
+#if defined( PIXEL_USE_SSE2 )
+	switch ( alphaIndex )
+	{
+		case 0:
+			UnpremultiplySSE2< 0 >( pixels, numPixels );
+			break;
+		case 3:
+			UnpremultiplySSE2< 3 >( pixels, numPixels );
+			break;
+		default:
+			UnpremultiplyScalar( pixels, numPixels, alphaIndex );
+			break;
+	}
+#elif defined( PIXEL_USE_NEON_DIVIDE )
+	UnpremultiplyNEON( pixels, numPixels, alphaIndex );
+#else
+	UnpremultiplyScalar( pixels, numPixels, alphaIndex );
+#endif
+}
+
+void
+PixelConversion::RGBToRGBA( const U8 *src, U8 *dst, size_t numPixels )
+{
+#if defined( PIXEL_USE_SSSE3 )
+	RGBToRGBASSSE3( src, dst, numPixels );
+#elif defined( PIXEL_USE_NEON )
+	RGBToRGBANEON( src, dst, numPixels );
+#else
+	RGBToRGBAScalar( src, dst, numPixels );
+#endif
+}
+
+void
+PixelConversion::SwapRedBlue( const U8 *src, U8 *dst, size_t numPixels )
+{
+#if defined( PIXEL_USE_AVX2 )
+	SwapRedBlueAVX2( src, dst, numPixels );
+#elif defined( PIXEL_USE_SSE2 )
+	SwapRedBlueSSE2( src, dst, numPixels );
+#elif defined( PIXEL_USE_NEON )
+	SwapRedBlueNEON( src, dst, numPixels );
+#else
+	SwapRedBlueScalar( src, dst, numPixels );
+#endif
+}
+
+void
+PixelConversion::ExtractChannel( const U8 *src, U8 *dst, size_t numPixels, S32 channel )
+{
+	Rtt_ASSERT( channel >= 0 && channel < 4 );
+
+#if defined( PIXEL_USE_SSE2 )
+	ExtractChannelSSE2( src, dst, numPixels, channel );
+#elif defined( PIXEL_USE_NEON )
+	ExtractChannelNEON( src, dst, numPixels, channel );
+#else
+	ExtractChannelScalar( src, dst, numPixels, channel );
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
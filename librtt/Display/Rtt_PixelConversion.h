@@ -0,0 +1,61 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_PixelConversion_H__
+#define _Rtt_PixelConversion_H__
+
+#include "Core/Rtt_Types.h"
+
+#include <stddef.h>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Per-pixel conversions shared by the platform bitmap loaders and by frame
+// buffer captures. Pixels are tightly packed 8-bit channels. Each kernel
+// uses SSE2 (AVX2 when the build targets it) or NEON where available, and
+// otherwise a scalar loop with identical results.
+class PixelConversion
+{
+	public:
+		// Name of the instruction set the kernels were built for
+		static const char* InstructionSet();
+
+	public:
+		// 4 bytes per pixel, alpha at byte 'alphaIndex' (3 for RGBA/BGRA,
+		// 0 for ARGB). Color channels become round( c * a / 255 ).
+		static void Premultiply( U8 *pixels, size_t numPixels, S32 alphaIndex = 3 );
+
+		// Inverse of Premultiply(), up to rounding. Fully transparent pixels
+		// are left as is.
+		static void Unpremultiply( U8 *pixels, size_t numPixels, S32 alphaIndex = 3 );
+
+		// 3 bytes per pixel in 'src' to 4 in 'dst', with an opaque alpha.
+		// The buffers must not overlap.
+		static void RGBToRGBA( const U8 *src, U8 *dst, size_t numPixels );
+
+		// RGBA <-> BGRA. 'src' and 'dst' may be the same buffer.
+		static void SwapRedBlue( const U8 *src, U8 *dst, size_t numPixels );
+
+		// Copies byte 'channel' of each 4-byte pixel in 'src' to 'dst', e.g.
+		// the alpha of an RGBA image into a mask.
+		static void ExtractChannel( const U8 *src, U8 *dst, size_t numPixels, S32 channel = 3 );
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_PixelConversion_H__
@@ -11,6 +11,7 @@
 
 #include "Display/Rtt_Scene.h"
 
+#include "Core/Rtt_TraceRecorder.h"
 #include "Display/Rtt_Display.h"
 #include "Display/Rtt_DisplayDefaults.h"
 #include "Rtt_MUpdatable.h"
@@ -56,6 +57,7 @@ Scene::Scene( Rtt_Allocator* pAllocator, Display& owner)
     fOverlay( Rtt_NEW( pAllocator, StageObject( pAllocator, * this ) ) ),
     fProxyOrphanage( owner.GetAllocator() ),
     fIsValid( false ),
+    fIsCollectDeferred( false ),
     fCounter( 0 ),
     fActiveUpdatable()
 {
@@ -177,7 +179,12 @@ Scene::IsValid() const
 void
 Scene::Invalidate()
 {
-    fIsValid = false;
+    // Only store on change: objects updated on worker threads invalidate the
+    // scene too, but only while it is already invalid (see GroupObject)
+    if ( fIsValid )
+    {
+        fIsValid = false;
+    }
 }
 
 void
@@ -204,6 +211,8 @@ Scene::Clear( Renderer& renderer )
 void
 Scene::Render( Renderer& renderer, PlatformSurface& rTarget, ProfilingEntryRAII* profiling )
 {
+    TRACE_SCOPE( render, "Scene::Render" );
+
     Rtt_ASSERT( fCurrentStage );
 
     U8 drawMode = fOwner.GetDrawMode();
@@ -307,9 +316,12 @@ Scene::Render( Renderer& renderer, PlatformSurface& rTarget, ProfilingEntryRAII*
     }
     
     // This needs to be done at the sync point (DMZ)
-    Collect();
-	
-	ADD_ENTRY( "Scene: Collect" );
+    if ( ! fIsCollectDeferred )
+    {
+        Collect();
+
+        ADD_ENTRY( "Scene: Collect" );
+    }
 }
 
 void
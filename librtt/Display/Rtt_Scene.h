@@ -61,6 +61,10 @@ class Scene
 		// Collects various resources passed into QueueRelease() after every 3rd and 32nd call.
 		void Collect();
 
+		// While deferred, Render() skips Collect(), which the caller must then
+		// make once it is safe to delete orphaned objects
+		void SetCollectDeferred( bool deferred ) { fIsCollectDeferred = deferred; }
+
 		// Collects all resources passed into QueueRelease() right now.
 		// Intended to be called when the app is about to lose the OpenGL context and must delete GPU resources now.
 		void ForceCollect();
@@ -103,6 +107,7 @@ class Scene
 		StageObject *fOverlay;
 		LightPtrArray< LuaUserdataProxy > fProxyOrphanage;
 		bool fIsValid;
+		bool fIsCollectDeferred;
 		U8 fCounter; // DO NOT change type --- must be U8
 
 		// IMPORTANT: The purpose of this set is to iterate over all active
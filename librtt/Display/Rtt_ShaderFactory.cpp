@@ -304,6 +304,11 @@ ShaderFactory::NewProgram(
 //    Rtt_TRACE( ( "Fragment source:\n%s\n", program->GetFragmentShaderSource() ) );
     lua_pop( L, 1 );
 
+    // The default shell only reads q for 2.5D; kernels may read the user data
+    // through any of a_UserData, v_UserData, or CoronaVertexUserData.
+    program->SetAcceptsPackedVertices( ShaderResource::k25D != mod );
+    program->SetReadsUserData( NULL != strstr( kernelVert, "UserData" ) || NULL != strstr( kernelFrag, "UserData" ) );
+
 	//TODO - move this into a delegate block, rather than extending this
 	{
 		Program::Language language;
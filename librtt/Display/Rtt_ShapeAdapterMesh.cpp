@@ -12,6 +12,7 @@
 #include "Display/Rtt_ShapeAdapterMesh.h"
 
 #include "Core/Rtt_StringHash.h"
+#include "Display/Rtt_MeshStream.h"
 #include "Display/Rtt_ShapePath.h"
 #include "Display/Rtt_ShapeObject.h"
 #include "Display/Rtt_TesselatorMesh.h"
@@ -68,168 +69,6 @@ ShapeAdapterMesh::GetMeshMode(lua_State *L, int index)
 	return ret;
 }
 
-static bool IsValidBuffer( lua_State *L, const void* &buffer, size_t &len )
-{
-    CoronaMemoryAcquireState state;
-
-    if ( CoronaMemoryAcquireInterface( L, -1, &state ) && CORONA_MEMORY_HAS( state, getReadableBytes ) )
-    {
-        buffer = CORONA_MEMORY_GET( state, ReadableBytes );
-        len = CORONA_MEMORY_GET( state, ByteCount );
-        
-        return true;
-    }
-    
-    else
-    {
-        return false;
-    }
-}
-
-static const unsigned char* AuxGetBuffer( lua_State *L, size_t valueSize, size_t &len, U32 &n )
-{
-    const void* buffer = NULL;
-
-    if ( IsValidBuffer( L, buffer, len ) )
-    {
-        n = (U32)(len / valueSize);
-    }
-
-    return static_cast< const unsigned char * >( buffer );
-}
-
-static const unsigned char* IssueWarning( lua_State *L, const unsigned char* buffer, const char * warning )
-{
-	if (buffer)
-	{
-		CoronaLuaWarning( L, "%s", warning );
-	}
-
-	return NULL;
-}
-
-static const unsigned char* GetBuffer( lua_State *L, size_t valueSize, size_t element, U32 &n, size_t &stride, const U32* outputLength = NULL )
-{
-	size_t len;
-    stride = 0;
-
-	const unsigned char* buffer = AuxGetBuffer( L, valueSize, len, n );
-
-	if ( !buffer && lua_istable( L, -1 ) )
-	{
-		lua_getfield( L, -1, "buffer" ); // ..., t, buffer
-
-		buffer = AuxGetBuffer( L, valueSize, len, n );
-
-		lua_pop( L, 1 ); // ..., t
-
-		if (buffer)
-		{
-			lua_getfield( L, -1, "count" ); // ..., t, count
-			lua_getfield( L, -2, "stride" ); // ..., t, count, stride
-			lua_getfield( L, -3, "offset" ); // ..., t, count, stride, offset
-
-			// Supplied own `count`? If a `stride` of 0 is not explicitly supplied, this is expected to be <= what the
-			// buffer can hold (`size` / `stride`, where the latter defaults to value size).
-			size_t count = 0;
-
-			if ( lua_type( L, -3 ) == LUA_TNUMBER )
-			{
-				count = lua_tointeger( L, -3 );
-			}
-
-			// Can it also fit in the output?
-			if ( outputLength && count > *outputLength )
-			{
-				buffer = IssueWarning( L, buffer, "Too many values to fit in output" );
-			}
-
-			// Possible strides include 0 (repeat the first element `count` times) or >= the value size.
-			// By default, the value size is used.
-			stride = 0;
-
-			bool repeatFirstValue = false;
-
-			if ( lua_type( L, -2 ) == LUA_TNUMBER )
-			{
-				stride = lua_tointeger( L, -2 );
-
-				if ( stride > 0 && stride <= valueSize )
-				{
-					buffer = IssueWarning( L, buffer, "`stride` is too low" );
-				}
-
-				else if ( 0 == stride )
-				{
-					if ( 0 == count )
-					{
-						buffer = IssueWarning( L, buffer, "Explicit zero `stride` expects `count`" );
-					}
-
-					else
-					{
-						repeatFirstValue = true;
-					}
-				}
-			}
-
-			if ( 0 == stride && !repeatFirstValue )
-			{
-				stride = valueSize;
-			}
-
-			// Get any custom `offset` and use it to find the final count, ensuring the data still fits.
-			// This will be added to any offset into the stream, e.g. starting at some vertex #3 versus
-			// right from the start. If all is well, update the buffer with respect to the offset.
-			size_t offset = element * stride;
-
-			if ( lua_type( L, -1 ) == LUA_TNUMBER )
-			{
-				offset += lua_tointeger( L, -1 );
-			}
-							
-			if ( stride > 0 )
-			{
-				n = ( len - offset ) / stride;
-
-				if ( 0 == n )
-				{
-					buffer = IssueWarning( L, buffer, "Buffer not large enough to supply any values" );
-				}
-
-				else if ( count > n )
-				{
-					buffer = IssueWarning( L, buffer, "Buffer not large enough to supply `count` values" );
-				}
-
-				else if ( count > 0 )
-				{
-					n = count;
-				}
-			}
-
-			else
-			{
-				n = count;
-
-				if ( len - offset < valueSize )
-				{
-					buffer = IssueWarning( L, buffer, "Buffer not large enough to supply (repeated) value" );
-				}
-			}
-
-			if ( buffer )
-			{
-				buffer += offset;
-			}
-
-			lua_pop( L, 3 ); // ..., t
-		}
-	}
-
-	return buffer;
-}
-
 static void UpdateIndexRange( U16 index, U16 &minIndex, U16 &maxIndex )
 {
 	minIndex = index < minIndex ? index : minIndex;
@@ -242,29 +81,6 @@ static bool HasIndices( U16 minIndex, U16 maxIndex )
 		|| 0 == minIndex; // i.e. maxIndex == 0 but minIndex no longer max unsigned U16?
 }
 
-template<typename T> T GetValueFromStream( const unsigned char* &from, size_t stride )
-{
-	T v;
-	memcpy( &v, from, sizeof( T ) );
-	from += stride;
-	return v;
-}
-
-template<typename T> void CopyToOutput( T * to, const unsigned char * from, U32 count, size_t stride )
-{
-	if ( sizeof( T ) == stride )
-	{
-		memcpy( to, from, count * sizeof( T ) );
-	}
-	else
-	{
-		for ( U32 i = 0; i < count; i++)
-		{
-			to[i] = GetValueFromStream<T>( from, stride );
-		}
-	}
-}
-
 bool
 ShapeAdapterMesh::InitializeMesh(lua_State *L, int index, TesselatorMesh& tesselator, bool hasZ )
 {
@@ -293,14 +109,14 @@ ShapeAdapterMesh::InitializeMesh(lua_State *L, int index, TesselatorMesh& tessel
 
 	size_t stride;
 	U32 numIndices = (U32)indices.Length();
-	const unsigned char* fromIndices = GetBuffer(L, sizeof(U16), 0, numIndices, stride);
+	const unsigned char* fromIndices = MeshStream::GetBuffer(L, sizeof(U16), 0, numIndices, stride);
 
 	if (fromIndices)
 	{
 		indices.Reserve( numIndices );
 		for (U32 i = 0; i < numIndices; i++)
 		{
-			U16 newIndex = GetValueFromStream<U16>( fromIndices, stride );
+			U16 newIndex = MeshStream::GetValueFromStream<U16>( fromIndices, stride );
 			indices.Append(newIndex);
 			UpdateIndexRange( newIndex, minIndex, maxIndex );
 		}
@@ -349,7 +165,7 @@ ShapeAdapterMesh::InitializeMesh(lua_State *L, int index, TesselatorMesh& tessel
 	Rtt_ASSERT( mesh.Length() == 0 );
 	lua_getfield( L, index, "vertices" );
 
-	const unsigned char* fromVertices = GetBuffer(L, sizeof(Vertex2), baseVertex, numVertices, stride);
+	const unsigned char* fromVertices = MeshStream::GetBuffer(L, sizeof(Vertex2), baseVertex, numVertices, stride);
 
 	if (fromVertices)
 	{
@@ -360,7 +176,7 @@ ShapeAdapterMesh::InitializeMesh(lua_State *L, int index, TesselatorMesh& tessel
 		mesh.Reserve( numVertices );
 		for ( U32 i = 0; i < numVertices; i++ )
 		{
-			Vertex2 v = GetValueFromStream<Vertex2>( fromVertices, stride );
+			Vertex2 v = MeshStream::GetValueFromStream<Vertex2>( fromVertices, stride );
 			mesh.Append( v );
 		}
     }
@@ -421,7 +237,7 @@ ShapeAdapterMesh::InitializeMesh(lua_State *L, int index, TesselatorMesh& tessel
 	ArrayVertex2& UVs = tesselator.GetUV();
 	U32 numUVs;
 	lua_getfield( L, index, "uvs" );
-	const unsigned char* fromUVs = GetBuffer(L, sizeof(Vertex2), baseVertex, numUVs, stride);
+	const unsigned char* fromUVs = MeshStream::GetBuffer(L, sizeof(Vertex2), baseVertex, numUVs, stride);
 
 	if (fromVertices)
 	{
@@ -432,7 +248,7 @@ ShapeAdapterMesh::InitializeMesh(lua_State *L, int index, TesselatorMesh& tessel
 		UVs.Reserve( numUVs );
 		for ( U32 i = 0; i < numUVs; i++ )
 		{
-			Vertex2 v = GetValueFromStream<Vertex2>( fromUVs, stride );
+			Vertex2 v = MeshStream::GetValueFromStream<Vertex2>( fromUVs, stride );
 			UVs.Append( v );
 		}
 	}
@@ -500,9 +316,12 @@ ShapeAdapterMesh::GetHash( lua_State *L ) const
 		"getUV",           // 3
 		"getVertexOffset", // 4
 		"update",		   // 5
-		"getLowestIndex"   // 6
+		"getLowestIndex",  // 6
+		"setVertices",     // 7
+		"setUVs",          // 8
+		"setColors"        // 9
 	};
-	static StringHash sHash( *LuaContext::GetAllocator( L ), keys, sizeof( keys ) / sizeof( const char * ), 7, 3, 2, __FILE__, __LINE__ );
+	static StringHash sHash( *LuaContext::GetAllocator( L ), keys, sizeof( keys ) / sizeof( const char * ), 10, 12, 4, __FILE__, __LINE__ );
 	return &sHash;
 }
 
@@ -549,6 +368,15 @@ ShapeAdapterMesh::ValueForKey(
 		case 6:
 			Lua::PushCachedFunction( L, getLowestIndex );
 			break;
+		case 7:
+			Lua::PushCachedFunction( L, setVertices );
+			break;
+		case 8:
+			Lua::PushCachedFunction( L, setUVs );
+			break;
+		case 9:
+			Lua::PushCachedFunction( L, setColors );
+			break;
 		default:
 			result = Super::ValueForKey( sender, L, key );
 			break;
@@ -773,13 +601,13 @@ int ShapeAdapterMesh::update(lua_State *L)
 		U16 minIndex = std::numeric_limits<U16>::max(), maxIndex = 0;
 		U16 *indices = tesselator->GetIndices().WriteAccess();
 		U32 numIndices, indicesOutputLen = (U32)tesselator->GetIndices().Length();
-		const unsigned char* fromIndices = GetBuffer(L, sizeof(U16), 0, numIndices, stride, &indicesOutputLen);
+		const unsigned char* fromIndices = MeshStream::GetBuffer(L, sizeof(U16), 0, numIndices, stride, &indicesOutputLen);
 
 		if (fromIndices)
 		{
 			for (U32 i = 0; i < numIndices; i++)
 			{
-				U16 newIndex = GetValueFromStream<U16>( fromIndices, stride );
+				U16 newIndex = MeshStream::GetValueFromStream<U16>( fromIndices, stride );
 				if (newIndex != indices[i])
 				{
 					changed = true;
@@ -845,12 +673,12 @@ int ShapeAdapterMesh::update(lua_State *L)
 		bool updatedVertices = false;
 		Vertex2 *mesh = tesselator->GetMesh().WriteAccess();
 		U32 numVertices, verticesOutputLen = (U32)tesselator->GetMesh().Length();
-		const unsigned char* fromVertices = GetBuffer(L, sizeof(Vertex2), baseVertex, numVertices, stride, &verticesOutputLen);
+		const unsigned char* fromVertices = MeshStream::GetBuffer(L, sizeof(Vertex2), baseVertex, numVertices, stride, &verticesOutputLen);
 
 		if (fromVertices)
 		{
 			updatedVertices = true;
-			CopyToOutput(mesh, fromVertices, numVertices, stride);
+			MeshStream::CopyToOutput(mesh, fromVertices, numVertices, stride);
 		}
 
 		else if (lua_istable(L, -1))
@@ -913,12 +741,12 @@ int ShapeAdapterMesh::update(lua_State *L)
 		bool updatedUVs = false;
 		Vertex2 *uvs = tesselator->GetUV().WriteAccess();
 		U32 numUVs;
-		const unsigned char* fromUVs = GetBuffer(L, sizeof(Vertex2), baseVertex, numUVs, stride, &verticesOutputLen);
+		const unsigned char* fromUVs = MeshStream::GetBuffer(L, sizeof(Vertex2), baseVertex, numUVs, stride, &verticesOutputLen);
 
 		if (fromUVs)
 		{
 			updatedUVs = true;
-			CopyToOutput(uvs, fromUVs, numUVs, stride);
+			MeshStream::CopyToOutput(uvs, fromUVs, numUVs, stride);
 		}
 
 		else if (lua_istable(L, -1))
@@ -956,12 +784,12 @@ int ShapeAdapterMesh::update(lua_State *L)
 		lua_getfield(L, -1, "fillVertexColors");
 		U32 *fvcs = NULL;
 		U32 numFVCs;
-		const unsigned char* fromFVCs = GetBuffer(L, sizeof(U32), baseVertex, numFVCs, stride, &verticesOutputLen);
+		const unsigned char* fromFVCs = MeshStream::GetBuffer(L, sizeof(U32), baseVertex, numFVCs, stride, &verticesOutputLen);
 
 		if (fromFVCs)
 		{
 			fvcs = path->GetFillVertexColors();
-			CopyToOutput(fvcs, fromFVCs, numFVCs, stride);
+			MeshStream::CopyToOutput(fvcs, fromFVCs, numFVCs, stride);
 		}
 		else if (lua_istable(L, -1))
 		{
@@ -1030,6 +858,94 @@ int ShapeAdapterMesh::getLowestIndex( lua_State *L )
 	return result;
 }
 
+// path:setVertices( vertices [, first] ), where 'vertices' is { x1, y1, x2, y2, ... }
+// or a buffer of float pairs. Unlike update(), the mesh is not re-centered.
+int ShapeAdapterMesh::setVertices( lua_State *L )
+{
+	int result = 0;
+	int nextArg = 1;
+	LuaUserdataProxy* sender = LuaUserdataProxy::ToProxy( L, nextArg++ );
+	if(!sender) { return result; }
+
+	ShapePath *path = (ShapePath *)sender->GetUserdata();
+	if ( ! path ) { return result; }
+
+	TesselatorMesh *tesselator =
+	static_cast< TesselatorMesh * >( path->GetTesselator() );
+	if ( ! tesselator ) { return result; }
+
+	ArrayVertex2& mesh = tesselator->GetMesh();
+	U32 first;
+	U32 n = MeshStream::ReadPairs( L, nextArg, mesh.WriteAccess(), (U32)mesh.Length(), first );
+
+	if ( n > 0 )
+	{
+		MeshStream::SubtractOffset( mesh.WriteAccess() + first, n, tesselator->GetVertexOffset() );
+
+		path->Invalidate( ClosedPath::kFillSource |
+						 ClosedPath::kStrokeSource );
+
+		path->GetObserver()->Invalidate( DisplayObject::kGeometryFlag |
+										DisplayObject::kStageBoundsFlag |
+										DisplayObject::kTransformFlag );
+	}
+
+	return 0;
+}
+
+// path:setUVs( uvs [, first] ), where 'uvs' is { u1, v1, u2, v2, ... } or a buffer of float pairs
+int ShapeAdapterMesh::setUVs( lua_State *L )
+{
+	int result = 0;
+	int nextArg = 1;
+	LuaUserdataProxy* sender = LuaUserdataProxy::ToProxy( L, nextArg++ );
+	if(!sender) { return result; }
+
+	ShapePath *path = (ShapePath *)sender->GetUserdata();
+	if ( ! path ) { return result; }
+
+	TesselatorMesh *tesselator =
+	static_cast< TesselatorMesh * >( path->GetTesselator() );
+	if ( ! tesselator ) { return result; }
+
+	ArrayVertex2& UVs = tesselator->GetUV();
+	U32 first;
+	U32 n = MeshStream::ReadPairs( L, nextArg, UVs.WriteAccess(), (U32)UVs.Length(), first );
+
+	if ( n > 0 )
+	{
+		path->Invalidate( ClosedPath::kFillSourceTexture );
+
+		path->GetObserver()->Invalidate( DisplayObject::kGeometryFlag );
+	}
+
+	return 0;
+}
+
+// path:setColors( colors [, first] ), where 'colors' is { r1, g1, b1, a1, r2, ... }, in the
+// object's color range, or a buffer of RGBA bytes, one U32 per fill vertex
+int ShapeAdapterMesh::setColors( lua_State *L )
+{
+	int result = 0;
+	int nextArg = 1;
+	LuaUserdataProxy* sender = LuaUserdataProxy::ToProxy( L, nextArg++ );
+	if(!sender) { return result; }
+
+	ShapePath *path = (ShapePath *)sender->GetUserdata();
+	if ( ! path ) { return result; }
+
+	float scale = path->GetObserver()->IsByteColorRange() ? 1.f : 255.f;
+	U32 first;
+	U32 n = MeshStream::ReadColors( L, nextArg, path->GetFillVertexColors(), path->GetFillVertexCount(), first, scale );
+
+	if ( n > 0 )
+	{
+		path->GetObserver()->Invalidate( DisplayObject::kGeometryFlag | DisplayObject::kColorFlag );
+	}
+
+	return 0;
+}
+
 // ----------------------------------------------------------------------------
 
 } // namespace Rtt
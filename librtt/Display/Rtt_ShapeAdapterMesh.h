@@ -52,6 +52,9 @@ class ShapeAdapterMesh : public ShapeAdapter
 		static int getVertexOffset( lua_State *L );
 		static int update(lua_State *L);
 		static int getLowestIndex( lua_State *L );
+		static int setVertices( lua_State *L );
+		static int setUVs( lua_State *L );
+		static int setColors( lua_State *L );
 };
 
 // ----------------------------------------------------------------------------
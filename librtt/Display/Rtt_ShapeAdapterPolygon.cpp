@@ -34,7 +34,7 @@ ShapeAdapterPolygon::Constant()
 
 bool
 ShapeAdapterPolygon::InitializeContour(
-	lua_State *L, int index, TesselatorPolygon& tesselator, bool hasZ )
+	lua_State *L, int index, TesselatorPolygon& tesselator, bool hasZ, int holesIndex )
 {
 	bool result = false;
 
@@ -76,6 +76,41 @@ ShapeAdapterPolygon::InitializeContour(
 			contour[ i ].y -= center_offset.y;
 		}
 
+		if ( holesIndex && lua_istable( L, holesIndex ) )
+		{
+			holesIndex = Lua::Normalize( L, holesIndex );
+
+			ArrayVertex2& holes = tesselator.GetHoles();
+			ArrayS32& holeStarts = tesselator.GetHoleStarts();
+
+			for ( int h = 1, hMax = (int) lua_objlen( L, holesIndex ); h <= hMax; h++ )
+			{
+				lua_rawgeti( L, holesIndex, h );
+
+				int numHoleVertices = lua_istable( L, -1 ) ? (int) lua_objlen( L, -1 ) / 2 : 0;
+
+				if ( numHoleVertices >= 3 )
+				{
+					holeStarts.Append( holes.Length() );
+
+					for ( int i = 0; i < numHoleVertices; i++ )
+					{
+						lua_rawgeti( L, -1, ( i * 2 ) + 1 );
+						lua_rawgeti( L, -2, ( i * 2 ) + 2 );
+
+						// Holes share the contour's offset
+						Vertex2 v = { luaL_toreal( L, -2 ) - center_offset.x,
+										luaL_toreal( L, -1 ) - center_offset.y };
+						lua_pop( L, 2 );
+
+						holes.Append( v );
+					}
+				}
+
+				lua_pop( L, 1 );
+			}
+		}
+
 		tesselator.Invalidate();
 		result = true;
 	}
@@ -29,8 +29,10 @@ class ShapeAdapterPolygon : public ShapeAdapter
 	public:
 		static const ShapeAdapterPolygon& Constant();
 
+		// If 'holesIndex' is nonzero, it is an array of hole outlines, each
+		// a flat array of x,y pairs like the contour.
 		static bool InitializeContour(
-			lua_State *L, int index, TesselatorPolygon& tesselator, bool hasZ );
+			lua_State *L, int index, TesselatorPolygon& tesselator, bool hasZ, int holesIndex = 0 );
 
 	protected:
 		ShapeAdapterPolygon();
@@ -255,6 +255,14 @@ ShapeObject::GetProgramMod() const
 	return ShaderResource::kDefault;
 }
 
+bool
+ShapeObject::CanUpdateConcurrently() const
+{
+	// Shader lookup (kProgramFlag) goes through the ShaderFactory, masks share
+	// their bitmap, and extensions are backed by Lua
+	return IsValid( kProgramFlag ) && ! GetMask() && ! GetExtensions();
+}
+
 const LuaProxyVTable&
 ShapeObject::ProxyVTable() const
 {
@@ -57,6 +57,7 @@ class ShapeObject : public DisplayObject
 		virtual bool HitTest( Real contentX, Real contentY );
 		virtual void DidUpdateTransform( Matrix& srcToDst );
 		virtual ShaderResource::ProgramMod GetProgramMod() const;
+		virtual bool CanUpdateConcurrently() const;
 
 	public:
 		virtual const LuaProxyVTable& ProxyVTable() const;
@@ -80,6 +80,7 @@ class SnapshotObject : public RectObject
 		virtual bool UpdateTransform( const Matrix& parentToDstSpace );
 		virtual void Prepare( const Display& display );
 		virtual void Draw( Renderer& renderer ) const;
+		virtual bool CanUpdateConcurrently() const { return false; } // prepares its own group
 
 	public:
 		static void RenderToFBO(
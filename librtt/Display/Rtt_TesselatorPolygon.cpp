@@ -11,10 +11,17 @@
 
 #include "Display/Rtt_TesselatorPolygon.h"
 
+#include "Core/Rtt_Math.h"
 #include "Display/Rtt_TesselatorLine.h"
 #include "Rtt_Matrix.h"
 #include "Rtt_Transform.h"
 
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <math.h>
+#include <vector>
+
 // ----------------------------------------------------------------------------
 
 namespace Rtt
@@ -22,34 +29,201 @@ namespace Rtt
 
 // ----------------------------------------------------------------------------
 
+// Ear clipping over a linked ring of vertices, after earcut
+// (https://github.com/mapbox/earcut). Candidate ears are only tested
+// against the vertices whose z-order (Morton) code falls within the ear's
+// bounds, so large contours triangulate in about O(n log n) rather than
+// O(n^3). Holes are bridged into the outer ring first. Rings the clipper
+// gets stuck on, e.g. due to self-intersections or repeated points, are
+// cured or split rather than rejected.
 class Triangulate
 {
 	public:
-		// Tesselate a contour/polygon into a series of triangles.
+		// Triangulates the contour, minus any holes. Holes are stored back to
+		// back in 'holes', with 'holeStarts' giving the index where each one
+		// begins. Triangulation indices refer to the contour followed by the
+		// holes.
 		static bool Process(
-			const ArrayVertex2 &contour, ArrayVertex2 &result, Rect& bounds, ArrayIndex * triangulationIndices );
+			const ArrayVertex2 &contour,
+			const ArrayVertex2 &holes,
+			const ArrayS32 &holeStarts,
+			ArrayVertex2 &result,
+			Rect& bounds,
+			ArrayIndex * triangulationIndices );
 
 		// Compute area of a contour/polygon
-		static float Area(const ArrayVertex2 &contour);
+		static float Area( const Vertex2 *contour, int n );
 
-		// Decide if point Px/Py is inside triangle defined by (Ax,Ay) (Bx,By) (Cx,Cy)
-		static bool InsideTriangle(
-			float Ax, float Ay,
-			float Bx, float By,
-			float Cx, float Cy,
-			float Px, float Py);
+	private:
+		struct Node
+		{
+			Node( S32 index, const Vertex2& v )
+			:	i( index ), x( v.x ), y( v.y ), prev( NULL ), next( NULL ),
+				z( 0 ), prevZ( NULL ), nextZ( NULL ), steiner( false )
+			{
+			}
+
+			S32 i; // vertex index
+			double x;
+			double y;
+
+			// ring
+			Node *prev;
+			Node *next;
+
+			// z-order curve
+			S32 z;
+			Node *prevZ;
+			Node *nextZ;
+
+			// hole made of a single point
+			bool steiner;
+		};
 
 	private:
-		static bool Snip(
-			const ArrayVertex2 &contour,
-			int u, int v, int w, int n, int *V );
+		Triangulate( const Vertex2 *vertices, S32 numVertices );
+
+		Node* LinkedList( S32 start, S32 end, bool clockwise );
+		Node* EliminateHoles( const ArrayS32 &holeStarts, S32 contourLength, S32 numVertices, Node *outerNode );
+		Node* EliminateHole( Node *hole, Node *outerNode );
+		static Node* FindHoleBridge( Node *hole, Node *outerNode );
+
+		void EarcutLinked( Node *ear, int pass );
+		bool IsEar( const Node *ear ) const;
+		bool IsEarHashed( const Node *ear ) const;
+		Node* CureLocalIntersections( Node *start );
+		void SplitEarcut( Node *start );
+		void AddTriangle( const Node *a, const Node *b, const Node *c );
+
+		void IndexCurve( Node *start );
+		S32 ZOrder( double x, double y ) const;
+
+		Node* InsertNode( S32 i, Node *last );
+		Node* SplitPolygon( Node *a, Node *b );
+		static Node* FilterPoints( Node *start, Node *end = NULL );
+		static void RemoveNode( Node *p );
+		static Node* SortLinked( Node *list );
+		static Node* GetLeftmost( Node *start );
+
+		static double Area( const Node *p, const Node *q, const Node *r );
+		static bool Equals( const Node *p1, const Node *p2 ) { return p1->x == p2->x && p1->y == p2->y; }
+		static bool PointInTriangle( double ax, double ay, double bx, double by, double cx, double cy, double px, double py );
+		static bool OnSegment( const Node *p, const Node *q, const Node *r );
+		static bool Intersects( const Node *p1, const Node *q1, const Node *p2, const Node *q2 );
+		static bool IntersectsPolygon( const Node *a, const Node *b );
+		static bool LocallyInside( const Node *a, const Node *b );
+		static bool MiddleInside( const Node *a, const Node *b );
+		static bool IsValidDiagonal( const Node *a, const Node *b );
+		static bool SectorContainsSector( const Node *m, const Node *p );
+
+	private:
+		const Vertex2 *fVertices;
+		std::deque< Node > fNodes; // addresses stay valid as nodes are added
+		std::vector< S32 > fTriangles;
+		double fMinX;
+		double fMinY;
+		double fInvSize; // nonzero if ears are looked up by z-order
 };
 
-float
-Triangulate::Area( const ArrayVertex2 &contour )
+// Below this many vertices, testing every vertex is cheaper than hashing
+static const S32 kMinVerticesToHash = 80;
+
+Triangulate::Triangulate( const Vertex2 *vertices, S32 numVertices )
+:	fVertices( vertices ),
+	fNodes(),
+	fTriangles(),
+	fMinX( 0.0 ),
+	fMinY( 0.0 ),
+	fInvSize( 0.0 )
 {
-	int n = contour.Length();
+	fTriangles.reserve( 3 * numVertices );
+}
+
+bool
+Triangulate::Process(
+	const ArrayVertex2 &contour,
+	const ArrayVertex2 &holes,
+	const ArrayS32 &holeStarts,
+	ArrayVertex2 &result,
+	Rect& bounds,
+	ArrayIndex * triangulationIndices )
+{
+	S32 contourLength = contour.Length();
+	if ( contourLength < 3 ) { return false; }
+
+	// contour and holes, back to back
+	ArrayVertex2 combined( contour.Allocator() );
+	const ArrayVertex2 *vertices = & contour;
+
+	if ( holeStarts.Length() > 0 )
+	{
+		combined.Reserve( contourLength + holes.Length() );
+		for ( S32 i = 0; i < contourLength; i++ ) { combined.Append( contour[i] ); }
+		for ( S32 i = 0, iMax = holes.Length(); i < iMax; i++ ) { combined.Append( holes[i] ); }
+
+		vertices = & combined;
+	}
+
+	S32 numVertices = vertices->Length();
+	Triangulate t( vertices->ReadAccess(), numVertices );
+
+	Node *outerNode = t.LinkedList( 0, contourLength, true );
+	if ( NULL == outerNode || outerNode->next == outerNode->prev ) { return false; }
+
+	if ( holeStarts.Length() > 0 )
+	{
+		outerNode = t.EliminateHoles( holeStarts, contourLength, numVertices, outerNode );
+	}
+
+	if ( numVertices > kMinVerticesToHash )
+	{
+		double minX = contour[0].x, maxX = minX;
+		double minY = contour[0].y, maxY = minY;
+
+		for ( S32 i = 1; i < contourLength; i++ )
+		{
+			double x = contour[i].x;
+			double y = contour[i].y;
+			if ( x < minX ) { minX = x; }
+			if ( y < minY ) { minY = y; }
+			if ( x > maxX ) { maxX = x; }
+			if ( y > maxY ) { maxY = y; }
+		}
+
+		// z-order codes interleave 15 bits of x and y
+		double size = Max( maxX - minX, maxY - minY );
+
+		t.fMinX = minX;
+		t.fMinY = minY;
+		t.fInvSize = ( size > 0.0 ? 32767.0 / size : 0.0 );
+	}
+
+	t.EarcutLinked( outerNode, 0 );
+
+	const std::vector< S32 >& triangles = t.fTriangles;
+	if ( triangles.empty() ) { return false; }
+
+	result.Reserve( result.Length() + (S32)triangles.size() );
+
+	for ( size_t i = 0, iMax = triangles.size(); i < iMax; i++ )
+	{
+		const Vertex2& v = (*vertices)[triangles[i]];
+
+		result.Append( v );
+		bounds.Union( v );
 
+		if ( triangulationIndices )
+		{
+			triangulationIndices->Append( (U16)triangles[i] );
+		}
+	}
+
+	return true;
+}
+
+float
+Triangulate::Area( const Vertex2 *contour, int n )
+{
 	float A = 0.0f;
 
 	for( int p = n-1, q = 0; q < n; p = q++ )
@@ -59,141 +233,697 @@ Triangulate::Area( const ArrayVertex2 &contour )
 	return A * 0.5f;
 }
 
-// InsideTriangle decides if point P is Inside of the triangle defined by A, B, C.
-bool
-Triangulate::InsideTriangle(
-	float Ax, float Ay,
-	float Bx, float By,
-	float Cx, float Cy,
-	float Px, float Py )
-{
-	float ax, ay, bx, by, cx, cy, apx, apy, bpx, bpy, cpx, cpy;
-	float cCROSSap, bCROSScp, aCROSSbp;
-
-	ax  = Cx - Bx;	ay  = Cy - By;
-	bx  = Ax - Cx;	by  = Ay - Cy;
-	cx  = Bx - Ax;	cy  = By - Ay;
-	apx = Px - Ax;	apy = Py - Ay;
-	bpx = Px - Bx;	bpy = Py - By;
-	cpx = Px - Cx;	cpy = Py - Cy;
-
-	aCROSSbp = ax*bpy - ay*bpx;
-	cCROSSap = cx*apy - cy*apx;
-	bCROSScp = bx*cpy - by*cpx;
-
-	return ((aCROSSbp >= 0.0f) && (bCROSScp >= 0.0f) && (cCROSSap >= 0.0f));
+// Ring of the vertices in [start, end), in the given winding (clockwise
+// meaning with y down, as on screen)
+Triangulate::Node*
+Triangulate::LinkedList( S32 start, S32 end, bool clockwise )
+{
+	Node *last = NULL;
+
+	if ( clockwise == ( Area( fVertices + start, end - start ) > 0.0f ) )
+	{
+		for ( S32 i = start; i < end; i++ ) { last = InsertNode( i, last ); }
+	}
+	else
+	{
+		for ( S32 i = end - 1; i >= start; i-- ) { last = InsertNode( i, last ); }
+	}
+
+	if ( last && Equals( last, last->next ) )
+	{
+		RemoveNode( last );
+		last = last->next;
+	}
+
+	return last;
+}
+
+namespace /*anonymous*/
+{
+
+struct LeftOf
+{
+	template < typename T >
+	bool operator()( const T *a, const T *b ) const { return a->x < b->x; }
 };
 
-static const float EPSILON=0.0000000001f;
+} // anonymous namespace
 
-bool
-Triangulate::Snip( const ArrayVertex2 &contour, int u, int v, int w, int n, int *V )
+// Links each hole into the outer ring, leftmost hole first
+Triangulate::Node*
+Triangulate::EliminateHoles( const ArrayS32 &holeStarts, S32 contourLength, S32 numVertices, Node *outerNode )
 {
-	int p;
-	float Ax, Ay, Bx, By, Cx, Cy, Px, Py;
+	std::vector< Node* > queue;
+	S32 numHoles = holeStarts.Length();
 
-	Ax = contour[V[u]].x;
-	Ay = contour[V[u]].y;
+	queue.reserve( numHoles );
 
-	Bx = contour[V[v]].x;
-	By = contour[V[v]].y;
+	for ( S32 h = 0; h < numHoles; h++ )
+	{
+		S32 start = contourLength + holeStarts[h];
+		S32 end = ( h + 1 < numHoles ? contourLength + holeStarts[h + 1] : numVertices );
 
-	Cx = contour[V[w]].x;
-	Cy = contour[V[w]].y;
+		Node *list = ( start < end ? LinkedList( start, end, false ) : NULL );
+		if ( list )
+		{
+			if ( list == list->next ) { list->steiner = true; }
+			queue.push_back( GetLeftmost( list ) );
+		}
+	}
 
-	if ( EPSILON > (((Bx-Ax)*(Cy-Ay)) - ((By-Ay)*(Cx-Ax))) ) { return false; }
+	std::sort( queue.begin(), queue.end(), LeftOf() );
 
-	for ( p=0; p < n; p++ )
+	for ( size_t i = 0; i < queue.size(); i++ )
 	{
-		if ( (p == u) || (p == v) || (p == w) ) { continue; }
-		Px = contour[V[p]].x;
-		Py = contour[V[p]].y;
-		if ( InsideTriangle( Ax, Ay, Bx, By, Cx, Cy, Px, Py ) ) { return false; }
+		outerNode = EliminateHole( queue[i], outerNode );
 	}
 
-	return true;
+	return outerNode;
 }
 
-bool
-Triangulate::Process( const ArrayVertex2 &contour, ArrayVertex2 &result, Rect& bounds, ArrayIndex * triangulationIndices )
+Triangulate::Node*
+Triangulate::EliminateHole( Node *hole, Node *outerNode )
 {
-	// allocate and initialize list of Vertices in polygon
-	int n = contour.Length();
-	if ( n < 3 ) return false;
+	Node *bridge = FindHoleBridge( hole, outerNode );
+	if ( ! bridge ) { return outerNode; }
 
-	int *V = new int[n];
+	Node *bridgeReverse = SplitPolygon( bridge, hole );
 
-	// we want a counter-clockwise polygon in V
-	if ( 0.0f < Area(contour) )
+	// filter collinear points around the cuts
+	FilterPoints( bridgeReverse, bridgeReverse->next );
+	return FilterPoints( bridge, bridge->next );
+}
+
+// David Eberly's algorithm for finding a bridge between a hole and the outer ring
+Triangulate::Node*
+Triangulate::FindHoleBridge( Node *hole, Node *outerNode )
+{
+	Node *p = outerNode;
+	double hx = hole->x;
+	double hy = hole->y;
+	double qx = -std::numeric_limits< double >::infinity();
+	Node *m = NULL;
+
+	// find a segment intersected by a ray from the hole's leftmost point to the left;
+	// segment's endpoint with lesser x will be potential connection point
+	do
 	{
-		for ( int v = 0; v < n; v++ )
+		if ( hy <= p->y && hy >= p->next->y && p->next->y != p->y )
 		{
-			V[v] = v;
+			double x = p->x + ( hy - p->y ) * ( p->next->x - p->x ) / ( p->next->y - p->y );
+			if ( x <= hx && x > qx )
+			{
+				qx = x;
+				m = ( p->x < p->next->x ? p : p->next );
+				if ( x == hx ) { return m; } // hole touches outer segment; pick leftmost endpoint
+			}
 		}
+		p = p->next;
 	}
-	else
+	while ( p != outerNode );
+
+	if ( ! m ) { return NULL; }
+
+	// look for points inside the triangle of hole point, segment intersection and endpoint;
+	// if there are no points found, we have a valid connection;
+	// otherwise choose the point of the minimum angle with the ray as connection point
+	const Node *stop = m;
+	double mx = m->x;
+	double my = m->y;
+	double tanMin = std::numeric_limits< double >::infinity();
+
+	p = m;
+
+	do
 	{
-		for ( int v = 0; v < n; v++ )
+		if ( hx >= p->x && p->x >= mx && hx != p->x
+			 && PointInTriangle( hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y ) )
 		{
-			V[v] = (n-1)-v;
+			double tan = fabs( hy - p->y ) / ( hx - p->x ); // tangential
+
+			if ( LocallyInside( p, hole )
+				 && ( tan < tanMin || ( tan == tanMin && ( p->x > m->x || ( p->x == m->x && SectorContainsSector( m, p ) ) ) ) ) )
+			{
+				m = p;
+				tanMin = tan;
+			}
 		}
+
+		p = p->next;
 	}
+	while ( p != stop );
 
-	int nv = n;
+	return m;
+}
 
-	// remove nv-2 Vertices, creating 1 triangle every time
-	int count = 2*nv;   // error detection
+// main ear slicing loop which triangulates a polygon (given as a linked list)
+void
+Triangulate::EarcutLinked( Node *ear, int pass )
+{
+	if ( ! ear ) { return; }
+
+	// interlink polygon nodes in z-order
+	if ( 0 == pass && fInvSize > 0.0 ) { IndexCurve( ear ); }
+
+	Node *stop = ear;
 
-	for ( int m = 0, v = nv-1; nv > 2; )
+	// iterate through ears, slicing them one by one
+	while ( ear->prev != ear->next )
 	{
-		// if we loop, it is probably a non-simple polygon 
-		if (0 >= (count--))
+		Node *prev = ear->prev;
+		Node *next = ear->next;
+
+		if ( fInvSize > 0.0 ? IsEarHashed( ear ) : IsEar( ear ) )
+		{
+			AddTriangle( prev, ear, next );
+
+			RemoveNode( ear );
+
+			// skipping the next vertex leads to less sliver triangles
+			ear = next->next;
+			stop = next->next;
+
+			continue;
+		}
+
+		ear = next;
+
+		// if we looped through the whole remaining polygon and can't find any more ears
+		if ( ear == stop )
+		{
+			if ( 0 == pass )
+			{
+				// try filtering points and slicing again
+				EarcutLinked( FilterPoints( ear ), 1 );
+			}
+			else if ( 1 == pass )
+			{
+				// if this didn't work, try curing all small self-intersections locally
+				ear = CureLocalIntersections( FilterPoints( ear ) );
+				EarcutLinked( ear, 2 );
+			}
+			else if ( 2 == pass )
+			{
+				// as a last resort, try splitting the remaining polygon into two
+				SplitEarcut( ear );
+			}
+
+			break;
+		}
+	}
+}
+
+// check whether a polygon node forms a valid ear with adjacent nodes
+bool
+Triangulate::IsEar( const Node *ear ) const
+{
+	const Node *a = ear->prev;
+	const Node *b = ear;
+	const Node *c = ear->next;
+
+	if ( Area( a, b, c ) >= 0.0 ) { return false; } // reflex, can't be an ear
+
+	// now make sure we don't have other points inside the potential ear
+	double x0 = Min( a->x, Min( b->x, c->x ) ), x1 = Max( a->x, Max( b->x, c->x ) );
+	double y0 = Min( a->y, Min( b->y, c->y ) ), y1 = Max( a->y, Max( b->y, c->y ) );
+
+	for ( const Node *p = c->next; p != a; p = p->next )
+	{
+		if ( p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1
+			 && PointInTriangle( a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y )
+			 && Area( p->prev, p, p->next ) >= 0.0 )
 		{
-			//** Triangulate: ERROR - probable bad polygon!
 			return false;
 		}
+	}
+
+	return true;
+}
+
+bool
+Triangulate::IsEarHashed( const Node *ear ) const
+{
+	const Node *a = ear->prev;
+	const Node *b = ear;
+	const Node *c = ear->next;
+
+	if ( Area( a, b, c ) >= 0.0 ) { return false; } // reflex, can't be an ear
 
-		// three consecutive vertices in current polygon, <u,v,w>
-		int u = v;   if (nv <= u) { u = 0; }	// previous
-		v = u+1;     if (nv <= v) { v = 0; }	// new v   
-		int w = v+1; if (nv <= w) { w = 0; }	// next    
+	double x0 = Min( a->x, Min( b->x, c->x ) ), x1 = Max( a->x, Max( b->x, c->x ) );
+	double y0 = Min( a->y, Min( b->y, c->y ) ), y1 = Max( a->y, Max( b->y, c->y ) );
 
-		if ( Snip( contour, u, v, w, nv, V ) )
+	// z-order range for the current triangle bbox
+	S32 minZ = ZOrder( x0, y0 );
+	S32 maxZ = ZOrder( x1, y1 );
+
+	const Node *p = ear->prevZ;
+	const Node *n = ear->nextZ;
+
+	#define Rtt_POINT_BLOCKS_EAR( q ) \
+		( q->x >= x0 && q->x <= x1 && q->y >= y0 && q->y <= y1 && q != a && q != c \
+		  && PointInTriangle( a->x, a->y, b->x, b->y, c->x, c->y, q->x, q->y ) \
+		  && Area( q->prev, q, q->next ) >= 0.0 )
+
+	// look for points inside the triangle in both directions
+	while ( p && p->z >= minZ && n && n->z <= maxZ )
+	{
+		if ( Rtt_POINT_BLOCKS_EAR( p ) ) { return false; }
+		p = p->prevZ;
+
+		if ( Rtt_POINT_BLOCKS_EAR( n ) ) { return false; }
+		n = n->nextZ;
+	}
+
+	// look for remaining points in decreasing z-order
+	while ( p && p->z >= minZ )
+	{
+		if ( Rtt_POINT_BLOCKS_EAR( p ) ) { return false; }
+		p = p->prevZ;
+	}
+
+	// look for remaining points in increasing z-order
+	while ( n && n->z <= maxZ )
+	{
+		if ( Rtt_POINT_BLOCKS_EAR( n ) ) { return false; }
+		n = n->nextZ;
+	}
+
+	#undef Rtt_POINT_BLOCKS_EAR
+
+	return true;
+}
+
+// go through all polygon nodes and cure small local self-intersections
+Triangulate::Node*
+Triangulate::CureLocalIntersections( Node *start )
+{
+	Node *p = start;
+
+	do
+	{
+		Node *a = p->prev;
+		Node *b = p->next->next;
+
+		if ( ! Equals( a, b ) && Intersects( a, p, p->next, b ) && LocallyInside( a, b ) && LocallyInside( b, a ) )
 		{
-			int a,b,c,s,t;
+			AddTriangle( a, p, b );
 
-			// true names of the vertices
-			a = V[u]; b = V[v]; c = V[w];
+			// remove two nodes involved
+			RemoveNode( p );
+			RemoveNode( p->next );
 
-			// output Triangle
-			result.Append( contour[a] ); bounds.Union( contour[a] );
-			result.Append( contour[b] ); bounds.Union( contour[b] );
-			result.Append( contour[c] ); bounds.Union( contour[c] );
+			p = start = b;
+		}
+
+		p = p->next;
+	}
+	while ( p != start );
 
-            if (triangulationIndices)
-            {
-                triangulationIndices->Append( a );
-                triangulationIndices->Append( b );
-                triangulationIndices->Append( c );
-            }
+	return FilterPoints( p );
+}
 
-			m++;
+// try splitting polygon into two and triangulate them independently
+void
+Triangulate::SplitEarcut( Node *start )
+{
+	// look for a valid diagonal that divides the polygon into two
+	Node *a = start;
 
-			// remove v from remaining polygon
-			for ( s = v, t = v+1; t < nv; s++, t++ )
+	do
+	{
+		Node *b = a->next->next;
+
+		while ( b != a->prev )
+		{
+			if ( a->i != b->i && IsValidDiagonal( a, b ) )
 			{
-				V[s] = V[t];
+				// split the polygon in two by the diagonal
+				Node *c = SplitPolygon( a, b );
+
+				// filter colinear points around the cuts
+				a = FilterPoints( a, a->next );
+				c = FilterPoints( c, c->next );
+
+				// run earcut on each half
+				EarcutLinked( a, 0 );
+				EarcutLinked( c, 0 );
+
+				return;
 			}
-			nv--;
 
-			// resest error detection counter
-			count = 2*nv;
+			b = b->next;
 		}
+
+		a = a->next;
 	}
+	while ( a != start );
+}
+
+void
+Triangulate::AddTriangle( const Node *a, const Node *b, const Node *c )
+{
+	fTriangles.push_back( a->i );
+	fTriangles.push_back( b->i );
+	fTriangles.push_back( c->i );
+}
 
-	delete [] V;
+// interlink polygon nodes in z-order
+void
+Triangulate::IndexCurve( Node *start )
+{
+	Node *p = start;
 
-	return true;
+	do
+	{
+		if ( 0 == p->z ) { p->z = ZOrder( p->x, p->y ); }
+		p->prevZ = p->prev;
+		p->nextZ = p->next;
+		p = p->next;
+	}
+	while ( p != start );
+
+	p->prevZ->nextZ = NULL;
+	p->prevZ = NULL;
+
+	SortLinked( p );
+}
+
+// z-order of a point given coords and inverse of the longer side of data bbox
+S32
+Triangulate::ZOrder( double x, double y ) const
+{
+	// coords are transformed into non-negative 15-bit integer range
+	U32 ix = (U32)( ( x - fMinX ) * fInvSize );
+	U32 iy = (U32)( ( y - fMinY ) * fInvSize );
+
+	ix = ( ix | ( ix << 8 ) ) & 0x00FF00FF;
+	ix = ( ix | ( ix << 4 ) ) & 0x0F0F0F0F;
+	ix = ( ix | ( ix << 2 ) ) & 0x33333333;
+	ix = ( ix | ( ix << 1 ) ) & 0x55555555;
+
+	iy = ( iy | ( iy << 8 ) ) & 0x00FF00FF;
+	iy = ( iy | ( iy << 4 ) ) & 0x0F0F0F0F;
+	iy = ( iy | ( iy << 2 ) ) & 0x33333333;
+	iy = ( iy | ( iy << 1 ) ) & 0x55555555;
+
+	return (S32)( ix | ( iy << 1 ) );
+}
+
+// create a node and optionally link it with previous one (in a circular doubly linked list)
+Triangulate::Node*
+Triangulate::InsertNode( S32 i, Node *last )
+{
+	fNodes.push_back( Node( i, fVertices[i] ) );
+	Node *p = & fNodes.back();
+
+	if ( ! last )
+	{
+		p->prev = p;
+		p->next = p;
+	}
+	else
+	{
+		p->next = last->next;
+		p->prev = last;
+		last->next->prev = p;
+		last->next = p;
+	}
+
+	return p;
+}
+
+// link two polygon vertices with a bridge; if the vertices belong to the same ring, it splits polygon into two;
+// if one belongs to the outer ring and another to a hole, it merges it into a single ring
+Triangulate::Node*
+Triangulate::SplitPolygon( Node *a, Node *b )
+{
+	fNodes.push_back( Node( a->i, fVertices[a->i] ) );
+	Node *a2 = & fNodes.back();
+
+	fNodes.push_back( Node( b->i, fVertices[b->i] ) );
+	Node *b2 = & fNodes.back();
+
+	Node *an = a->next;
+	Node *bp = b->prev;
+
+	a->next = b;
+	b->prev = a;
+
+	a2->next = an;
+	an->prev = a2;
+
+	b2->next = a2;
+	a2->prev = b2;
+
+	bp->next = b2;
+	b2->prev = bp;
+
+	return b2;
+}
+
+// eliminate colinear or duplicate points
+Triangulate::Node*
+Triangulate::FilterPoints( Node *start, Node *end )
+{
+	if ( ! start ) { return start; }
+	if ( ! end ) { end = start; }
+
+	Node *p = start;
+	bool again;
+
+	do
+	{
+		again = false;
+
+		if ( ! p->steiner && ( Equals( p, p->next ) || 0.0 == Area( p->prev, p, p->next ) ) )
+		{
+			RemoveNode( p );
+			p = end = p->prev;
+			if ( p == p->next ) { break; }
+			again = true;
+		}
+		else
+		{
+			p = p->next;
+		}
+	}
+	while ( again || p != end );
+
+	return end;
+}
+
+void
+Triangulate::RemoveNode( Node *p )
+{
+	p->next->prev = p->prev;
+	p->prev->next = p->next;
+
+	if ( p->prevZ ) { p->prevZ->nextZ = p->nextZ; }
+	if ( p->nextZ ) { p->nextZ->prevZ = p->prevZ; }
+}
+
+// Simon Tatham's linked list merge sort algorithm
+// http://www.chiark.greenend.org.uk/~sgtatham/algorithms/listsort.html
+Triangulate::Node*
+Triangulate::SortLinked( Node *list )
+{
+	S32 inSize = 1;
+	S32 numMerges;
+
+	do
+	{
+		Node *p = list;
+		Node *tail = NULL;
+
+		list = NULL;
+		numMerges = 0;
+
+		while ( p )
+		{
+			numMerges++;
+
+			Node *q = p;
+			S32 pSize = 0;
+
+			for ( S32 i = 0; i < inSize; i++ )
+			{
+				pSize++;
+				q = q->nextZ;
+				if ( ! q ) { break; }
+			}
+
+			S32 qSize = inSize;
+
+			while ( pSize > 0 || ( qSize > 0 && q ) )
+			{
+				Node *e;
+
+				if ( pSize != 0 && ( 0 == qSize || ! q || p->z <= q->z ) )
+				{
+					e = p;
+					p = p->nextZ;
+					pSize--;
+				}
+				else
+				{
+					e = q;
+					q = q->nextZ;
+					qSize--;
+				}
+
+				if ( tail ) { tail->nextZ = e; }
+				else { list = e; }
+
+				e->prevZ = tail;
+				tail = e;
+			}
+
+			p = q;
+		}
+
+		tail->nextZ = NULL;
+		inSize *= 2;
+	}
+	while ( numMerges > 1 );
+
+	return list;
+}
+
+// find the leftmost node of a polygon ring
+Triangulate::Node*
+Triangulate::GetLeftmost( Node *start )
+{
+	Node *p = start;
+	Node *leftmost = start;
+
+	do
+	{
+		if ( p->x < leftmost->x || ( p->x == leftmost->x && p->y < leftmost->y ) ) { leftmost = p; }
+		p = p->next;
+	}
+	while ( p != start );
+
+	return leftmost;
+}
+
+// signed area of a triangle
+double
+Triangulate::Area( const Node *p, const Node *q, const Node *r )
+{
+	return ( q->y - p->y ) * ( r->x - q->x ) - ( q->x - p->x ) * ( r->y - q->y );
+}
+
+// check if a point lies within a convex triangle
+bool
+Triangulate::PointInTriangle( double ax, double ay, double bx, double by, double cx, double cy, double px, double py )
+{
+	return ( cx - px ) * ( ay - py ) >= ( ax - px ) * ( cy - py )
+		&& ( ax - px ) * ( by - py ) >= ( bx - px ) * ( ay - py )
+		&& ( bx - px ) * ( cy - py ) >= ( cx - px ) * ( by - py );
+}
+
+// for collinear points p, q, r, check if point q lies on segment pr
+bool
+Triangulate::OnSegment( const Node *p, const Node *q, const Node *r )
+{
+	return q->x <= Max( p->x, r->x ) && q->x >= Min( p->x, r->x )
+		&& q->y <= Max( p->y, r->y ) && q->y >= Min( p->y, r->y );
+}
+
+static int
+Sign( double value )
+{
+	return ( value > 0.0 ) - ( value < 0.0 );
+}
+
+// check if two segments intersect
+bool
+Triangulate::Intersects( const Node *p1, const Node *q1, const Node *p2, const Node *q2 )
+{
+	int o1 = Sign( Area( p1, q1, p2 ) );
+	int o2 = Sign( Area( p1, q1, q2 ) );
+	int o3 = Sign( Area( p2, q2, p1 ) );
+	int o4 = Sign( Area( p2, q2, q1 ) );
+
+	if ( o1 != o2 && o3 != o4 ) { return true; } // general case
+
+	if ( 0 == o1 && OnSegment( p1, p2, q1 ) ) { return true; } // p1, q1 and p2 are collinear and p2 lies on p1q1
+	if ( 0 == o2 && OnSegment( p1, q2, q1 ) ) { return true; } // p1, q1 and q2 are collinear and q2 lies on p1q1
+	if ( 0 == o3 && OnSegment( p2, p1, q2 ) ) { return true; } // p2, q2 and p1 are collinear and p1 lies on p2q2
+	if ( 0 == o4 && OnSegment( p2, q1, q2 ) ) { return true; } // p2, q2 and q1 are collinear and q1 lies on p2q2
+
+	return false;
+}
+
+// check if a polygon diagonal intersects any polygon segments
+bool
+Triangulate::IntersectsPolygon( const Node *a, const Node *b )
+{
+	const Node *p = a;
+
+	do
+	{
+		if ( p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i
+			 && Intersects( p, p->next, a, b ) )
+		{
+			return true;
+		}
+
+		p = p->next;
+	}
+	while ( p != a );
+
+	return false;
+}
+
+// check if a polygon diagonal is locally inside the polygon
+bool
+Triangulate::LocallyInside( const Node *a, const Node *b )
+{
+	return Area( a->prev, a, a->next ) < 0.0
+		? Area( a, b, a->next ) >= 0.0 && Area( a, a->prev, b ) >= 0.0
+		: Area( a, b, a->prev ) < 0.0 || Area( a, a->next, b ) < 0.0;
+}
+
+// check if the middle point of a polygon diagonal is inside the polygon
+bool
+Triangulate::MiddleInside( const Node *a, const Node *b )
+{
+	const Node *p = a;
+	bool inside = false;
+	double px = ( a->x + b->x ) * 0.5;
+	double py = ( a->y + b->y ) * 0.5;
+
+	do
+	{
+		if ( ( ( p->y > py ) != ( p->next->y > py ) ) && p->next->y != p->y
+			 && ( px < ( p->next->x - p->x ) * ( py - p->y ) / ( p->next->y - p->y ) + p->x ) )
+		{
+			inside = ! inside;
+		}
+
+		p = p->next;
+	}
+	while ( p != a );
+
+	return inside;
+}
+
+// check if a diagonal between two polygon nodes is valid (lies in polygon interior)
+bool
+Triangulate::IsValidDiagonal( const Node *a, const Node *b )
+{
+	return a->next->i != b->i && a->prev->i != b->i && ! IntersectsPolygon( a, b ) // doesn't intersect other edges
+		&& ( ( LocallyInside( a, b ) && LocallyInside( b, a ) && MiddleInside( a, b ) // locally visible
+			   && ( 0.0 != Area( a->prev, a, b->prev ) || 0.0 != Area( a, b->prev, b ) ) ) // does not create opposite-facing sectors
+			 || ( Equals( a, b ) && Area( a->prev, a, a->next ) > 0.0 && Area( b->prev, b, b->next ) > 0.0 ) ); // special zero-length case
+}
+
+// whether sector in vertex m contains sector in vertex p in the same coordinates
+bool
+Triangulate::SectorContainsSector( const Node *m, const Node *p )
+{
+	return Area( m->prev, m, p->prev ) < 0.0 && Area( p->next, m, m->next ) < 0.0;
 }
 
 // ----------------------------------------------------------------------------
@@ -201,6 +931,8 @@ Triangulate::Process( const ArrayVertex2 &contour, ArrayVertex2 &result, Rect& b
 TesselatorPolygon::TesselatorPolygon( Rtt_Allocator *allocator )
 :	Super(),
 	fContour( allocator ),
+	fHoles( allocator ),
+	fHoleStarts( allocator ),
 	fFill( allocator ),
 	fSelfBounds(),
 	fCenter( kVertexOrigin ),
@@ -275,6 +1007,57 @@ TesselatorPolygon::GenerateStroke( ArrayVertex2& vertices )
 	t.SetOuterWidth( GetOuterWidth() );
 
 	t.GenerateStroke( vertices );
+
+	// Holes are outlined too, continuing the strip through degenerate triangles
+	S32 numHoles = fHoleStarts.Length();
+	if ( numHoles > 0 )
+	{
+		bool isContourPositive = Triangulate::Area( fContour.ReadAccess(), fContour.Length() ) > 0.0f;
+
+		for ( S32 h = 0; h < numHoles; h++ )
+		{
+			ArrayVertex2 hole( fHoles.Allocator() );
+			GetHole( h, isContourPositive, hole );
+
+			ArrayVertex2 strip( fHoles.Allocator() );
+			TesselatorLine holeStroke( hole, TesselatorLine::kLoopMode );
+			holeStroke.SetInnerWidth( GetInnerWidth() );
+			holeStroke.SetOuterWidth( GetOuterWidth() );
+			holeStroke.GenerateStroke( strip );
+
+			if ( strip.Length() > 0 && vertices.Length() > 0 )
+			{
+				vertices.Append( vertices[vertices.Length() - 1] );
+				vertices.Append( strip[0] );
+			}
+
+			for ( S32 i = 0, iMax = strip.Length(); i < iMax; i++ )
+			{
+				vertices.Append( strip[i] );
+			}
+		}
+	}
+}
+
+void
+TesselatorPolygon::GetHole( S32 index, bool isContourPositive, ArrayVertex2& hole ) const
+{
+	S32 start = fHoleStarts[index];
+	S32 end = ( index + 1 < fHoleStarts.Length() ? fHoleStarts[index + 1] : fHoles.Length() );
+
+	// Wind opposite to the contour, so the stroke's inner side faces the fill
+	bool isHolePositive = Triangulate::Area( fHoles.ReadAccess() + start, end - start ) > 0.0f;
+
+	hole.Reserve( end - start );
+
+	if ( isHolePositive != isContourPositive )
+	{
+		for ( S32 i = start; i < end; i++ ) { hole.Append( fHoles[i] ); }
+	}
+	else
+	{
+		for ( S32 i = end - 1; i >= start; i-- ) { hole.Append( fHoles[i] ); }
+	}
 }
 
 void
@@ -304,6 +1087,18 @@ TesselatorPolygon::FillVertexCount() const
 			dummy.fContour.Append( fContour[i] );
 		}
 
+		dummy.fHoles.Reserve( fHoles.Length() );
+
+		for (int i = 0, iMax = fHoles.Length(); i < iMax; ++i)
+		{
+			dummy.fHoles.Append( fHoles[i] );
+		}
+
+		for (int i = 0, iMax = fHoleStarts.Length(); i < iMax; ++i)
+		{
+			dummy.fHoleStarts.Append( fHoleStarts[i] );
+		}
+
 		dummy.Update();
 
 		fFillCount = S32( dummy.fFill.Length() );
@@ -315,7 +1110,18 @@ TesselatorPolygon::FillVertexCount() const
 U32
 TesselatorPolygon::StrokeVertexCount() const
 {
-	return TesselatorLine::VertexCountFromPoints( fContour, true );
+	U32 count = TesselatorLine::VertexCountFromPoints( fContour, true );
+
+	for ( S32 h = 0, hMax = fHoleStarts.Length(); h < hMax; h++ )
+	{
+		S32 end = ( h + 1 < hMax ? fHoleStarts[h + 1] : fHoles.Length() );
+		S32 numPoints = end - fHoleStarts[h];
+
+		// Two degenerate vertices join each hole's strip to the previous one
+		count += TesselatorLine::VertexCountFromPoints( numPoints, true ) + 2;
+	}
+
+	return count;
 }
 
 void
@@ -323,6 +1129,7 @@ TesselatorPolygon::Invalidate()
 {
 	fIsFillValid = false;
 	fIsBadPolygon = false;
+	fFillCount = -1;
 }
 
 void
@@ -340,7 +1147,9 @@ TesselatorPolygon::Update()
             fTriangulationIndices->Clear();
         }
 
-		fIsFillValid = Triangulate::Process( fContour, fFill, fSelfBounds, fTriangulationIndices );
+		fFill.Empty();
+
+		fIsFillValid = Triangulate::Process( fContour, fHoles, fHoleStarts, fFill, fSelfBounds, fTriangulationIndices );
 		fIsBadPolygon = ! fIsFillValid;
 
 		if ( fIsFillValid )
@@ -45,6 +45,11 @@ class TesselatorPolygon : public TesselatorShape
 		void Invalidate();
 
 		ArrayVertex2& GetContour() { return fContour; }
+
+		// Hole outlines, back to back. Each entry in GetHoleStarts() is the
+		// index in GetHoles() where a hole begins.
+		ArrayVertex2& GetHoles() { return fHoles; }
+		ArrayS32& GetHoleStarts() { return fHoleStarts; }
     
         void SetTriangulationArray( ArrayIndex * triangulationIndices ) { fTriangulationIndices = triangulationIndices; }
 
@@ -52,8 +57,13 @@ class TesselatorPolygon : public TesselatorShape
 		// Update the polygons
 		void Update();
 
+		// Copy of a hole, wound opposite to a contour with the given sign of area
+		void GetHole( S32 index, bool isContourPositive, ArrayVertex2& hole ) const;
+
 	private:
 		ArrayVertex2 fContour;
+		ArrayVertex2 fHoles;
+		ArrayS32 fHoleStarts;
 		ArrayVertex2 fFill; // cache the fill
 		Rect fSelfBounds;
 		Vertex2 fCenter;
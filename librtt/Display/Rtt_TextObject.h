@@ -86,6 +86,7 @@ class TextObject : public RectObject
 		virtual void GetSelfBounds( Rect& rect ) const;
 		virtual void Prepare( const Display& display );
 		virtual void Draw( Renderer& renderer ) const;
+		virtual bool CanUpdateConcurrently() const { return false; } // rasterizes via the platform
 
 	public:
 		virtual const LuaProxyVTable& ProxyVTable() const;
@@ -0,0 +1,366 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Display/Rtt_TextureAtlas.h"
+
+#include "Core/Rtt_Math.h"
+#include "Display/Rtt_BufferBitmap.h"
+#include "Display/Rtt_Display.h"
+#include "Display/Rtt_ImageFrame.h"
+#include "Display/Rtt_ImageSheet.h"
+#include "Display/Rtt_TextureFactory.h"
+#include "Display/Rtt_TextureResourceBitmap.h"
+#include "Renderer/Rtt_Texture.h"
+
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Each image is surrounded by a copy of its edge pixels
+static const U32 kPadding = 1;
+
+TextureAtlas::TextureAtlas( TextureFactory& factory, U32 pageSize, U32 maxImageSize, U32 maxPages )
+:	fFactory( factory ),
+	fPageSize( pageSize ),
+	fMaxImageSize( Min( maxImageSize, pageSize - 2 * kPadding ) ),
+	fMaxPages( maxPages ),
+	fPages(),
+	fLocations()
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+	Empty();
+}
+
+bool
+TextureAtlas::Find( const std::string& key, const AutoPtr< ImageSheet > *& sheet, S32& frameIndex ) const
+{
+	std::map< std::string, Location >::const_iterator element = fLocations.find( key );
+
+	if ( element == fLocations.end() )
+	{
+		return false;
+	}
+
+	sheet = & element->second.fPage->fSheet;
+	frameIndex = element->second.fFrame;
+
+	return true;
+}
+
+bool
+TextureAtlas::Add( const std::string& key, const PlatformBitmap& bitmap, bool isRetina, const AutoPtr< ImageSheet > *& sheet, S32& frameIndex )
+{
+	U32 w = bitmap.Width();
+	U32 h = bitmap.Height();
+
+	if ( 0 == w || 0 == h || w > fMaxImageSize || h > fMaxImageSize )
+	{
+		return false;
+	}
+
+	// Pages hold 4 byte pixels, in the layout the images are decoded to
+	switch ( bitmap.GetFormat() )
+	{
+		case PlatformBitmap::kRGBA:
+		case PlatformBitmap::kBGRA:
+		case PlatformBitmap::kABGR:
+		case PlatformBitmap::kARGB:
+			break;
+		default:
+			return false;
+	}
+
+	// Frames can't be rotated, and repeating fills need a texture of their own
+	if ( 0 != bitmap.DegreesToUprightBits()
+		 || RenderTypes::kClampToEdgeWrap != bitmap.GetWrapX()
+		 || RenderTypes::kClampToEdgeWrap != bitmap.GetWrapY() )
+	{
+		return false;
+	}
+
+	U32 paddedW = w + 2 * kPadding;
+	U32 paddedH = h + 2 * kPadding;
+
+	Page *page = NULL;
+	size_t node = 0;
+	U32 x = 0, y = 0;
+
+	for ( size_t i = 0, iMax = fPages.size(); i < iMax && NULL == page; i++ )
+	{
+		Page *candidate = fPages[i];
+
+		if ( IsCompatible( * candidate, bitmap, isRetina ) && Fit( * candidate, fPageSize, paddedW, paddedH, node, x, y ) )
+		{
+			page = candidate;
+		}
+	}
+
+	if ( NULL == page )
+	{
+		if ( fPages.size() >= fMaxPages )
+		{
+			return false;
+		}
+
+		page = NewPage( bitmap, isRetina );
+		fPages.push_back( page );
+
+		if ( ! Rtt_VERIFY( Fit( * page, fPageSize, paddedW, paddedH, node, x, y ) ) )
+		{
+			return false;
+		}
+	}
+
+	Insert( * page, node, x, y, paddedW, paddedH );
+	Copy( fFactory.GetDisplay().GetAllocator(), bitmap, * page->fBitmap, x, y );
+	page->fIsDirty = true;
+
+	ImageSheet& pageSheet = * page->fSheet;
+	Location location = { page, pageSheet.GetNumFrames() };
+
+	ImageFrame *frame = Rtt_NEW( fFactory.GetDisplay().GetAllocator(),
+		ImageFrame( pageSheet, x + kPadding, y + kPadding, w, h, Rtt_REAL_1, Rtt_REAL_1, false ) );
+	pageSheet.AppendFrame( frame );
+
+	fLocations[key] = location;
+
+	sheet = & page->fSheet;
+	frameIndex = location.fFrame;
+
+	return true;
+}
+
+void
+TextureAtlas::Invalidate()
+{
+	for ( size_t i = 0, iMax = fPages.size(); i < iMax; i++ )
+	{
+		Page *page = fPages[i];
+
+		if ( page->fIsDirty )
+		{
+			// No-op until the texture is first drawn, which uploads all of it
+			page->fSheet->GetTextureResource()->GetTexture().Invalidate();
+			page->fIsDirty = false;
+		}
+	}
+}
+
+void
+TextureAtlas::ReleaseUnused()
+{
+	for ( size_t i = 0; i < fPages.size(); )
+	{
+		Page *page = fPages[i];
+
+		// Each object showing an image holds the page's texture, as the
+		// sheet does
+		if ( ! page->fSheet->GetTextureResource().IsUnique() )
+		{
+			++i;
+			continue;
+		}
+
+		for ( std::map< std::string, Location >::iterator it = fLocations.begin(); it != fLocations.end(); )
+		{
+			if ( it->second.fPage == page )
+			{
+				fLocations.erase( it++ );
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		Rtt_DELETE( page );
+		fPages.erase( fPages.begin() + i );
+	}
+}
+
+void
+TextureAtlas::Empty()
+{
+	for ( size_t i = 0, iMax = fPages.size(); i < iMax; i++ )
+	{
+		Rtt_DELETE( fPages[i] );
+	}
+
+	fPages.clear();
+	fLocations.clear();
+}
+
+bool
+TextureAtlas::IsCompatible( const Page& page, const PlatformBitmap& bitmap, bool isRetina ) const
+{
+	const BufferBitmap& pageBitmap = * page.fBitmap;
+
+	return pageBitmap.GetFormat() == bitmap.GetFormat()
+		&& pageBitmap.IsPremultiplied() == bitmap.IsPremultiplied()
+		&& pageBitmap.GetMagFilter() == bitmap.GetMagFilter()
+		&& pageBitmap.GetMinFilter() == bitmap.GetMinFilter()
+		&& page.fIsRetina == isRetina;
+}
+
+TextureAtlas::Page*
+TextureAtlas::NewPage( const PlatformBitmap& bitmap, bool isRetina )
+{
+	Rtt_Allocator *allocator = fFactory.GetDisplay().GetAllocator();
+
+	BufferBitmap *pageBitmap = Rtt_NEW( allocator, BufferBitmap( allocator, fPageSize, fPageSize, bitmap.GetFormat(), PlatformBitmap::kUp ) );
+	memset( pageBitmap->WriteAccess(), 0, pageBitmap->NumBytes() );
+
+	pageBitmap->SetProperty( PlatformBitmap::kIsPremultiplied, bitmap.IsPremultiplied() );
+	pageBitmap->SetMagFilter( bitmap.GetMagFilter() );
+	pageBitmap->SetMinFilter( bitmap.GetMinFilter() );
+	pageBitmap->SetWrapX( RenderTypes::kClampToEdgeWrap );
+	pageBitmap->SetWrapY( RenderTypes::kClampToEdgeWrap );
+
+	SharedPtr< TextureResource > resource( TextureResourceBitmap::Create( fFactory, pageBitmap, isRetina ) );
+
+	Page *result = Rtt_NEW( allocator, Page( allocator, Rtt_NEW( allocator, ImageSheet( allocator, resource ) ), pageBitmap, isRetina ) );
+
+	SkylineNode bottom = { 0, 0, fPageSize };
+	result->fSkyline.push_back( bottom );
+
+	return result;
+}
+
+bool
+TextureAtlas::Fit( const Page& page, U32 pageSize, U32 w, U32 h, size_t& node, U32& x, U32& y )
+{
+	const std::vector< SkylineNode >& skyline = page.fSkyline;
+	U32 bestBottom = pageSize + 1;
+	U32 bestWidth = pageSize + 1;
+
+	for ( size_t i = 0, iMax = skyline.size(); i < iMax; i++ )
+	{
+		U32 left = skyline[i].fX;
+
+		if ( left + w > pageSize )
+		{
+			break;
+		}
+
+		// Rest on the highest of the nodes spanned
+		U32 top = 0;
+		for ( size_t j = i, remaining = w; remaining > 0; j++ )
+		{
+			top = Max( top, skyline[j].fY );
+			remaining -= Min< size_t >( remaining, skyline[j].fWidth );
+		}
+
+		U32 bottom = top + h;
+
+		if ( bottom <= pageSize && ( bottom < bestBottom || ( bottom == bestBottom && skyline[i].fWidth < bestWidth ) ) )
+		{
+			bestBottom = bottom;
+			bestWidth = skyline[i].fWidth;
+			node = i;
+			x = left;
+			y = top;
+		}
+	}
+
+	return bestBottom <= pageSize;
+}
+
+void
+TextureAtlas::Insert( Page& page, size_t node, U32 x, U32 y, U32 w, U32 h )
+{
+	std::vector< SkylineNode >& skyline = page.fSkyline;
+
+	SkylineNode added = { x, y + h, w };
+	skyline.insert( skyline.begin() + node, added );
+
+	// Trim what the new node covers
+	for ( size_t i = node + 1; i < skyline.size(); )
+	{
+		U32 right = skyline[i - 1].fX + skyline[i - 1].fWidth;
+
+		if ( skyline[i].fX >= right )
+		{
+			break;
+		}
+
+		U32 overlap = right - skyline[i].fX;
+
+		if ( overlap >= skyline[i].fWidth )
+		{
+			skyline.erase( skyline.begin() + i );
+		}
+		else
+		{
+			skyline[i].fX += overlap;
+			skyline[i].fWidth -= overlap;
+			break;
+		}
+	}
+
+	// Merge neighbors at the same height
+	for ( size_t i = 0; i + 1 < skyline.size(); )
+	{
+		if ( skyline[i].fY == skyline[i + 1].fY )
+		{
+			skyline[i].fWidth += skyline[i + 1].fWidth;
+			skyline.erase( skyline.begin() + i + 1 );
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+void
+TextureAtlas::Copy( Rtt_Allocator *allocator, const PlatformBitmap& src, BufferBitmap& dst, U32 x, U32 y )
+{
+	const size_t kBytesPerPixel = 4;
+
+	U32 w = src.Width();
+	U32 h = src.Height();
+	const U8 *srcBits = (const U8 *)src.GetBits( allocator );
+	U8 *dstBits = (U8 *)dst.WriteAccess();
+
+	size_t srcStride = w * kBytesPerPixel;
+	size_t dstStride = dst.Width() * kBytesPerPixel;
+
+	// Rows -1 and h repeat the first and last rows
+	for ( S32 row = -(S32)kPadding; row < (S32)( h + kPadding ); row++ )
+	{
+		S32 srcRow = Clamp< S32 >( row, 0, (S32)h - 1 );
+		const U8 *srcLine = srcBits + srcRow * srcStride;
+		U8 *dstLine = dstBits + ( y + kPadding + row ) * dstStride + x * kBytesPerPixel;
+
+		for ( U32 i = 0; i < kPadding; i++ )
+		{
+			memcpy( dstLine + i * kBytesPerPixel, srcLine, kBytesPerPixel );
+			memcpy( dstLine + ( kPadding + w + i ) * kBytesPerPixel, srcLine + srcStride - kBytesPerPixel, kBytesPerPixel );
+		}
+
+		memcpy( dstLine + kPadding * kBytesPerPixel, srcLine, srcStride );
+	}
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
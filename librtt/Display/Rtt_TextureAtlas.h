@@ -0,0 +1,134 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_TextureAtlas_H__
+#define _Rtt_TextureAtlas_H__
+
+#include "Core/Rtt_AutoPtr.h"
+#include "Core/Rtt_Types.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+class BufferBitmap;
+class ImageSheet;
+class PlatformBitmap;
+class TextureFactory;
+
+// ----------------------------------------------------------------------------
+
+// Packs small images into shared pages, so that display objects showing
+// different images can still be drawn in one batch. Each page is an
+// ImageSheet that gains a frame per image, so objects use the pages via
+// ImageSheetPaint like any other sheet. Images are padded by a copy of
+// their edge pixels, so filtering never picks up a neighbor.
+//
+// As with any sheet frame, an object's texture coordinates span only its
+// image's rectangle in the page, not 0-1. Effects that read or offset UVs,
+// and fill.x/y, scaleX/Y and rotation, see those sub-rect coordinates.
+//
+// Space is not reused within a page; a page is freed once no object shows
+// any of its images. Past 'maxPages' pages, images that don't fit are left
+// to go on their own.
+class TextureAtlas
+{
+	public:
+		TextureAtlas( TextureFactory& factory, U32 pageSize, U32 maxImageSize, U32 maxPages );
+		~TextureAtlas();
+
+	public:
+		// Frame for an image added earlier under 'key'. 'sheet' points to the
+		// page's sheet, which stays valid until Empty().
+		bool Find( const std::string& key, const AutoPtr< ImageSheet > *& sheet, S32& frameIndex ) const;
+
+		// Copies the bitmap into a page with room for it. Returns false if it
+		// is too big or its pixels can't go in a page, e.g. a mask or an image
+		// that is not upright, or if no page has room and there are already
+		// as many as allowed; the bitmap is then best used on its own.
+		bool Add( const std::string& key, const PlatformBitmap& bitmap, bool isRetina, const AutoPtr< ImageSheet > *& sheet, S32& frameIndex );
+
+		// Queues pages that gained images since the last call for upload
+		void Invalidate();
+
+		// Frees pages that no object shows, along with their images
+		void ReleaseUnused();
+
+		// Forgets all pages. Objects still showing images keep their page
+		// alive; new images go to new pages.
+		void Empty();
+
+		U32 GetPageSize() const { return fPageSize; }
+		U32 GetMaxImageSize() const { return fMaxImageSize; }
+		U32 GetMaxPages() const { return fMaxPages; }
+		S32 GetNumPages() const { return (S32)fPages.size(); }
+
+	protected:
+		// Top edge of the packed area over [fX, fX + fWidth)
+		struct SkylineNode
+		{
+			U32 fX;
+			U32 fY;
+			U32 fWidth;
+		};
+
+		struct Page
+		{
+			Page( Rtt_Allocator *allocator, ImageSheet *sheet, BufferBitmap *bitmap, bool isRetina )
+			:	fSheet( allocator, sheet ),
+				fBitmap( bitmap ),
+				fSkyline(),
+				fIsRetina( isRetina ),
+				fIsDirty( false )
+			{
+			}
+
+			AutoPtr< ImageSheet > fSheet;
+			BufferBitmap *fBitmap; // Owned by the sheet's texture
+			std::vector< SkylineNode > fSkyline;
+			bool fIsRetina;
+			bool fIsDirty;
+		};
+
+		struct Location
+		{
+			Page *fPage;
+			S32 fFrame;
+		};
+
+		bool IsCompatible( const Page& page, const PlatformBitmap& bitmap, bool isRetina ) const;
+		Page* NewPage( const PlatformBitmap& bitmap, bool isRetina );
+
+		// Bottom-left skyline fit. Returns false if the page is too full
+		static bool Fit( const Page& page, U32 pageSize, U32 w, U32 h, size_t& node, U32& x, U32& y );
+		static void Insert( Page& page, size_t node, U32 x, U32 y, U32 w, U32 h );
+
+		static void Copy( Rtt_Allocator *allocator, const PlatformBitmap& src, BufferBitmap& dst, U32 x, U32 y );
+
+	private:
+		TextureFactory& fFactory;
+		U32 fPageSize;
+		U32 fMaxImageSize;
+		U32 fMaxPages;
+		std::vector< Page* > fPages;
+		std::map< std::string, Location > fLocations;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_TextureAtlas_H__
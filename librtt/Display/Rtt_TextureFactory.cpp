@@ -10,11 +10,15 @@
 #include "Core/Rtt_Build.h"
 
 #include "Core/Rtt_String.h"
+#include "Core/Rtt_Time.h"
+#include "Core/Rtt_TraceRecorder.h"
 #include "Display/Rtt_BufferBitmap.h"
 #include "Display/Rtt_Display.h"
 #include "Display/Rtt_DisplayDefaults.h"
 #include "Display/Rtt_PlatformBitmap.h"
+#include "Display/Rtt_ImageSheet.h"
 #include "Display/Rtt_Scene.h"
+#include "Display/Rtt_TextureAtlas.h"
 #include "Display/Rtt_TextureFactory.h"
 #include "Display/Rtt_TextureResource.h"
 #include "Renderer/Rtt_Renderer.h"
@@ -25,11 +29,18 @@
 #include "Display/Rtt_TextureResourceCapture.h"
 #include "Display/Rtt_TextureResourceExternal.h"
 
+#include "Rtt_Event.h"
 #include "Rtt_FilePath.h"
+#include "Rtt_LuaResource.h"
 #include "Rtt_MPlatform.h"
 #include "Rtt_Runtime.h"
 #include "CoronaLua.h"
 
+#include <condition_variable>
+#include <string.h>
+#include <mutex>
+#include <thread>
+
 // ----------------------------------------------------------------------------
 
 namespace Rtt
@@ -37,20 +48,278 @@ namespace Rtt
 
 // ----------------------------------------------------------------------------
 
+// One file of a TextureFactory::LoadAsync() call
+struct TextureLoadItem
+{
+	TextureLoadBatch *fBatch;
+	std::string fKey;
+	U32 fFlags;
+	bool fIsMask;
+	bool fIsRetina;
+	PlatformBitmap *fBitmap; // Decoded, until UpdateLoads() takes it
+	SharedPtr< TextureResource > fResource;
+};
+
+class TextureLoadBatch
+{
+	Rtt_CLASS_NO_COPIES( TextureLoadBatch )
+
+	public:
+		TextureLoadBatch( U32 count, LuaResource *listener )
+		:	fItems( count ),
+			fListener( listener ),
+			fNumPending( 0 )
+		{
+		}
+
+		~TextureLoadBatch()
+		{
+			for ( size_t i = 0; i < fItems.size(); i++ )
+			{
+				Rtt_DELETE( fItems[i].fBitmap );
+			}
+
+			Rtt_DELETE( fListener );
+		}
+
+	public:
+		std::vector< TextureLoadItem > fItems;
+		LuaResource *fListener;
+		U32 fNumPending;
+};
+
+// ----------------------------------------------------------------------------
+
+// Decodes the files of TextureLoadBatches. Given a thread of its own, it
+// decodes one file at a time there, leaving the shared WorkerPool to the
+// main thread's ParallelFor() calls; otherwise, the caller of TakeDecoded()
+// decodes for a few milliseconds at a time.
+class TextureLoader
+{
+	Rtt_CLASS_NO_COPIES( TextureLoader )
+
+	public:
+		TextureLoader( const MPlatform& platform, bool isThreaded );
+		~TextureLoader();
+
+	public:
+		void Add( TextureLoadItem *item );
+		void TakeDecoded( std::vector< TextureLoadItem* >& decoded );
+
+	private:
+		void Decode( TextureLoadItem *item ) const;
+		void Run();
+
+	private:
+		const MPlatform& fPlatform;
+		std::mutex fMutex;
+		std::condition_variable fWake;
+		std::vector< TextureLoadItem* > fPending;
+		std::vector< TextureLoadItem* > fDecoded;
+		bool fShouldQuit;
+		std::thread fThread;
+};
+
+// Time the main thread spends decoding per frame, when it has to
+static const U64 kMainThreadDecodeMS = 4;
+
+TextureLoader::TextureLoader( const MPlatform& platform, bool isThreaded )
+:	fPlatform( platform ),
+	fMutex(),
+	fWake(),
+	fPending(),
+	fDecoded(),
+	fShouldQuit( false ),
+	fThread()
+{
+	if ( isThreaded )
+	{
+		fThread = std::thread( & TextureLoader::Run, this );
+	}
+}
+
+TextureLoader::~TextureLoader()
+{
+	if ( fThread.joinable() )
+	{
+		{
+			std::lock_guard< std::mutex > lock( fMutex );
+			fShouldQuit = true;
+		}
+		fWake.notify_one();
+
+		fThread.join();
+	}
+}
+
+void
+TextureLoader::Add( TextureLoadItem *item )
+{
+	{
+		std::lock_guard< std::mutex > lock( fMutex );
+		fPending.push_back( item );
+	}
+	fWake.notify_one();
+}
+
+void
+TextureLoader::TakeDecoded( std::vector< TextureLoadItem* >& decoded )
+{
+	std::lock_guard< std::mutex > lock( fMutex );
+
+	if ( ! fThread.joinable() )
+	{
+		Rtt_AbsoluteTime start = Rtt_GetAbsoluteTime();
+		size_t count = 0;
+
+		while ( count < fPending.size() )
+		{
+			Decode( fPending[count] );
+			fDecoded.push_back( fPending[count] );
+			++count;
+
+			if ( Rtt_AbsoluteToMilliseconds( Rtt_GetAbsoluteTime() - start ) >= kMainThreadDecodeMS )
+			{
+				break;
+			}
+		}
+
+		fPending.erase( fPending.begin(), fPending.begin() + count );
+	}
+
+	decoded.insert( decoded.end(), fDecoded.begin(), fDecoded.end() );
+	fDecoded.clear();
+}
+
+void
+TextureLoader::Decode( TextureLoadItem *item ) const
+{
+	const char* key = item->fKey.c_str();
+	const char* fileName = strrchr( key, '/' );
+	TraceScope trace( "Decode", fileName ? fileName + 1 : key );
+
+	item->fBitmap = fPlatform.CreateBitmap( item->fKey.c_str(), item->fIsMask );
+}
+
+void
+TextureLoader::Run()
+{
+	TraceRecorder::SetThreadName( "Texture Loader" );
+
+	for ( ;; )
+	{
+		TextureLoadItem *item = NULL;
+
+		{
+			std::unique_lock< std::mutex > lock( fMutex );
+			fWake.wait( lock, [this]{ return fShouldQuit || ! fPending.empty(); } );
+
+			if ( fShouldQuit )
+			{
+				break;
+			}
+
+			item = fPending.front();
+			fPending.erase( fPending.begin() );
+		}
+
+		// Each file is handed over as soon as it's ready
+		Decode( item );
+
+		{
+			std::lock_guard< std::mutex > lock( fMutex );
+			fDecoded.push_back( item );
+		}
+	}
+}
+
+// ----------------------------------------------------------------------------
+
+// Sent to the listener of TextureFactory::LoadAsync()
+class TextureLoadEvent : public CompletionEvent
+{
+	public:
+		typedef CompletionEvent Super;
+
+	public:
+		TextureLoadEvent( const TextureLoadBatch& batch )
+		:	fBatch( batch )
+		{
+		}
+
+	public:
+		virtual int Push( lua_State *L ) const;
+
+	private:
+		const TextureLoadBatch& fBatch;
+};
+
+int
+TextureLoadEvent::Push( lua_State *L ) const
+{
+	if ( Rtt_VERIFY( Super::Push( L ) ) )
+	{
+		bool isError = false;
+
+		// In request order, false where a file failed to load
+		lua_createtable( L, (int)fBatch.fItems.size(), 0 );
+		for ( size_t i = 0; i < fBatch.fItems.size(); i++ )
+		{
+			const SharedPtr< TextureResource >& resource = fBatch.fItems[i].fResource;
+
+			if ( resource.NotNull() )
+			{
+				resource->PushProxy( L );
+			}
+			else
+			{
+				lua_pushboolean( L, 0 );
+				isError = true;
+			}
+
+			lua_rawseti( L, -2, (int)i + 1 );
+		}
+		lua_setfield( L, -2, "textures" );
+
+		lua_pushboolean( L, isError );
+		lua_setfield( L, -2, "isError" );
+	}
+
+	return 1;
+}
+
+// ----------------------------------------------------------------------------
+
 TextureFactory::TextureFactory( Display& display )
 :	fCache(),
+	fCreateQueue( display.GetAllocator() ),
 	fDisplay( display ),
 	fDefault(),
 	fContainerMask(),
 	fVideo(),
 	fVideoSource(kCamera),
 	fTextureMemoryUsed( 0 ),
-	fCreateQueue( display.GetAllocator() )
+	fLoader( NULL ),
+	fLoadBatches(),
+	fRecentTextures(),
+	fRecentTexturesIndex(),
+	fRecentTexturesBudget( 0 ),
+	fAtlas( NULL )
 {
+	memset( & fCacheStats, 0, sizeof( fCacheStats ) );
 }
 
 TextureFactory::~TextureFactory()
 {
+	// Stop decoding before the batches go away
+	Rtt_DELETE( fLoader );
+	Rtt_DELETE( fAtlas );
+
+	for ( size_t i = 0; i < fLoadBatches.size(); i++ )
+	{
+		Rtt_DELETE( fLoadBatches[i] );
+	}
+
 	fCreateQueue.Empty();
 }
 
@@ -86,14 +355,23 @@ TextureFactory::CreateBitmap(
 	}
 
 	// Load the given image file.
-	const Display& display = fDisplay;
-	const MPlatform& platform = display.GetRuntime().Platform();
+	const MPlatform& platform = fDisplay.GetRuntime().Platform();
 	PlatformBitmap* pBitmap = platform.CreateBitmap( filePath, convertToGrayscale );
 	if (!pBitmap)
 	{
 		return NULL;
 	}
 
+	ConfigureBitmap( pBitmap, filePath, flags );
+
+	return pBitmap;
+}
+
+void
+TextureFactory::ConfigureBitmap( PlatformBitmap *pBitmap, const char *filePath, U32 flags )
+{
+	const Display& display = fDisplay;
+
 #ifdef Rtt_AUTHORING_SIMULATOR
 
 	const DisplayDefaults &defaults = display.GetDefaults();
@@ -136,8 +414,6 @@ TextureFactory::CreateBitmap(
 			}
 		}
 	}
-
-	return pBitmap;
 }
 
 SharedPtr< TextureResource >
@@ -209,6 +485,12 @@ TextureFactory::CreateAndAdd( const std::string& key,
 void
 TextureFactory::Preload( Renderer& renderer )
 {
+	if ( fAtlas )
+	{
+		fAtlas->ReleaseUnused();
+		fAtlas->Invalidate();
+	}
+
 	for ( int i = 0; i < fCreateQueue.Length(); i++ )
 	{
 		const WeakPtr< TextureResource > item = fCreateQueue[i];
@@ -246,6 +528,45 @@ TextureFactory::FindOrCreate(
 	}
 
 	bool isRetina = false;
+	std::string key;
+
+	if ( ! KeyForFile( key, isRetina, filename, baseDir, flags ) )
+	{
+		Rtt_ASSERT( result.IsNull() );
+		return result;
+	}
+
+	// Lookup cache
+	result = Find( key );
+
+	// Create on a cache miss
+	// NOTE: Even if we found an entry, it could still be null.
+	if ( result.IsNull() )
+	{
+		PlatformBitmap *bitmap = CreateBitmap( key.c_str(), flags, isMask );
+		result = CreateAndAdd( key, bitmap, true, isRetina );
+
+		++fCacheStats.fMisses;
+	}
+	else
+	{
+		++fCacheStats.fHits;
+	}
+
+	TouchRecentTexture( result );
+
+	return result;
+}
+
+bool
+TextureFactory::KeyForFile(
+	std::string& key,
+	bool& isRetina,
+	const char *filename,
+	MPlatform::Directory baseDir,
+	U32 flags )
+{
+	isRetina = false;
 
 	// Check for a higher resolution image file using Corona's special suffix notation.
 	String suffixedFilename( fDisplay.GetAllocator() );
@@ -265,23 +586,13 @@ TextureFactory::FindOrCreate(
 	{
         CoronaLuaWarning(fDisplay.GetL(), "Failed to find image '%s'", filename);
 
-		Rtt_ASSERT( result.IsNull() );
-		return result;
+		return false;
 	}
 
-	// Lookup cache
-	std::string key( filePath.GetString() );
-	result = Find( key );
-
-	// Create on a cache miss
-	// NOTE: Even if we found an entry, it could still be null.
-	if ( result.IsNull() )
-	{
-		PlatformBitmap *bitmap = CreateBitmap( filePath.GetString(), flags, isMask );
-		result = CreateAndAdd( key, bitmap, true, isRetina );
-	}
+	// The absolute path doubles as the cache key
+	key = filePath.GetString();
 
-	return result;
+	return true;
 }
 
 SharedPtr< TextureResource >
@@ -324,6 +635,135 @@ TextureFactory::FindOrCreate(
 	return result;
 }
 
+void
+TextureFactory::LoadAsync( const LoadRequest *requests, U32 count, LuaResource *listener )
+{
+	// Same as graphics.newTexture()
+	const U32 flags = PlatformBitmap::kIsNearestAvailablePixelDensity | PlatformBitmap::kIsBitsFullResolution;
+
+	if ( ! fLoader )
+	{
+		const MPlatform& platform = fDisplay.GetRuntime().Platform();
+		bool isThreaded = platform.CanCreateBitmapsConcurrently();
+
+#if defined( Rtt_EMSCRIPTEN_ENV )
+		isThreaded = false;
+#endif
+
+		fLoader = Rtt_NEW( fDisplay.GetAllocator(), TextureLoader( platform, isThreaded ) );
+	}
+
+	TextureLoadBatch *batch = Rtt_NEW( fDisplay.GetAllocator(), TextureLoadBatch( count, listener ) );
+
+	fLoadBatches.push_back( batch );
+
+	for ( U32 i = 0; i < count; i++ )
+	{
+		TextureLoadItem& item = batch->fItems[i];
+
+		item.fBatch = batch;
+		item.fFlags = flags;
+		item.fIsMask = requests[i].isMask;
+		item.fBitmap = NULL;
+
+		// Cached files and ones not found are done already
+		if ( KeyForFile( item.fKey, item.fIsRetina, requests[i].filename, requests[i].baseDir, flags ) )
+		{
+			item.fResource = Find( item.fKey );
+
+			if ( item.fResource.IsNull() )
+			{
+				++batch->fNumPending;
+				fLoader->Add( & item );
+			}
+			else
+			{
+				++fCacheStats.fHits;
+
+				Retain( item.fResource );
+				TouchRecentTexture( item.fResource );
+			}
+		}
+	}
+}
+
+void
+TextureFactory::UpdateLoads()
+{
+	if ( fLoadBatches.empty() )
+	{
+		return;
+	}
+
+	std::vector< TextureLoadItem* > decoded;
+	fLoader->TakeDecoded( decoded );
+
+	for ( size_t i = 0; i < decoded.size(); i++ )
+	{
+		TextureLoadItem& item = * decoded[i];
+		PlatformBitmap *bitmap = item.fBitmap;
+
+		item.fBitmap = NULL;
+
+		// The file may have been loaded synchronously in the meantime
+		SharedPtr< TextureResource > result = Find( item.fKey );
+
+		if ( result.NotNull() )
+		{
+			Rtt_DELETE( bitmap );
+
+			++fCacheStats.fHits;
+		}
+		else if ( bitmap )
+		{
+			ConfigureBitmap( bitmap, item.fKey.c_str(), item.fFlags );
+			result = CreateAndAdd( item.fKey, bitmap, true, item.fIsRetina );
+
+			// Upload at the next render, unless CreateAndAdd() queued it already
+			if ( ! fDisplay.GetDefaults().ShouldPreloadTextures() )
+			{
+				AddToPreloadQueue( result );
+			}
+
+			++fCacheStats.fMisses;
+		}
+
+		item.fResource = result;
+		Retain( result );
+		TouchRecentTexture( result );
+
+		Rtt_ASSERT( item.fBatch->fNumPending > 0 );
+		--item.fBatch->fNumPending;
+	}
+
+	// Listeners may start new loads, so take finished batches out first
+	std::vector< TextureLoadBatch* > finished;
+	for ( size_t i = 0; i < fLoadBatches.size(); )
+	{
+		if ( 0 == fLoadBatches[i]->fNumPending )
+		{
+			finished.push_back( fLoadBatches[i] );
+			fLoadBatches.erase( fLoadBatches.begin() + i );
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	for ( size_t i = 0; i < finished.size(); i++ )
+	{
+		TextureLoadBatch *batch = finished[i];
+
+		if ( batch->fListener )
+		{
+			batch->fListener->DispatchEvent( TextureLoadEvent( * batch ) );
+		}
+
+		Rtt_DELETE( batch );
+	}
+}
+
 SharedPtr< TextureResource >
 TextureFactory::GetDefault()
 {
@@ -539,6 +979,168 @@ TextureFactory::WillRemoveTexture( const TextureResource& resource )
 }
 
 
+void
+TextureFactory::SetRecentTexturesBudget( size_t budget )
+{
+	fRecentTexturesBudget = budget;
+
+	if ( 0 == budget )
+	{
+		EmptyRecentTextures();
+	}
+}
+
+void
+TextureFactory::TouchRecentTexture( const SharedPtr< TextureResource >& resource )
+{
+	if ( 0 == fRecentTexturesBudget || resource.IsNull() )
+	{
+		return;
+	}
+
+	const std::string& key = resource->GetCacheKey();
+	std::map< std::string, RecentTextures::iterator >::iterator element = fRecentTexturesIndex.find( key );
+
+	if ( element != fRecentTexturesIndex.end() )
+	{
+		fRecentTextures.splice( fRecentTextures.begin(), fRecentTextures, element->second );
+	}
+	else
+	{
+		fRecentTextures.push_front( resource );
+		fRecentTexturesIndex[key] = fRecentTextures.begin();
+	}
+}
+
+void
+TextureFactory::TrimRecentTextures()
+{
+	// Textures only this list refers to are idle
+	size_t idleBytes = 0;
+
+	for ( RecentTextures::const_iterator it = fRecentTextures.begin(); it != fRecentTextures.end(); ++it )
+	{
+		if ( it->IsUnique() )
+		{
+			idleBytes += (*it)->GetTexture().GetSizeInBytes();
+		}
+	}
+
+	// Evict the least recently used until the rest fit
+	for ( RecentTextures::iterator it = fRecentTextures.end(); idleBytes > fRecentTexturesBudget && it != fRecentTextures.begin(); )
+	{
+		--it;
+
+		if ( it->IsUnique() )
+		{
+			idleBytes -= (*it)->GetTexture().GetSizeInBytes();
+
+			fRecentTexturesIndex.erase( (*it)->GetCacheKey() );
+			it = fRecentTextures.erase( it );
+
+			++fCacheStats.fEvictions;
+		}
+	}
+
+	fCacheStats.fIdleBytes = idleBytes;
+}
+
+void
+TextureFactory::EmptyRecentTextures()
+{
+	fRecentTexturesIndex.clear();
+	fRecentTextures.clear();
+
+	fCacheStats.fIdleBytes = 0;
+}
+
+// Pages are kept small enough to fill up, yet large enough to batch a
+// screenful of icons
+static const U32 kAtlasPageSize = 1024;
+
+// Pages don't reuse the space of released images, so this bounds what an
+// app that keeps loading new images can tie up (32 MB at full page size)
+static const U32 kAtlasMaxPages = 8;
+
+void
+TextureFactory::SetAtlasMaxImageSize( U32 maxImageSize )
+{
+	Rtt_DELETE( fAtlas );
+	fAtlas = NULL;
+
+	if ( maxImageSize > 0 )
+	{
+		U32 pageSize = kAtlasPageSize;
+		U32 maxTextureSize = Display::GetMaxTextureSize();
+
+		if ( maxTextureSize > 0 && maxTextureSize < pageSize )
+		{
+			pageSize = maxTextureSize;
+		}
+
+		fAtlas = Rtt_NEW( fDisplay.GetAllocator(), TextureAtlas( * this, pageSize, maxImageSize, kAtlasMaxPages ) );
+	}
+}
+
+SharedPtr< TextureResource >
+TextureFactory::FindOrCreateInAtlas(
+	const char *filename,
+	MPlatform::Directory baseDir,
+	U32 flags,
+	const AutoPtr< ImageSheet > *& sheet,
+	S32& frameIndex )
+{
+	if ( NULL == fAtlas || MPlatform::kVirtualTexturesDir == baseDir )
+	{
+		return FindOrCreate( filename, baseDir, flags, false );
+	}
+
+	SharedPtr< TextureResource > result;
+
+	bool isRetina = false;
+	std::string key;
+
+	if ( ! KeyForFile( key, isRetina, filename, baseDir, flags ) )
+	{
+		return result;
+	}
+
+	if ( fAtlas->Find( key, sheet, frameIndex ) )
+	{
+		++fCacheStats.fHits;
+
+		return ( * sheet )->GetTextureResource();
+	}
+
+	// Already resident on its own, e.g. via graphics.newTexture()
+	result = Find( key );
+
+	if ( result.NotNull() )
+	{
+		++fCacheStats.fHits;
+	}
+	else
+	{
+		PlatformBitmap *bitmap = CreateBitmap( key.c_str(), flags, false );
+
+		++fCacheStats.fMisses;
+
+		if ( bitmap && fAtlas->Add( key, * bitmap, isRetina, sheet, frameIndex ) )
+		{
+			Rtt_DELETE( bitmap );
+
+			return ( * sheet )->GetTextureResource();
+		}
+
+		// Not suited to the atlas, so use the decoded image on its own
+		result = CreateAndAdd( key, bitmap, true, isRetina );
+	}
+
+	TouchRecentTexture( result );
+
+	return result;
+}
+
 SharedPtr< TextureResource >
 TextureFactory::FindOrCreateCanvas(const std::string &cacheKey,
 								Real width, Real height,
@@ -630,6 +1232,17 @@ void TextureFactory::Release( const std::string &key )
 	
 void TextureFactory::ReleaseByType( TextureResource::TextureResourceType type)
 {
+	// Idle image textures go too; ones still in use stay alive regardless
+	if ( TextureResource::kTextureResource_Any == type || TextureResource::kTextureResourceBitmap == type )
+	{
+		EmptyRecentTextures();
+
+		if ( fAtlas )
+		{
+			fAtlas->Empty();
+		}
+	}
+
 	if ( TextureResource::kTextureResource_Any == type )
 	{
 		fOwnedTextures.clear();
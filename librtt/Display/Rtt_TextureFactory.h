@@ -10,14 +10,17 @@
 #ifndef _Rtt_TextureResource_H__
 #define _Rtt_TextureResource_H__
 
+#include "Core/Rtt_AutoPtr.h"
 #include "Core/Rtt_SharedPtr.h"
 #include "Renderer/Rtt_Texture.h"
 #include "Renderer/Rtt_VideoSource.h"
 #include "Display/Rtt_TextureResource.h"
 
 #include <string>
+#include <list>
 #include <map>
 #include <set>
+#include <vector>
 
 // ----------------------------------------------------------------------------
 
@@ -31,6 +34,11 @@ namespace Rtt
 
 class Display;
 class FilePath;
+class ImageSheet;
+class LuaResource;
+class TextureAtlas;
+class TextureLoadBatch;
+class TextureLoader;
 class TextureResource;
 
 // ----------------------------------------------------------------------------
@@ -53,6 +61,13 @@ class TextureFactory
 			const char *filePath,
 			U32 flags = 0, bool convertToGrayscale = false );
 
+		// The part of CreateBitmap() that follows the platform's decode
+		void ConfigureBitmap( PlatformBitmap *bitmap, const char *filePath, U32 flags );
+
+		// Resolves a file the way FindOrCreate() does; returns false if it
+		// was not found, after warning
+		bool KeyForFile( std::string& key, bool& isRetina, const char *filename, MPlatform::Directory baseDir, U32 flags );
+
 		SharedPtr< TextureResource > Find( const std::string& key );
 		SharedPtr< TextureResource > CreateAndAdd( const std::string& key,
 													PlatformBitmap *bitmap,
@@ -91,6 +106,25 @@ class TextureFactory
 			void* context);
 
 
+	// Asynchronous cached texture resources
+	public:
+		struct LoadRequest
+		{
+			const char *filename;
+			MPlatform::Directory baseDir;
+			bool isMask;
+		};
+
+		// Decodes images off the main thread where the platform allows it,
+		// else a few per frame. UpdateLoads() then adds each one as if by
+		// FindOrCreate(), retains it as newTexture() does and queues it for
+		// the renderer. Once all of them are in, listener, which this takes
+		// ownership of, receives a "completion" event.
+		void LoadAsync( const LoadRequest *requests, U32 count, LuaResource *listener );
+
+		// Called once per frame, where Lua may run
+		void UpdateLoads();
+
 	// One-off texture resources
 	public:
 		SharedPtr< TextureResource > Create(
@@ -124,6 +158,51 @@ class TextureFactory
 		void WillRemoveTexture( const TextureResource& resource );
 		S32 GetTextureMemoryUsed() const { return fTextureMemoryUsed; }
 
+	// Recently used image textures
+	public:
+		struct CacheStats
+		{
+			U32 fHits;		// Image lookups found resident
+			U32 fMisses;	// Image lookups that decoded the file
+			U32 fEvictions;
+			size_t fIdleBytes;	// Kept by the budget alone
+		};
+
+		// Image textures stay resident after their last user lets go, as
+		// long as the idle ones add up to at most budget bytes; the least
+		// recently used are evicted first. 0 (the default) disables this.
+		void SetRecentTexturesBudget( size_t budget );
+		size_t GetRecentTexturesBudget() const { return fRecentTexturesBudget; }
+
+		// Called once per frame
+		void TrimRecentTextures();
+
+		const CacheStats& GetCacheStats() const { return fCacheStats; }
+
+	protected:
+		void TouchRecentTexture( const SharedPtr< TextureResource >& resource );
+		void EmptyRecentTextures();
+
+	// Small images packed into shared pages
+	public:
+		// Images loaded through FindOrCreateInAtlas() that are at most
+		// maxImageSize pixels on a side share atlas pages, so objects showing
+		// them can be batched. 0 (the default) disables this. Such objects'
+		// texture coordinates cover only their part of the page, which effects
+		// and fill transforms see too; see TextureAtlas.
+		void SetAtlasMaxImageSize( U32 maxImageSize );
+		bool IsAtlasEnabled() const { return NULL != fAtlas; }
+
+		// Like FindOrCreate(), except that if the image went into an atlas
+		// page, 'sheet' and 'frameIndex' locate it and the page's texture
+		// is returned; otherwise 'sheet' is left NULL
+		SharedPtr< TextureResource > FindOrCreateInAtlas(
+			const char *filename,
+			MPlatform::Directory baseDir,
+			U32 flags,
+			const AutoPtr< ImageSheet > *& sheet,
+			S32& frameIndex );
+
 	protected:
 		class CacheEntry
 		{
@@ -179,6 +258,18 @@ class TextureFactory
 		VideoSource fVideoSource;
 		
 		S32 fTextureMemoryUsed;
+
+		TextureLoader *fLoader;
+		std::vector< TextureLoadBatch* > fLoadBatches;
+
+		// Most recently used first
+		typedef std::list< SharedPtr< TextureResource > > RecentTextures;
+		RecentTextures fRecentTextures;
+		std::map< std::string, RecentTextures::iterator > fRecentTexturesIndex;
+		size_t fRecentTexturesBudget;
+		CacheStats fCacheStats;
+
+		TextureAtlas *fAtlas;
 		
 };
 
@@ -66,6 +66,9 @@ class CommandBuffer
         virtual bool HasFramebufferBlit( bool * canScale ) const = 0;
 		virtual void GetVertexAttributes( VertexAttributeSupport & support ) const = 0;
 
+		// Whether BindVertexFormat() understands packings other than kUnpacked
+		virtual bool SupportsPackedVertices() const { return false; }
+
     public:
         CommandBuffer( Rtt_Allocator* allocator );
         virtual ~CommandBuffer();
@@ -90,7 +93,7 @@ class CommandBuffer
         virtual void BindUniform( Uniform* uniform, U32 unit ) = 0;
         virtual void BindProgram( Program* program, Program::Version version ) = 0;
         virtual void BindInstancing( U32 count, Geometry::Vertex* instanceData ) = 0;
-        virtual void BindVertexFormat( FormatExtensionList* extensionList, U16 fullCount, U16 vertexSize, U32 offset ) = 0;
+        virtual void BindVertexFormat( FormatExtensionList* extensionList, U16 fullCount, U16 vertexSize, U32 offset, Geometry::VertexPacking packing ) = 0;
         virtual void SetBlendEnabled( bool enabled ) = 0;
         virtual void SetBlendFunction( const BlendMode& mode ) = 0;
         virtual void SetBlendEquation( RenderTypes::BlendEquation equation ) = 0;
@@ -598,7 +598,7 @@ FormatExtensionList::Build( Rtt_Allocator* allocator, const CoronaVertexExtensio
 }
 
 void
-FormatExtensionList::ReconcileFormats( Rtt_Allocator* allocator, CommandBuffer * buffer, const FormatExtensionList * shaderList, const FormatExtensionList * geometryList, U32 offset )
+FormatExtensionList::ReconcileFormats( Rtt_Allocator* allocator, CommandBuffer * buffer, const FormatExtensionList * shaderList, const FormatExtensionList * geometryList, U32 offset, Geometry::VertexPacking packing )
 {
     Array<Attribute> attributes( allocator );
     Array<Group> groups( allocator );
@@ -644,7 +644,12 @@ FormatExtensionList::ReconcileFormats( Rtt_Allocator* allocator, CommandBuffer *
     
     U32 geometryAttributeCount = geometryList ? geometryList->fAttributeCount : 0;
     
-    buffer->BindVertexFormat( &reconciledList, geometryAttributeCount, FormatExtensionList::GetVertexSize( geometryList ), offset );
+    // Packed vertices are only used without extensions
+    Rtt_ASSERT( Geometry::kUnpacked == packing || !geometryList );
+
+    U32 vertexSize = Geometry::kUnpacked == packing ? FormatExtensionList::GetVertexSize( geometryList ) : Geometry::PackedVertex::GetSize( packing );
+
+    buffer->BindVertexFormat( &reconciledList, geometryAttributeCount, vertexSize, offset, packing );
 }
 
 FormatExtensionList::Iterator::Iterator( const FormatExtensionList* list, GroupFilter filter, IterationPolicy policy )
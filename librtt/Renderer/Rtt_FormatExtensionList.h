@@ -12,6 +12,7 @@
 
 #include "Core/Rtt_Array.h"
 #include "Core/Rtt_Types.h"
+#include "Renderer/Rtt_Geometry_Renderer.h"
 
 // ----------------------------------------------------------------------------
 
@@ -116,7 +117,7 @@ class FormatExtensionList {
         static size_t GetVertexSize( const FormatExtensionList * list );
         static bool Compatible( const FormatExtensionList * shaderList, const FormatExtensionList * geometryList );
         static bool Match( const FormatExtensionList * list1, const FormatExtensionList * list2 );
-        static void ReconcileFormats( Rtt_Allocator* allocator, CommandBuffer * buffer, const FormatExtensionList * shaderList, const FormatExtensionList * geometryList, U32 offset );
+        static void ReconcileFormats( Rtt_Allocator* allocator, CommandBuffer * buffer, const FormatExtensionList * shaderList, const FormatExtensionList * geometryList, U32 offset, Geometry::VertexPacking packing = Geometry::kUnpacked );
     
     public:
         void Build( Rtt_Allocator* allocator, const CoronaVertexExtension * extension );
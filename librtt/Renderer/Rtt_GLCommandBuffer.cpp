@@ -539,12 +539,13 @@ GLCommandBuffer::BindInstancing( U32 count, Geometry::Vertex* instanceData )
 }
 
 void
-GLCommandBuffer::BindVertexFormat( FormatExtensionList* list, U16 fullCount, U16 vertexSize, U32 offset )
+GLCommandBuffer::BindVertexFormat( FormatExtensionList* list, U16 fullCount, U16 vertexSize, U32 offset, Geometry::VertexPacking packing )
 {
     WRITE_COMMAND( kCommandResolveVertexFormat );
     Write( fullCount );
     Write( vertexSize );
 	Write( offset );
+    Write( packing );
     Write<U16>( list->GetAttributeCount() );
     
     for (U32 i = 0; i < list->GetAttributeCount(); ++i)
@@ -760,11 +761,8 @@ GLCommandBuffer::Draw( U32 offset, U32 count, Geometry::PrimitiveType type )
 }
 
 void
-GLCommandBuffer::DrawIndexed( U32, U32 count, Geometry::PrimitiveType type )
+GLCommandBuffer::DrawIndexed( U32 offset, U32 count, Geometry::PrimitiveType type )
 {
-    // The first argument, offset, is currently unused. If support for non-
-    // VBO based indexed rendering is added later, an offset may be needed.
-
     Rtt_ASSERT( fProgram && fProgram->GetGPUResource() );
     ApplyUniforms( fProgram->GetGPUResource() );
     
@@ -774,6 +772,7 @@ GLCommandBuffer::DrawIndexed( U32, U32 count, Geometry::PrimitiveType type )
         case Geometry::kIndexedTriangles:    Write<GLenum>(GL_TRIANGLES);    break;
         default: Rtt_ASSERT_NOT_REACHED(); break;
     }
+    Write<U32>(offset);
     Write<GLsizei>(count);
 }
 
@@ -1052,6 +1051,7 @@ GLCommandBuffer::Execute( bool measureGPU )
                 U16 fullCount = Read<U16>();
                 U16 vertexSize = Read<U16>();
 				U32 offset = Read<U32>();
+                Geometry::VertexPacking packing = Read<Geometry::VertexPacking>();
                 
                 // Reconstitute any attribute attached to the geometry.
                 U16 attributeCount = Read<U16>();
@@ -1112,7 +1112,7 @@ GLCommandBuffer::Execute( bool measureGPU )
                 }
                 
                 // Commit the format.
-                geometry->ResolveVertexFormat( &list, vertexSize, offset, instancingData, instanceCount );
+                geometry->ResolveVertexFormat( &list, vertexSize, offset, packing, instancingData, instanceCount );
 
                 DEBUG_PRINT( "Resolved geometry vertex format" );
                 
@@ -1339,16 +1339,18 @@ GLCommandBuffer::Execute( bool measureGPU )
             case kCommandDrawIndexed:
             {
                 GLenum mode = Read<GLenum>();
+                U32 offset = Read<U32>();
                 GLsizei count = Read<GLsizei>();
+                GLvoid* indices = geometry->GetIndices( offset );
                 if (0 == instanceCount)
                 {
-                    glDrawElements( mode, count, GL_UNSIGNED_SHORT, NULL );
-                    DEBUG_PRINT( "Draw indexed: mode=%i, count=%i", mode, count );
+                    glDrawElements( mode, count, GL_UNSIGNED_SHORT, indices );
+                    DEBUG_PRINT( "Draw indexed: mode=%i, offset=%u, count=%i", mode, offset, count );
                 }
                 else
                 {
-                    GLGeometry::DrawElementsInstanced( mode, count, GL_UNSIGNED_SHORT, NULL, instanceCount );
-                    DEBUG_PRINT( "Draw indexed (instanced): mode=%i, count=%i, instance count=%i", mode, count, instanceCount );
+                    GLGeometry::DrawElementsInstanced( mode, count, GL_UNSIGNED_SHORT, indices, instanceCount );
+                    DEBUG_PRINT( "Draw indexed (instanced): mode=%i, offset=%u, count=%i, instance count=%i", mode, offset, count, instanceCount );
                     instanceCount = 0;
                 }
                 CHECK_ERROR_AND_BREAK;
@@ -35,6 +35,7 @@ class GLCommandBuffer : public CommandBuffer
 
 		bool HasFramebufferBlit( bool * canScale ) const;
         void GetVertexAttributes( VertexAttributeSupport & support ) const;
+        virtual bool SupportsPackedVertices() const { return true; }
 
     public:
         GLCommandBuffer( Rtt_Allocator* allocator );
@@ -55,7 +56,7 @@ class GLCommandBuffer : public CommandBuffer
         virtual void BindUniform( Uniform* uniform, U32 unit );
         virtual void BindProgram( Program* program, Program::Version version );
         virtual void BindInstancing( U32 count, Geometry::Vertex* instanceData );
-        virtual void BindVertexFormat( FormatExtensionList* list, U16 fullCount, U16 vertexSize, U32 offset );
+        virtual void BindVertexFormat( FormatExtensionList* list, U16 fullCount, U16 vertexSize, U32 offset, Geometry::VertexPacking packing );
         virtual void SetBlendEnabled( bool enabled );
         virtual void SetBlendFunction( const BlendMode& mode );
         virtual void SetBlendEquation( RenderTypes::BlendEquation mode );
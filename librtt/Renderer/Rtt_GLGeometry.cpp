@@ -250,6 +250,7 @@ GLGeometry::GLGeometry()
     fTexCoordStart( NULL ),
     fColorScaleStart( NULL ),
     fUserDataStart( NULL ),
+    fIndexStart( NULL ),
     fVAO( 0 ),
     fVBO( 0 ),
     fIBO( 0 ),
@@ -663,6 +664,7 @@ GLGeometry::Update( CPUResource* resource )
         fTexCoordStart = &data[0].u;
         fColorScaleStart = &data[0].rs;
         fUserDataStart = &data[0].ux;
+        fIndexStart = geometry->GetIndexData();
     }
     GL_CHECK_ERROR();
 }
@@ -690,6 +692,7 @@ GLGeometry::Destroy()
         fTexCoordStart = NULL;
         fColorScaleStart = NULL;
         fUserDataStart = NULL;
+        fIndexStart = NULL;
     }
 
     if (fInstancesVBO)
@@ -703,8 +706,17 @@ GLGeometry::Destroy()
 }
 
 void
-GLGeometry::BindStockAttributes( size_t size, U32 offset )
+GLGeometry::BindStockAttributes( size_t size, U32 offset, Geometry::VertexPacking packing )
 {
+    if (Geometry::kUnpacked != packing)
+    {
+        BindPackedAttributes( size, offset, packing );
+
+        return;
+    }
+
+    glEnableVertexAttribArray( Geometry::kVertexUserDataAttribute ); // cf. BindPackedAttributes()
+
     const GLbyte* positionStart = (const GLbyte*)fPositionStart;
     const GLbyte* texCoordStart = (const GLbyte*)fTexCoordStart;
     const GLbyte* colorScaleStart = (const GLbyte*)fColorScaleStart;
@@ -724,6 +736,33 @@ GLGeometry::BindStockAttributes( size_t size, U32 offset )
     glVertexAttribPointer( Geometry::kVertexUserDataAttribute, 4, GL_FLOAT, GL_FALSE, (GLsizei)size, userDataStart ); GL_CHECK_ERROR();
 }
 
+void
+GLGeometry::BindPackedAttributes( size_t size, U32 offset, Geometry::VertexPacking packing )
+{
+    const GLbyte* start = (const GLbyte*)fPositionStart;
+
+    if (!StoredOnGPU())
+    {
+        start += offset;
+    }
+
+    glVertexAttribPointer( Geometry::kVertexPositionAttribute, 2, GL_FLOAT, GL_FALSE, (GLsizei)size, start + offsetof( Geometry::PackedVertex, x ) ); GL_CHECK_ERROR();
+    glVertexAttribPointer( Geometry::kVertexTexCoordAttribute, 2, GL_UNSIGNED_SHORT, GL_TRUE, (GLsizei)size, start + offsetof( Geometry::PackedVertex, u ) ); GL_CHECK_ERROR();
+    glVertexAttribPointer( Geometry::kVertexColorScaleAttribute, 4, GL_UNSIGNED_BYTE, GL_TRUE, (GLsizei)size, start + offsetof( Geometry::PackedVertex, rs ) ); GL_CHECK_ERROR();
+
+    if (Geometry::kPackedWithUserData == packing)
+    {
+        glEnableVertexAttribArray( Geometry::kVertexUserDataAttribute );
+        glVertexAttribPointer( Geometry::kVertexUserDataAttribute, 4, GL_FLOAT, GL_FALSE, (GLsizei)size, start + offsetof( Geometry::PackedVertex, ux ) ); GL_CHECK_ERROR();
+    }
+    else
+    {
+        // The shell still passes the user data along, so feed it a constant
+        glDisableVertexAttribArray( Geometry::kVertexUserDataAttribute );
+        glVertexAttrib4f( Geometry::kVertexUserDataAttribute, 0.0f, 0.0f, 0.0f, 0.0f ); GL_CHECK_ERROR();
+    }
+}
+
 void
 GLGeometry::Bind()
 {
@@ -752,6 +791,20 @@ GLGeometry::Bind()
     }
 }
 
+GLvoid*
+GLGeometry::GetIndices( U32 offset ) const
+{
+    if ( StoredOnGPU() )
+    {
+        return (GLvoid*)( offset * sizeof( Geometry::Index ) );
+    }
+
+    // e.g. indexed batches, built each frame in the renderer's geometry pool
+    Rtt_ASSERT( fIndexStart );
+
+    return static_cast< Geometry::Index* >( fIndexStart ) + offset;
+}
+
 static void
 BindExtensionAttribute( const FormatExtensionList::Attribute& attribute, GLuint attributeIndex, size_t size, GLbyte* start, U32 offsetExtra )
 {
@@ -769,7 +822,7 @@ BindExtensionAttribute( const FormatExtensionList::Attribute& attribute, GLuint
 }
 
 void
-GLGeometry::ResolveVertexFormat( const FormatExtensionList * list, U32 vertexSize, U32 offset, const Geometry::Vertex* instancingData, U32 instanceCount )
+GLGeometry::ResolveVertexFormat( const FormatExtensionList * list, U32 vertexSize, U32 offset, Geometry::VertexPacking packing, const Geometry::Vertex* instancingData, U32 instanceCount )
 {
     bool storedOnGPU = StoredOnGPU();
 
@@ -781,7 +834,11 @@ GLGeometry::ResolveVertexFormat( const FormatExtensionList * list, U32 vertexSiz
 	offset *= sizeof( Geometry::Vertex );
     if ( !fVAO ) // a VAO does not have this info, but already has it bound
     {
-        BindStockAttributes( vertexSize, offset );
+        BindStockAttributes( vertexSize, offset, packing );
+    }
+    else
+    {
+        Rtt_ASSERT( Geometry::kUnpacked == packing ); // only pool geometry is packed
     }
 
     Rtt_ASSERT( list );
@@ -48,16 +48,25 @@ class GLGeometry : public GPUResource
         virtual void Update( CPUResource* resource );
         virtual void Destroy();
 
-        void BindStockAttributes( size_t size, U32 offset );
+        void BindStockAttributes( size_t size, U32 offset, Geometry::VertexPacking packing = Geometry::kUnpacked );
 		void Bind();
 
-        void ResolveVertexFormat( const FormatExtensionList * list, U32 vertexSize, U32 offset, const Geometry::Vertex* instancingData, U32 instanceCount );
+        void ResolveVertexFormat( const FormatExtensionList * list, U32 vertexSize, U32 offset, Geometry::VertexPacking packing, const Geometry::Vertex* instancingData, U32 instanceCount );
+
+        // The "indices" argument to glDrawElements() for the given index:
+        // an offset into the index buffer, or a client-side pointer.
+        GLvoid* GetIndices( U32 offset ) const;
+
+    private:
+        // Geometry::PackedVertex counterpart of BindStockAttributes()
+        void BindPackedAttributes( size_t size, U32 offset, Geometry::VertexPacking packing );
 
     private:
         GLvoid* fPositionStart;
         GLvoid* fTexCoordStart;
         GLvoid* fColorScaleStart;
         GLvoid* fUserDataStart;
+        GLvoid* fIndexStart;
         GLuint fVAO;
         GLuint fVBO;
         GLuint fIBO;
@@ -41,7 +41,7 @@ GeometryPool::Bucket::GetOrCreate()
 {
 	if( fUsedCount == fGeometry.Length() )
 	{
-		const U32 indexCount = 0;
+		const U32 indexCount = fVertexCount * kIndicesPerVertex;
 		const bool storeOnGPU = false;
 		fGeometry.Append( Rtt_NEW( fAllocator, Geometry( fAllocator, Geometry::kTriangleStrip,
 			fVertexCount, indexCount, storeOnGPU ) ) );
@@ -49,6 +49,7 @@ GeometryPool::Bucket::GetOrCreate()
 
 	Geometry* result = fGeometry[fUsedCount++];
 	result->SetVerticesUsed( 0 );
+	result->SetIndicesUsed( 0 );
 	return result;
 }
 
@@ -69,9 +70,10 @@ GeometryPool::~GeometryPool()
 }
 
 Geometry*
-GeometryPool::GetOrCreate( U32 requiredVertexCount )
+GeometryPool::GetOrCreate( U32 requiredVertexCount, U32 requiredIndexCount )
 {
-	U32 finalCount = Max( fMinimumVertexCount, NextPowerOf2( requiredVertexCount ) );
+	U32 vertexCountForIndices = ( requiredIndexCount + kIndicesPerVertex - 1 ) / kIndicesPerVertex;
+	U32 finalCount = Max( fMinimumVertexCount, NextPowerOf2( Max( requiredVertexCount, vertexCountForIndices ) ) );
 	U32 bucketIndex = LogBase2( finalCount ) - fMinimumPower;
 	
 	const S32 length = fBackPool->Length();
@@ -32,12 +32,17 @@ class GeometryPool
 	public:
 		// Geometry instances allocated through the pool are always powers of
 		// two in size. The smallest size is given by the minimum vertex count.
+		// Each one also has room for kIndicesPerVertex indices per vertex.
 		GeometryPool( Rtt_Allocator* allocator, U32 minimumVertexCount = 1024 );
 		~GeometryPool();
 
+		// Enough to draw any triangle strip or fan as a triangle list.
+		static const U32 kIndicesPerVertex = 3;
+
 		// Return an unused Geometry large enough to store the specified number
-		// of vertices. If no such Geometry is available, create a new one.
-		Geometry* GetOrCreate( U32 requiredVertexCount );
+		// of vertices and indices. If no such Geometry is available, create a
+		// new one.
+		Geometry* GetOrCreate( U32 requiredVertexCount, U32 requiredIndexCount = 0 );
 
 		// Swap the front and back pools. Draw commands pull their data from
 		// Geometry in the front pool while Geometry in the back is filled.
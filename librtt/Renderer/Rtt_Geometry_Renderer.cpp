@@ -129,6 +129,74 @@ Geometry::Vertex::SizeInVertices( U32 size )
     return size / sizeof(Geometry::Vertex);
 }
 
+U32
+Geometry::PackedVertex::GetSize( VertexPacking packing )
+{
+    Rtt_STATIC_ASSERT( 16 == offsetof( PackedVertex, ux ) );
+    Rtt_STATIC_ASSERT( 32 == sizeof( PackedVertex ) );
+
+    switch ( packing )
+    {
+        case kPacked:
+            return offsetof( PackedVertex, ux );
+        case kPackedWithUserData:
+            return sizeof( PackedVertex );
+        default:
+            return sizeof( Vertex );
+    }
+}
+
+bool
+Geometry::PackedVertex::CanPack( const Vertex* vertices, U32 count )
+{
+    for ( U32 i = 0; i < count; ++i )
+    {
+        const Vertex& vert = vertices[i];
+
+        if ( !( vert.u >= Rtt_REAL_0 && vert.u <= Rtt_REAL_1 && vert.v >= Rtt_REAL_0 && vert.v <= Rtt_REAL_1 ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void
+Geometry::PackedVertex::Pack( void* destination, const Vertex* vertices, U32 count, VertexPacking packing )
+{
+    Rtt_ASSERT( kUnpacked != packing );
+
+    const U32 size = GetSize( packing );
+    const bool hasUserData = kPackedWithUserData == packing;
+    U8* out = static_cast< U8* >( destination );
+
+    for ( U32 i = 0; i < count; ++i, out += size )
+    {
+        const Vertex& vert = vertices[i];
+
+        // Without user data, the struct's tail belongs to the next vertex
+        PackedVertex* packed = reinterpret_cast< PackedVertex* >( out );
+
+        packed->x = vert.x;
+        packed->y = vert.y;
+        packed->u = (U16)( vert.u * 65535.0f + 0.5f );
+        packed->v = (U16)( vert.v * 65535.0f + 0.5f );
+        packed->rs = vert.rs;
+        packed->gs = vert.gs;
+        packed->bs = vert.bs;
+        packed->as = vert.as;
+
+        if ( hasUserData )
+        {
+            packed->ux = vert.ux;
+            packed->uy = vert.uy;
+            packed->uz = vert.uz;
+            packed->uw = vert.uw;
+        }
+    }
+}
+
 Geometry::ExtensionBlock::ExtensionBlock( Rtt_Allocator* allocator )
 :   fVertexData( allocator ),
     fInstanceData( NULL ),
@@ -133,6 +133,30 @@ class Geometry : public CPUResource
 
         typedef U16 Index;
 
+        // Batches whose program reads neither z nor q may store their
+        // vertices as PackedVertex instead; cf. Program::AcceptsPackedVertices().
+        typedef enum _VertexPacking
+        {
+            kUnpacked,              // Vertex
+            kPacked,                // PackedVertex, up to and including the color
+            kPackedWithUserData,    // PackedVertex
+        }
+        VertexPacking;
+
+        struct PackedVertex
+        {
+            static U32 GetSize( VertexPacking packing );
+
+            // The UVs are normalized, so must lie within [0, 1]
+            static bool CanPack( const Vertex* vertices, U32 count );
+            static void Pack( void* destination, const Vertex* vertices, U32 count, VertexPacking packing );
+
+            Real x, y;              // 8 bytes
+            U16 u, v;               // 4 bytes
+            U8 rs, gs, bs, as;      // 4 bytes
+            Real ux, uy, uz, uw;    // 16 bytes
+        };
+
         struct ExtensionBlock {
             ExtensionBlock( Rtt_Allocator* allocator );
             ExtensionBlock( ExtensionBlock & block );
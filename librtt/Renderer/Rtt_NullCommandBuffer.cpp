@@ -0,0 +1,703 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Renderer/Rtt_NullCommandBuffer.h"
+
+#include "Renderer/Rtt_FrameBufferObject.h"
+#include "Renderer/Rtt_FormatExtensionList.h"
+#include "Renderer/Rtt_Geometry_Renderer.h"
+#include "Renderer/Rtt_Program.h"
+#include "Renderer/Rtt_Texture.h"
+#include "Renderer/Rtt_Uniform.h"
+#include "Display/Rtt_ShaderResource.h"
+#include "Core/Rtt_Allocator.h"
+#include "Core/Rtt_Assert.h"
+#include "Core/Rtt_Math.h"
+#include <string.h>
+
+#include "Corona/CoronaGraphics.h"
+
+// ----------------------------------------------------------------------------
+
+namespace /*anonymous*/
+{
+    enum Command
+    {
+        kCommandBindFrameBufferObject,
+        kCommandUnBindFrameBufferObject,
+		kCommandCaptureRect,
+        kCommandBindGeometry,
+        kCommandBindTexture,
+        kCommandBindProgram,
+        kCommandBindInstancing,
+        kCommandResolveVertexFormat,
+        kCommandApplyUniform,
+        kCommandEnableBlend,
+        kCommandDisableBlend,
+        kCommandSetBlendFunction,
+        kCommandSetBlendEquation,
+        kCommandSetViewport,
+        kCommandEnableScissor,
+        kCommandDisableScissor,
+        kCommandSetScissorRegion,
+        kCommandEnableMultisample,
+        kCommandDisableMultisample,
+        kCommandClearDepth,
+        kCommandClearStencil,
+        kCommandClear,
+        kCommandDraw,
+        kCommandDrawIndexed,
+        kNumCommands
+    };
+
+    // Reported in lieu of a real query. Matches common desktop limits.
+    const S32 kNullMaxTextureSize = 4096;
+    const U32 kNullMaxVertexAttributes = 12;
+
+    // See GLCommandBuffer: the timestamp must be shared by the front and
+    // back buffers, since only one of them writes on any given frame.
+    static U32 gUniformTimestamp = 1;
+
+    // Ensure command count is incremented
+    #define WRITE_COMMAND( command ) Write<Command>( command ); ++fNumCommands;
+}
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+NullCommandBuffer::Recording::Recording()
+:   fCommandCount( 0 ),
+    fCommandBytes( 0 ),
+    fDrawCount( 0 ),
+    fIndexedDrawCount( 0 ),
+    fVertexCount( 0 ),
+    fIndexCount( 0 ),
+    fVertexBytes( 0 ),
+    fFrameBufferBindCount( 0 ),
+    fGeometryBindCount( 0 ),
+    fTextureBindCount( 0 ),
+    fProgramBindCount( 0 ),
+    fVertexFormatCount( 0 ),
+    fUniformWriteCount( 0 ),
+    fUniformBytes( 0 ),
+    fStateChangeCount( 0 ),
+    fClearCount( 0 ),
+    fCaptureCount( 0 ),
+    fCustomCommandCount( 0 )
+{
+}
+
+void
+NullCommandBuffer::Recording::Log() const
+{
+    Rtt_LogException( "Commands(%d) CommandBytes(%d)\n", fCommandCount, fCommandBytes );
+    Rtt_LogException( "\tDraws(%d) IndexedDraws(%d) Vertices(%d) Indices(%d) VertexBytes(%d)\n", fDrawCount, fIndexedDrawCount, fVertexCount, fIndexCount, fVertexBytes );
+    Rtt_LogException( "\tBinds (fbo, geometry, texture, program, format) = (%d, %d, %d, %d, %d)\n", fFrameBufferBindCount, fGeometryBindCount, fTextureBindCount, fProgramBindCount, fVertexFormatCount );
+    Rtt_LogException( "\tUniformWrites(%d) UniformBytes(%d) StateChanges(%d) Clears(%d) Captures(%d) Custom(%d)\n", fUniformWriteCount, fUniformBytes, fStateChangeCount, fClearCount, fCaptureCount, fCustomCommandCount );
+}
+
+bool
+NullCommandBuffer::HasFramebufferBlit( bool * canScale ) const
+{
+    if (canScale)
+    {
+        *canScale = false;
+    }
+
+    return false;
+}
+
+void
+NullCommandBuffer::GetVertexAttributes( VertexAttributeSupport & support ) const
+{
+    support.maxCount = kNullMaxVertexAttributes;
+    support.hasInstancing = false;
+    support.hasDivisors = false;
+    support.hasPerInstance = false;
+    support.suffix = NULL;
+}
+
+NullCommandBuffer::NullCommandBuffer( Rtt_Allocator* allocator )
+:   CommandBuffer( allocator ),
+    fProgram( NULL ),
+    fNamedUniformCount( 0 ),
+    fNamedUniformBytes( 0 ),
+    fCustomCommands( allocator )
+{
+    for(U32 i = 0; i < Uniform::kNumBuiltInVariables; ++i)
+    {
+        fUniformUpdates[i].uniform = NULL;
+        fUniformUpdates[i].timestamp = 0;
+        fAppliedTimestamps[i] = 0;
+    }
+}
+
+NullCommandBuffer::~NullCommandBuffer()
+{
+}
+
+void
+NullCommandBuffer::Initialize()
+{
+    InitializeFBO();
+    InitializeCachedParams();
+    CacheQueryParam( kMaxTextureSize );
+}
+
+void
+NullCommandBuffer::InitializeFBO()
+{
+}
+
+void
+NullCommandBuffer::InitializeCachedParams()
+{
+    for (int i = 0; i < kNumQueryableParams; i++)
+    {
+        fCachedQuery[i] = -1;
+    }
+}
+
+void
+NullCommandBuffer::CacheQueryParam( CommandBuffer::QueryableParams param )
+{
+    switch (param)
+    {
+        case CommandBuffer::kMaxTextureSize:
+            fCachedQuery[param] = kNullMaxTextureSize;
+            break;
+        default:
+            break;
+    }
+}
+
+void
+NullCommandBuffer::Denitialize()
+{
+}
+
+void
+NullCommandBuffer::ClearUserUniforms()
+{
+    fUniformUpdates[Uniform::kMaskMatrix0].uniform = NULL;
+    fUniformUpdates[Uniform::kMaskMatrix1].uniform = NULL;
+    fUniformUpdates[Uniform::kMaskMatrix2].uniform = NULL;
+    fUniformUpdates[Uniform::kUserData0].uniform = NULL;
+    fUniformUpdates[Uniform::kUserData1].uniform = NULL;
+    fUniformUpdates[Uniform::kUserData2].uniform = NULL;
+    fUniformUpdates[Uniform::kUserData3].uniform = NULL;
+}
+
+void
+NullCommandBuffer::BindFrameBufferObject( FrameBufferObject* fbo, bool asDrawBuffer )
+{
+	if( fbo )
+	{
+		WRITE_COMMAND( kCommandBindFrameBufferObject );
+		Write<FrameBufferObject*>( fbo );
+		Write<bool>( asDrawBuffer );
+	}
+	else
+	{
+		WRITE_COMMAND( kCommandUnBindFrameBufferObject );
+	}
+}
+
+void
+NullCommandBuffer::CaptureRect( FrameBufferObject* fbo, Texture& texture, const Rect& rect, const Rect& unclipped )
+{
+	WRITE_COMMAND( kCommandCaptureRect );
+	Write<Texture*>( &texture );
+	Write<Rect>( rect );
+	Write<Rect>( unclipped );
+}
+
+void
+NullCommandBuffer::BindGeometry( Geometry* geometry )
+{
+    WRITE_COMMAND( kCommandBindGeometry );
+    Write<Geometry*>( geometry );
+}
+
+void
+NullCommandBuffer::BindTexture( Texture* texture, U32 unit )
+{
+    WRITE_COMMAND( kCommandBindTexture );
+    Write<U32>( unit );
+    Write<Texture*>( texture );
+}
+
+void
+NullCommandBuffer::BindProgram( Program* program, Program::Version version )
+{
+    WRITE_COMMAND( kCommandBindProgram );
+    Write<Program::Version>( version );
+    Write<Program*>( program );
+
+    fProgram = program;
+
+    // A freshly bound program has none of the current uniform values
+    for(U32 i = 0; i < Uniform::kNumBuiltInVariables; ++i)
+    {
+        fAppliedTimestamps[i] = 0;
+    }
+
+    AcquireTimeTransform( program->GetShaderResource() );
+}
+
+void
+NullCommandBuffer::BindInstancing( U32 count, Geometry::Vertex* instanceData )
+{
+    WRITE_COMMAND( kCommandBindInstancing );
+    Write( count );
+    Write( instanceData );
+}
+
+void
+NullCommandBuffer::BindVertexFormat( FormatExtensionList* list, U16 fullCount, U16 vertexSize, U32 offset, Geometry::VertexPacking packing )
+{
+    WRITE_COMMAND( kCommandResolveVertexFormat );
+    Write( fullCount );
+    Write( vertexSize );
+	Write( offset );
+    Write( packing );
+}
+
+void
+NullCommandBuffer::BindUniform( Uniform* uniform, U32 unit )
+{
+    Rtt_ASSERT( unit < Uniform::kNumBuiltInVariables );
+    UniformUpdate& update = fUniformUpdates[ unit ];
+    update.uniform = uniform;
+    update.timestamp = gUniformTimestamp++;
+}
+
+void
+NullCommandBuffer::SetBlendEnabled( bool enabled )
+{
+    WRITE_COMMAND( enabled ? kCommandEnableBlend : kCommandDisableBlend );
+}
+
+void
+NullCommandBuffer::SetBlendFunction( const BlendMode& mode )
+{
+    WRITE_COMMAND( kCommandSetBlendFunction );
+    Write<BlendMode>( mode );
+}
+
+void
+NullCommandBuffer::SetBlendEquation( RenderTypes::BlendEquation mode )
+{
+    WRITE_COMMAND( kCommandSetBlendEquation );
+    Write<RenderTypes::BlendEquation>( mode );
+}
+
+void
+NullCommandBuffer::SetViewport( int x, int y, int width, int height )
+{
+    WRITE_COMMAND( kCommandSetViewport );
+    Write<S32>(x);
+    Write<S32>(y);
+    Write<S32>(width);
+    Write<S32>(height);
+}
+
+void
+NullCommandBuffer::SetScissorEnabled( bool enabled )
+{
+    WRITE_COMMAND( enabled ? kCommandEnableScissor : kCommandDisableScissor );
+}
+
+void
+NullCommandBuffer::SetScissorRegion( int x, int y, int width, int height )
+{
+    WRITE_COMMAND( kCommandSetScissorRegion );
+    Write<S32>(x);
+    Write<S32>(y);
+    Write<S32>(width);
+    Write<S32>(height);
+}
+
+void
+NullCommandBuffer::SetMultisampleEnabled( bool enabled )
+{
+    WRITE_COMMAND( enabled ? kCommandEnableMultisample : kCommandDisableMultisample );
+}
+
+void
+NullCommandBuffer::ClearDepth( Real depth )
+{
+    WRITE_COMMAND( kCommandClearDepth );
+    Write<Real>(depth);
+}
+
+void
+NullCommandBuffer::ClearStencil( U32 stencil )
+{
+    WRITE_COMMAND( kCommandClearStencil );
+    Write<U32>(stencil);
+}
+
+void
+NullCommandBuffer::Clear( Real r, Real g, Real b, Real a )
+{
+    WRITE_COMMAND( kCommandClear );
+    Write<Real>(r);
+    Write<Real>(g);
+    Write<Real>(b);
+    Write<Real>(a);
+}
+
+void
+NullCommandBuffer::Draw( U32 offset, U32 count, Geometry::PrimitiveType type )
+{
+    Rtt_ASSERT( fProgram );
+    ApplyUniforms();
+
+    WRITE_COMMAND( kCommandDraw );
+    Write<Geometry::PrimitiveType>(type);
+    Write<U32>(offset);
+    Write<U32>(count);
+}
+
+void
+NullCommandBuffer::DrawIndexed( U32 offset, U32 count, Geometry::PrimitiveType type )
+{
+    Rtt_ASSERT( fProgram );
+    ApplyUniforms();
+
+    WRITE_COMMAND( kCommandDrawIndexed );
+    Write<Geometry::PrimitiveType>(type);
+    Write<U32>(offset);
+    Write<U32>(count);
+}
+
+S32
+NullCommandBuffer::GetCachedParam( CommandBuffer::QueryableParams param )
+{
+    S32 result = -1;
+    if (param < kNumQueryableParams)
+    {
+        result = fCachedQuery[param];
+    }
+
+    Rtt_ASSERT_MSG(result != -1, "Parameter not cached");
+
+    return result;
+}
+
+void
+NullCommandBuffer::AddCommand( const CoronaCommand* command )
+{
+    fCustomCommands.Append( command );
+}
+
+void
+NullCommandBuffer::IssueCommand( U16 id, const void * data, U32 size )
+{
+    // The writer is skipped: user commands typically target a real API, so
+    // only the space they would occupy is reserved.
+    Command custom = Command( kNumCommands + id );
+
+    WRITE_COMMAND( custom );
+    Write< U32 >( size );
+
+    U8 * buffer = Reserve( size );
+
+    if (data && size)
+    {
+        memcpy( buffer, data, size );
+    }
+}
+
+bool
+NullCommandBuffer::WriteNamedUniform( const char * uniformName, const void * data, unsigned int size )
+{
+    ++fNamedUniformCount;
+    fNamedUniformBytes += size;
+
+    return true;
+}
+
+Real
+NullCommandBuffer::Execute( bool measureGPU )
+{
+    Recording recording;
+
+    recording.fCommandCount = fNumCommands;
+    recording.fCommandBytes = fBytesUsed;
+
+	// Reset the offset pointer to the start of the buffer.
+	fOffset = fBuffer;
+
+    Geometry* geometry = NULL;
+    U32 vertexSize = sizeof( Geometry::Vertex );
+
+    for( U32 i = 0; i < fNumCommands; ++i )
+    {
+        Command command = Read<Command>();
+
+        Rtt_ASSERT( command < kNumCommands + fCustomCommands.Length() );
+		switch( command )
+		{
+			case kCommandBindFrameBufferObject:
+			{
+				Read<FrameBufferObject*>();
+				Read<bool>();
+				++recording.fFrameBufferBindCount;
+				break;
+			}
+			case kCommandUnBindFrameBufferObject:
+			{
+				++recording.fFrameBufferBindCount;
+				break;
+			}
+			case kCommandCaptureRect:
+			{
+				Read<Texture*>();
+				Read<Rect>();
+				Read<Rect>();
+				++recording.fCaptureCount;
+				break;
+			}
+			case kCommandBindGeometry:
+			{
+				geometry = Read<Geometry*>();
+				vertexSize = sizeof( Geometry::Vertex );
+				++recording.fGeometryBindCount;
+				break;
+			}
+			case kCommandBindTexture:
+			{
+				Read<U32>();
+				Read<Texture*>();
+				++recording.fTextureBindCount;
+				break;
+			}
+			case kCommandBindProgram:
+			{
+				Read<Program::Version>();
+				Read<Program*>();
+				++recording.fProgramBindCount;
+				break;
+			}
+			case kCommandBindInstancing:
+			{
+				Read<U32>();
+				Read<Geometry::Vertex*>();
+				break;
+			}
+			case kCommandResolveVertexFormat:
+			{
+				Read<U16>();
+				vertexSize = Read<U16>();
+				Read<U32>();
+				Read<Geometry::VertexPacking>();
+				++recording.fVertexFormatCount;
+				break;
+			}
+			case kCommandApplyUniform:
+			{
+				Read<U32>();
+				U32 size = Read<U32>();
+				fOffset += size;
+				++recording.fUniformWriteCount;
+				recording.fUniformBytes += size;
+				break;
+			}
+			case kCommandSetBlendFunction:
+			{
+				Read<BlendMode>();
+				++recording.fStateChangeCount;
+				break;
+			}
+			case kCommandSetBlendEquation:
+			{
+				Read<RenderTypes::BlendEquation>();
+				++recording.fStateChangeCount;
+				break;
+			}
+			case kCommandSetViewport:
+			case kCommandSetScissorRegion:
+			{
+				fOffset += 4 * sizeof( S32 );
+				++recording.fStateChangeCount;
+				break;
+			}
+			case kCommandEnableBlend:
+			case kCommandDisableBlend:
+			case kCommandEnableScissor:
+			case kCommandDisableScissor:
+			case kCommandEnableMultisample:
+			case kCommandDisableMultisample:
+			{
+				++recording.fStateChangeCount;
+				break;
+			}
+			case kCommandClearDepth:
+			{
+				Read<Real>();
+				break;
+			}
+			case kCommandClearStencil:
+			{
+				Read<U32>();
+				break;
+			}
+			case kCommandClear:
+			{
+				fOffset += 4 * sizeof( Real );
+				++recording.fClearCount;
+				break;
+			}
+			case kCommandDraw:
+			{
+				Read<Geometry::PrimitiveType>();
+				Read<U32>();
+				U32 count = Read<U32>();
+				++recording.fDrawCount;
+				recording.fVertexCount += count;
+
+				// Geometry stored on the GPU is not streamed per draw
+				if ( geometry && ! geometry->GetStoredOnGPU() )
+				{
+					recording.fVertexBytes += count * vertexSize;
+				}
+				break;
+			}
+			case kCommandDrawIndexed:
+			{
+				Read<Geometry::PrimitiveType>();
+				U32 offset = Read<U32>();
+				U32 count = Read<U32>();
+				++recording.fIndexedDrawCount;
+				recording.fIndexCount += count;
+
+				// Client-side indices, e.g. from an indexed batch, are streamed
+				// along with the range of vertices they reference
+				if ( geometry && ! geometry->GetStoredOnGPU() && count > 0 )
+				{
+					const Geometry::Index* indices = geometry->GetIndexData() + offset;
+					U32 minIndex = indices[0], maxIndex = indices[0];
+
+					for ( U32 i = 1; i < count; i++ )
+					{
+						minIndex = Min( minIndex, (U32)indices[i] );
+						maxIndex = Max( maxIndex, (U32)indices[i] );
+					}
+
+					recording.fVertexBytes += ( maxIndex - minIndex + 1 ) * vertexSize + count * sizeof( Geometry::Index );
+				}
+				break;
+			}
+			default:
+			{
+				U32 size = Read< U32 >();
+				fOffset += size;
+				++recording.fCustomCommandCount;
+				break;
+			}
+		}
+    }
+
+    // Named uniforms are written directly, outside of the command stream
+    recording.fUniformWriteCount += fNamedUniformCount;
+    recording.fUniformBytes += fNamedUniformBytes;
+    fNamedUniformCount = 0;
+    fNamedUniformBytes = 0;
+
+    fRecording = recording;
+
+    fBytesUsed = 0;
+    fNumCommands = 0;
+
+    return 0.0f;
+}
+
+template <typename T>
+T
+NullCommandBuffer::Read()
+{
+    Rtt_ASSERT( fOffset < fBuffer + fBytesAllocated );
+    T result;
+    memcpy( &result, fOffset, sizeof( T ) );
+    fOffset += sizeof( T );
+    return result;
+}
+
+template <typename T>
+void
+NullCommandBuffer::Write( T value )
+{
+    U8 * writePos = Reserve( sizeof( T ) );
+
+    memcpy( writePos, &value, sizeof( T ) );
+}
+
+void
+NullCommandBuffer::ApplyUniforms()
+{
+    for( U32 i = 0; i < Uniform::kNumBuiltInVariables; ++i)
+    {
+        const UniformUpdate& update = fUniformUpdates[i];
+        if( update.uniform && update.timestamp != fAppliedTimestamps[i] )
+        {
+            fAppliedTimestamps[i] = update.timestamp;
+
+            WRITE_COMMAND( kCommandApplyUniform );
+            Write<U32>( i );
+            WriteUniform( update.uniform );
+        }
+    }
+}
+
+void
+NullCommandBuffer::WriteUniform( Uniform* uniform )
+{
+    U32 size = uniform->GetSizeInBytes();
+
+    Write<U32>( size );
+    memcpy( Reserve( size ), uniform->GetData(), size );
+}
+
+U8 *
+NullCommandBuffer::Reserve( U32 size )
+{
+    U32 bytesNeeded = fBytesUsed + size;
+    if( bytesNeeded > fBytesAllocated )
+    {
+        U32 doubleSize = fBytesUsed ? 2 * fBytesUsed : 4;
+        U32 newSize = Max( bytesNeeded, doubleSize );
+        U8* newBuffer = new U8[newSize];
+
+        memcpy( newBuffer, fBuffer, fBytesUsed );
+        delete [] fBuffer;
+
+        fBuffer = newBuffer;
+        fBytesAllocated = newSize;
+    }
+
+    U8 * buffer = fBuffer + fBytesUsed;
+
+    fBytesUsed += size;
+
+    return buffer;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+#undef WRITE_COMMAND
+
+// ----------------------------------------------------------------------------
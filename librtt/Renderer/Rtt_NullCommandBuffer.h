@@ -0,0 +1,154 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_NullCommandBuffer_H__
+#define _Rtt_NullCommandBuffer_H__
+
+#include "Renderer/Rtt_CommandBuffer.h"
+#include "Renderer/Rtt_Uniform.h"
+
+#include "Core/Rtt_Array.h"
+
+// ----------------------------------------------------------------------------
+
+struct CoronaCommand;
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// A CommandBuffer that requires no rendering context. Commands are buffered
+// exactly as a real backend would buffer them, but Execute() only walks the
+// stream and tallies what it would have submitted. This allows the complete
+// preparation path (Scene::Render -> Renderer::Insert -> Swap) to be run and
+// measured on machines without a GPU.
+class NullCommandBuffer : public CommandBuffer
+{
+    public:
+        typedef CommandBuffer Super;
+        typedef NullCommandBuffer Self;
+
+        // Totals for the most recently executed command stream.
+        struct Recording
+        {
+            Recording();
+            void Log() const;
+
+            U32 fCommandCount;          // Number of buffered commands
+            U32 fCommandBytes;          // Size of the command stream in bytes
+            U32 fDrawCount;             // Number of non-indexed draws
+            U32 fIndexedDrawCount;      // Number of indexed draws
+            U32 fVertexCount;           // Vertices submitted by non-indexed draws
+            U32 fIndexCount;            // Indices submitted by indexed draws
+            U32 fVertexBytes;           // Client-side vertex and index bytes read by draws
+            U32 fFrameBufferBindCount;  // Number of FBO binds (and unbinds)
+            U32 fGeometryBindCount;     // Number of Geometry bindings
+            U32 fTextureBindCount;      // Number of Texture bindings
+            U32 fProgramBindCount;      // Number of Program bindings
+            U32 fVertexFormatCount;     // Number of vertex format changes
+            U32 fUniformWriteCount;     // Number of uniform writes
+            U32 fUniformBytes;          // Bytes of uniform data written
+            U32 fStateChangeCount;      // Blend, scissor, viewport, etc.
+            U32 fClearCount;            // Number of clears
+            U32 fCaptureCount;          // Number of capture rects
+            U32 fCustomCommandCount;    // Number of user-defined commands
+        };
+
+		bool HasFramebufferBlit( bool * canScale ) const;
+        void GetVertexAttributes( VertexAttributeSupport & support ) const;
+        virtual bool SupportsPackedVertices() const { return true; }
+
+    public:
+        NullCommandBuffer( Rtt_Allocator* allocator );
+        virtual ~NullCommandBuffer();
+
+        virtual void Initialize();
+        virtual void Denitialize();
+
+        virtual void ClearUserUniforms();
+
+        virtual void BindFrameBufferObject( FrameBufferObject* fbo, bool asDrawBuffer );
+		virtual void CaptureRect( FrameBufferObject* fbo, Texture& texture, const Rect& rect, const Rect& rawRect );
+		virtual void BindGeometry( Geometry* geometry );
+        virtual void BindTexture( Texture* texture, U32 unit );
+        virtual void BindUniform( Uniform* uniform, U32 unit );
+        virtual void BindProgram( Program* program, Program::Version version );
+        virtual void BindInstancing( U32 count, Geometry::Vertex* instanceData );
+        virtual void BindVertexFormat( FormatExtensionList* list, U16 fullCount, U16 vertexSize, U32 offset, Geometry::VertexPacking packing );
+        virtual void SetBlendEnabled( bool enabled );
+        virtual void SetBlendFunction( const BlendMode& mode );
+        virtual void SetBlendEquation( RenderTypes::BlendEquation mode );
+        virtual void SetViewport( int x, int y, int width, int height );
+        virtual void SetScissorEnabled( bool enabled );
+        virtual void SetScissorRegion( int x, int y, int width, int height );
+        virtual void SetMultisampleEnabled( bool enabled );
+        virtual void ClearDepth( Real depth );
+        virtual void ClearStencil( U32 stencil );
+        virtual void Clear( Real r, Real g, Real b, Real a );
+        virtual void Draw( U32 offset, U32 count, Geometry::PrimitiveType type );
+        virtual void DrawIndexed( U32 offset, U32 count, Geometry::PrimitiveType type );
+        virtual S32 GetCachedParam( CommandBuffer::QueryableParams param );
+
+        virtual void AddCommand( const CoronaCommand * command );
+        virtual void IssueCommand( U16 id, const void * data, U32 size );
+
+        virtual const unsigned char * GetBaseAddress() const { return fBuffer; }
+
+        virtual bool WriteNamedUniform( const char * uniformName, const void * data, unsigned int size );
+
+        // Walk all buffered commands, tallying them into the recording. No
+        // rendering context is required. Always returns 0 for GPU time.
+        virtual Real Execute( bool measureGPU );
+
+    public:
+        const Recording& GetRecording() const { return fRecording; }
+
+    private:
+        virtual void InitializeFBO();
+        virtual void InitializeCachedParams();
+        virtual void CacheQueryParam( CommandBuffer::QueryableParams param );
+
+    private:
+        template <typename T>
+        T Read();
+
+		template <typename T>
+		void Write(T);
+
+		struct UniformUpdate
+		{
+			Uniform* uniform;
+			U32 timestamp;
+		};
+
+		void ApplyUniforms();
+		void WriteUniform( Uniform* uniform );
+
+        U8 * Reserve( U32 size );
+
+		UniformUpdate fUniformUpdates[Uniform::kNumBuiltInVariables];
+		U32 fAppliedTimestamps[Uniform::kNumBuiltInVariables];
+		Program* fProgram;
+		S32 fCachedQuery[kNumQueryableParams];
+		U32 fNamedUniformCount;
+		U32 fNamedUniformBytes;
+
+        LightPtrArray< const CoronaCommand > fCustomCommands;
+
+        Recording fRecording;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_NullCommandBuffer_H__
@@ -92,6 +92,14 @@ class Program : public CPUResource
 		bool IsCompilerVerbose() const { return fCompilerVerbose; }
 		void SetCompilerVerbose( bool newValue ) { fCompilerVerbose = newValue; }
 
+		// Whether the shaders read neither z nor q, and so accept batches of
+		// Geometry::PackedVertex; and if so, whether they read the user data.
+		bool AcceptsPackedVertices() const { return fAcceptsPackedVertices; }
+		void SetAcceptsPackedVertices( bool newValue ) { fAcceptsPackedVertices = newValue; }
+
+		bool ReadsUserData() const { return fReadsUserData; }
+		void SetReadsUserData( bool newValue ) { fReadsUserData = newValue; }
+
 
 	private:
 		char *fVertexShaderSource;
@@ -104,6 +112,8 @@ class Program : public CPUResource
 		int fFragmentShellNumLines;
 		ShaderResource *fResource;
 		bool fCompilerVerbose;
+		bool fAcceptsPackedVertices;
+		bool fReadsUserData;
 };
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,154 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Renderer/Rtt_RecordingRenderer.h"
+
+#include "Renderer/Rtt_NullCommandBuffer.h"
+#include "Renderer/Rtt_Geometry_Renderer.h"
+#include "Renderer/Rtt_GPUResource.h"
+#include "Renderer/Rtt_CPUResource.h"
+#include "Renderer/Rtt_Texture.h"
+#include "Core/Rtt_Assert.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+namespace /*anonymous*/
+{
+
+// Stand-in for an API-specific resource. Texture data is still requested and
+// released, so that any decoding work done on demand is accounted for.
+class NullGPUResource : public GPUResource
+{
+	public:
+		typedef GPUResource Super;
+
+	public:
+		NullGPUResource( RecordingRenderer::Uploads& uploads )
+		:	fUploads( uploads )
+		{
+		}
+
+		virtual void Create( CPUResource* resource )
+		{
+			fHandle = this;
+
+			++fUploads.fCreateCount;
+			Upload( resource );
+		}
+
+		virtual void Update( CPUResource* resource )
+		{
+			++fUploads.fUpdateCount;
+			Upload( resource );
+		}
+
+		virtual void Destroy()
+		{
+			fHandle = 0;
+
+			++fUploads.fDestroyCount;
+		}
+
+	private:
+		void Upload( CPUResource* resource )
+		{
+			switch ( resource->GetType() )
+			{
+				case CPUResource::kGeometry:
+				{
+					Geometry* geometry = static_cast< Geometry* >( resource );
+
+					// Dynamic geometry is streamed per draw; see NullCommandBuffer
+					if ( geometry->GetStoredOnGPU() )
+					{
+						fUploads.fGeometryBytes += geometry->GetVerticesUsed() * sizeof( Geometry::Vertex );
+						fUploads.fGeometryBytes += geometry->GetIndicesUsed() * sizeof( Geometry::Index );
+					}
+					break;
+				}
+				case CPUResource::kTexture:
+				{
+					Texture* texture = static_cast< Texture* >( resource );
+
+					if ( texture->GetData() )
+					{
+						fUploads.fTextureBytes += texture->GetSizeInBytes();
+					}
+					texture->ReleaseData();
+					break;
+				}
+				default:
+					break;
+			}
+		}
+
+	private:
+		RecordingRenderer::Uploads& fUploads;
+};
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+RecordingRenderer::Uploads::Uploads()
+:	fCreateCount( 0 ),
+	fUpdateCount( 0 ),
+	fDestroyCount( 0 ),
+	fGeometryBytes( 0 ),
+	fTextureBytes( 0 )
+{
+}
+
+RecordingRenderer::RecordingRenderer( Rtt_Allocator* allocator )
+:	Super( allocator )
+{
+	fFrontCommandBuffer = Rtt_NEW( allocator, NullCommandBuffer( allocator ) );
+	fBackCommandBuffer = Rtt_NEW( allocator, NullCommandBuffer( allocator ) );
+}
+
+void
+RecordingRenderer::BeginFrame( Real totalTime, Real deltaTime, const TimeTransform *defTimeTransform, Real contentScaleX, Real contentScaleY, bool isCapture )
+{
+	fUploads = Uploads();
+
+	Super::BeginFrame( totalTime, deltaTime, defTimeTransform, contentScaleX, contentScaleY, isCapture );
+}
+
+const NullCommandBuffer::Recording&
+RecordingRenderer::GetRecording() const
+{
+	return static_cast< const NullCommandBuffer* >( fFrontCommandBuffer )->GetRecording();
+}
+
+GPUResource*
+RecordingRenderer::Create( const CPUResource* resource )
+{
+	switch( resource->GetType() )
+	{
+		case CPUResource::kFrameBufferObject:
+		case CPUResource::kGeometry:
+		case CPUResource::kProgram:
+		case CPUResource::kTexture:
+		case CPUResource::kVideoTexture:
+			return new NullGPUResource( fUploads );
+		case CPUResource::kUniform: return NULL;
+		default: Rtt_ASSERT_NOT_REACHED(); return NULL;
+	}
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
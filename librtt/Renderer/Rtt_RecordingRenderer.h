@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_RecordingRenderer_H__
+#define _Rtt_RecordingRenderer_H__
+
+#include "Renderer/Rtt_Renderer.h"
+#include "Renderer/Rtt_NullCommandBuffer.h"
+
+// ----------------------------------------------------------------------------
+
+struct Rtt_Allocator;
+
+namespace Rtt
+{
+
+class GPUResource;
+class CPUResource;
+
+// ----------------------------------------------------------------------------
+
+// Headless Renderer backed by NullCommandBuffers. GPU resources are stand-ins
+// that only tally the bytes that would have been uploaded. Selected through
+// the "nullBackend" backend name.
+class RecordingRenderer : public Renderer
+{
+	public:
+		typedef Renderer Super;
+		typedef RecordingRenderer Self;
+
+		// Resource traffic seen during the most recent Swap().
+		struct Uploads
+		{
+			Uploads();
+
+			U32 fCreateCount;
+			U32 fUpdateCount;
+			U32 fDestroyCount;
+			size_t fGeometryBytes;
+			size_t fTextureBytes;
+		};
+
+	public:
+		RecordingRenderer( Rtt_Allocator* allocator );
+
+	public:
+		virtual void BeginFrame( Real totalTime, Real deltaTime, const TimeTransform *defTimeTransform, Real contentScaleX, Real contentScaleY, bool isCapture = false );
+
+	public:
+		// Valid after Render(), i.e. describes the command stream just executed.
+		const NullCommandBuffer::Recording& GetRecording() const;
+
+		const Uploads& GetUploads() const { return fUploads; }
+		Uploads& GetUploads() { return fUploads; }
+
+	protected:
+		virtual GPUResource* Create( const CPUResource* resource );
+
+	private:
+		Uploads fUploads;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_RecordingRenderer_H__
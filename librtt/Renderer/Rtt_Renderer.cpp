@@ -25,6 +25,7 @@
 #include "Core/Rtt_Allocator.h"
 #include "Core/Rtt_Assert.h"
 #include "Core/Rtt_Math.h"
+#include "Core/Rtt_TraceRecorder.h"
 #include "Core/Rtt_Types.h"
 #include "Renderer/Rtt_MCPUResourceObserver.h"
 #include "Display/Rtt_ObjectHandle.h"
@@ -92,6 +93,85 @@ namespace /*anonymous*/
             }
         }
     }
+
+    // Indices needed to draw the geometry as a triangle list.
+    U32 ComputeRequiredIndices( Rtt::Geometry* geometry )
+    {
+        const U32 verticesUsed = geometry->GetVerticesUsed();
+
+        switch( geometry->GetPrimitiveType() )
+        {
+            case Rtt::Geometry::kTriangleStrip:
+            case Rtt::Geometry::kTriangleFan:
+                return verticesUsed > 2 ? 3 * ( verticesUsed - 2 ) : 0;
+            case Rtt::Geometry::kTriangles:
+                return verticesUsed - verticesUsed % 3;
+            default:
+                return 0;
+        }
+    }
+
+    // Geometry::Index is 16 bits wide.
+    const U32 kMaxIndexedVertices = 0xFFFF + 1;
+
+    // True if the geometry can be appended to an indexed triangle list.
+    bool IsIndexable( Rtt::Geometry* geometry )
+    {
+        switch( geometry->GetPrimitiveType() )
+        {
+            case Rtt::Geometry::kTriangleStrip:
+            case Rtt::Geometry::kTriangleFan:
+            case Rtt::Geometry::kTriangles:
+                return geometry->GetVerticesUsed() <= kMaxIndexedVertices;
+            default:
+                return false;
+        }
+    }
+
+    // Extent of the vertices in the x-y plane. This is a conservative stand-in
+    // for the pixels a draw touches; see Renderer::SetBatchSortingEnabled().
+    void ComputeBounds( Rtt::Geometry* geometry, Rtt::Rect& bounds )
+    {
+        const Rtt::Geometry::Vertex* vertices = geometry->GetVertexData();
+
+        bounds.SetEmpty();
+
+        for( U32 i = 0, iMax = geometry->GetVerticesUsed(); i < iMax; ++i )
+        {
+            Rtt::Vertex2 p = { vertices[i].x, vertices[i].y };
+            bounds.Union( p );
+        }
+    }
+
+    // Unlike Rect::Intersects(), touching edges count, so that lines and
+    // other zero-area bounds still keep their order.
+    bool BoundsOverlap( const Rtt::Rect& a, const Rtt::Rect& b )
+    {
+        return a.NotEmpty() && b.NotEmpty()
+            && a.xMin <= b.xMax && b.xMin <= a.xMax
+            && a.yMin <= b.yMax && b.yMin <= a.yMax;
+    }
+
+    // True if the two may be drawn back to back without changing any state.
+    bool IsSameState( const Rtt::RenderData& a, const Rtt::RenderData& b )
+    {
+        return a.fProgram == b.fProgram
+            && a.fFillTexture0 == b.fFillTexture0
+            && a.fFillTexture1 == b.fFillTexture1
+            && a.fMaskTexture == b.fMaskTexture
+            && a.fMaskUniform == b.fMaskUniform
+            && a.fUserUniform0 == b.fUserUniform0
+            && a.fUserUniform1 == b.fUserUniform1
+            && a.fUserUniform2 == b.fUserUniform2
+            && a.fUserUniform3 == b.fUserUniform3
+            && a.fBlendMode == b.fBlendMode
+            && a.fBlendEquation == b.fBlendEquation
+            && ( a.fGeometry->GetPrimitiveType() == b.fGeometry->GetPrimitiveType() || ( IsIndexable( a.fGeometry ) && IsIndexable( b.fGeometry ) ) )
+            && Rtt::FormatExtensionList::Match( a.fGeometry->GetExtensionList(), b.fGeometry->GetExtensionList() );
+    }
+
+    // Limits the search for a compatible group, so that flushing stays linear.
+    const S32 kMaxDeferredGroupSearch = 32;
 }
 
 // ----------------------------------------------------------------------------
@@ -151,19 +231,33 @@ void Renderer::Statistics::Log() const
 
 Renderer::Renderer( Rtt_Allocator* allocator )
 :    fAllocator( allocator ),
+    fCPUResourceObserver(NULL),
     fCreateQueue( allocator ),
     fUpdateQueue( allocator ),
     fDestroyQueue( allocator ),
-    fCPUResourceObserver(NULL),
     fGeometryPool( Rtt_NEW( fAllocator, GeometryPool( fAllocator ) ) ),
     fInstancingGeometryPool( Rtt_NEW( fAllocator, GeometryPool( fAllocator ) ) ),
     fFrontCommandBuffer( NULL ),
     fBackCommandBuffer( NULL ),
+    fViewProjectionMatrix( Rtt_NEW( fAllocator, Uniform( fAllocator, Uniform::kMat4 ) ) ),
     fTotalTime( Rtt_NEW( fAllocator, Uniform( fAllocator, Uniform::kScalar ) ) ),
     fDeltaTime( Rtt_NEW( fAllocator, Uniform( fAllocator, Uniform::kScalar ) ) ),
     fTexelSize( Rtt_NEW( fAllocator, Uniform( fAllocator, Uniform::kVec4 ) ) ),
     fContentScale( Rtt_NEW( fAllocator, Uniform( fAllocator, Uniform::kVec2 ) ) ),
-    fViewProjectionMatrix( Rtt_NEW( fAllocator, Uniform( fAllocator, Uniform::kMat4 ) ) ),
+    fMaskCountIndex( 0 ),
+    fMaskCount( allocator ),
+    fCurrentProgramMaskCount( 0 ),
+    fWireframeEnabled( false ),
+    fStatisticsEnabled( false ),
+    fScissorEnabled( false ),
+    fMultisampleEnabled( false ),
+    fFrameBufferObject( NULL ),
+	fVertexOffset( 0 ),
+    fRenderDataCount( 0 ),
+    fInsertionLimit( (std::numeric_limits<U32>::max)() ),
+	fVertexPacking( Geometry::kUnpacked ),
+	fCurrentGeometry( NULL ),
+    fTimeDependencyCount( 0 ),
 	fCaptureGroups( allocator ),
 	fCaptureRects( allocator ),
     fDefaultState( allocator ),
@@ -175,19 +269,9 @@ Renderer::Renderer( Rtt_Allocator* allocator )
     fGeometryWriters( allocator ),
     fCurrentGeometryWriterList( NULL ),
     fCanAddGeometryWriters( false ),
-    fMaskCountIndex( 0 ),
-    fMaskCount( allocator ),
-    fCurrentProgramMaskCount( 0 ),
-    fWireframeEnabled( false ),
-    fStatisticsEnabled( false ),
-    fScissorEnabled( false ),
-    fMultisampleEnabled( false ),
-    fFrameBufferObject( NULL ),
-    fInsertionLimit( (std::numeric_limits<U32>::max)() ),
-    fRenderDataCount( 0 ),
-	fVertexOffset( 0 ),
-	fCurrentGeometry( NULL ),
-    fTimeDependencyCount( 0 )
+    fDeferred( allocator ),
+    fDeferredGroups( allocator ),
+    fBatchSortingEnabled( false )
 {
     // Always have at least 1 mask count.
     fMaskCount.Append( 0 );
@@ -236,6 +320,7 @@ Renderer::BeginFrame( Real totalTime, Real deltaTime, const TimeTransform *defTi
     fVertexOffset = 0;
     fVertexCount = 0;
     fVertexExtra = 0;
+    fVertexPacking = Geometry::kUnpacked;
     fIndexOffset = 0;
     fIndexCount = 0;
     fRenderDataCount = 0;
@@ -248,6 +333,8 @@ Renderer::BeginFrame( Real totalTime, Real deltaTime, const TimeTransform *defTi
     fMaskCountIndex = 0;
     fMaskCount[0] = 0;
     fInsertionCount = 0;
+
+    fDeferred.Clear();
     
     SetGeometryWriters( NULL, 0 );
 
@@ -278,6 +365,7 @@ Renderer::BeginFrame( Real totalTime, Real deltaTime, const TimeTransform *defTi
 void
 Renderer::EndFrame()
 {
+    FlushDeferred();
     CheckAndInsertDrawCommand();
 
     // We usually want some default state when a frame starts, so
@@ -301,6 +389,8 @@ Renderer::BeginDrawing()
 void
 Renderer::CaptureFrameBuffer( RenderingStream & stream, BufferBitmap & bitmap, S32 x_in_pixels, S32 y_in_pixels, S32 w_in_pixels, S32 h_in_pixels )
 {
+	FlushDeferred();
+
 	stream.CaptureFrameBuffer( bitmap,
 		x_in_pixels,
 		y_in_pixels,
@@ -326,6 +416,7 @@ Renderer::SetFrustum( const Real* viewMatrix, const Real* projMatrix )
     memcpy( fViewMatrix, viewMatrix, ELEMENTS_PER_MAT4 * sizeof( Real ) );
     memcpy( fProjMatrix, projMatrix, ELEMENTS_PER_MAT4 * sizeof( Real ) );
 
+    FlushDeferred();
     CheckAndInsertDrawCommand();
     Real* data = reinterpret_cast<Real*>( fViewProjectionMatrix->GetData() );
     Multiply4x4( projMatrix, viewMatrix, data );
@@ -352,6 +443,7 @@ Renderer::SetViewport( S32 x, S32 y, S32 width, S32 height )
     fViewport[2] = width;
     fViewport[3] = height;
 
+    FlushDeferred();
     CheckAndInsertDrawCommand();
     fBackCommandBuffer->SetViewport( x, y, width, height );
     
@@ -390,6 +482,7 @@ Renderer::SetScissor( S32 x, S32 y, S32 width, S32 height )
     ClipToWindow( corner0, fViewport[2], fViewport[3], windowCoord0 );
     ClipToWindow( corner1, fViewport[2], fViewport[3], windowCoord1 );
 
+    FlushDeferred();
     CheckAndInsertDrawCommand();
 
     S32 x0 = static_cast<S32>( windowCoord0[0] );
@@ -411,6 +504,7 @@ void
 Renderer::SetScissorEnabled( bool enabled )
 {
     fScissorEnabled = enabled;
+    FlushDeferred();
     CheckAndInsertDrawCommand();
     fBackCommandBuffer->SetScissorEnabled( enabled );
     
@@ -427,6 +521,7 @@ void
 Renderer::SetMultisampleEnabled( bool enabled )
 {
     fMultisampleEnabled = enabled;
+    FlushDeferred();
     CheckAndInsertDrawCommand();
     fBackCommandBuffer->SetMultisampleEnabled( enabled );
     
@@ -442,6 +537,8 @@ Renderer::GetFrameBufferObject() const
 void
 Renderer::SetFrameBufferObject( FrameBufferObject* fbo )
 {
+    FlushDeferred();
+
     fFrameBufferObject = fbo;
 
     FlushBatch();
@@ -467,6 +564,7 @@ Renderer::SetFrameBufferObject( FrameBufferObject* fbo )
 void
 Renderer::Clear( Real r, Real g, Real b, Real a, const ExtraClearOptions * extraOptions ) 
 {
+    FlushDeferred();
     CheckAndInsertDrawCommand();
 
     if (extraOptions && extraOptions->clearDepth)
@@ -491,6 +589,7 @@ Renderer::Clear( Real r, Real g, Real b, Real a, const ExtraClearOptions * extra
 void
 Renderer::PushMask( Texture* maskTexture, Uniform* maskMatrix )
 {
+    FlushDeferred();
     CheckAndInsertDrawCommand();
     
     ++MaskCount();
@@ -506,6 +605,8 @@ Renderer::PushMask( Texture* maskTexture, Uniform* maskMatrix )
 void
 Renderer::PopMask()
 {
+    FlushDeferred();
+
     --MaskCount();
 
     // fCurrentProgramMaskCount is used to track batches. Thing is if we pop and then push new mask, it thinks we're in same batch.
@@ -521,6 +622,8 @@ Renderer::PopMask()
 void
 Renderer::PushMaskCount()
 {
+    FlushDeferred();
+
     ++fMaskCountIndex;
     
     // Always reset to 0
@@ -540,6 +643,8 @@ Renderer::PopMaskCount()
 {
     Rtt_ASSERT( fMaskCountIndex > 0 );
 
+    FlushDeferred();
+
     --fMaskCountIndex;
 }
 
@@ -551,7 +656,164 @@ Renderer::Insert( const RenderData* data, const ShaderData * shaderData )
     {
         return;
     }
-    
+
+    if( fBatchSortingEnabled && CanDefer( data, shaderData ) )
+    {
+        Defer( data, shaderData );
+    }
+    else
+    {
+        FlushDeferred();
+        InsertImmediate( data, shaderData );
+    }
+}
+
+bool
+Renderer::GetBatchSortingEnabled() const
+{
+    return fBatchSortingEnabled;
+}
+
+void
+Renderer::SetBatchSortingEnabled( bool enabled )
+{
+    if( !enabled )
+    {
+        FlushDeferred();
+    }
+
+    fBatchSortingEnabled = enabled;
+}
+
+bool
+Renderer::CanDefer( const RenderData* data, const ShaderData * shaderData ) const
+{
+    // Anything that writes to the CommandBuffer as a side effect of the
+    // insertion, or that reads vertex data only when drawn, must stay in order.
+    if( fWireframeEnabled || fCanAddGeometryWriters || fMaybeDirty || fCaptureGroups.Length() > 0 )
+    {
+        return false;
+    }
+
+    if( fGeometryWriters.Length() != 1 || fCurrentGeometryWriterList != &GeometryWriter::CopyGeometryWriter() )
+    {
+        return false;
+    }
+
+    Geometry* geometry = data->fGeometry;
+    Rtt_ASSERT( geometry );
+
+    if( geometry->GetStoredOnGPU() || Geometry::UsesInstancing( geometry->GetExtensionBlock(), geometry->GetExtensionList() ) )
+    {
+        return false;
+    }
+
+    const FormatExtensionList* programList = data->fProgram->GetShaderResource()->GetExtensionList();
+    if( programList && programList->HasInstanceRateData() )
+    {
+        return false;
+    }
+
+    if( shaderData )
+    {
+        const CoronaEffectCallbacks * effectCallbacks = data->fProgram->GetShaderResource()->GetEffectCallbacks();
+
+        if( effectCallbacks && effectCallbacks->shaderBind )
+        {
+            return false;
+        }
+    }
+
+    // Geometry reused for back to back draws (e.g. debug draw) is rewritten
+    // in between, so only its latest contents would survive.
+    S32 count = fDeferred.Length();
+    if( count > 0 && fDeferred[count - 1].fData.fGeometry == geometry )
+    {
+        return false;
+    }
+
+    return true;
+}
+
+void
+Renderer::Defer( const RenderData* data, const ShaderData * shaderData )
+{
+    DeferredData deferred;
+    deferred.fData = *data;
+    deferred.fShaderData = shaderData;
+    deferred.fNext = -1;
+    ComputeBounds( data->fGeometry, deferred.fBounds );
+
+    fDeferred.Append( deferred );
+}
+
+void
+Renderer::FlushDeferred()
+{
+    const S32 count = fDeferred.Length();
+    if( 0 == count )
+    {
+        return;
+    }
+
+    DeferredData* deferred = fDeferred.WriteAccess();
+
+    // Greedily move each draw back into the most recent group that shares
+    // its state, as long as nothing it would jump over overlaps it.
+    fDeferredGroups.Clear();
+
+    for( S32 i = 0; i < count; ++i )
+    {
+        DeferredData& item = deferred[i];
+        DeferredGroup* groups = fDeferredGroups.WriteAccess();
+        S32 target = -1;
+
+        for( S32 g = fDeferredGroups.Length() - 1, gMin = Max( 0, g - kMaxDeferredGroupSearch ); g >= gMin; --g )
+        {
+            if( IsSameState( deferred[groups[g].fFirst].fData, item.fData ) )
+            {
+                target = g;
+                break;
+            }
+
+            if( BoundsOverlap( groups[g].fBounds, item.fBounds ) )
+            {
+                break;
+            }
+        }
+
+        if( target >= 0 )
+        {
+            DeferredGroup& group = groups[target];
+            deferred[group.fLast].fNext = i;
+            group.fLast = i;
+            group.fBounds.Union( item.fBounds );
+        }
+        else
+        {
+            DeferredGroup group;
+            group.fFirst = group.fLast = i;
+            group.fBounds = item.fBounds;
+            fDeferredGroups.Append( group );
+        }
+    }
+
+    // Clear first, since nothing below may defer again
+    fDeferred.Clear();
+
+    const DeferredGroup* groups = fDeferredGroups.ReadAccess();
+    for( S32 g = 0, gMax = fDeferredGroups.Length(); g < gMax; ++g )
+    {
+        for( S32 i = groups[g].fFirst; i >= 0; i = deferred[i].fNext )
+        {
+            InsertImmediate( &deferred[i].fData, deferred[i].fShaderData );
+        }
+    }
+}
+
+void
+Renderer::InsertImmediate( const RenderData* data, const ShaderData * shaderData )
+{
     // Derived Renderers are required to allocate CommandBuffers
     Rtt_ASSERT( fBackCommandBuffer != NULL );
     Rtt_ASSERT( fFrontCommandBuffer != NULL );
@@ -604,6 +866,9 @@ Renderer::Insert( const RenderData* data, const ShaderData * shaderData )
     const Geometry::ExtensionBlock* block = geometry->GetExtensionBlock();
     bool isInstanced = Geometry::UsesInstancing( block, extensionList );
 	bool mustReconcileFormats = formatsDirty;
+    bool indexed = false;
+    Geometry::VertexPacking packing = Geometry::kUnpacked;
+    U32 firstVertex = 0;
 
     // Geometry that is stored on the GPU does not need to be copied
     // over each frame. As a consequence, they can not be batched.
@@ -632,10 +897,14 @@ Renderer::Insert( const RenderData* data, const ShaderData * shaderData )
         fCachedVertexOffset = fVertexOffset;
         fCachedVertexCount = fVertexCount;
         fCachedVertexExtra = fVertexExtra;
+        fCachedIndexOffset = fIndexOffset;
+        fCachedIndexCount = fIndexCount;
         fOffsetCorrection = 0;
         fVertexExtra = 0;
         fVertexOffset = 0;
+        fVertexPacking = Geometry::kUnpacked;
         fVertexCount = geometry->GetVerticesUsed();
+        fIndexOffset = 0;
         fIndexCount = geometry->GetIndicesUsed();
         fPreviousPrimitiveType = geometry->GetPrimitiveType();
     }
@@ -657,10 +926,20 @@ Renderer::Insert( const RenderData* data, const ShaderData * shaderData )
 				|| fCaptureGroups.Length() > 0 
                 || dirtyIndices.Length() > 0 );
 
-        // Only triangle strips are batched. All other primitive types
-        // force the previous batch to draw and a new one to be started.
-        Geometry::PrimitiveType primitiveType = geometry->GetPrimitiveType();
-        if( primitiveType != fPreviousPrimitiveType || primitiveType != Geometry::kTriangleStrip )
+        // Triangles of any kind are appended to an indexed triangle list,
+        // so they batch with one another. Otherwise, only triangle strips
+        // are batched, by way of degenerate triangles. All other primitive
+        // types force the previous batch to draw and a new one to be started.
+        indexed = UsesIndexedBatch( geometry, vertexExtra, isInstanced );
+        Geometry::PrimitiveType primitiveType = indexed ? Geometry::kIndexedTriangles : geometry->GetPrimitiveType();
+        if( primitiveType != fPreviousPrimitiveType || ( !indexed && primitiveType != Geometry::kTriangleStrip ) )
+        {
+            batch = false;
+        }
+
+        // Indexed data may also be packed, which changes the vertex layout.
+        packing = indexed ? ChooseVertexPacking( data, programList, extensionList ) : Geometry::kUnpacked;
+        if( packing != fVertexPacking )
         {
             batch = false;
         }
@@ -693,8 +972,10 @@ Renderer::Insert( const RenderData* data, const ShaderData * shaderData )
         
         // Depending on batching, wireframe, etc, the amount of space
         // needed may be more than what is used by the Geometry itself.
-        const U32 verticesComputed = ComputeRequiredVertices( geometry, fWireframeEnabled );
-        const U32 verticesRequired = verticesComputed * (1 + vertexExtra);
+        const U32 verticesComputed = indexed ? geometry->GetVerticesUsed() : ComputeRequiredVertices( geometry, fWireframeEnabled );
+        const U32 packedSize = Geometry::PackedVertex::GetSize( packing );
+        const U32 verticesRequired = Geometry::kUnpacked != packing ? Geometry::Vertex::SizeInVertices( verticesComputed * packedSize ) : verticesComputed * (1 + vertexExtra);
+        const U32 indicesRequired = indexed ? ComputeRequiredIndices( geometry ) : 0;
 //        bool enoughSpace = fCurrentGeometry;
 //        if ( enoughSpace )
 //        {
@@ -704,21 +985,55 @@ Renderer::Insert( const RenderData* data, const ShaderData * shaderData )
 
         bool enoughSpace = fCurrentGeometry && verticesRequired <=
          ( fCurrentGeometry->GetVerticesAllocated() - fCurrentGeometry->GetVerticesUsed() );
+        if( enoughSpace && indexed )
+        {
+            // Packed vertices are indexed from the start of their batch
+            const U32 indexLimit = Geometry::kUnpacked != packing ? ( batch ? fVertexCount : 0 ) + verticesComputed : fCurrentGeometry->GetVerticesUsed() + verticesRequired;
+
+            enoughSpace = indicesRequired <= ( fCurrentGeometry->GetIndicesAllocated() - fCurrentGeometry->GetIndicesUsed() )
+                && indexLimit <= kMaxIndexedVertices;
+        }
         if( !batch || !enoughSpace )
         {
-            UpdateBatch( batch, enoughSpace, storedOnGPU, verticesRequired );
+            UpdateBatch( batch, enoughSpace, storedOnGPU, verticesRequired, indicesRequired );
 
             if ( 0 == fVertexOffset )
 			{
 				mustReconcileFormats = true; // geometry is new
 			}
         }
+
+        // The packed layout's stride differs, and its pointers must start
+        // at the batch, since the pool is addressed in whole vertices.
+        if( packing != fVertexPacking || ( Geometry::kUnpacked != packing && 0 == fVertexCount ) )
+        {
+            mustReconcileFormats = true;
+        }
         
         fVertexExtra = vertexExtra;
+        fVertexPacking = packing;
 
         // Copy the the incoming vertex data into the current Geometry
-        // pool instance, even if the data will not be batched.
-        CopyVertexData( geometry, fCurrentVertex, batch && enoughSpace );
+        // pool instance, even if the data will not be batched. Indexed
+        // data needs no degenerate vertices; its indices are added below,
+        // once the base vertex is known.
+        firstVertex = fCurrentGeometry->GetVerticesUsed();
+        if( Geometry::kUnpacked != packing )
+        {
+            U8* destination = reinterpret_cast< U8* >( fCurrentGeometry->GetVertexData() + fVertexOffset );
+
+            Geometry::PackedVertex::Pack( destination + fVertexCount * packedSize, geometry->GetVertexData(), verticesComputed, packing );
+
+            firstVertex = fVertexCount;
+        }
+        else if( indexed )
+        {
+            WriteGeometry( fCurrentVertex, geometry->GetVertexData(), sizeof(Geometry::Vertex), 0, geometry->GetVerticesUsed() );
+        }
+        else
+        {
+            CopyVertexData( geometry, fCurrentVertex, batch && enoughSpace );
+        }
 
         if (isInstanced)
         {
@@ -729,9 +1044,19 @@ Renderer::Insert( const RenderData* data, const ShaderData * shaderData )
             mustReconcileFormats = true; // pointers out of date
         }
 
-        fCurrentVertex += verticesRequired;
-        fVertexCount += verticesComputed;
-        fCurrentGeometry->SetVerticesUsed( fCurrentGeometry->GetVerticesUsed() + verticesRequired );
+        if( Geometry::kUnpacked != packing )
+        {
+            // Round the batch, rather than each insertion, up to whole vertices
+            fVertexCount += verticesComputed;
+            fCurrentGeometry->SetVerticesUsed( fVertexOffset + Geometry::Vertex::SizeInVertices( fVertexCount * packedSize ) );
+            fCurrentVertex = fCurrentGeometry->GetVertexData() + fCurrentGeometry->GetVerticesUsed();
+        }
+        else
+        {
+            fCurrentVertex += verticesRequired;
+            fVertexCount += verticesComputed;
+            fCurrentGeometry->SetVerticesUsed( fCurrentGeometry->GetVerticesUsed() + verticesRequired );
+        }
 
         // Update previous batch
         fPreviousPrimitiveType = primitiveType;
@@ -953,7 +1278,14 @@ Renderer::Insert( const RenderData* data, const ShaderData * shaderData )
 			fOffsetCorrection = fVertexOffset;
 		}
 		
-        FormatExtensionList::ReconcileFormats( fAllocator, fBackCommandBuffer, programList, extensionList, fVertexOffset );
+        FormatExtensionList::ReconcileFormats( fAllocator, fBackCommandBuffer, programList, extensionList, fVertexOffset, fVertexPacking );
+    }
+
+    // Indices are relative to the vertex the formats were last reconciled at;
+    // packed vertices already are, cf. Pack() above.
+    if( indexed )
+    {
+        CopyIndexData( geometry, Geometry::kUnpacked != packing ? firstVertex : firstVertex - fOffsetCorrection );
     }
     
     if (dirtyIndices.Length() > 0)
@@ -970,6 +1302,8 @@ Renderer::Insert( const RenderData* data, const ShaderData * shaderData )
 void
 Renderer::Render()
 {
+    TRACE_SCOPE( render, "Renderer::Render" );
+
     Rtt_AbsoluteTime start = START_TIMING();
     fStatistics.fRenderTimeGPU = fFrontCommandBuffer->Execute( fStatisticsEnabled );
     fStatistics.fRenderTimeCPU = STOP_TIMING(start);
@@ -978,6 +1312,8 @@ Renderer::Render()
 void
 Renderer::Swap()
 {
+    TRACE_SCOPE( swap, "Renderer::Swap" );
+
 	ENABLE_SUMMED_TIMING( true );
 
     // Create GPUResources
@@ -1072,6 +1408,8 @@ Renderer::TallyTimeDependency( bool usesTime )
 U16
 Renderer::AddCustomCommand( const CoronaCommand & command )
 {
+    FlushDeferred();
+
     if ( 0xFFFF == (U16)fCustomInfo->fCommands.Length() )
     {
         return 0U;
@@ -1091,6 +1429,8 @@ Renderer::IssueCustomCommand( U16 id, const void * data, U32 size )
 {
     if ( id < (U16)fCustomInfo->fCommands.Length() )
     {
+        FlushDeferred();
+
         fBackCommandBuffer->IssueCommand( id, data, size );
 
         return true;
@@ -1102,6 +1442,8 @@ Renderer::IssueCustomCommand( U16 id, const void * data, U32 size )
 void
 Renderer::InsertCaptureRect( FrameBufferObject * fbo, Texture * texture, const Rect & clipped, const Rect & unclipped )
 {
+	FlushDeferred();
+
 	RectPair pair = {};
 	
 	pair.fClipped = clipped;
@@ -1202,6 +1544,11 @@ Renderer::GetStateBlockInfo( U16 id, U8 *& start, U32 & size, bool mightDirty )
     {
         const StateBlockInfo* info = fCustomInfo->fStateBlocks.ReadAccess()[id];
 
+        if ( mightDirty )
+        {
+            FlushDeferred();
+        }
+
         start = fWorkingState.WriteAccess() + info->fOffset;
         size = info->fSize;
 
@@ -1285,6 +1632,8 @@ Renderer::SetGeometryWriters( const GeometryWriter* list, U32 n )
 {
     if ( 0 == n || list != fCurrentGeometryWriterList )
     {
+        FlushDeferred();
+
         fGeometryWriters.Clear();
 
         if ( NULL == list )
@@ -1322,6 +1671,8 @@ Renderer::AddGeometryWriter( const GeometryWriter& writer, bool isUpdate )
         return false;
     }
 
+    FlushDeferred();
+
     S32 iMax = fGeometryWriters.Length(), insertPos = -1;
 
     if ( !isUpdate )
@@ -1355,6 +1706,7 @@ Renderer::AddGeometryWriter( const GeometryWriter& writer, bool isUpdate )
 Renderer::GeometryWriterRAII::GeometryWriterRAII( Renderer& renderer )
 :   fRenderer( renderer )
 {
+    fRenderer.FlushDeferred();
     fRenderer.fCanAddGeometryWriters = true;
 }
 
@@ -1791,7 +2143,7 @@ Renderer::FlushBatch()
 }
 
 void
-Renderer::UpdateBatch( bool batch, bool enoughSpace, bool storedOnGPU, U32 verticesRequired )
+Renderer::UpdateBatch( bool batch, bool enoughSpace, bool storedOnGPU, U32 verticesRequired, U32 indicesRequired )
 {
     CheckAndInsertDrawCommand();
     
@@ -1800,6 +2152,8 @@ Renderer::UpdateBatch( bool batch, bool enoughSpace, bool storedOnGPU, U32 verti
         fVertexOffset = fCachedVertexOffset;
         fVertexCount = fCachedVertexCount;
         fVertexExtra = fCachedVertexExtra;
+        fIndexOffset = fCachedIndexOffset;
+        fIndexCount = fCachedIndexCount;
 
         if( enoughSpace )
         {
@@ -1807,13 +2161,21 @@ Renderer::UpdateBatch( bool batch, bool enoughSpace, bool storedOnGPU, U32 verti
         }
     }
     
-    fVertexOffset += fVertexCount * (1 + fVertexExtra);
+    if( Geometry::kUnpacked != fVertexPacking )
+    {
+        fVertexOffset += Geometry::Vertex::SizeInVertices( fVertexCount * Geometry::PackedVertex::GetSize( fVertexPacking ) );
+    }
+    else
+    {
+        fVertexOffset += fVertexCount * (1 + fVertexExtra);
+    }
     fVertexCount = 0;
+    fIndexOffset += fIndexCount;
     fIndexCount = 0;
 
     if( !enoughSpace )
     {
-        fCurrentGeometry = fGeometryPool->GetOrCreate( verticesRequired );
+        fCurrentGeometry = fGeometryPool->GetOrCreate( verticesRequired, indicesRequired );
         if( !fCurrentGeometry->GetGPUResource() )
         {
             QueueCreate( fCurrentGeometry );
@@ -1821,11 +2183,103 @@ Renderer::UpdateBatch( bool batch, bool enoughSpace, bool storedOnGPU, U32 verti
 
         fCurrentVertex = fCurrentGeometry->GetVertexData();
         fVertexOffset = 0;
+        fIndexOffset = 0;
         fBackCommandBuffer->BindGeometry( fCurrentGeometry );
         INCREMENT( fStatistics.fGeometryBindCount );
     }
 }
 
+bool
+Renderer::UsesIndexedBatch( Geometry* geometry, U32 vertexExtra, bool isInstanced ) const
+{
+    // Wireframes are drawn as lines and extended formats interleave extra
+    // vertices, so both keep to the non-indexed path.
+    if( fWireframeEnabled || vertexExtra > 0 || isInstanced )
+    {
+        return false;
+    }
+
+    return IsIndexable( geometry );
+}
+
+Geometry::VertexPacking
+Renderer::ChooseVertexPacking( const RenderData* data, const FormatExtensionList* programList, const FormatExtensionList* geometryList ) const
+{
+    Program* program = data->fProgram;
+    const ShaderResource* shaderResource = program->GetShaderResource();
+
+    if( !program->AcceptsPackedVertices() || !fBackCommandBuffer->SupportsPackedVertices() )
+    {
+        return Geometry::kUnpacked;
+    }
+
+    // Anything that might rewrite the shell, or see the vertices on its own
+    if( programList || geometryList || shaderResource->GetShellTransform() || shaderResource->GetEffectCallbacks() )
+    {
+        return Geometry::kUnpacked;
+    }
+
+    if( fGeometryWriters.Length() != 1 || fCurrentGeometryWriterList != &GeometryWriter::CopyGeometryWriter() )
+    {
+        return Geometry::kUnpacked;
+    }
+
+    // e.g. repeating texture wraps
+    if( !Geometry::PackedVertex::CanPack( data->fGeometry->GetVertexData(), data->fGeometry->GetVerticesUsed() ) )
+    {
+        return Geometry::kUnpacked;
+    }
+
+    return program->ReadsUserData() ? Geometry::kPackedWithUserData : Geometry::kPacked;
+}
+
+void
+Renderer::CopyIndexData( Geometry* geometry, U32 firstIndex )
+{
+    const U32 indicesRequired = ComputeRequiredIndices( geometry );
+    const U32 indicesUsed = fCurrentGeometry->GetIndicesUsed();
+
+    Rtt_ASSERT( firstIndex + geometry->GetVerticesUsed() <= kMaxIndexedVertices );
+    Rtt_ASSERT( indicesUsed + indicesRequired <= fCurrentGeometry->GetIndicesAllocated() );
+
+    Geometry::Index* destination = fCurrentGeometry->GetIndexData() + indicesUsed;
+
+    switch( geometry->GetPrimitiveType() )
+    {
+        case Geometry::kTriangleStrip:
+            // Every other triangle is flipped to keep the strip's winding
+            for( U32 i = 0, iMax = indicesRequired / 3; i < iMax; ++i )
+            {
+                U32 odd = i & 1;
+
+                *destination++ = (Geometry::Index)( firstIndex + i + odd );
+                *destination++ = (Geometry::Index)( firstIndex + i + 1 - odd );
+                *destination++ = (Geometry::Index)( firstIndex + i + 2 );
+            }
+            break;
+        case Geometry::kTriangleFan:
+            for( U32 i = 0, iMax = indicesRequired / 3; i < iMax; ++i )
+            {
+                *destination++ = (Geometry::Index)( firstIndex );
+                *destination++ = (Geometry::Index)( firstIndex + i + 1 );
+                *destination++ = (Geometry::Index)( firstIndex + i + 2 );
+            }
+            break;
+        case Geometry::kTriangles:
+            for( U32 i = 0; i < indicesRequired; ++i )
+            {
+                *destination++ = (Geometry::Index)( firstIndex + i );
+            }
+            break;
+        default:
+            Rtt_ASSERT_NOT_REACHED();
+            break;
+    }
+
+    fCurrentGeometry->SetIndicesUsed( indicesUsed + indicesRequired );
+    fIndexCount += indicesRequired;
+}
+
 void
 Renderer::CopyVertexData( Geometry* geometry, Geometry::Vertex* destination, bool interior )
 {
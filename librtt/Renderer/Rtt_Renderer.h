@@ -149,6 +149,18 @@ class Renderer
 		// RenderData is properly drawn on the next call to Render().
 		void Insert( const RenderData* data, const ShaderData * shaderData = NULL );
 
+        // Return true if batch sorting is enabled. Disabled by default.
+        bool GetBatchSortingEnabled() const;
+
+        // When enabled, RenderData inserted between two render state changes
+        // (frustum, viewport, FBO, masks, etc.) is collected and regrouped so
+        // that draws with matching state become adjacent and may be batched.
+        // Painter's order is kept wherever geometry bounds overlap. Inserted
+        // Geometry must not be modified until the next state change, and
+        // vertex kernels that move vertices outside of them are not accounted
+        // for, so this is opt-in.
+        void SetBatchSortingEnabled( bool enabled );
+
         // Render all data added since the last call to swap(). It is both safe
         // and expected that Render() is called while another thread is adding
         // new RenderData and preparing it for the subsequent call to Render().
@@ -290,15 +302,22 @@ class Renderer
         void CheckAndInsertDrawCommand();
 
     private:
+        void InsertImmediate( const RenderData* data, const ShaderData * shaderData );
+        bool CanDefer( const RenderData* data, const ShaderData * shaderData ) const;
+        void Defer( const RenderData* data, const ShaderData * shaderData );
+        void FlushDeferred();
         U32 EnumerateDirtyBlocks( ArrayS32& dirtyIndices );
         void UpdateDirtyBlocks( const ArrayS32& dirtyIndices, U32 largestDirtySize );
         void RestoreDefaultBlocks();
         void InsertInstancing( const Geometry::ExtensionBlock* block, const FormatExtensionList* programList, const FormatExtensionList* geometryList );
         void FlushBatch();
+        bool UsesIndexedBatch( Geometry* geometry, U32 vertexExtra, bool isInstanced ) const;
+        Geometry::VertexPacking ChooseVertexPacking( const RenderData* data, const FormatExtensionList* programList, const FormatExtensionList* geometryList ) const;
     
     protected:
-        void UpdateBatch( bool batch, bool enoughSpace, bool storedOnGPU, U32 verticesRequired );
+        void UpdateBatch( bool batch, bool enoughSpace, bool storedOnGPU, U32 verticesRequired, U32 indicesRequired = 0 );
         void CopyVertexData( Geometry* geometry, Geometry::Vertex* destination, bool interior );
+        void CopyIndexData( Geometry* geometry, U32 firstIndex );
         void CopyTriangleStripsAsLines( Geometry* geometry, Geometry::Vertex* destination );
         void CopyTriangleFanAsLines( Geometry* geometry, Geometry::Vertex* destination );
         void CopyIndexedTrianglesAsLines( Geometry* geometry, Geometry::Vertex* destination );
@@ -372,8 +391,11 @@ class Renderer
         U32 fCachedVertexOffset;
         U32 fCachedVertexCount;
         U32 fCachedVertexExtra;
+        U32 fCachedIndexOffset;
+        U32 fCachedIndexCount;
 		U32 fOffsetCorrection;
         Geometry::PrimitiveType fPreviousPrimitiveType;
+        Geometry::VertexPacking fVertexPacking;
         Geometry::Vertex* fCurrentVertex;
         Geometry* fCurrentGeometry;
         Geometry::Vertex* fCurrentInstancingVertex;
@@ -411,6 +433,23 @@ class Renderer
         Array< GeometryWriter > fGeometryWriters;
         const GeometryWriter* fCurrentGeometryWriterList; // to detect change in writer; assumed to be stable object, i.e. either NULL (default) or some static array
         bool fCanAddGeometryWriters;
+
+        struct DeferredData {
+            RenderData fData;
+            const ShaderData* fShaderData;
+            Rect fBounds;
+            S32 fNext; // next entry in the same group, or -1
+        };
+
+        struct DeferredGroup {
+            S32 fFirst;
+            S32 fLast;
+            Rect fBounds; // union of members
+        };
+
+        Array< DeferredData > fDeferred;
+        Array< DeferredGroup > fDeferredGroups;
+        bool fBatchSortingEnabled;
 };
 
 // ----------------------------------------------------------------------------
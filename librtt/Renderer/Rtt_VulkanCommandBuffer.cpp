@@ -574,11 +574,8 @@ VulkanCommandBuffer::Draw( U32 offset, U32 count, Geometry::PrimitiveType type )
 }
 
 void 
-VulkanCommandBuffer::DrawIndexed( U32, U32 count, Geometry::PrimitiveType type )
+VulkanCommandBuffer::DrawIndexed( U32 offset, U32 count, Geometry::PrimitiveType type )
 {
-	// The first argument, offset, is currently unused. If support for non-
-	// VBO based indexed rendering is added later, an offset may be needed.
-
 	Rtt_ASSERT( fProgram && fProgram->GetGPUResource() );
 	ApplyUniforms( fProgram->GetGPUResource() );
 	
@@ -588,6 +585,7 @@ VulkanCommandBuffer::DrawIndexed( U32, U32 count, Geometry::PrimitiveType type )
 		case Geometry::kIndexedTriangles:	Write<VkPrimitiveTopology>(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);	break;
 		default: Rtt_ASSERT_NOT_REACHED(); break;
 	}
+	Write<U32>(offset);
 	Write<U32>(count);
 }
 
@@ -1368,17 +1366,15 @@ VulkanCommandBuffer::Execute( bool measureGPU )
 				case kCommandDrawIndexed:
 				{
 					VkPrimitiveTopology mode = Read<VkPrimitiveTopology>();
+					U32 offset = Read<U32>();
 					U32 count = Read<U32>();
 
 					if (PrepareDraw( commandBuffer, mode, descriptorImageInfo, pushConstants, stages ))
 					{
-						// The first argument, offset, is currently unused. If support for non-
-						// VBO based indexed rendering is added later, an offset may be needed.
-
-						vkCmdDrawIndexed( commandBuffer, count, 1U, 0U, 0U, 0U );
+						vkCmdDrawIndexed( commandBuffer, count, 1U, offset, 0U, 0U );
 					}
 
-					DEBUG_PRINT( "Draw indexed: mode=%i, count=%u", mode, count );
+					DEBUG_PRINT( "Draw indexed: mode=%i, offset=%u, count=%u", mode, offset, count );
 					CHECK_ERROR_AND_BREAK;
 				}
 				default:
@@ -83,7 +83,7 @@ class VulkanCommandBuffer : public CommandBuffer
 		virtual void BindUniform( Uniform* uniform, U32 unit );
 		virtual void BindProgram( Program* program, Program::Version version );
         virtual void BindInstancing( U32 count, Geometry::Vertex* instanceData ) { Rtt_ASSERT_NOT_IMPLEMENTED(); }
-        virtual void BindVertexFormat( FormatExtensionList* extensionList, U16 fullCount, U16 vertexSize, U32 offset ) { Rtt_ASSERT_NOT_IMPLEMENTED(); }
+        virtual void BindVertexFormat( FormatExtensionList* extensionList, U16 fullCount, U16 vertexSize, U32 offset, Geometry::VertexPacking packing ) { Rtt_ASSERT_NOT_IMPLEMENTED(); }
 		virtual void SetBlendEnabled( bool enabled );
 		virtual void SetBlendFunction( const BlendMode& mode );
 		virtual void SetBlendEquation( RenderTypes::BlendEquation mode );
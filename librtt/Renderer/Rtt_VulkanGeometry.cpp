@@ -29,6 +29,7 @@ VulkanGeometry::VulkanGeometry( VulkanContext * context )
 	fIndexBufferData( NULL ),
 	fResource( NULL ),
 	fMappedVertices( NULL ),
+	fMappedIndices( NULL ),
 	fVertexCount( 0U ),
 	fIndexCount( 0U )
 {
@@ -73,6 +74,17 @@ VulkanGeometry::Create( CPUResource* resource )
 		fMappedVertices = fContext->MapData( bufferData.GetMemory() );
 		fVertexBufferData = bufferData.Extract( NULL );
 
+		// e.g. indexed batches, built each frame in the renderer's geometry pool
+		if (fIndexCount > 0U)
+		{
+			VulkanBufferData indexData( fContext->GetDevice(), fContext->GetAllocator() );
+
+			fContext->CreateBuffer( fIndexCount * sizeof( Geometry::Index ), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, indexData );
+
+			fMappedIndices = fContext->MapData( indexData.GetMemory() );
+			fIndexBufferData = indexData.Extract( NULL );
+		}
+
 		fResource = geometry;
 	}
 }
@@ -110,6 +122,11 @@ VulkanGeometry::Update( CPUResource* resource )
 	else
 	{
 		memcpy( fMappedVertices, vertexData, geometry->GetVerticesUsed() * sizeof( Geometry::Vertex ) );
+
+		if (fMappedIndices)
+		{
+			memcpy( fMappedIndices, geometry->GetIndexData(), geometry->GetIndicesUsed() * sizeof( Geometry::Index ) );
+		}
 	}
 }
 
@@ -123,6 +140,13 @@ VulkanGeometry::Destroy()
 		fMappedVertices = NULL;
 	}
 
+	if (fMappedIndices)
+	{
+		vkUnmapMemory( fContext->GetDevice(), fIndexBufferData->GetMemory() );
+
+		fMappedIndices = NULL;
+	}
+
 	Rtt_DELETE( fVertexBufferData );
 	Rtt_DELETE( fIndexBufferData );
 
@@ -167,6 +191,13 @@ VulkanGeometry::Populate()
 
 		memcpy( fMappedVertices, fResource->GetVertexData(), fResource->GetVerticesUsed() * sizeof( Geometry::Vertex ) );
 	}
+
+	if (fResource && fResource->GetIndicesUsed())
+	{
+		Rtt_ASSERT( fMappedIndices );
+
+		memcpy( fMappedIndices, fResource->GetIndexData(), fResource->GetIndicesUsed() * sizeof( Geometry::Index ) );
+	}
 }
 
 VulkanBufferData *
@@ -52,6 +52,7 @@ class VulkanGeometry : public GPUResource
 		VulkanBufferData * fIndexBufferData;
 		Geometry * fResource;
 		void * fMappedVertices;
+		void * fMappedIndices;
 		U32 fVertexCount;
 		U32 fIndexCount;
 };
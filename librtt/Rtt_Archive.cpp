@@ -42,6 +42,8 @@
 #include <errno.h>
 #include <sys/stat.h>
 
+#include "../external/wyhash/wyhash.h"
+
 // #define Rtt_DEBUG_ARCHIVE 1
 
 // ----------------------------------------------------------------------------
@@ -224,6 +226,7 @@ struct ArchiveWriterEntry
 	size_t nameLen;
 	const char* srcPath;
 	size_t srcLen;
+	U32 record;
 };
 
 class ArchiveWriter
@@ -429,6 +432,7 @@ class ArchiveReader
 
 	public:
 		bool Seek( S32 offset, bool fromOrigin );
+		U32 GetPosition() const { return (U32)( (const U8*)fPos - (const U8*)fData ); }
 
 	protected:
 		void VerifyBounds() const;
@@ -478,7 +482,7 @@ ArchiveReader::Initialize( const void* data, size_t numBytes )
 }
 
 static U32
-ReadU32( U32 *p )
+ReadU32( const U32 *p )
 {
 	#ifdef Rtt_LITTLE_ENDIAN
 		return *p;
@@ -491,6 +495,61 @@ ReadU32( U32 *p )
 	#endif
 }
 
+static void
+WriteU32( U32 *p, U32 value )
+{
+	#ifdef Rtt_LITTLE_ENDIAN
+		*p = value;
+	#else
+		U8 *pp = (U8*)p;
+		pp[0] = (U8)(value & 0xFF);
+		pp[1] = (U8)(value >> 8 & 0xFF);
+		pp[2] = (U8)(value >> 16 & 0xFF);
+		pp[3] = (U8)(value >> 24 & 0xFF);
+	#endif
+}
+
+// ----------------------------------------------------------------------------
+
+// Index slots are pairs of little-endian U32's: { hash, record }, where record
+// is the file offset of the entry's Contents record and 0 marks an empty slot
+static const U32 kIndexSlotSize = 2;
+
+static U32
+HashResourceName( const char *name, size_t nameLen )
+{
+	return (U32)wyhash( name, nameLen, 0, _wyp );
+}
+
+// Smallest power of 2 that keeps the table at most half full
+static U32
+GetNumIndexSlots( size_t numEntries )
+{
+	U32 result = 2;
+	while ( result < numEntries * 2 )
+	{
+		result <<= 1;
+	}
+	return result;
+}
+
+// Linear probing. Entries are inserted in Contents order, so for duplicate
+// names the first one wins, as it did with the linear search.
+static void
+InsertIndexSlot( U32 *slots, U32 mask, U32 hash, U32 record )
+{
+	Rtt_ASSERT( record > 0 );
+
+	U32 i = hash & mask;
+	while ( 0 != ReadU32( slots + i*kIndexSlotSize + 1 ) )
+	{
+		i = ( i + 1 ) & mask;
+	}
+
+	WriteU32( slots + i*kIndexSlotSize, hash );
+	WriteU32( slots + i*kIndexSlotSize + 1, record );
+}
+
 U32
 ArchiveReader::ParseTag( U32& rLength )
 {
@@ -683,13 +742,20 @@ Archive::Serialize( const char *dstPath, int numSrcPaths, const char *srcPaths[]
 			entry.srcPath = path;
 			entry.srcLen = GetFileSize( path );
 
+			// record follows the Contents tag and numElements
+			entry.record = startPos + ArchiveWriter::kTagSize + contentsLen;
+
 			// type, offset, numChars, string data
 			contentsLen += 3*sizeof(U32) + GetByteAlignedValue< 4 >( entry.nameLen + 1 );
 		}
 
+		const U32 numSlots = GetNumIndexSlots( fileCount );
+		const U32 indexLen = sizeof(U32) + numSlots*kIndexSlotSize*sizeof(U32); // numSlots, slots
+
 		U32 offsetBase = startPos + contentsLen;
 
 		offsetBase += writer.Serialize( Archive::kContentsTag, contentsLen );
+		offsetBase += ArchiveWriter::kTagSize + indexLen;
 
 		// Contents
 		// --------------------------
@@ -722,6 +788,30 @@ Archive::Serialize( const char *dstPath, int numSrcPaths, const char *srcPaths[]
 				+ sizeof(U32);
 		}
 
+		// Index
+		// --------------------------
+		//   U32        numSlots (power of 2)
+		//   Slot[]     {
+		//                U32 hash (wyhash of name)
+		//                U32 record (offset of Contents record, 0 if empty)
+		//              }
+		//
+		// Optional. Readers that predate it never look past Contents, since
+		// they locate Data through the offsets stored in each record.
+		std::vector< U32 > slots( numSlots*kIndexSlotSize, 0 );
+		for ( size_t i = 0; i < fileCount; i++ )
+		{
+			const ArchiveWriterEntry& entry = entries[i];
+			InsertIndexSlot( & slots[0], numSlots - 1, HashResourceName( entry.name, entry.nameLen ), entry.record );
+		}
+
+		writer.Serialize( kIndexTag, indexLen );
+		writer.Serialize( numSlots );
+		for ( size_t i = 0; i < slots.size(); i++ )
+		{
+			writer.Serialize( ReadU32( & slots[i] ) );
+		}
+
 		// Data
 		// --------------------------
 		//   String     data
@@ -968,7 +1058,9 @@ Archive::List(const char *srcCarFile)
 
 Archive::Archive( Rtt_Allocator& allocator, const char *srcPath )
 :	fAllocator( allocator ),
-	fEntries( NULL ),
+	fIndex( NULL ),
+	fOwnedIndex( NULL ),
+	fIndexMask( 0 ),
 	fNumEntries( 0 ),
 #if defined( Rtt_ARCHIVE_COPY_DATA )
 	fBits( &allocator ),
@@ -1069,20 +1161,53 @@ Archive::Archive( Rtt_Allocator& allocator, const char *srcPath )
 			{
 				case kContentsTag:
 					{
+						const U32 contentsEnd = reader.GetPosition() + tagLen;
 						U32 numElements = reader.ParseU32();
-						fEntries = (ArchiveEntry*)Rtt_MALLOC( & allocator, sizeof( ArchiveEntry )*numElements );
 						fNumEntries = numElements;
-#if Rtt_DEBUG_ARCHIVE
-						Rtt_TRACE( ( "[Archive::Archive] fNumEntries %ld, fEntries %p\n", fNumEntries, fEntries ) );
-#endif
 
-						for ( U32 i = 0; i < numElements; i++ )
+						if ( 0 == numElements )
 						{
-							ArchiveEntry& entry = fEntries[i];
-							entry.type = reader.ParseU32();
-							entry.offset = reader.ParseU32();
-							entry.name = reader.ParseString();
+							break;
+						}
+
+						// Use the precomputed index when the archive has one
+						reader.Seek( contentsEnd, true );
+						U32 indexLen;
+						if ( kIndexTag == reader.ParseTag( indexLen ) )
+						{
+							U32 numSlots = reader.ParseU32();
+							bool isValid = numSlots >= numElements
+								&& 0 == ( numSlots & ( numSlots - 1 ) )
+								&& indexLen == sizeof(U32) + numSlots*kIndexSlotSize*sizeof(U32);
+
+							if ( Rtt_VERIFY( isValid ) )
+							{
+								fIndex = (const U32*)( (const U8*)fData + reader.GetPosition() );
+								fIndexMask = numSlots - 1;
+							}
 						}
+
+						// Otherwise hash the names in Contents
+						if ( ! fIndex )
+						{
+							U32 numSlots = GetNumIndexSlots( numElements );
+							fOwnedIndex = (U32*)Rtt_CALLOC( & allocator, numSlots*kIndexSlotSize, sizeof( U32 ) );
+							fIndex = fOwnedIndex;
+							fIndexMask = numSlots - 1;
+
+							reader.Seek( contentsEnd - tagLen + sizeof( U32 ), true );
+							for ( U32 i = 0; i < numElements; i++ )
+							{
+								U32 record = reader.GetPosition();
+								reader.ParseU32(); // type
+								reader.ParseU32(); // offset
+								const char *name = reader.ParseString();
+								InsertIndexSlot( fOwnedIndex, fIndexMask, HashResourceName( name, strlen( name ) ), record );
+							}
+						}
+#if Rtt_DEBUG_ARCHIVE
+						Rtt_TRACE( ( "[Archive::Archive] fNumEntries %ld, fIndex %p, owned %d\n", fNumEntries, fIndex, NULL != fOwnedIndex ) );
+#endif
 					}
 					break;
 				default:
@@ -1112,7 +1237,7 @@ Archive::~Archive()
 	}
 #endif
 
-	Rtt_FREE( fEntries );
+	Rtt_FREE( fOwnedIndex );
 
 }
 
@@ -1167,9 +1292,29 @@ Archive::LoadResource( lua_State *L, const char *name )
 
 	reader.Initialize( fData, fDataLen );
 
-	for ( size_t i = 0, iMax = fNumEntries; i < iMax; i++ )
+	// Probe from the name's home slot until an empty one. fIndex is NULL for
+	// archives without entries
+	for ( U32 hash = ( fIndex ? HashResourceName( name, strlen( name ) ) : 0 ), i = hash & fIndexMask, n = 0;
+		  fIndex && n <= fIndexMask;
+		  i = ( i + 1 ) & fIndexMask, n++ )
 	{
-		ArchiveEntry& entry = fEntries[i];
+		const U32 *slot = fIndex + i*kIndexSlotSize;
+		U32 record = ReadU32( slot + 1 );
+		if ( 0 == record )
+		{
+			break;
+		}
+
+		if ( ReadU32( slot ) != hash )
+		{
+			continue;
+		}
+
+		reader.Seek( record, true );
+		ArchiveEntry entry;
+		entry.type = reader.ParseU32();
+		entry.offset = reader.ParseU32();
+		entry.name = reader.ParseString();
 		if ( 0 == Rtt_StringCompare( entry.name, name ) )
 		{
 			reader.Seek( entry.offset, true );
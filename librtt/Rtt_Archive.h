@@ -42,13 +42,13 @@ class Archive
 			kUnknownTag = 0x0,
 			kContentsTag = 0x1,
 			kDataTag = 0x2,
+			kIndexTag = 0x3,
 			
 			kEOFTag = 0xFFFFFFFF
 		}
 		Tag;
 
 	private:
-		// TODO: Create a hash table (keyed by resource type and then name)
 		struct ArchiveEntry
 		{
 			U32 type;
@@ -74,9 +74,15 @@ class Archive
 		int DoResource( lua_State *L, const char *name, int narg );
 
 	private:
+		// Resources are looked up by the hash of their name in an open
+		// addressing table of { hash, record offset } slots. The table is
+		// read from the archive's Index section, or built from the Contents
+		// section for archives written before it existed.
 		Rtt_Allocator& fAllocator;
 //		int fDescriptor;
-		ArchiveEntry* fEntries;
+		const U32* fIndex;
+		U32* fOwnedIndex;
+		U32 fIndexMask;
 		size_t fNumEntries;
 		const void* fData;
 		size_t fDataLen;
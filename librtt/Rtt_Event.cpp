@@ -22,6 +22,7 @@
 #include "Display/Rtt_BitmapPaint.h"
 #include "Display/Rtt_Display.h"
 #include "Display/Rtt_DisplayObject.h"
+#include "Display/Rtt_HitTestGrid.h"
 #include "Display/Rtt_StageObject.h"
 #include "Input/Rtt_PlatformInputAxis.h"
 #include "Input/Rtt_PlatformInputDevice.h"
@@ -56,12 +57,98 @@ const char MEvent::kDataKey[] = "data";
 // since we can use kIsErrorKey to tell us how to interpret the response
 static const char kErrorMessageKey[] = "errorMessage";
 
+// Maps event names to their reusable tables, and each table to true while
+// it is being dispatched. Only present once table reuse is enabled.
+static const char kReusedEventTablesKey[] = "_corona.reusedEventTables." __FILE__;
+
 // ----------------------------------------------------------------------------
 
+void
+VirtualEvent::EnableTableReuse( lua_State *L )
+{
+	lua_newtable( L );
+	lua_setfield( L, LUA_REGISTRYINDEX, kReusedEventTablesKey );
+}
+
+VirtualEvent::VirtualEvent()
+:	fHoldsReusedTable( false )
+{
+}
+
 VirtualEvent::~VirtualEvent()
 {
 }
 
+bool
+VirtualEvent::IsReusable() const
+{
+	return false;
+}
+
+// Pushes the table reused for Name(), emptied except for its name, unless
+// that table is still in use further up the stack, e.g. by a listener that
+// caused another event of the same kind to be dispatched
+bool
+VirtualEvent::PushReusedTable( lua_State *L ) const
+{
+	lua_getfield( L, LUA_REGISTRYINDEX, kReusedEventTablesKey );
+	if ( ! lua_istable( L, -1 ) )
+	{
+		lua_pop( L, 1 );
+		return false;
+	}
+
+	const char *name = Name();
+
+	lua_getfield( L, -1, name );
+	if ( lua_istable( L, -1 ) )
+	{
+		lua_pushvalue( L, -1 );
+		lua_rawget( L, -3 );
+		bool isInUse = lua_toboolean( L, -1 );
+		lua_pop( L, 1 );
+
+		if ( isInUse )
+		{
+			lua_pop( L, 2 );
+			return false;
+		}
+
+		// Setting existing fields to nil keeps their slots, so overwriting
+		// them afterwards does not allocate
+		lua_pushnil( L );
+		while ( lua_next( L, -2 ) )
+		{
+			lua_pop( L, 1 );
+			lua_pushvalue( L, -1 );
+			lua_pushnil( L );
+			lua_rawset( L, -4 );
+		}
+
+		lua_pushnil( L );
+		lua_setmetatable( L, -2 );
+	}
+	else
+	{
+		lua_pop( L, 1 );
+		lua_newtable( L );
+		lua_pushvalue( L, -1 );
+		lua_setfield( L, -3, name );
+	}
+
+	lua_pushvalue( L, -1 );
+	lua_pushboolean( L, 1 );
+	lua_rawset( L, -4 );
+	lua_remove( L, -2 );
+
+	lua_pushstring( L, name );
+	lua_setfield( L, -2, kNameKey );
+
+	fHoldsReusedTable = true;
+
+	return true;
+}
+
 int
 VirtualEvent::PrepareDispatch( lua_State *L ) const
 {
@@ -77,12 +164,46 @@ VirtualEvent::Dispatch( lua_State *L, Runtime& ) const
 	// Invoke Lua code: "Runtime:dispatchEvent( eventKey )"
 	int nargs = PrepareDispatch( L );
 	LuaContext::DoCall( L, nargs, 0 );
+	DidDispatch( L );
+}
+
+void
+VirtualEvent::DidDispatch( lua_State *L ) const
+{
+	if ( fHoldsReusedTable )
+	{
+		fHoldsReusedTable = false;
+
+		lua_getfield( L, LUA_REGISTRYINDEX, kReusedEventTablesKey );
+		lua_getfield( L, -1, Name() );
+		lua_pushnil( L );
+		lua_rawset( L, -3 );
+		lua_pop( L, 1 );
+	}
+}
+
+int
+VirtualEvent::PushUnique( lua_State *L ) const
+{
+	// Push() only reuses a table if this event does not already hold one
+	bool holdsReusedTable = fHoldsReusedTable;
+	fHoldsReusedTable = true;
+
+	int result = Push( L );
+
+	fHoldsReusedTable = holdsReusedTable;
+
+	return result;
 }
 
 int
 VirtualEvent::Push( lua_State *L ) const
 {
-	Lua::NewEvent( L, Name() ); Rtt_ASSERT( lua_istable( L, -1 ) );
+	if ( ! IsReusable() || fHoldsReusedTable || ! PushReusedTable( L ) )
+	{
+		Lua::NewEvent( L, Name() );
+	}
+	Rtt_ASSERT( lua_istable( L, -1 ) );
 	return 1;
 }
 
@@ -153,6 +274,12 @@ FrameEvent::Push( lua_State *L ) const
 	return 1;
 }
 
+bool
+FrameEvent::IsReusable() const
+{
+	return true;
+}
+
 // ----------------------------------------------------------------------------
 
 const RenderEvent&
@@ -188,6 +315,12 @@ RenderEvent::Push( lua_State *L ) const
 	return 1;
 }
 
+bool
+RenderEvent::IsReusable() const
+{
+	return true;
+}
+
 // ----------------------------------------------------------------------------
 
 const char*
@@ -999,6 +1132,12 @@ BaseCollisionEvent::Push( lua_State *L ) const
 	return 1;
 }
 
+bool
+BaseCollisionEvent::IsReusable() const
+{
+	return true;
+}
+
 // Collision events follow a propagation model similar to touch events.
 // They propagate to object1, then object2, then to the global Runtime.
 // The choice of object1 and object2 is *arbitrary*, determined by Box2D.
@@ -1011,6 +1150,18 @@ BaseCollisionEvent::Push( lua_State *L ) const
 // so the Lua listener would return true to stop propagation.
 void
 BaseCollisionEvent::Dispatch( lua_State *L, Runtime& runtime ) const
+{
+	bool handled = DispatchToObjects( L );
+
+	if ( ! handled )
+	{
+		// Send to global Runtime
+		Super::Dispatch( L, runtime );
+	}
+}
+
+bool
+BaseCollisionEvent::DispatchToObjects( lua_State *L ) const
 {
 	Rtt_ASSERT( ! fOther ); // fOther is merely a cache for the Push()
 
@@ -1025,11 +1176,7 @@ BaseCollisionEvent::Dispatch( lua_State *L, Runtime& runtime ) const
 
 	fOther = NULL; // Always reset fOther
 
-	if ( ! handled )
-	{
-		// Send to global Runtime
-		Super::Dispatch( L, runtime );
-	}
+	return handled;
 }
 
 CollisionEvent::CollisionEvent( DisplayObject& object1, DisplayObject& object2, Real x, Real y, int fixtureIndex1, int fixtureIndex2, const char *phase )
@@ -1038,10 +1185,11 @@ CollisionEvent::CollisionEvent( DisplayObject& object1, DisplayObject& object2,
 {
 }
 
+const char CollisionEvent::kName[] = "collision";
+
 const char*
 CollisionEvent::Name() const
 {
-	static const char kName[] = "collision";
 	return kName;
 }
 
@@ -1076,10 +1224,11 @@ PostCollisionEvent::PostCollisionEvent( DisplayObject& object1, DisplayObject& o
 {
 }
 
+const char PostCollisionEvent::kName[] = "postCollision";
+
 const char*
 PostCollisionEvent::Name() const
 {
-	static const char kName[] = "postCollision";
 	return kName;
 }
 
@@ -1632,6 +1781,12 @@ HitEvent::InvalidateTime()
 	fTime = -1.;
 }
 
+bool
+HitEvent::IsReusable() const
+{
+	return true;
+}
+
 enum HitTestProperties
 {
 	kHitTestHandled = 0x1,
@@ -1703,93 +1858,114 @@ HitEvent::Test( HitTestObject& hitParent, const Matrix& srcToDstSpace ) const
 	const Display& display = stage->GetDisplay();
 	Rtt_Allocator *allocator = display.GetRuntime().GetAllocator();
 
+	// Large groups only visit the children whose bounds may contain the point
+	HitTestGrid *grid = object.GetHitTestGrid();
+	if ( grid )
+	{
+		Array< S32 > candidates( allocator );
+		grid->Query( object, fXContent, fYContent, candidates );
+
+		for ( S32 i = 0, iMax = candidates.Length(); i < iMax; i++ )
+		{
+			TestChild( hitParent, object.ChildAt( candidates[i] ), xform, display );
+		}
+	}
+	else
+	{
+		for ( S32 i = 0, iMax = object.NumChildren(); i < iMax; i++ )
+		{
+			TestChild( hitParent, object.ChildAt( i ), xform, display );
+		}
+	}
+}
+
+void
+HitEvent::TestChild( HitTestObject& hitParent, DisplayObject& child, const Matrix& xform, const Display& display ) const
+{
+	Rtt_Allocator *allocator = display.GetRuntime().GetAllocator();
+
 	Real x = fXContent;
 	Real y = fYContent;
 
-	for ( S32 i = 0, iMax = object.NumChildren(); i < iMax; i++ )
+	// Only add visible/hitTestable objects
+	// and in the multitouch case, do not have per object focus id set
+	// since we dispatch focused events outside of hit testing.
+	if ( child.ShouldHitTest() && ! child.GetFocusId() && ( !child.SkipsHitTest() && child.CanHitTest()) )
 	{
-		DisplayObject& child = object.ChildAt( i );
-
-		// Only add visible/hitTestable objects
-		// and in the multitouch case, do not have per object focus id set
-		// since we dispatch focused events outside of hit testing.
-		if ( child.ShouldHitTest() && ! child.GetFocusId() && ( !child.SkipsHitTest() && child.CanHitTest()) )
+		GroupObject* childAsGroup = child.AsGroupObject();
+		if ( ! childAsGroup )
 		{
-			GroupObject* childAsGroup = child.AsGroupObject();
-			if ( ! childAsGroup )
-			{
 //				Rtt_ASSERT( child.IsStageBoundsValid() || ! child.CanCull() );
 
-				// Only test if object is actually on-screen
-				// Test bounding box before doing more expensive testing
-				if ( ! child.IsOffScreen() && child.StageBounds().HitTest( fXContent, fYContent ) )
+			// Only test if object is actually on-screen
+			// Test bounding box before doing more expensive testing
+			if ( ! child.IsOffScreen() && child.StageBounds().HitTest( fXContent, fYContent ) )
+			{
+				Rtt_ASSERT( child.IsStageBoundsValid() );
+				child.Prepare( display );
+
+				// TODO: Should we only do SetForceDraw() if the object is hidden?
+				// Ensure Draw() is not a no-op for hidden objects
+				// as defined by DisplayObject::IsNotHidden()
+				bool oldValue = child.IsForceDraw();
+				child.SetForceDraw( true );
+
+				bool didHit = child.HitTest( x, y );
+
+				child.SetForceDraw( oldValue );
+
+				// Only do deeper testing if a mask exists and the "isHitTestMasked" property is true
+				if ( didHit && child.IsHitTestMasked() && child.GetMask() )
+				{
+					Matrix childToDst( xform );
+					childToDst.Concat( child.GetMatrix() );
+					didHit = TestMask( allocator, child, childToDst, x, y );
+				}
+
+				if ( didHit )
 				{
-					Rtt_ASSERT( child.IsStageBoundsValid() );
-					child.Prepare( display );
-
-					// TODO: Should we only do SetForceDraw() if the object is hidden?
-					// Ensure Draw() is not a no-op for hidden objects
-					// as defined by DisplayObject::IsNotHidden()
-					bool oldValue = child.IsForceDraw();
-					child.SetForceDraw( true );
-
-					bool didHit = child.HitTest( x, y );
-
-					child.SetForceDraw( oldValue );
-
-					// Only do deeper testing if a mask exists and the "isHitTestMasked" property is true
-					if ( didHit && child.IsHitTestMasked() && child.GetMask() )
-					{
-						Matrix childToDst( xform );
-						childToDst.Concat( child.GetMatrix() );
-						didHit = TestMask( allocator, child, childToDst, x, y );
-					}
-
-					if ( didHit )
-					{
-						// Only if we hit, do we add child to the snapshot
-						HitTestObject* hitChild = Rtt_NEW( object.Allocator(), HitTestObject( child, & hitParent ) );
-						hitParent.Prepend( hitChild );
-					}
+					// Only if we hit, do we add child to the snapshot
+					HitTestObject* hitChild = HitTestObject::New( child, & hitParent );
+					hitParent.Prepend( hitChild );
 				}
 			}
-			else
+		}
+		else
+		{
+			// By default, we hit test children, but if the group has hit test masking on,
+			// then we hit test the group's clipped bounding box before we attempt to
+			// hit test the group's children.
+			bool hitTestChildren = child.HitTest( x, y );
+			if( hitTestChildren && child.IsHitTestMasked() )
 			{
-				// By default, we hit test children, but if the group has hit test masking on,
-				// then we hit test the group's clipped bounding box before we attempt to
-				// hit test the group's children.
-				bool hitTestChildren = child.HitTest( x, y );
-				if( hitTestChildren && child.IsHitTestMasked() )
+				// By default, stage bounds of composite objects are not built.
+				child.BuildStageBounds();
+				hitTestChildren = child.StageBounds().HitTest( x, y );
+
+				// Only do deeper testing if a mask exists and the "isHitTestMasked" property is true
+				if ( hitTestChildren && child.GetMask() )
 				{
-					// By default, stage bounds of composite objects are not built.
-					child.BuildStageBounds();
-					hitTestChildren = child.StageBounds().HitTest( x, y );
-
-					// Only do deeper testing if a mask exists and the "isHitTestMasked" property is true
-					if ( hitTestChildren && child.GetMask() )
-					{
-						Matrix childToDst( xform );
-						childToDst.Concat( child.GetMatrix() );
-
-						hitTestChildren = TestMask( allocator, child, childToDst, x, y );
-					}
+					Matrix childToDst( xform );
+					childToDst.Concat( child.GetMatrix() );
+
+					hitTestChildren = TestMask( allocator, child, childToDst, x, y );
 				}
+			}
 
-				if ( hitTestChildren )
+			if ( hitTestChildren )
+			{
+				HitTestObject* hitGroup = HitTestObject::New( child, & hitParent );
+
+				// Recursively call on children
+				Test( * hitGroup, xform );
+				if ( hitGroup->NumChildren() > 0 )
+				{
+					// Only groups that contain children that were hit are added to the snapshot
+					hitParent.Prepend( hitGroup );
+				}
+				else
 				{
-					HitTestObject* hitGroup = Rtt_NEW( object.Allocator(), HitTestObject( child, & hitParent ) );
-
-					// Recursively call on children
-					Test( * hitGroup, xform );
-					if ( hitGroup->NumChildren() > 0 )
-					{
-						// Only groups that contain children that were hit are added to the snapshot
-						hitParent.Prepend( hitGroup );
-					}
-					else
-					{
-						Rtt_DELETE( hitGroup );
-					}
+					HitTestObject::Delete( hitGroup );
 				}
 			}
 		}
@@ -2905,6 +3081,12 @@ SpriteEvent::Push( lua_State *L ) const
 	return 1;
 }
 
+bool
+SpriteEvent::IsReusable() const
+{
+	return true;
+}
+
 // ----------------------------------------------------------------------------
 
 const char NetworkRequestEvent::kName[] = "networkRequest";
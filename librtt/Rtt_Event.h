@@ -81,22 +81,47 @@ class MEvent
 		virtual const char* Name() const = 0;
 		virtual int Push( lua_State *L ) const = 0;
 		virtual void Dispatch( lua_State *L, Runtime& runtime ) const = 0;
+
+		// Called once the table from Push() has been handed to the listeners
+		virtual void DidDispatch( lua_State *L ) const = 0;
 };
 
 // Base class for all derived event types
 class VirtualEvent : public MEvent
 {
 	public:
+		VirtualEvent();
 		virtual ~VirtualEvent();
 
+	public:
+		// Opt-in via "reuseEventTables" in config.lua. Events that are sent
+		// many times per frame then overwrite one table per event name,
+		// kept in the registry, instead of allocating a new one per Push().
+		// Listeners must not hold on to such tables past their dispatch.
+		static void EnableTableReuse( lua_State *L );
+
 	public:
 		virtual int Push( lua_State *L ) const;
 
+		// Like Push(), but never with a reused table, e.g. for tables that
+		// outlive the dispatch
+		int PushUnique( lua_State *L ) const;
+
 	protected:
 		int PrepareDispatch( lua_State *L ) const;
 
+		// True for the high-frequency events whose tables may be reused
+		virtual bool IsReusable() const;
+
 	public:
 		virtual void Dispatch( lua_State *L, Runtime& runtime ) const;
+		virtual void DidDispatch( lua_State *L ) const;
+
+	private:
+		bool PushReusedTable( lua_State *L ) const;
+
+	private:
+		mutable bool fHoldsReusedTable;
 };
 
 // Base class for all events that want to report an error
@@ -137,6 +162,9 @@ class FrameEvent : public VirtualEvent
 	public:
 		virtual const char* Name() const;
 		virtual int Push( lua_State *L ) const;
+
+	protected:
+		virtual bool IsReusable() const;
 };
 
 // ============================================================================
@@ -156,6 +184,9 @@ class RenderEvent : public VirtualEvent
 	public:
 		virtual const char* Name() const;
 		virtual int Push( lua_State *L ) const;
+
+	protected:
+		virtual bool IsReusable() const;
 };
 
 // ----------------------------------------------------------------------------
@@ -579,6 +610,12 @@ class BaseCollisionEvent : public VirtualEvent
 	public:
 		virtual int Push( lua_State *L ) const;
 		virtual void Dispatch( lua_State *L, Runtime& runtime ) const;
+
+		// Dispatch() minus the Runtime; returns true if an object handled it
+		bool DispatchToObjects( lua_State *L ) const;
+
+	protected:
+		virtual bool IsReusable() const;
 		
 	private:
 		DisplayObject& fObject1;
@@ -596,6 +633,9 @@ class CollisionEvent : public BaseCollisionEvent
 {
 	public:
 		typedef BaseCollisionEvent Super;
+
+	public:
+		static const char kName[];
 		
 	public:
 		CollisionEvent( DisplayObject& object1, DisplayObject& object2, Real x, Real y, int fixtureIndex1, int fixtureIndex2, const char *phase );
@@ -624,6 +664,9 @@ class PostCollisionEvent : public BaseCollisionEvent
 {
 	public:
 		typedef BaseCollisionEvent Super;
+
+	public:
+		static const char kName[];
 		
 	public:
 		PostCollisionEvent( DisplayObject& object1, DisplayObject& object2, Real x, Real y, int fixtureIndex1, int fixtureIndex2, Real normalImpulse, Real tangentImpulse );
@@ -841,6 +884,7 @@ class HitEvent : public VirtualEvent
 
 	protected:
 		virtual U32 GetListenerMask() const;
+		virtual bool IsReusable() const;
 
 	public:
 		Rtt_INLINE Real X() const { return fXContent; }
@@ -860,6 +904,7 @@ class HitEvent : public VirtualEvent
 
 	protected:
 		void Test( HitTestObject& parent, const Matrix& srcToDstSpace ) const;
+		void TestChild( HitTestObject& parent, DisplayObject& child, const Matrix& xform, const Display& display ) const;
 
 	protected:
 		static void ScreenToContent( const Display& display,  Real xScreen, Real yScreen, Real& outXContent, Real& outYContent );
@@ -1366,6 +1411,9 @@ class SpriteEvent : public VirtualEvent
 	public:
 		virtual const char* Name() const;
 		virtual int Push( lua_State *L ) const;
+
+	protected:
+		virtual bool IsReusable() const;
 				
 	private:
 		const SpriteObject& fTarget;
@@ -10,6 +10,7 @@
 #include "Core/Rtt_Build.h"
 
 #include "Rtt_HitTestObject.h"
+#include "Core/Rtt_New.h"
 #include "Display/Rtt_DisplayObject.h"
 
 // ----------------------------------------------------------------------------
@@ -19,6 +20,123 @@ namespace Rtt
 
 // ----------------------------------------------------------------------------
 
+namespace /*anonymous*/
+{
+
+// Free list of HitTestObject-sized nodes, grown a block at a time. Hit testing
+// only happens on the main thread, so no locking is needed.
+class HitTestObjectPool
+{
+	public:
+		HitTestObjectPool();
+		~HitTestObjectPool();
+
+	public:
+		void* Alloc();
+		void Free( void* p );
+
+	private:
+		union Node
+		{
+			Node* fNext;
+			alignas( HitTestObject ) U8 fStorage[sizeof( HitTestObject )];
+		};
+
+		enum
+		{
+			kNodesPerBlock = 64
+		};
+
+		struct Block
+		{
+			Block* fNext;
+			Node fNodes[kNodesPerBlock];
+		};
+
+	private:
+		Node* fFree;
+		Block* fBlocks;
+};
+
+HitTestObjectPool::HitTestObjectPool()
+:	fFree( NULL ),
+	fBlocks( NULL )
+{
+}
+
+HitTestObjectPool::~HitTestObjectPool()
+{
+	for ( Block* iCurrent = fBlocks, *iNext = NULL;
+		  iCurrent;
+		  iCurrent = iNext )
+	{
+		iNext = iCurrent->fNext;
+		Rtt_FREE( iCurrent );
+	}
+}
+
+void*
+HitTestObjectPool::Alloc()
+{
+	if ( ! fFree )
+	{
+		Block* block = (Block*)Rtt_MALLOC( NULL, sizeof( Block ) );
+		if ( ! Rtt_VERIFY( block ) )
+		{
+			return NULL;
+		}
+
+		block->fNext = fBlocks;
+		fBlocks = block;
+
+		for ( int i = kNodesPerBlock; --i >= 0; )
+		{
+			Free( & block->fNodes[i] );
+		}
+	}
+
+	Node* result = fFree;
+	fFree = result->fNext;
+
+	return result;
+}
+
+void
+HitTestObjectPool::Free( void* p )
+{
+	Node* node = (Node*)p;
+	node->fNext = fFree;
+	fFree = node;
+}
+
+static HitTestObjectPool&
+Pool()
+{
+	static HitTestObjectPool sPool;
+	return sPool;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+HitTestObject*
+HitTestObject::New( DisplayObject& target, HitTestObject* parent )
+{
+	void* p = Pool().Alloc();
+	return ( p ? new( p ) HitTestObject( target, parent ) : NULL );
+}
+
+void
+HitTestObject::Delete( HitTestObject* object )
+{
+	if ( object )
+	{
+		object->~HitTestObject();
+		Pool().Free( object );
+	}
+}
+
 HitTestObject::HitTestObject( DisplayObject& target, HitTestObject* parent )
 :	fTarget( target ),
 	fParent( parent ),
@@ -36,7 +154,7 @@ HitTestObject::~HitTestObject()
 		  iCurrent = iNext )
 	{
 		iNext = iCurrent->fSibling;
-		Rtt_DELETE( iCurrent );
+		Delete( iCurrent );
 	}
 
 	fTarget.SetUsedByHitTest( false );
@@ -23,6 +23,9 @@ class DisplayObject;
 
 // HitTestObject is a wrapper for DisplayObjects. Its sole function is to allow
 // the creation of a snapshot of the display hierarchy during hit testing.
+//
+// A snapshot is built for every touch, so child nodes come from a pool via
+// New()/Delete() rather than the heap. Roots can live on the stack.
 
 class HitTestObject
 {
@@ -31,6 +34,10 @@ class HitTestObject
 	public:
 		typedef HitTestObject Self;
 
+	public:
+		static Self* New( DisplayObject& target, Self* parent );
+		static void Delete( Self* object );
+
 	public:
 		HitTestObject( DisplayObject& target, Self* parent );
 		virtual ~HitTestObject();
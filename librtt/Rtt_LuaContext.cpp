@@ -12,6 +12,7 @@
 
 #include "Rtt_LuaContext.h"
 
+#include "Core/Rtt_SizeClassAllocator.h"
 #include "Display/Rtt_Display.h"
 #include "Display/Rtt_LuaLibDisplay.h"
 #include "Display/Rtt_LuaLibGraphics.h"
@@ -25,6 +26,7 @@
 #include "Rtt_LuaCoronaBaseLib.h"
 #include "Rtt_LuaLibCrypto.h"
 #include "Rtt_LuaLibFacebook.h"
+#include "Rtt_LuaLibJSON.h"
 #include "Rtt_LuaLibMedia.h"
 #if defined ( Rtt_USE_ALMIXER )
 #include "Rtt_LuaLibOpenAL.h"
@@ -190,28 +192,6 @@ LuaContext::stackdump(lua_State* L)
 
 // ----------------------------------------------------------------------------
 
-void*
-LuaContext::Alloc(void *ud, void *ptr, size_t osize, size_t nsize)
-{
-	if ( 0 == nsize )
-	{
-		Rtt_CNTX_FREE( (Rtt_Allocator*)ud, ptr );
-		return NULL;
-	}
-	else if ( 0 == osize )
-	{
-		return Rtt_CNTX_MALLOC( (Rtt_Allocator*)ud, nsize );
-	}
-	else if ( nsize <= osize )
-	{
-		return ptr;
-	}
-	else
-	{
-		return Rtt_CNTX_REALLOC( (Rtt_Allocator*)ud, ptr, nsize );
-	}
-}
-
 int
 LuaContext::Panic( ::lua_State* L )
 {
@@ -759,6 +739,7 @@ LuaContext::InitializeLuaCore( lua_State* L )
 		{ "store", LuaLibStore::Open },
 		{ "easing", Lua::Open< luaload_easing> },
 		{ "launchpad", Lua::Open< luaload_launchpad> },
+		{ "json.native", LuaLibJSON::Open },
 		{ "dkjson", Lua::Open< luaload_dkjson > },
 		{ "json", Lua::Open< luaload_json > },
 		{ "widget", Lua::Open< luaload_widget > },
@@ -1056,19 +1037,26 @@ class LuaContextUserdata
 		Runtime* GetRuntime() const { return fRuntime; }
 		LuaContext* GetOwner() const { return fOwner; }
 
+		static SizeClassAllocator& GetHeap( void *ud ) { return static_cast< LuaContextUserdata* >( ud )->fHeap; }
+
 	// Weak references. Does NOT own these.
 	private:
 		Rtt_Allocator *fAllocator;
 		const MPlatform& fPlatform;
 		Runtime *fRuntime;
 		LuaContext *fOwner;
+
+	// Owned, and outlives the Lua state
+	private:
+		SizeClassAllocator fHeap;
 };
 
 LuaContextUserdata::LuaContextUserdata( Rtt_Allocator* pAllocator, const MPlatform& platform, Runtime *runtime )
 :	fAllocator( pAllocator ),
 	fPlatform( platform ),
 	fRuntime( runtime ),
-	fOwner( NULL )
+	fOwner( NULL ),
+	fHeap( pAllocator )
 {
 }
 
@@ -1081,6 +1069,12 @@ LuaContextUserdata::Initialize( LuaContext *owner )
 	}
 }
 
+void*
+LuaContext::Alloc(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+	return LuaContextUserdata::GetHeap( ud ).Realloc( ptr, osize, nsize );
+}
+
 // ----------------------------------------------------------------------------	
 
 LuaContext*
@@ -1165,6 +1159,14 @@ LuaContext::GetContext( lua_State *L )
 	return static_cast< LuaContextUserdata* >( ud )->GetOwner();
 }
 
+const SizeClassAllocator&
+LuaContext::GetHeap( lua_State* L )
+{
+	void *ud = NULL;
+	(void)lua_getallocf( L, & ud ); Rtt_ASSERT( ud );
+	return LuaContextUserdata::GetHeap( ud );
+}
+
 bool
 LuaContext::IsBinaryLua( const char* filename )
 {
@@ -1197,7 +1199,9 @@ LuaContext::IsBinaryLua( const char* filename )
 LuaContext::LuaContext( ::lua_State* L )
 :	fL( L ),
 	fHandle( LuaContext::GetAllocator( L ), * L ),
-	fModules( 0 )
+	fModules( 0 ),
+	fGCScheduler( LuaContext::GetHeap( L ) ),
+	fSampler( L )
 {
 }
 
@@ -1254,6 +1258,7 @@ LuaContext::Initialize( const MPlatform& platform, Runtime* runtime )
 LuaContext::~LuaContext()
 {
 	Rtt_ASSERT( fL );
+	fSampler.Stop(); // its timer must not outlive the state
 	lua_close( fL );
 }
 
@@ -15,6 +15,8 @@
 #include "Core/Rtt_ResourceHandle.h"
 
 #include "Rtt_LuaAux.h"
+#include "Rtt_LuaGCScheduler.h"
+#include "Rtt_LuaSampler.h"
 
 namespace Rtt
 {
@@ -22,6 +24,7 @@ namespace Rtt
 class MEvent;
 class MPlatform;
 class Runtime;
+class SizeClassAllocator;
 class StageObject;
 
 // ----------------------------------------------------------------------------
@@ -41,6 +44,9 @@ class LuaContext
         static bool HasRuntime( lua_State* L );
 		static LuaContext* GetContext( lua_State *L );
 
+		// Backs every allocation the Lua VM makes
+		static const SizeClassAllocator& GetHeap( lua_State* L );
+
 		static bool IsBinaryLua( const char* filename );
 
 	protected:
@@ -123,6 +129,12 @@ class LuaContext
 	public:
 		void Collect();
 
+		// Collects in the frame's slack once enabled, see Runtime::operator()
+		LuaGCScheduler& GetGCScheduler() { return fGCScheduler; }
+
+		// Samples Lua call stacks once started, see display.startProfiler()
+		LuaSampler& GetSampler() { return fSampler; }
+
 	public:
 		// See comments for DoCall(): do *not* call from outside librtt *if* the receiver
 		// belongs to the Corona runtime.
@@ -155,6 +167,8 @@ class LuaContext
 		lua_State* fL;
 		ResourceHandleOwner< lua_State > fHandle;
 		U32 fModules; // Used by Simulator to determine what modules are in use
+		LuaGCScheduler fGCScheduler;
+		LuaSampler fSampler;
 };
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,535 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Rtt_LuaEventDispatcher.h"
+
+#include "Core/Rtt_TraceRecorder.h"
+#include "Display/Rtt_Display.h"
+#include "Rtt_LuaContext.h"
+#include "Rtt_Profiling.h"
+#include "Rtt_Runtime.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+static const char kFunctionListenersKey[] = "_functionListeners";
+static const char kTableListenersKey[] = "_tableListeners";
+static const char kGenerationKey[] = "_generation";
+static const char kSupersededKey[] = "_superseded";
+
+// Maps event names to profile ids, and ids to the profile names, which must
+// stay alive since Profiling does not copy them
+static const char kEventProfilesKey[] = "_corona.eventProfiles";
+
+static const char*
+ListenersKey( int listenerType )
+{
+	switch ( listenerType )
+	{
+		case LUA_TFUNCTION:
+			return kFunctionListenersKey;
+		case LUA_TTABLE:
+			return kTableListenersKey;
+		default:
+			return NULL;
+	}
+}
+
+// With no listener given, the dispatcher itself listens if it has a method
+// named after the event. Expects ( self, eventName, listener ) on the stack.
+static void
+ResolveListener( lua_State *L )
+{
+	if ( ! lua_toboolean( L, 3 ) )
+	{
+		lua_pushvalue( L, 2 );
+		lua_gettable( L, 1 );
+		if ( lua_toboolean( L, -1 ) )
+		{
+			lua_pushvalue( L, 1 );
+			lua_replace( L, 3 );
+		}
+		lua_pop( L, 1 );
+	}
+}
+
+// Pushes self[key][eventName], or nil
+static void
+PushListenerArray( lua_State *L, int selfIndex, const char *key, int eventNameIndex )
+{
+	lua_getfield( L, selfIndex, key );
+	if ( lua_istable( L, -1 ) )
+	{
+		lua_pushvalue( L, eventNameIndex );
+		lua_rawget( L, -2 );
+		lua_remove( L, -2 );
+	}
+	else
+	{
+		lua_pop( L, 1 );
+		lua_pushnil( L );
+	}
+}
+
+static bool
+IsSuperseded( lua_State *L, int arrayIndex )
+{
+	lua_pushstring( L, kSupersededKey );
+	lua_rawget( L, arrayIndex );
+	bool result = lua_toboolean( L, -1 );
+	lua_pop( L, 1 );
+	return result;
+}
+
+static lua_Number
+GetGeneration( lua_State *L, int arrayIndex )
+{
+	lua_pushstring( L, kGenerationKey );
+	lua_rawget( L, arrayIndex );
+	lua_Number result = lua_tonumber( L, -1 );
+	lua_pop( L, 1 );
+	return result;
+}
+
+static int
+FindListener( lua_State *L, int arrayIndex, int listenerIndex )
+{
+	for ( int i = 1, iMax = (int)lua_objlen( L, arrayIndex ); i <= iMax; i++ )
+	{
+		lua_rawgeti( L, arrayIndex, i );
+		bool isEqual = lua_rawequal( L, -1, listenerIndex );
+		lua_pop( L, 1 );
+
+		if ( isEqual )
+		{
+			return i;
+		}
+	}
+	return 0;
+}
+
+// ----------------------------------------------------------------------------
+
+// Listeners a dispatch still has to check after the array it walks got
+// superseded. Lazily snapshots the current array into a set, and redoes it
+// whenever that array is appended to or superseded in turn.
+class ListenerMembership
+{
+	public:
+		ListenerMembership( lua_State *L, int selfIndex, const char *key, int eventNameIndex );
+
+	public:
+		bool Contains( int listenerIndex );
+
+	private:
+		lua_State *fL;
+		int fSelfIndex;
+		const char *fKey;
+		int fEventNameIndex;
+		int fArrayIndex;
+		int fSetIndex;
+		lua_Number fGeneration;
+};
+
+ListenerMembership::ListenerMembership( lua_State *L, int selfIndex, const char *key, int eventNameIndex )
+:	fL( L ),
+	fSelfIndex( selfIndex ),
+	fKey( key ),
+	fEventNameIndex( eventNameIndex ),
+	fArrayIndex( 0 ),
+	fSetIndex( 0 ),
+	fGeneration( 0 )
+{
+	lua_pushnil( L );
+	fArrayIndex = lua_gettop( L );
+	lua_pushnil( L );
+	fSetIndex = lua_gettop( L );
+}
+
+bool
+ListenerMembership::Contains( int listenerIndex )
+{
+	lua_State *L = fL;
+
+	bool isStale = ! lua_istable( L, fArrayIndex )
+		|| IsSuperseded( L, fArrayIndex )
+		|| GetGeneration( L, fArrayIndex ) != fGeneration;
+
+	if ( isStale )
+	{
+		PushListenerArray( L, fSelfIndex, fKey, fEventNameIndex );
+		lua_replace( L, fArrayIndex );
+
+		if ( lua_istable( L, fArrayIndex ) )
+		{
+			int n = (int)lua_objlen( L, fArrayIndex );
+			lua_createtable( L, 0, n );
+			for ( int i = 1; i <= n; i++ )
+			{
+				lua_rawgeti( L, fArrayIndex, i );
+				lua_pushboolean( L, 1 );
+				lua_rawset( L, -3 );
+			}
+			fGeneration = GetGeneration( L, fArrayIndex );
+		}
+		else
+		{
+			lua_pushnil( L );
+		}
+		lua_replace( L, fSetIndex );
+	}
+
+	bool result = false;
+	if ( lua_istable( L, fSetIndex ) )
+	{
+		lua_pushvalue( L, listenerIndex );
+		lua_rawget( L, fSetIndex );
+		result = lua_toboolean( L, -1 );
+		lua_pop( L, 1 );
+	}
+	return result;
+}
+
+// ----------------------------------------------------------------------------
+
+// Profiles are only opened while event profiling is enabled; see
+// ProfilingState::EnableEventProfiles()
+static Profiling*
+BeginProfile( lua_State *L, ProfilingState& state, int eventNameIndex )
+{
+	if ( LUA_TSTRING != lua_type( L, eventNameIndex ) )
+	{
+		return NULL;
+	}
+
+	lua_getfield( L, LUA_REGISTRYINDEX, kEventProfilesKey );
+	if ( ! lua_istable( L, -1 ) )
+	{
+		lua_pop( L, 1 );
+		lua_newtable( L );
+		lua_pushvalue( L, -1 );
+		lua_setfield( L, LUA_REGISTRYINDEX, kEventProfilesKey );
+	}
+
+	lua_pushvalue( L, eventNameIndex );
+	lua_rawget( L, -2 );
+	int id = (int)lua_tointeger( L, -1 );
+	lua_pop( L, 1 );
+
+	if ( id <= 0 )
+	{
+		lua_pushvalue( L, eventNameIndex );
+		lua_pushliteral( L, " (event)" );
+		lua_concat( L, 2 );
+
+		id = state.Create( lua_tostring( L, -1 ) ) + 1;
+		lua_rawseti( L, -2, id ); // keeps the name alive
+
+		lua_pushvalue( L, eventNameIndex );
+		lua_pushinteger( L, id );
+		lua_rawset( L, -3 );
+	}
+	lua_pop( L, 1 );
+
+	Profiling* result = state.Open( id );
+	if ( result )
+	{
+		// Lets Lua close the profile if a listener raises an error
+		lua_setlevelid( L, id );
+	}
+	return result;
+}
+
+static void
+EndProfile( lua_State *L, ProfilingState& state, Profiling* profile )
+{
+	state.Close( profile );
+	lua_setlevelid( L, 0 );
+}
+
+// Calls the listener below its 'nargs' arguments, for one result. While
+// tracing, the call is protected so that its scope is ended even if the
+// listener raises an error, which is then raised again from here. A scope
+// object can't span the call, since the error longjmps past its destructor.
+static void
+CallListener( lua_State *L, int nargs, bool isTableListener, int eventNameIndex )
+{
+	if ( ! TraceRecorder::IsEnabled() )
+	{
+		lua_call( L, nargs, 1 );
+		return;
+	}
+
+	const char* eventName = ( LUA_TSTRING == lua_type( L, eventNameIndex ) ? lua_tostring( L, eventNameIndex ) : NULL );
+	TraceRecorder::Begin( isTableListener ? "Table Listener" : "Function Listener", eventName );
+
+	int status = lua_pcall( L, nargs, 1, 0 );
+
+	TraceRecorder::End();
+
+	if ( 0 != status )
+	{
+		lua_error( L );
+	}
+}
+
+// ----------------------------------------------------------------------------
+
+// dispatcher:addEventListener( eventName [, listener] )
+int
+LuaEventDispatcher::addEventListener( lua_State *L )
+{
+	lua_settop( L, 3 );
+	ResolveListener( L );
+
+	const char *key = ListenersKey( lua_type( L, 3 ) );
+	if ( ! key )
+	{
+		luaL_error( L, "addEventListener: listener cannot be nil: nil" );
+	}
+
+	// 4: self[key]
+	lua_getfield( L, 1, key );
+	if ( lua_isnil( L, 4 ) )
+	{
+		lua_pop( L, 1 );
+		lua_newtable( L );
+		lua_pushvalue( L, 4 );
+		lua_setfield( L, 1, key );
+	}
+
+	// 5: self[key][eventName]
+	lua_pushvalue( L, 2 );
+	lua_gettable( L, 4 );
+	if ( lua_isnil( L, 5 ) )
+	{
+		lua_pop( L, 1 );
+		lua_newtable( L );
+		lua_pushvalue( L, 2 );
+		lua_pushvalue( L, 5 );
+		lua_settable( L, 4 );
+	}
+
+	lua_pushvalue( L, 3 );
+	lua_rawseti( L, 5, (int)lua_objlen( L, 5 ) + 1 );
+
+	lua_pushstring( L, kGenerationKey );
+	lua_pushnumber( L, GetGeneration( L, 5 ) + 1 );
+	lua_rawset( L, 5 );
+
+	lua_pushboolean( L, 1 );
+	return 1;
+}
+
+// dispatcher:removeEventListener( eventName [, listener] )
+int
+LuaEventDispatcher::removeEventListener( lua_State *L )
+{
+	lua_settop( L, 3 );
+	ResolveListener( L );
+
+	bool wasRemoved = false;
+
+	const char *key = ListenersKey( lua_type( L, 3 ) );
+	if ( key )
+	{
+		// 4: self[key]
+		lua_getfield( L, 1, key );
+		if ( lua_istable( L, 4 ) )
+		{
+			// 5: self[key][eventName]
+			lua_pushvalue( L, 2 );
+			lua_gettable( L, 4 );
+
+			int index = ( lua_istable( L, 5 ) ? FindListener( L, 5, 3 ) : 0 );
+			if ( index > 0 )
+			{
+				int n = (int)lua_objlen( L, 5 );
+
+				// Dispatches in progress keep walking the old array
+				lua_pushvalue( L, 2 );
+				if ( n > 1 )
+				{
+					lua_createtable( L, n - 1, 1 );
+					for ( int i = 1, j = 1; i <= n; i++ )
+					{
+						if ( i != index )
+						{
+							lua_rawgeti( L, 5, i );
+							lua_rawseti( L, -2, j++ );
+						}
+					}
+				}
+				else
+				{
+					lua_pushnil( L );
+				}
+				lua_settable( L, 4 );
+
+				lua_pushstring( L, kSupersededKey );
+				lua_pushboolean( L, 1 );
+				lua_rawset( L, 5 );
+
+				wasRemoved = true;
+
+				// Signal an EventDispatcher derived object that a listener has been removed
+				lua_getfield( L, 1, "didRemoveListener" );
+				lua_pushvalue( L, 1 );
+				lua_pushvalue( L, 2 );
+				lua_call( L, 2, 0 );
+			}
+		}
+	}
+
+	if ( wasRemoved )
+	{
+		lua_pushboolean( L, 1 );
+	}
+	else
+	{
+		lua_pushnil( L );
+	}
+	return 1;
+}
+
+// dispatcher:hasEventListener( eventName [, listener] )
+int
+LuaEventDispatcher::hasEventListener( lua_State *L )
+{
+	lua_settop( L, 3 );
+	ResolveListener( L );
+
+	bool result = false;
+
+	const char *key = ListenersKey( lua_type( L, 3 ) );
+	if ( key )
+	{
+		lua_getfield( L, 1, key );
+		if ( lua_istable( L, 4 ) )
+		{
+			lua_pushvalue( L, 2 );
+			lua_gettable( L, 4 );
+			result = lua_istable( L, 5 ) && FindListener( L, 5, 3 ) > 0;
+		}
+	}
+
+	lua_pushboolean( L, result );
+	return 1;
+}
+
+// dispatcher:dispatchEvent( event )
+//
+// Function listeners run before table listeners, each in the order they were
+// added. Listeners added during the dispatch are not called; listeners removed
+// during the dispatch are not called if they had not run yet. Returns the last
+// truthy value returned by a listener, or false.
+int
+LuaEventDispatcher::dispatchEvent( lua_State *L )
+{
+	lua_settop( L, 2 );
+
+	const int kEventIndex = 2;
+	const int kEventNameIndex = 3;
+	const int kResultIndex = 4;
+
+	lua_getfield( L, kEventIndex, "name" );
+	lua_pushboolean( L, 0 );
+
+	ProfilingState& profilingState = * LuaContext::GetRuntime( L )->GetDisplay().GetProfilingState();
+	const bool isProfiling = profilingState.AreEventProfilesEnabled();
+	Profiling* profile = NULL;
+
+	const char* keys[] = { kFunctionListenersKey, kTableListenersKey };
+	for ( int k = 0; k < 2; k++ )
+	{
+		const bool isTableListener = ( kTableListenersKey == keys[k] );
+
+		PushListenerArray( L, 1, keys[k], kEventNameIndex );
+		const int arrayIndex = lua_gettop( L );
+
+		const int n = ( lua_istable( L, arrayIndex ) ? (int)lua_objlen( L, arrayIndex ) : 0 );
+		if ( n > 0 )
+		{
+			if ( isProfiling && ! profile )
+			{
+				profile = BeginProfile( L, profilingState, kEventNameIndex );
+			}
+
+			ListenerMembership membership( L, 1, keys[k], kEventNameIndex );
+			const int top = lua_gettop( L );
+
+			for ( int i = 1; i <= n; i++ )
+			{
+				lua_rawgeti( L, arrayIndex, i );
+				const int listenerIndex = lua_gettop( L );
+
+				if ( profile )
+				{
+					profilingState.AddEntry( profile, Profiling::Payload( lua_topointer( L, listenerIndex ), isTableListener ) );
+				}
+
+				// Until something is removed, every listener in the array is
+				// still registered
+				bool isRegistered = ! IsSuperseded( L, arrayIndex ) || membership.Contains( listenerIndex );
+				if ( isRegistered )
+				{
+					bool didCall = true;
+					if ( ! isTableListener )
+					{
+						lua_pushvalue( L, listenerIndex );
+						lua_pushvalue( L, kEventIndex );
+						CallListener( L, 1, isTableListener, kEventNameIndex );
+					}
+					else
+					{
+						// Fetch method stored as property of object
+						lua_pushvalue( L, kEventNameIndex );
+						lua_gettable( L, listenerIndex );
+						didCall = lua_isfunction( L, -1 );
+						if ( didCall )
+						{
+							lua_pushvalue( L, listenerIndex );
+							lua_pushvalue( L, kEventIndex );
+							CallListener( L, 2, isTableListener, kEventNameIndex );
+						}
+					}
+
+					if ( didCall && lua_toboolean( L, -1 ) )
+					{
+						lua_replace( L, kResultIndex );
+					}
+				}
+
+				lua_settop( L, top );
+			}
+		}
+
+		lua_settop( L, kResultIndex );
+	}
+
+	if ( profile )
+	{
+		EndProfile( L, profilingState, profile );
+	}
+
+	return 1;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
@@ -0,0 +1,50 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_LuaEventDispatcher_H__
+#define _Rtt_LuaEventDispatcher_H__
+
+#include "Rtt_Lua.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Native core of the EventDispatcher class in init.lua, which Runtime and all
+// display objects derive from.
+//
+// Listeners live in the same Lua tables as before: self._functionListeners and
+// self._tableListeners map event names to arrays of listeners. Appending to an
+// array bumps its "_generation", while removing a listener replaces the array
+// with a copy and marks the old one "_superseded". Appends past the end and
+// replacements never disturb the array a dispatch is walking, so dispatchEvent()
+// needs neither a clone nor a per-listener scan to honor listeners removed by
+// earlier listeners.
+class LuaEventDispatcher
+{
+	public:
+		typedef LuaEventDispatcher Self;
+
+	public:
+		static int addEventListener( lua_State *L );
+		static int removeEventListener( lua_State *L );
+		static int hasEventListener( lua_State *L );
+		static int dispatchEvent( lua_State *L );
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_LuaEventDispatcher_H__
@@ -0,0 +1,168 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Rtt_LuaGCScheduler.h"
+
+#include "Core/Rtt_Math.h"
+#include "Core/Rtt_SizeClassAllocator.h"
+#include "Core/Rtt_Time.h"
+#include "Rtt_Lua.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+LuaGCScheduler::LuaGCScheduler( const SizeClassAllocator& heap )
+:	fHeap( heap ),
+	fBudget( 0 ),
+	fPause( LUAI_GCPAUSE ),
+	fThreshold( 0 ),
+	fLowCount( 0 ),
+	fLastAllocated( 0 ),
+	fDebt( 0 ),
+	fIsCollecting( false )
+{
+	fStats.fCycles = 0;
+	fStats.fSteps = 0;
+	fStats.fOverruns = 0;
+	fStats.fMicroseconds = 0;
+}
+
+void
+LuaGCScheduler::SetBudget( lua_State *L, double milliseconds )
+{
+	U64 budget = milliseconds > 0. ? (U64)( milliseconds * 1000. ) : 0;
+
+	if ( budget > 0 && ! IsEnabled() )
+	{
+		// Treat the current heap as if a cycle had just finished
+		fThreshold = (int)( (S64)lua_gc( L, LUA_GCCOUNT, 0 ) * fPause / 100 );
+		fLastAllocated = fHeap.GetStats().fAllocatedBytes;
+		fDebt = 0;
+		fIsCollecting = false;
+
+		lua_gc( L, LUA_GCSTOP, 0 );
+	}
+	else if ( 0 == budget && IsEnabled() )
+	{
+		lua_gc( L, LUA_GCRESTART, 0 );
+	}
+
+	fBudget = budget;
+}
+
+void
+LuaGCScheduler::SetPause( lua_State *L, int pause )
+{
+	fPause = pause;
+
+	lua_gc( L, LUA_GCSETPAUSE, pause );
+}
+
+void
+LuaGCScheduler::SetStepMul( lua_State *L, int stepMul )
+{
+	lua_gc( L, LUA_GCSETSTEPMUL, stepMul );
+}
+
+bool
+LuaGCScheduler::Step( lua_State *L, U64 slack )
+{
+	if ( ! IsEnabled() )
+	{
+		return false;
+	}
+
+	// The automatic collector takes a step per KB allocated mid-cycle, so
+	// those steps are owed even if the frame left no slack
+	U64 allocated = fHeap.GetStats().fAllocatedBytes;
+
+	if ( fIsCollecting )
+	{
+		fDebt += allocated - fLastAllocated;
+	}
+
+	fLastAllocated = allocated;
+
+	// LUA_GCSTEP and full collections (e.g. on errors) restart the automatic
+	// collector, so it is stopped again on the way out
+	int count = lua_gc( L, LUA_GCCOUNT, 0 );
+
+	if ( ! fIsCollecting )
+	{
+		if ( count < fThreshold )
+		{
+			lua_gc( L, LUA_GCSTOP, 0 );
+
+			return false;
+		}
+
+		fIsCollecting = true;
+		fLowCount = count;
+	}
+
+	// Should the budget fall too far behind, the debt is paid in full, so
+	// the heap grows no faster than under the automatic collector
+	bool isOverrun = fDebt > (U64)fThreshold * 1024 / 4;
+
+	if ( isOverrun )
+	{
+		++fStats.fOverruns;
+	}
+
+	Rtt_AbsoluteTime start = Rtt_GetAbsoluteTime();
+	U64 elapsed = 0;
+	bool isFinished = false;
+
+	do
+	{
+		++fStats.fSteps;
+
+		fDebt -= Min< U64 >( fDebt, kStepSize );
+
+		if ( lua_gc( L, LUA_GCSTEP, 0 ) )
+		{
+			isFinished = true;
+
+			break;
+		}
+
+		elapsed = Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - start );
+	}
+	while ( ( isOverrun && fDebt > 0 ) || ( elapsed < fBudget && ( fDebt > 0 || elapsed < slack ) ) );
+
+	fStats.fMicroseconds += Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - start );
+
+	fLowCount = Min( fLowCount, lua_gc( L, LUA_GCCOUNT, 0 ) );
+
+	if ( isFinished )
+	{
+		// What survived is closer to the low point than to the current heap,
+		// which also holds whatever was allocated while the cycle swept
+		fThreshold = (int)( (S64)fLowCount * fPause / 100 );
+		fDebt = 0;
+		fIsCollecting = false;
+		++fStats.fCycles;
+	}
+
+	lua_gc( L, LUA_GCSTOP, 0 );
+
+	return isFinished;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_LuaGCScheduler_H__
+#define _Rtt_LuaGCScheduler_H__
+
+#include "Core/Rtt_Types.h"
+
+// ----------------------------------------------------------------------------
+
+struct lua_State;
+
+namespace Rtt
+{
+
+class SizeClassAllocator;
+
+// ----------------------------------------------------------------------------
+
+// Moves Lua's incremental collector out of the frame's Lua callbacks and into
+// the time left over once the frame is done. While enabled, the automatic
+// collector is kept stopped, and Step() advances it with LUA_GCSTEP.
+//
+// A new cycle is started once the heap has grown by the pause, as Lua would.
+// During a cycle, each frame first takes the steps the automatic collector
+// would have taken for that frame's allocations, then keeps stepping while
+// the frame has slack, all within the per-frame budget. Steps the budget
+// could not cover carry over; once they add up to a quarter of the heap the
+// cycle was due at, the frame goes over budget to take them all, so memory
+// stays bounded as with the automatic collector.
+class LuaGCScheduler
+{
+	public:
+		struct Stats
+		{
+			U32 fCycles;		// completed by Step()
+			U32 fSteps;			// LUA_GCSTEP calls
+			U32 fOverruns;		// frames that went over budget to catch up
+			U64 fMicroseconds;	// spent in Step()
+		};
+
+	public:
+		// The heap backing the lua_State, whose allocations pace collection
+		LuaGCScheduler( const SizeClassAllocator& heap );
+
+	public:
+		// Budget in milliseconds; 0 disables scheduling and restarts the
+		// automatic collector
+		void SetBudget( lua_State *L, double milliseconds );
+		double GetBudget() const { return (double)fBudget / 1000.; }
+		bool IsEnabled() const { return fBudget > 0; }
+
+		// Same meaning as collectgarbage( "setpause" / "setstepmul" )
+		void SetPause( lua_State *L, int pause );
+		void SetStepMul( lua_State *L, int stepMul );
+
+	public:
+		// Runs collection for up to the smaller of the budget and 'slack',
+		// both in microseconds, or up to the budget while steps are owed.
+		// Returns true if a cycle finished.
+		bool Step( lua_State *L, U64 slack );
+
+		const Stats& GetStats() const { return fStats; }
+
+	private:
+		// Bytes allocated per step of the automatic collector (GCSTEPSIZE)
+		static const U64 kStepSize = 1024;
+
+		const SizeClassAllocator& fHeap;
+		U64 fBudget;
+		int fPause;
+		int fThreshold; // KB at which the next cycle is due
+		int fLowCount; // least KB seen during the cycle
+		U64 fLastAllocated; // heap's running total as of the previous Step()
+		U64 fDebt; // bytes allocated during the cycle not yet stepped for
+		bool fIsCollecting;
+		Stats fStats;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_LuaGCScheduler_H__
@@ -0,0 +1,1483 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Rtt_LuaLibJSON.h"
+
+#include <locale.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+static const char kBufferMetatable[] = "json.native.buffer";
+
+// Guards the C stack against hostile input; dkjson's LPeg grammar gives up
+// well before this
+static const int kMaxDepth = 512;
+
+static char
+GetDecimalPoint()
+{
+	const struct lconv *conv = localeconv();
+	return ( conv && conv->decimal_point && conv->decimal_point[0] ? conv->decimal_point[0] : '.' );
+}
+
+// ----------------------------------------------------------------------------
+// Decoding
+// ----------------------------------------------------------------------------
+
+// Recursive descent version of dkjson's LPeg grammar. Values are pushed onto
+// the Lua stack as soon as they are recognized, so strings without escapes go
+// straight from the source into Lua and tables are filled in place.
+class JSONDecoder
+{
+	public:
+		enum Result
+		{
+			kMatch = 0,
+			kNoMatch,
+			kError
+		};
+
+	public:
+		JSONDecoder( lua_State *L, const char *json, size_t length, int nullIndex, int objectMetaIndex, int arrayMetaIndex );
+
+	public:
+		// Matches dkjson's ExpectedValue at pos; on success, the value is on
+		// top of the stack and pos is just past it
+		Result ParseExpectedValue( size_t& pos );
+
+		// Pushes the error position and message. Only valid after kError.
+		int PushError() const;
+
+	protected:
+		Result ParseValue( size_t& pos );
+		Result ParseArray( size_t& pos );
+		Result ParseObject( size_t& pos );
+		Result ParseString( size_t& pos );
+		Result ParseNumber( size_t& pos );
+
+		size_t SkipSpace( size_t pos ) const;
+		bool Matches( size_t pos, const char *literal, size_t length ) const;
+		bool ReadHex4( size_t pos, U32& result ) const;
+
+		Result Error( size_t pos, const char *message );
+
+	private:
+		lua_State *fL;
+		const char *fJSON;
+		size_t fLength;
+		int fNullIndex;
+		int fObjectMetaIndex;
+		int fArrayMetaIndex;
+		int fDepth;
+		char fDecimalPoint;
+		size_t fErrorPos;
+		const char *fErrorMessage;
+};
+
+JSONDecoder::JSONDecoder( lua_State *L, const char *json, size_t length, int nullIndex, int objectMetaIndex, int arrayMetaIndex )
+:	fL( L ),
+	fJSON( json ),
+	fLength( length ),
+	fNullIndex( nullIndex ),
+	fObjectMetaIndex( objectMetaIndex ),
+	fArrayMetaIndex( arrayMetaIndex ),
+	fDepth( 0 ),
+	fDecimalPoint( GetDecimalPoint() ),
+	fErrorPos( 0 ),
+	fErrorMessage( NULL )
+{
+}
+
+JSONDecoder::Result
+JSONDecoder::ParseExpectedValue( size_t& pos )
+{
+	Result result = ParseValue( pos );
+	if ( kNoMatch == result )
+	{
+		result = Error( SkipSpace( pos ), "value expected" );
+	}
+	return result;
+}
+
+int
+JSONDecoder::PushError() const
+{
+	Rtt_ASSERT( fErrorMessage );
+
+	// Same as dkjson's loc(), with 1-based positions
+	size_t where = fErrorPos + 1;
+	size_t line = 1;
+	size_t linePos = 0;
+	for ( size_t i = 0; i < fErrorPos && i < fLength; i++ )
+	{
+		if ( '\n' == fJSON[i] )
+		{
+			++line;
+			linePos = i + 1;
+		}
+	}
+
+	lua_pushnil( fL );
+	lua_pushinteger( fL, (lua_Integer)where );
+	lua_pushfstring( fL, "%s at line %d, column %d", fErrorMessage, (int)line, (int)( where - linePos ) );
+	return 3;
+}
+
+JSONDecoder::Result
+JSONDecoder::ParseValue( size_t& pos )
+{
+	size_t p = SkipSpace( pos );
+	Result result = kNoMatch;
+
+	switch ( p < fLength ? fJSON[p] : '\0' )
+	{
+		case '[':
+			result = ParseArray( p );
+			break;
+		case '{':
+			result = ParseObject( p );
+			break;
+		case '"':
+			result = ParseString( p );
+			break;
+		case '-':
+		case '0': case '1': case '2': case '3': case '4':
+		case '5': case '6': case '7': case '8': case '9':
+			result = ParseNumber( p );
+			break;
+		case 't':
+			if ( Matches( p, "true", 4 ) )
+			{
+				lua_pushboolean( fL, 1 );
+				p += 4;
+				result = kMatch;
+			}
+			break;
+		case 'f':
+			if ( Matches( p, "false", 5 ) )
+			{
+				lua_pushboolean( fL, 0 );
+				p += 5;
+				result = kMatch;
+			}
+			break;
+		case 'n':
+			if ( Matches( p, "null", 4 ) )
+			{
+				lua_pushvalue( fL, fNullIndex );
+				p += 4;
+				result = kMatch;
+			}
+			break;
+		default:
+			break;
+	}
+
+	if ( kMatch == result )
+	{
+		pos = p;
+	}
+	return result;
+}
+
+JSONDecoder::Result
+JSONDecoder::ParseArray( size_t& pos )
+{
+	if ( ++fDepth > kMaxDepth )
+	{
+		return Error( pos, "too many nested levels" );
+	}
+	luaL_checkstack( fL, 4, "json.decode" );
+
+	lua_newtable( fL );
+	int n = 0;
+
+	size_t p = pos + 1;
+	for ( ;; )
+	{
+		Result result = ParseValue( p );
+		if ( kError == result )
+		{
+			return result;
+		}
+		if ( kNoMatch == result )
+		{
+			break;
+		}
+
+		// Like dkjson, a null decoded to nil still takes up its index
+		lua_rawseti( fL, -2, ++n );
+
+		size_t q = SkipSpace( p );
+		if ( q < fLength && ',' == fJSON[q] )
+		{
+			p = q + 1;
+		}
+		else
+		{
+			p = q;
+			break;
+		}
+	}
+
+	p = SkipSpace( p );
+	if ( p >= fLength || ']' != fJSON[p] )
+	{
+		return Error( p, "']' expected" );
+	}
+
+	if ( lua_istable( fL, fArrayMetaIndex ) )
+	{
+		lua_pushvalue( fL, fArrayMetaIndex );
+		lua_setmetatable( fL, -2 );
+	}
+
+	--fDepth;
+	pos = p + 1;
+	return kMatch;
+}
+
+JSONDecoder::Result
+JSONDecoder::ParseObject( size_t& pos )
+{
+	if ( ++fDepth > kMaxDepth )
+	{
+		return Error( pos, "too many nested levels" );
+	}
+	luaL_checkstack( fL, 4, "json.decode" );
+
+	lua_newtable( fL );
+
+	size_t p = pos + 1;
+	for ( ;; )
+	{
+		size_t q = SkipSpace( p );
+		if ( q >= fLength || '"' != fJSON[q] )
+		{
+			break;
+		}
+
+		Result result = ParseString( q );
+		if ( kError == result )
+		{
+			return result;
+		}
+
+		q = SkipSpace( q );
+		if ( q >= fLength || ':' != fJSON[q] )
+		{
+			return Error( q, "colon expected" );
+		}
+
+		++q;
+		result = ParseExpectedValue( q );
+		if ( kError == result )
+		{
+			return result;
+		}
+
+		lua_rawset( fL, -3 );
+
+		q = SkipSpace( q );
+		if ( q < fLength && ',' == fJSON[q] )
+		{
+			p = q + 1;
+		}
+		else
+		{
+			p = q;
+			break;
+		}
+	}
+
+	p = SkipSpace( p );
+	if ( p >= fLength || '}' != fJSON[p] )
+	{
+		return Error( p, "'}' expected" );
+	}
+
+	if ( lua_istable( fL, fObjectMetaIndex ) )
+	{
+		lua_pushvalue( fL, fObjectMetaIndex );
+		lua_setmetatable( fL, -2 );
+	}
+
+	--fDepth;
+	pos = p + 1;
+	return kMatch;
+}
+
+static void
+AddUTF8( luaL_Buffer& buffer, U32 value )
+{
+	if ( value <= 0x7F )
+	{
+		luaL_addchar( & buffer, (char)value );
+	}
+	else if ( value <= 0x7FF )
+	{
+		luaL_addchar( & buffer, (char)( 0xC0 | ( value >> 6 ) ) );
+		luaL_addchar( & buffer, (char)( 0x80 | ( value & 0x3F ) ) );
+	}
+	else if ( value <= 0xFFFF )
+	{
+		luaL_addchar( & buffer, (char)( 0xE0 | ( value >> 12 ) ) );
+		luaL_addchar( & buffer, (char)( 0x80 | ( ( value >> 6 ) & 0x3F ) ) );
+		luaL_addchar( & buffer, (char)( 0x80 | ( value & 0x3F ) ) );
+	}
+	else
+	{
+		luaL_addchar( & buffer, (char)( 0xF0 | ( value >> 18 ) ) );
+		luaL_addchar( & buffer, (char)( 0x80 | ( ( value >> 12 ) & 0x3F ) ) );
+		luaL_addchar( & buffer, (char)( 0x80 | ( ( value >> 6 ) & 0x3F ) ) );
+		luaL_addchar( & buffer, (char)( 0x80 | ( value & 0x3F ) ) );
+	}
+}
+
+static bool
+IsPlainChar( char c )
+{
+	return '"' != c && '\\' != c && '\n' != c && '\r' != c;
+}
+
+JSONDecoder::Result
+JSONDecoder::ParseString( size_t& pos )
+{
+	const size_t start = pos + 1;
+	size_t p = start;
+	while ( p < fLength && IsPlainChar( fJSON[p] ) )
+	{
+		++p;
+	}
+
+	// Common case: nothing to unescape
+	if ( p < fLength && '"' == fJSON[p] )
+	{
+		lua_pushlstring( fL, fJSON + start, p - start );
+		pos = p + 1;
+		return kMatch;
+	}
+
+	luaL_Buffer buffer;
+	luaL_buffinit( fL, & buffer );
+	luaL_addlstring( & buffer, fJSON + start, p - start );
+
+	while ( p < fLength && '\\' == fJSON[p] )
+	{
+		U32 high, low;
+		char c = ( p + 1 < fLength ? fJSON[p + 1] : '\0' );
+		if ( 'u' == c && ReadHex4( p + 2, high ) )
+		{
+			if ( high >= 0xD800 && high <= 0xDBFF
+				 && Matches( p + 6, "\\u", 2 ) && ReadHex4( p + 8, low )
+				 && low >= 0xDC00 && low <= 0xDFFF )
+			{
+				AddUTF8( buffer, ( high - 0xD800 ) * 0x400 + ( low - 0xDC00 ) + 0x10000 );
+				p += 12;
+			}
+			else
+			{
+				// Lone surrogates are passed through, as dkjson does
+				AddUTF8( buffer, high );
+				p += 6;
+			}
+		}
+		else
+		{
+			switch ( c )
+			{
+				case '"': case '\\': case '/':
+					break;
+				case 'b': c = '\b'; break;
+				case 'f': c = '\f'; break;
+				case 'n': c = '\n'; break;
+				case 'r': c = '\r'; break;
+				case 't': c = '\t'; break;
+				default:
+					return Error( p + 1, "unsupported escape sequence" );
+			}
+			luaL_addchar( & buffer, c );
+			p += 2;
+		}
+
+		size_t runStart = p;
+		while ( p < fLength && IsPlainChar( fJSON[p] ) )
+		{
+			++p;
+		}
+		luaL_addlstring( & buffer, fJSON + runStart, p - runStart );
+	}
+
+	if ( p >= fLength || '"' != fJSON[p] )
+	{
+		return Error( p, "unterminated string" );
+	}
+
+	luaL_pushresult( & buffer );
+	pos = p + 1;
+	return kMatch;
+}
+
+static bool
+IsDigit( char c )
+{
+	return c >= '0' && c <= '9';
+}
+
+JSONDecoder::Result
+JSONDecoder::ParseNumber( size_t& pos )
+{
+	// -?(0|[1-9][0-9]*)(\.[0-9]*)?([eE][+-]?[0-9]+)?
+	size_t p = pos;
+	if ( '-' == fJSON[p] )
+	{
+		++p;
+	}
+
+	if ( p < fLength && '0' == fJSON[p] )
+	{
+		++p;
+	}
+	else if ( p < fLength && IsDigit( fJSON[p] ) )
+	{
+		while ( p < fLength && IsDigit( fJSON[p] ) )
+		{
+			++p;
+		}
+	}
+	else
+	{
+		return kNoMatch;
+	}
+
+	if ( p < fLength && '.' == fJSON[p] )
+	{
+		++p;
+		while ( p < fLength && IsDigit( fJSON[p] ) )
+		{
+			++p;
+		}
+	}
+
+	if ( p < fLength && ( 'e' == fJSON[p] || 'E' == fJSON[p] ) )
+	{
+		size_t q = p + 1;
+		if ( q < fLength && ( '+' == fJSON[q] || '-' == fJSON[q] ) )
+		{
+			++q;
+		}
+		if ( q < fLength && IsDigit( fJSON[q] ) )
+		{
+			while ( q < fLength && IsDigit( fJSON[q] ) )
+			{
+				++q;
+			}
+			p = q;
+		}
+	}
+
+	// strtod() wants a terminated string using the locale's decimal point
+	const size_t length = p - pos;
+	char stackBuffer[64];
+	char *number = ( length < sizeof( stackBuffer ) ? stackBuffer : (char*)malloc( length + 1 ) );
+	memcpy( number, fJSON + pos, length );
+	number[length] = '\0';
+
+	char *dot = (char*)memchr( number, '.', length );
+	if ( dot )
+	{
+		*dot = fDecimalPoint;
+	}
+
+	lua_Number value = (lua_Number)strtod( number, NULL );
+	if ( number != stackBuffer )
+	{
+		free( number );
+	}
+
+	lua_pushnumber( fL, value );
+	pos = p;
+	return kMatch;
+}
+
+size_t
+JSONDecoder::SkipSpace( size_t pos ) const
+{
+	while ( pos < fLength )
+	{
+		char c = fJSON[pos];
+		if ( ' ' == c || '\n' == c || '\r' == c || '\t' == c )
+		{
+			++pos;
+		}
+		else if ( Matches( pos, "\xEF\xBB\xBF", 3 ) ) // UTF-8 byte order mark
+		{
+			pos += 3;
+		}
+		else if ( Matches( pos, "//", 2 ) )
+		{
+			pos += 2;
+			while ( pos < fLength && '\n' != fJSON[pos] && '\r' != fJSON[pos] )
+			{
+				++pos;
+			}
+		}
+		else if ( Matches( pos, "/*", 2 ) )
+		{
+			// An unclosed comment is not space
+			const char *end = NULL;
+			for ( size_t i = pos + 2; i + 1 < fLength && ! end; i++ )
+			{
+				if ( '*' == fJSON[i] && '/' == fJSON[i + 1] )
+				{
+					end = fJSON + i;
+				}
+			}
+			if ( ! end )
+			{
+				break;
+			}
+			pos = ( end - fJSON ) + 2;
+		}
+		else
+		{
+			break;
+		}
+	}
+	return pos;
+}
+
+bool
+JSONDecoder::Matches( size_t pos, const char *literal, size_t length ) const
+{
+	return pos <= fLength && fLength - pos >= length && 0 == memcmp( fJSON + pos, literal, length );
+}
+
+bool
+JSONDecoder::ReadHex4( size_t pos, U32& result ) const
+{
+	if ( pos > fLength || fLength - pos < 4 )
+	{
+		return false;
+	}
+
+	U32 value = 0;
+	for ( size_t i = pos; i < pos + 4; i++ )
+	{
+		char c = fJSON[i];
+		U32 digit;
+		if ( c >= '0' && c <= '9' ) { digit = c - '0'; }
+		else if ( c >= 'a' && c <= 'f' ) { digit = c - 'a' + 10; }
+		else if ( c >= 'A' && c <= 'F' ) { digit = c - 'A' + 10; }
+		else { return false; }
+
+		value = ( value << 4 ) | digit;
+	}
+
+	result = value;
+	return true;
+}
+
+JSONDecoder::Result
+JSONDecoder::Error( size_t pos, const char *message )
+{
+	// Only the first error is reported, as with dkjson
+	if ( ! fErrorMessage )
+	{
+		fErrorPos = pos;
+		fErrorMessage = message;
+	}
+	return kError;
+}
+
+// json.decode( str [, pos [, nullval [, objectmeta [, arraymeta]]]] )
+static int
+decode( lua_State *L )
+{
+	size_t length;
+	const char *json = luaL_checklstring( L, 1, & length );
+
+	// Same cropping of the start position as lpeg.match()
+	lua_Integer init = luaL_optinteger( L, 2, 1 );
+	size_t pos;
+	if ( init > 0 )
+	{
+		pos = ( (size_t)init <= length ? (size_t)init - 1 : length );
+	}
+	else
+	{
+		pos = ( (size_t)( -init ) <= length ? length - (size_t)( -init ) : 0 );
+	}
+
+	// Arguments past nullval replace the default metatables, even with nil
+	const bool hasMetatables = lua_gettop( L ) > 3;
+	lua_settop( L, 5 );
+	if ( ! hasMetatables )
+	{
+		lua_createtable( L, 0, 1 );
+		lua_pushliteral( L, "object" );
+		lua_setfield( L, -2, "__jsontype" );
+		lua_replace( L, 4 );
+
+		lua_createtable( L, 0, 1 );
+		lua_pushliteral( L, "array" );
+		lua_setfield( L, -2, "__jsontype" );
+		lua_replace( L, 5 );
+	}
+
+	JSONDecoder decoder( L, json, length, 3, 4, 5 );
+	if ( JSONDecoder::kMatch != decoder.ParseExpectedValue( pos ) )
+	{
+		lua_settop( L, 5 );
+		return decoder.PushError();
+	}
+
+	lua_pushinteger( L, (lua_Integer)( pos + 1 ) );
+	return 2;
+}
+
+// ----------------------------------------------------------------------------
+// Encoding
+// ----------------------------------------------------------------------------
+
+// Output that has not been handed to Lua yet. Owned by a userdata so it is
+// released even when encoding raises an error.
+struct JSONBuffer
+{
+	char *fData;
+	size_t fLength;
+	size_t fCapacity;
+};
+
+static int
+JSONBufferFinalizer( lua_State *L )
+{
+	JSONBuffer *buffer = (JSONBuffer*)luaL_checkudata( L, 1, kBufferMetatable );
+	free( buffer->fData );
+	buffer->fData = NULL;
+	return 0;
+}
+
+static int
+NullToJSON( lua_State *L )
+{
+	lua_pushliteral( L, "null" );
+	return 1;
+}
+
+// Byte classes for quoting; see dkjson's quotestring()
+enum
+{
+	kPlainByte = 0,
+	kEscapeByte, // control characters, '"', '\\' and DEL
+	kLeadByte // may start a sequence that JavaScript treats specially
+};
+
+static U8 sByteClasses[256];
+
+static void
+InitByteClasses()
+{
+	for ( int i = 0; i < 0x20; i++ )
+	{
+		sByteClasses[i] = kEscapeByte;
+	}
+	sByteClasses[(U8)'"'] = kEscapeByte;
+	sByteClasses[(U8)'\\'] = kEscapeByte;
+	sByteClasses[0x7F] = kEscapeByte;
+
+	sByteClasses[0xC2] = kLeadByte;
+	sByteClasses[0xD8] = kLeadByte;
+	sByteClasses[0xDC] = kLeadByte;
+	sByteClasses[0xE1] = kLeadByte;
+	sByteClasses[0xE2] = kLeadByte;
+	sByteClasses[0xEF] = kLeadByte;
+}
+
+// Length of the sequence starting at s that dkjson escapes, or 0
+static size_t
+GetSpecialSequenceLength( const U8 *s, size_t length )
+{
+	U8 a = s[0];
+	U8 b = ( length > 1 ? s[1] : 0 );
+	U8 c = ( length > 2 ? s[2] : 0 );
+
+	switch ( a )
+	{
+		case 0xC2:
+			return ( ( b >= 0x80 && b <= 0x9F ) || 0xAD == b ? 2 : 0 );
+		case 0xD8:
+			return ( b >= 0x80 && b <= 0x84 ? 2 : 0 );
+		case 0xDC:
+			return ( 0x8F == b ? 2 : 0 );
+		case 0xE1:
+			return ( 0x9E == b && ( 0xB4 == c || 0xB5 == c ) ? 3 : 0 );
+		case 0xE2:
+			if ( 0x80 == b )
+			{
+				return ( ( c >= 0x8C && c <= 0x8F ) || ( c >= 0xA8 && c <= 0xAF ) ? 3 : 0 );
+			}
+			return ( 0x81 == b && c >= 0xA0 && c <= 0xAF ? 3 : 0 );
+		case 0xEF:
+			if ( 0xBB == b )
+			{
+				return ( 0xBF == c ? 3 : 0 );
+			}
+			return ( 0xBF == b && c >= 0xB0 && c <= 0xBF ? 3 : 0 );
+		default:
+			return 0;
+	}
+}
+
+// Mirrors dkjson's encode2(). Output accumulates in a JSONBuffer and only
+// moves into state.buffer when a __tojson or exception handler runs, since
+// those may inspect or append to it.
+class JSONEncoder
+{
+	public:
+		JSONEncoder( lua_State *L, int stateIndex, int bufferIndex, int tablesIndex, int keyOrderIndex );
+
+	public:
+		void Encode( int index, int level );
+
+		// Moves pending output into state.buffer, creating it if needed
+		void Flush();
+
+		bool HasFlushed() const { return fHasFlushed; }
+		int GetBufferLength() const { return fBufferLength; }
+		const char* GetPending( size_t& length ) const;
+
+	protected:
+		void EncodeTable( int index, int level, int metaIndex );
+		void AddPair( int keyIndex, int valueIndex, bool prev, int level );
+		void AddCustom( int resultIndex );
+		void Exception( const char *reason, int valueIndex, const char *defaultMessage );
+		void CallToJSON( int valueIndex, int toJSONIndex );
+
+		bool IsActive( int index );
+		void SetActive( int index, bool active );
+		bool IsArray( int index, lua_Number& max );
+
+		void Reserve( size_t length );
+		void Append( const char *s, size_t length );
+		void Append( char c );
+		void AppendNewline( int level );
+		void AppendNumber( lua_Number value );
+		void AppendQuoted( const char *s, size_t length );
+
+	private:
+		lua_State *fL;
+		int fStateIndex;
+		int fBufferIndex;
+		int fTablesIndex;
+		int fKeyOrderIndex;
+		JSONBuffer *fBuffer;
+		int fBufferLength; // state.bufferlen
+		bool fIndent;
+		bool fHasFlushed;
+		char fDecimalPoint;
+};
+
+JSONEncoder::JSONEncoder( lua_State *L, int stateIndex, int bufferIndex, int tablesIndex, int keyOrderIndex )
+:	fL( L ),
+	fStateIndex( stateIndex ),
+	fBufferIndex( bufferIndex ),
+	fTablesIndex( tablesIndex ),
+	fKeyOrderIndex( keyOrderIndex ),
+	fBuffer( (JSONBuffer*)lua_touserdata( L, bufferIndex ) ),
+	fBufferLength( 0 ),
+	fIndent( false ),
+	fHasFlushed( false ),
+	fDecimalPoint( GetDecimalPoint() )
+{
+	lua_getfield( L, stateIndex, "indent" );
+	fIndent = lua_toboolean( L, -1 );
+	lua_getfield( L, stateIndex, "bufferlen" );
+	fBufferLength = (int)lua_tointeger( L, -1 );
+	lua_pop( L, 2 );
+}
+
+void
+JSONEncoder::Encode( int index, int level )
+{
+	luaL_checkstack( fL, 8, "json.encode" );
+
+	const int top = lua_gettop( fL );
+	const int type = lua_type( fL, index );
+
+	int metaIndex = 0;
+	if ( lua_getmetatable( fL, index ) )
+	{
+		if ( lua_istable( fL, -1 ) )
+		{
+			metaIndex = lua_gettop( fL );
+
+			lua_getfield( fL, metaIndex, "__tojson" );
+			if ( lua_tocfunction( fL, -1 ) == NullToJSON )
+			{
+				Append( "null", 4 );
+				lua_settop( fL, top );
+				return;
+			}
+			if ( lua_toboolean( fL, -1 ) )
+			{
+				CallToJSON( index, lua_gettop( fL ) );
+				lua_settop( fL, top );
+				return;
+			}
+			lua_pop( fL, 1 );
+		}
+	}
+
+	switch ( type )
+	{
+		case LUA_TNIL:
+		case LUA_TNONE:
+			Append( "null", 4 );
+			break;
+		case LUA_TNUMBER:
+			AppendNumber( lua_tonumber( fL, index ) );
+			break;
+		case LUA_TBOOLEAN:
+			if ( lua_toboolean( fL, index ) )
+			{
+				Append( "true", 4 );
+			}
+			else
+			{
+				Append( "false", 5 );
+			}
+			break;
+		case LUA_TSTRING:
+			{
+				size_t length;
+				const char *s = lua_tolstring( fL, index, & length );
+				AppendQuoted( s, length );
+			}
+			break;
+		case LUA_TTABLE:
+			EncodeTable( index, level, metaIndex );
+			break;
+		default:
+			{
+				const char *typeName = lua_typename( fL, type );
+				lua_pushfstring( fL, "type '%s' is not supported by JSON.", typeName );
+				Exception( "unsupported type", index, lua_tostring( fL, -1 ) );
+			}
+			break;
+	}
+
+	lua_settop( fL, top );
+}
+
+void
+JSONEncoder::EncodeTable( int index, int level, int metaIndex )
+{
+	if ( IsActive( index ) )
+	{
+		Exception( "reference cycle", index, NULL );
+		return;
+	}
+	SetActive( index, true );
+	++level;
+
+	const int top = lua_gettop( fL );
+
+	lua_Number n = 0;
+	bool isArray = IsArray( index, n );
+	if ( isArray && 0 == n && metaIndex )
+	{
+		lua_getfield( fL, metaIndex, "__jsontype" );
+		const char *jsonType = lua_tostring( fL, -1 );
+		isArray = ! ( jsonType && 0 == strcmp( jsonType, "object" ) );
+		lua_pop( fL, 1 );
+	}
+
+	if ( isArray )
+	{
+		Append( '[' );
+		for ( int i = 1; i <= n; i++ )
+		{
+			if ( metaIndex )
+			{
+				lua_pushinteger( fL, i );
+				lua_gettable( fL, index );
+			}
+			else
+			{
+				lua_rawgeti( fL, index, i );
+			}
+			Encode( lua_gettop( fL ), level );
+			lua_pop( fL, 1 );
+
+			if ( i < n )
+			{
+				Append( ',' );
+			}
+		}
+		Append( ']' );
+	}
+	else
+	{
+		bool prev = false;
+		Append( '{' );
+
+		int orderIndex = 0;
+		if ( metaIndex )
+		{
+			lua_getfield( fL, metaIndex, "__jsonorder" );
+			if ( lua_toboolean( fL, -1 ) )
+			{
+				orderIndex = lua_gettop( fL );
+			}
+		}
+		if ( ! orderIndex && fKeyOrderIndex )
+		{
+			orderIndex = fKeyOrderIndex;
+		}
+
+		int usedIndex = 0;
+		if ( orderIndex )
+		{
+			lua_newtable( fL );
+			usedIndex = lua_gettop( fL );
+
+			for ( int i = 1, iMax = (int)lua_objlen( fL, orderIndex ); i <= iMax; i++ )
+			{
+				lua_rawgeti( fL, orderIndex, i );
+				const int keyIndex = lua_gettop( fL );
+				lua_pushvalue( fL, keyIndex );
+				lua_gettable( fL, index );
+				if ( ! lua_isnil( fL, -1 ) )
+				{
+					lua_pushvalue( fL, keyIndex );
+					lua_pushboolean( fL, 1 );
+					lua_rawset( fL, usedIndex );
+
+					AddPair( keyIndex, keyIndex + 1, prev, level );
+					prev = true;
+				}
+				lua_settop( fL, usedIndex );
+			}
+		}
+
+		lua_pushnil( fL );
+		while ( lua_next( fL, index ) )
+		{
+			const int keyIndex = lua_gettop( fL ) - 1;
+			bool isUsed = false;
+			if ( usedIndex )
+			{
+				lua_pushvalue( fL, keyIndex );
+				lua_rawget( fL, usedIndex );
+				isUsed = lua_toboolean( fL, -1 );
+				lua_pop( fL, 1 );
+			}
+			if ( ! isUsed )
+			{
+				AddPair( keyIndex, keyIndex + 1, prev, level );
+				prev = true;
+			}
+			lua_settop( fL, keyIndex );
+		}
+
+		if ( fIndent )
+		{
+			AppendNewline( level - 1 );
+		}
+		Append( '}' );
+	}
+
+	lua_settop( fL, top );
+	SetActive( index, false );
+}
+
+void
+JSONEncoder::AddPair( int keyIndex, int valueIndex, bool prev, int level )
+{
+	// Never call lua_tolstring() on a number key; it would confuse lua_next()
+	const int keyType = lua_type( fL, keyIndex );
+	if ( LUA_TSTRING != keyType && LUA_TNUMBER != keyType )
+	{
+		luaL_error( fL, "type '%s' is not supported as a key by JSON.", lua_typename( fL, keyType ) );
+	}
+
+	if ( prev )
+	{
+		Append( ',' );
+	}
+	if ( fIndent )
+	{
+		AppendNewline( level );
+	}
+
+	if ( LUA_TSTRING == keyType )
+	{
+		size_t length;
+		const char *s = lua_tolstring( fL, keyIndex, & length );
+		AppendQuoted( s, length );
+	}
+	else
+	{
+		char s[LUAI_MAXNUMBER2STR];
+		int length = snprintf( s, sizeof( s ), LUA_NUMBER_FMT, (LUAI_UACNUMBER)lua_tonumber( fL, keyIndex ) );
+		AppendQuoted( s, (size_t)length );
+	}
+	Append( ':' );
+
+	Encode( valueIndex, level );
+}
+
+void
+JSONEncoder::CallToJSON( int valueIndex, int toJSONIndex )
+{
+	if ( IsActive( valueIndex ) )
+	{
+		Exception( "reference cycle", valueIndex, NULL );
+		return;
+	}
+	SetActive( valueIndex, true );
+
+	Flush();
+
+	lua_pushvalue( fL, toJSONIndex );
+	lua_pushvalue( fL, valueIndex );
+	lua_pushvalue( fL, fStateIndex );
+	lua_call( fL, 2, 2 );
+
+	const int resultIndex = lua_gettop( fL ) - 1;
+	if ( ! lua_toboolean( fL, resultIndex ) )
+	{
+		Exception( "custom encoder failed", valueIndex, lua_tostring( fL, resultIndex + 1 ) );
+		return;
+	}
+
+	SetActive( valueIndex, false );
+	AddCustom( resultIndex );
+}
+
+void
+JSONEncoder::AddCustom( int resultIndex )
+{
+	// The handler may have appended to state.buffer itself
+	lua_getfield( fL, fStateIndex, "bufferlen" );
+	fBufferLength = (int)lua_tointeger( fL, -1 );
+	lua_pop( fL, 1 );
+
+	if ( LUA_TSTRING == lua_type( fL, resultIndex ) )
+	{
+		size_t length;
+		const char *s = lua_tolstring( fL, resultIndex, & length );
+		Append( s, length );
+	}
+}
+
+void
+JSONEncoder::Exception( const char *reason, int valueIndex, const char *defaultMessage )
+{
+	if ( ! defaultMessage )
+	{
+		defaultMessage = reason;
+	}
+
+	lua_getfield( fL, fStateIndex, "exception" );
+	if ( ! lua_toboolean( fL, -1 ) )
+	{
+		luaL_error( fL, "%s", defaultMessage );
+	}
+
+	Flush();
+
+	lua_pushstring( fL, reason );
+	lua_pushvalue( fL, valueIndex );
+	lua_pushvalue( fL, fStateIndex );
+	lua_pushstring( fL, defaultMessage );
+	lua_call( fL, 4, 2 );
+
+	const int resultIndex = lua_gettop( fL ) - 1;
+	if ( ! lua_toboolean( fL, resultIndex ) )
+	{
+		const char *message = lua_tostring( fL, resultIndex + 1 );
+		luaL_error( fL, "%s", message ? message : defaultMessage );
+	}
+
+	AddCustom( resultIndex );
+}
+
+void
+JSONEncoder::Flush()
+{
+	lua_getfield( fL, fStateIndex, "buffer" );
+	if ( ! lua_istable( fL, -1 ) )
+	{
+		lua_pop( fL, 1 );
+		lua_newtable( fL );
+		lua_pushvalue( fL, -1 );
+		lua_setfield( fL, fStateIndex, "buffer" );
+	}
+
+	if ( fBuffer->fLength > 0 )
+	{
+		lua_pushlstring( fL, fBuffer->fData, fBuffer->fLength );
+		lua_rawseti( fL, -2, ++fBufferLength );
+		fBuffer->fLength = 0;
+	}
+	lua_pop( fL, 1 );
+
+	lua_pushinteger( fL, fBufferLength );
+	lua_setfield( fL, fStateIndex, "bufferlen" );
+
+	fHasFlushed = true;
+}
+
+const char*
+JSONEncoder::GetPending( size_t& length ) const
+{
+	length = fBuffer->fLength;
+	return fBuffer->fData;
+}
+
+bool
+JSONEncoder::IsActive( int index )
+{
+	lua_pushvalue( fL, index );
+	lua_rawget( fL, fTablesIndex );
+	bool result = lua_toboolean( fL, -1 );
+	lua_pop( fL, 1 );
+	return result;
+}
+
+void
+JSONEncoder::SetActive( int index, bool active )
+{
+	lua_pushvalue( fL, index );
+	if ( active )
+	{
+		lua_pushboolean( fL, 1 );
+	}
+	else
+	{
+		lua_pushnil( fL );
+	}
+	lua_rawset( fL, fTablesIndex );
+}
+
+bool
+JSONEncoder::IsArray( int index, lua_Number& max )
+{
+	lua_Number n = 0;
+	lua_Number arrayLength = 0;
+	max = 0;
+
+	lua_pushnil( fL );
+	while ( lua_next( fL, index ) )
+	{
+		const int keyType = lua_type( fL, -2 );
+		if ( LUA_TSTRING == keyType && LUA_TNUMBER == lua_type( fL, -1 ) && 0 == strcmp( lua_tostring( fL, -2 ), "n" ) )
+		{
+			arrayLength = lua_tonumber( fL, -1 );
+			if ( arrayLength > max )
+			{
+				max = arrayLength;
+			}
+		}
+		else
+		{
+			lua_Number k = ( LUA_TNUMBER == keyType ? lua_tonumber( fL, -2 ) : 0 );
+			if ( LUA_TNUMBER != keyType || k < 1 || floor( k ) != k )
+			{
+				lua_pop( fL, 2 );
+				return false;
+			}
+			if ( k > max )
+			{
+				max = k;
+			}
+			++n;
+		}
+		lua_pop( fL, 1 );
+	}
+
+	// Don't create an array with too many holes
+	return ! ( max > 10 && max > arrayLength && max > n * 2 );
+}
+
+void
+JSONEncoder::Reserve( size_t length )
+{
+	JSONBuffer& buffer = * fBuffer;
+	if ( buffer.fLength + length > buffer.fCapacity )
+	{
+		size_t capacity = ( buffer.fCapacity > 0 ? buffer.fCapacity * 2 : 256 );
+		while ( capacity < buffer.fLength + length )
+		{
+			capacity *= 2;
+		}
+
+		char *data = (char*)realloc( buffer.fData, capacity );
+		if ( ! data )
+		{
+			luaL_error( fL, "not enough memory" );
+		}
+		buffer.fData = data;
+		buffer.fCapacity = capacity;
+	}
+}
+
+void
+JSONEncoder::Append( const char *s, size_t length )
+{
+	Reserve( length );
+	memcpy( fBuffer->fData + fBuffer->fLength, s, length );
+	fBuffer->fLength += length;
+}
+
+void
+JSONEncoder::Append( char c )
+{
+	Reserve( 1 );
+	fBuffer->fData[fBuffer->fLength++] = c;
+}
+
+void
+JSONEncoder::AppendNewline( int level )
+{
+	Reserve( 1 + 2 * (size_t)( level > 0 ? level : 0 ) );
+	Append( '\n' );
+	for ( int i = 0; i < level; i++ )
+	{
+		Append( "  ", 2 );
+	}
+}
+
+void
+JSONEncoder::AppendNumber( lua_Number value )
+{
+	// Matches the original JSON implementation
+	if ( value != value || value >= HUGE_VAL || -value >= HUGE_VAL )
+	{
+		Append( "null", 4 );
+		return;
+	}
+
+	char s[LUAI_MAXNUMBER2STR];
+	int length = snprintf( s, sizeof( s ), LUA_NUMBER_FMT, (LUAI_UACNUMBER)value );
+	if ( '.' != fDecimalPoint )
+	{
+		char *point = (char*)memchr( s, fDecimalPoint, length );
+		if ( point )
+		{
+			*point = '.';
+		}
+	}
+	Append( s, (size_t)length );
+}
+
+void
+JSONEncoder::AppendQuoted( const char *s, size_t length )
+{
+	static const char kHexDigits[] = "0123456789abcdef";
+
+	const U8 *bytes = (const U8*)s;
+
+	Reserve( length + 2 );
+	Append( '"' );
+
+	size_t runStart = 0;
+	size_t i = 0;
+	while ( i < length )
+	{
+		U8 c = bytes[i];
+		U8 byteClass = sByteClasses[c];
+		if ( kPlainByte == byteClass )
+		{
+			++i;
+			continue;
+		}
+
+		U32 value = c;
+		size_t sequenceLength = 1;
+		if ( kLeadByte == byteClass )
+		{
+			sequenceLength = GetSpecialSequenceLength( bytes + i, length - i );
+			if ( 0 == sequenceLength )
+			{
+				++i;
+				continue;
+			}
+			value = ( 2 == sequenceLength
+				? ( ( c - 0xC0 ) << 6 ) | ( bytes[i + 1] - 0x80 )
+				: ( ( ( c - 0xE0 ) << 6 | ( bytes[i + 1] - 0x80 ) ) << 6 ) | ( bytes[i + 2] - 0x80 ) );
+		}
+
+		Append( s + runStart, i - runStart );
+
+		const char *escape = NULL;
+		switch ( value )
+		{
+			case '"': escape = "\\\""; break;
+			case '\\': escape = "\\\\"; break;
+			case '\b': escape = "\\b"; break;
+			case '\f': escape = "\\f"; break;
+			case '\n': escape = "\\n"; break;
+			case '\r': escape = "\\r"; break;
+			case '\t': escape = "\\t"; break;
+			default: break;
+		}
+
+		if ( escape )
+		{
+			Append( escape, 2 );
+		}
+		else
+		{
+			char u[6] = { '\\', 'u',
+				kHexDigits[( value >> 12 ) & 0xF], kHexDigits[( value >> 8 ) & 0xF],
+				kHexDigits[( value >> 4 ) & 0xF], kHexDigits[value & 0xF] };
+			Append( u, sizeof( u ) );
+		}
+
+		i += sequenceLength;
+		runStart = i;
+	}
+
+	Append( s + runStart, length - runStart );
+	Append( '"' );
+}
+
+// json.encode( value [, state] )
+static int
+encode( lua_State *L )
+{
+	lua_settop( L, 2 );
+	if ( lua_isnil( L, 2 ) )
+	{
+		lua_newtable( L );
+		lua_replace( L, 2 );
+	}
+	luaL_checktype( L, 2, LUA_TTABLE );
+
+	// 3: the original state.buffer
+	lua_getfield( L, 2, "buffer" );
+	const bool hasBuffer = lua_toboolean( L, 3 );
+
+	// 4: tables being encoded, for cycle detection
+	lua_getfield( L, 2, "tables" );
+	if ( ! lua_istable( L, 4 ) )
+	{
+		lua_pop( L, 1 );
+		lua_newtable( L );
+	}
+
+	// 5: state.keyorder
+	lua_getfield( L, 2, "keyorder" );
+	const int keyOrderIndex = ( lua_toboolean( L, 5 ) ? 5 : 0 );
+
+	// 6: pending output
+	JSONBuffer *buffer = (JSONBuffer*)lua_newuserdata( L, sizeof( JSONBuffer ) );
+	buffer->fData = NULL;
+	buffer->fLength = 0;
+	buffer->fCapacity = 0;
+	luaL_getmetatable( L, kBufferMetatable );
+	lua_setmetatable( L, -2 );
+
+	lua_getfield( L, 2, "level" );
+	int level = (int)lua_tointeger( L, -1 );
+	lua_pop( L, 1 );
+
+	JSONEncoder encoder( L, 2, 6, 4, keyOrderIndex );
+	encoder.Encode( 1, level );
+
+	if ( hasBuffer )
+	{
+		encoder.Flush();
+		lua_pushboolean( L, 1 );
+		return 1;
+	}
+
+	size_t length;
+	const char *pending = encoder.GetPending( length );
+	if ( ! encoder.HasFlushed() )
+	{
+		lua_pushlstring( L, pending ? pending : "", length );
+	}
+	else
+	{
+		// Handlers saw a state.buffer, so concatenate it like dkjson does
+		encoder.Flush();
+		lua_getfield( L, 2, "buffer" );
+		const int bufferIndex = lua_gettop( L );
+		luaL_Buffer result;
+		luaL_buffinit( L, & result );
+		for ( int i = 1, iMax = encoder.GetBufferLength(); i <= iMax; i++ )
+		{
+			lua_rawgeti( L, bufferIndex, i );
+			luaL_addvalue( & result );
+		}
+		luaL_pushresult( & result );
+	}
+
+	lua_pushnil( L );
+	lua_setfield( L, 2, "bufferlen" );
+	lua_pushnil( L );
+	lua_setfield( L, 2, "buffer" );
+	return 1;
+}
+
+// ----------------------------------------------------------------------------
+
+int
+LuaLibJSON::Open( lua_State *L )
+{
+	InitByteClasses();
+
+	luaL_newmetatable( L, kBufferMetatable );
+	lua_pushcfunction( L, JSONBufferFinalizer );
+	lua_setfield( L, -2, "__gc" );
+	lua_pop( L, 1 );
+
+	const luaL_Reg kVTable[] =
+	{
+		{ "decode", decode },
+		{ "encode", encode },
+
+		{ NULL, NULL }
+	};
+
+	lua_newtable( L );
+	luaL_register( L, NULL, kVTable );
+
+	// Sentinel the encoder recognizes without calling back into Lua
+	lua_newtable( L );
+	lua_createtable( L, 0, 1 );
+	lua_pushcfunction( L, NullToJSON );
+	lua_setfield( L, -2, "__tojson" );
+	lua_setmetatable( L, -2 );
+	lua_setfield( L, -2, "null" );
+
+	return 1;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
@@ -0,0 +1,41 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef __Rtt_LuaLibJSON__
+#define __Rtt_LuaLibJSON__
+
+#include "Rtt_Lua.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Native implementation of dkjson's encode() and decode(). The "dkjson" module
+// picks these up when the "json.native" module is available, so they accept
+// the same arguments, honor the same state options and report errors the same
+// way as the Lua code.
+class LuaLibJSON
+{
+	public:
+		typedef LuaLibJSON Self;
+
+	public:
+		static int Open( lua_State *L );
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // __Rtt_LuaLibJSON__
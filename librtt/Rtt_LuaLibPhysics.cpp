@@ -43,6 +43,7 @@
 #include "CoronaLua.h"
 
 #include <list>
+#include <string.h>
 
 # define ENABLE_DEBUG_PRINT	( 0 )
 #
@@ -892,6 +893,73 @@ GetAverageCollisionPositions( lua_State *L )
 	return 1;
 }
 
+static const char *kCollisionDeliveryNames[] = { "immediate", "buffered", "batched", NULL };
+
+static int
+SetCollisionDelivery( lua_State *L )
+{
+	const char *name = lua_tostring( L, 1 );
+	int index = -1;
+
+	for ( int i = 0; name && kCollisionDeliveryNames[i]; i++ )
+	{
+		if ( 0 == strcmp( name, kCollisionDeliveryNames[i] ) )
+		{
+			index = i;
+		}
+	}
+
+	if ( index < 0 )
+	{
+		CoronaLuaError(L, "physics.setCollisionDelivery() requires 1 parameter (\"immediate\", \"buffered\" or \"batched\")");
+
+		return 0;
+	}
+
+	PhysicsWorld& physics = LuaContext::GetRuntime( L )->GetPhysicsWorld();
+
+	physics.SetCollisionDelivery( (PhysicsWorld::CollisionDelivery)index );
+
+	return 0;
+}
+
+static int
+GetCollisionDelivery( lua_State *L )
+{
+	const PhysicsWorld& physics = LuaContext::GetRuntime( L )->GetPhysicsWorld();
+
+	lua_pushstring( L, kCollisionDeliveryNames[physics.GetCollisionDelivery()] );
+
+	return 1;
+}
+
+static int
+SetAsyncStep( lua_State *L )
+{
+    if (! lua_isboolean(L, 1))
+    {
+        CoronaLuaError(L, "physics.setAsyncStep() requires 1 parameter (boolean)");
+        
+        return 0;
+    }
+    
+	PhysicsWorld& physics = LuaContext::GetRuntime( L )->GetPhysicsWorld();
+
+	physics.SetAsyncStep( lua_toboolean( L, 1 ) );
+
+	return 0;
+}
+
+static int
+GetAsyncStep( lua_State *L )
+{
+	const PhysicsWorld& physics = LuaContext::GetRuntime( L )->GetPhysicsWorld();
+
+	lua_pushboolean( L, physics.GetAsyncStep() );
+
+	return 1;
+}
+
 static int
 setScale( lua_State *L )
 {
@@ -2777,6 +2845,10 @@ LuaLibPhysics::Open( lua_State *L )
 		{ "queryRegion", QueryRegion },
 		{ "setAverageCollisionPositions", SetAverageCollisionPositions },
 		{ "getAverageCollisionPositions", GetAverageCollisionPositions },
+		{ "setCollisionDelivery", SetCollisionDelivery },
+		{ "getCollisionDelivery", GetCollisionDelivery },
+		{ "setAsyncStep", SetAsyncStep },
+		{ "getAsyncStep", GetAsyncStep },
 		{ "setScale", setScale },
 		{ "newJoint", newJoint },
 		{ "newParticleSystem", newParticleSystem },
@@ -11,9 +11,11 @@
 
 #include "Rtt_LuaLibSystem.h"
 
+#include "Core/Rtt_SizeClassAllocator.h"
 #include "Display/Rtt_Display.h"
 #include "Display/Rtt_TextureFactory.h"
 #include "Rtt_LuaContext.h"
+#include "Rtt_LuaEventDispatcher.h"
 #include "Display/Rtt_LuaLibDisplay.h"
 #include "Rtt_LuaProxy.h"
 #include "Rtt_MPlatform.h"
@@ -181,6 +183,43 @@ LuaLibSystem::getInfo( lua_State *L )
 		TextureFactory& factory = LuaContext::GetRuntime( L )->GetDisplay().GetTextureFactory();
 		lua_pushinteger( L, factory.GetTextureMemoryUsed() );
 	}
+	else if ( Rtt_StringCompare( key, "textureCacheHits" ) == 0 )
+	{
+		TextureFactory& factory = LuaContext::GetRuntime( L )->GetDisplay().GetTextureFactory();
+		lua_pushinteger( L, factory.GetCacheStats().fHits );
+	}
+	else if ( Rtt_StringCompare( key, "textureCacheMisses" ) == 0 )
+	{
+		TextureFactory& factory = LuaContext::GetRuntime( L )->GetDisplay().GetTextureFactory();
+		lua_pushinteger( L, factory.GetCacheStats().fMisses );
+	}
+	else if ( Rtt_StringCompare( key, "textureCacheEvictions" ) == 0 )
+	{
+		TextureFactory& factory = LuaContext::GetRuntime( L )->GetDisplay().GetTextureFactory();
+		lua_pushinteger( L, factory.GetCacheStats().fEvictions );
+	}
+	else if ( Rtt_StringCompare( key, "textureCacheMemoryUsed" ) == 0 )
+	{
+		TextureFactory& factory = LuaContext::GetRuntime( L )->GetDisplay().GetTextureFactory();
+		lua_pushinteger( L, factory.GetCacheStats().fIdleBytes );
+	}
+	else if ( Rtt_StringCompare( key, "textureCacheBudget" ) == 0 )
+	{
+		TextureFactory& factory = LuaContext::GetRuntime( L )->GetDisplay().GetTextureFactory();
+		lua_pushinteger( L, factory.GetRecentTexturesBudget() );
+	}
+	else if ( Rtt_StringCompare( key, "luaHeapMemoryUsed" ) == 0 )
+	{
+		lua_pushinteger( L, LuaContext::GetHeap( L ).GetStats().fBytesInUse );
+	}
+	else if ( Rtt_StringCompare( key, "luaHeapPoolMemory" ) == 0 )
+	{
+		lua_pushinteger( L, LuaContext::GetHeap( L ).GetStats().fPooledBytes );
+	}
+	else if ( Rtt_StringCompare( key, "luaHeapLargeMemory" ) == 0 )
+	{
+		lua_pushinteger( L, LuaContext::GetHeap( L ).GetStats().fLargeBytes );
+	}
 	else if ( Rtt_StringCompare( key, "maxTextureSize" ) == 0 )
 	{
 		Runtime *runtime = LuaContext::GetRuntime( L );
@@ -1572,6 +1611,10 @@ LuaLibSystem::Initialize( lua_State *L )
         { "__proxyindex", LuaProxy::__proxyindex },
         { "__proxynewindex", LuaProxy::__proxynewindex },
         { "__proxyregister", LuaProxy::__proxyregister },
+        { "__addEventListener", LuaEventDispatcher::addEventListener }, // private
+        { "__removeEventListener", LuaEventDispatcher::removeEventListener }, // private
+        { "__hasEventListener", LuaEventDispatcher::hasEventListener }, // private
+        { "__dispatchEvent", LuaEventDispatcher::dispatchEvent }, // private
         { "pathForFile", LuaLibSystem::PathForFile },
         { "pathForTable", LuaLibSystem::PathForTable }, // private
         { "beginListener", LuaLibSystem::BeginListener }, // private; use system.activate() publicly
@@ -0,0 +1,341 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Rtt_LuaSampler.h"
+
+#include "Core/Rtt_FileSystem.h"
+#include "Rtt_Lua.h"
+
+#include <chrono>
+#include <map>
+#include <stdio.h>
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+static std::atomic< LuaSampler* > sActiveSampler( NULL );
+
+#if defined( Rtt_EMSCRIPTEN_ENV )
+	// Instructions between checks of the clock
+	static const int kPollCount = 1000;
+#endif
+
+static U64
+Now()
+{
+	return (U64)std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+// FNV-1a
+static U64
+Hash( const char* str )
+{
+	U64 result = 14695981039346656037ULL;
+
+	for ( ; *str; ++str )
+	{
+		result = ( result ^ (unsigned char)*str ) * 1099511628211ULL;
+	}
+
+	return result;
+}
+
+// ----------------------------------------------------------------------------
+
+LuaSampler::LuaSampler( lua_State *L )
+:	fL( L ),
+	fInterval( 0 ),
+	fIsRunning( false ),
+	fArmedAt( 0 ),
+	fBuffer(),
+	fUsed( 0 ),
+	fFrameNames(),
+	fFrameIds(),
+	fTimer(),
+	fMutex(),
+	fWake(),
+	fShouldQuit( false )
+{
+	memset( & fStats, 0, sizeof( fStats ) );
+}
+
+LuaSampler::~LuaSampler()
+{
+	Stop();
+}
+
+bool
+LuaSampler::Start( U32 interval )
+{
+	Stop();
+
+	LuaSampler* expected = NULL;
+
+	if ( 0 == interval || lua_gethook( fL ) || ! sActiveSampler.compare_exchange_strong( expected, this ) )
+	{
+		return false;
+	}
+
+	// Allocated once, so sampling itself only allocates for new functions
+	fBuffer.resize( kBufferSize );
+	fUsed = 0;
+	fFrameNames.clear();
+	fFrameIds.clear();
+	memset( & fStats, 0, sizeof( fStats ) );
+
+	fInterval = interval;
+	fIsRunning = true;
+	fArmedAt.store( Now(), std::memory_order_relaxed );
+
+#if defined( Rtt_EMSCRIPTEN_ENV )
+	lua_sethook( fL, & Hook, LUA_MASKCOUNT, kPollCount );
+#else
+	fShouldQuit = false;
+	fTimer = std::thread( & LuaSampler::RunTimer, this );
+#endif
+
+	return true;
+}
+
+void
+LuaSampler::Stop()
+{
+	if ( ! fIsRunning )
+	{
+		return;
+	}
+
+	if ( fTimer.joinable() )
+	{
+		{
+			std::lock_guard< std::mutex > lock( fMutex );
+			fShouldQuit = true;
+		}
+		fWake.notify_one();
+
+		fTimer.join();
+	}
+
+	if ( lua_gethook( fL ) == & Hook )
+	{
+		lua_sethook( fL, NULL, 0, 0 );
+	}
+
+	fIsRunning = false;
+	sActiveSampler.store( NULL );
+}
+
+void
+LuaSampler::RunTimer()
+{
+	std::unique_lock< std::mutex > lock( fMutex );
+
+	while ( ! fWake.wait_for( lock, std::chrono::microseconds( fInterval ), [this]{ return fShouldQuit; } ) )
+	{
+		// Leave a debugger's hook alone
+		lua_Hook hook = lua_gethook( fL );
+
+		if ( NULL == hook || & Hook == hook )
+		{
+			fArmedAt.store( Now(), std::memory_order_relaxed );
+
+			// Fires on the next instruction; as in lua.c, setting a hook from
+			// outside the VM's thread is safe
+			lua_sethook( fL, & Hook, LUA_MASKCOUNT, 1 );
+		}
+	}
+}
+
+void
+LuaSampler::Hook( lua_State *L, lua_Debug *ar )
+{
+	Rtt_UNUSED( ar );
+
+	LuaSampler* sampler = sActiveSampler.load( std::memory_order_acquire );
+
+	if ( ! sampler )
+	{
+		return;
+	}
+
+	U64 now = Now();
+	U64 armedAt = sampler->fArmedAt.load( std::memory_order_relaxed );
+
+#if defined( Rtt_EMSCRIPTEN_ENV )
+	if ( now - armedAt < sampler->fInterval )
+	{
+		return;
+	}
+
+	sampler->fArmedAt.store( now, std::memory_order_relaxed );
+#else
+	lua_sethook( L, NULL, 0, 0 );
+
+	// Lua was not running when the timer went off
+	if ( now - armedAt > sampler->fInterval / 2 )
+	{
+		++sampler->fStats.fIdle;
+
+		return;
+	}
+#endif
+
+	sampler->Sample( L );
+
+	sampler->fStats.fMicroseconds += Now() - now;
+}
+
+void
+LuaSampler::Sample( lua_State *L )
+{
+	U32 ids[kMaxDepth + 1];
+	int depth = 0;
+	lua_Debug ar;
+	char label[160];
+
+	for ( int level = 0; lua_getstack( L, level, & ar ); level++ )
+	{
+		if ( kMaxDepth == depth )
+		{
+			ids[depth++] = FrameId( "(truncated)" );
+
+			break;
+		}
+
+		lua_getinfo( L, "Sn", & ar );
+
+		if ( 0 == strcmp( ar.what, "C" ) )
+		{
+			snprintf( label, sizeof( label ), "%s [C]", ar.name ? ar.name : "?" );
+		}
+		else if ( 0 == strcmp( ar.what, "main" ) )
+		{
+			snprintf( label, sizeof( label ), "main chunk (%s)", ar.short_src );
+		}
+		else if ( 0 == strcmp( ar.what, "tail" ) )
+		{
+			snprintf( label, sizeof( label ), "(tail call)" );
+		}
+		else
+		{
+			snprintf( label, sizeof( label ), "%s (%s:%d)", ar.name ? ar.name : "?", ar.short_src, ar.linedefined );
+		}
+
+		// ';' separates frames in the output
+		for ( char* c = strchr( label, ';' ); c; c = strchr( c, ';' ) )
+		{
+			*c = ':';
+		}
+
+		ids[depth++] = FrameId( label );
+	}
+
+	if ( 0 == depth )
+	{
+		return;
+	}
+
+	if ( fUsed + depth + 1 > fBuffer.size() )
+	{
+		++fStats.fDropped;
+
+		return;
+	}
+
+	fBuffer[fUsed++] = (U32)depth;
+
+	for ( int i = depth - 1; i >= 0; i-- )
+	{
+		fBuffer[fUsed++] = ids[i];
+	}
+
+	++fStats.fSamples;
+}
+
+U32
+LuaSampler::FrameId( const char* label )
+{
+	for ( U64 key = Hash( label ); ; ++key )
+	{
+		std::unordered_map< U64, U32 >::const_iterator iter = fFrameIds.find( key );
+
+		if ( fFrameIds.end() == iter )
+		{
+			U32 id = (U32)fFrameNames.size();
+
+			fFrameNames.push_back( label );
+			fFrameIds[key] = id;
+			fStats.fFrames = id + 1;
+
+			return id;
+		}
+
+		if ( fFrameNames[iter->second] == label )
+		{
+			return iter->second;
+		}
+	}
+}
+
+bool
+LuaSampler::Write( const char* path ) const
+{
+	std::map< std::string, U32 > counts;
+	std::string stack;
+
+	for ( U32 i = 0; i < fUsed; )
+	{
+		U32 depth = fBuffer[i++];
+
+		stack.clear();
+
+		for ( U32 j = 0; j < depth; j++ )
+		{
+			if ( j > 0 )
+			{
+				stack += ';';
+			}
+
+			stack += fFrameNames[fBuffer[i++]];
+		}
+
+		++counts[stack];
+	}
+
+	FILE* file = Rtt_FileOpen( path, "w" );
+
+	if ( ! file )
+	{
+		return false;
+	}
+
+	for ( std::map< std::string, U32 >::const_iterator iter = counts.begin(); iter != counts.end(); ++iter )
+	{
+		fprintf( file, "%s %u\n", iter->first.c_str(), iter->second );
+	}
+
+	bool result = ( 0 == ferror( file ) );
+
+	Rtt_FileClose( file );
+
+	return result;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
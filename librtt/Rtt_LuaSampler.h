@@ -0,0 +1,124 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_LuaSampler_H__
+#define _Rtt_LuaSampler_H__
+
+#include "Core/Rtt_Types.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+struct lua_State;
+struct lua_Debug;
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Statistical profiler for Lua code. Every interval, a timer thread sets a
+// count hook that fires on the next VM instruction; the hook records the Lua
+// and C functions on the stack, then removes itself, so Lua runs unhooked
+// between samples. Without threads, the hook instead runs every so many
+// instructions and samples once the interval has passed.
+//
+// Samples are kept as frame ids in a buffer of fixed size, and written out
+// as folded stacks ("outer;inner count" per line), as used by flamegraph.pl,
+// speedscope and similar tools.
+//
+// Only time spent running Lua is sampled. Should the hook fire well after the
+// timer set it, Lua was idle (e.g. while the frame rendered) and the sample
+// is counted as idle rather than charged to whatever ran next. Time inside a
+// C function shows up in the Lua function that called it.
+//
+// A sample takes a few microseconds for a shallow stack, about 0.3% of Lua's
+// time at a 1 ms interval; "Solar2DBenchmark luaprofile" measures it.
+//
+// One sampler may run at a time. It replaces any debug hook while running,
+// and only samples the lua_State it was started on, not coroutines.
+class LuaSampler
+{
+	public:
+		struct Stats
+		{
+			U32 fSamples;	// recorded
+			U32 fIdle;		// dropped, Lua was not running
+			U32 fDropped;	// dropped, buffer full
+			U32 fFrames;	// distinct functions seen
+			U64 fMicroseconds;	// spent taking samples
+		};
+
+	public:
+		LuaSampler( lua_State *L );
+		~LuaSampler();
+
+	public:
+		// Clears earlier samples and starts sampling every 'interval'
+		// microseconds; returns false if another sampler or a debug hook is
+		// already running
+		bool Start( U32 interval );
+
+		// Keeps the samples for Write()
+		void Stop();
+
+		bool IsRunning() const { return fIsRunning; }
+		const Stats& GetStats() const { return fStats; }
+
+	public:
+		// Returns false if 'path' can't be written
+		bool Write( const char* path ) const;
+
+	private:
+		static void Hook( lua_State *L, lua_Debug *ar );
+
+		void Sample( lua_State *L );
+		U32 FrameId( const char* label );
+		void RunTimer();
+
+	private:
+		// Stacks deeper than this keep their innermost frames
+		static const int kMaxDepth = 64;
+
+		// U32 entries: each sample is its depth, then its frame ids from the
+		// outermost in
+		static const U32 kBufferSize = 256 * 1024;
+
+		lua_State *fL;
+		U32 fInterval;
+		bool fIsRunning;
+		std::atomic< U64 > fArmedAt; // microseconds, when the hook was set
+
+		std::vector< U32 > fBuffer;
+		U32 fUsed;
+		std::vector< std::string > fFrameNames;
+		std::unordered_map< U64, U32 > fFrameIds; // label hash -> index
+
+		Stats fStats;
+
+		std::thread fTimer;
+		std::mutex fMutex;
+		std::condition_variable fWake;
+		bool fShouldQuit;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_LuaSampler_H__
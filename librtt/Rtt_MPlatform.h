@@ -167,6 +167,10 @@ class MPlatform
 		virtual PlatformTimer* CreateTimerWithCallback( MCallback& callback ) const = 0;
 		virtual PlatformBitmap* CreateBitmap( const char *filePath, bool convertToGrayscale ) const = 0;
 		virtual PlatformBitmap* CreateBitmapMask( const char str[], const PlatformFont& font, Real w, Real h, const char alignment[], Real& baselineOffset ) const = 0;
+
+		// True if CreateBitmap() may be called off the main thread, and has
+		// decoded the image by the time it returns
+		virtual bool CanCreateBitmapsConcurrently() const { return false; }
 		virtual bool SaveImageToPhotoLibrary(const char* filePath) const = 0;
 		virtual bool SaveBitmap( PlatformBitmap* bitmap, const char* filePath, float jpegQuality ) const = 0;
 		virtual bool AddBitmapToPhotoLibrary( PlatformBitmap* bitmap ) const = 0;
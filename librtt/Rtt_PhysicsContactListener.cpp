@@ -16,6 +16,7 @@
 #include "Display/Rtt_DisplayObject.h"
 #include "Rtt_Runtime.h"
 #include "Rtt_Event.h"
+#include "Rtt_Lua.h"
 #include "Rtt_LuaContext.h"
 #include "Rtt_PhysicsContact.h"
 #include "Rtt_PhysicsWorld.h"
@@ -30,10 +31,104 @@ namespace Rtt
 // ----------------------------------------------------------------------------
 
 PhysicsContactListener::PhysicsContactListener( Runtime& runtime )
-:	fRuntime( runtime )
+:	fRuntime( runtime ),
+	fRuntimeListeners( 0 )
 {
 }
 
+// Same test as Runtime:respondsToEvent(), without calling into Lua
+bool
+PhysicsContactListener::RuntimeListensFor( const char *eventName ) const
+{
+	lua_State *L = fRuntime.VMContext().L();
+
+	bool result = false;
+
+	Lua::PushRuntime( L );
+	if ( lua_istable( L, -1 ) )
+	{
+		const char* keys[] = { "_functionListeners", "_tableListeners" };
+		for ( int i = 0; i < 2 && ! result; i++ )
+		{
+			lua_getfield( L, -1, keys[i] );
+			if ( lua_istable( L, -1 ) )
+			{
+				lua_getfield( L, -1, eventName );
+				result = ! lua_isnil( L, -1 );
+				lua_pop( L, 1 );
+			}
+			lua_pop( L, 1 );
+		}
+	}
+	lua_pop( L, 1 );
+
+	return result;
+}
+
+void
+PhysicsContactListener::WillStep()
+{
+	fRuntimeListeners = 0;
+
+	if ( RuntimeListensFor( CollisionEvent::kName ) )
+	{
+		fRuntimeListeners |= DisplayObject::kCollisionListener;
+	}
+
+	if ( RuntimeListensFor( PostCollisionEvent::kName ) )
+	{
+		fRuntimeListeners |= DisplayObject::kPostCollisionListener;
+	}
+}
+
+bool
+PhysicsContactListener::BufferCollision( PhysicsWorld::BufferedCollision::Type type,
+											DisplayObject& object1,
+											DisplayObject& object2,
+											const b2Vec2& position,
+											size_t fixtureIndex1,
+											size_t fixtureIndex2,
+											float32 normalImpulse,
+											float32 tangentImpulse )
+{
+	PhysicsWorld& physics = fRuntime.GetPhysicsWorld();
+
+	// Contacts also end outside of steps, e.g. when a body is replaced, and
+	// nothing guarantees their objects survive until the next step. Steps
+	// off the main thread always record, since they cannot reach Lua.
+	if ( ! physics.IsProperty( PhysicsWorld::kIsWorldStepping )
+		 || ( PhysicsWorld::kImmediateCollisions == physics.GetCollisionDelivery()
+			  && ! physics.IsProperty( PhysicsWorld::kIsWorldSteppingAsync ) ) )
+	{
+		return false;
+	}
+
+	bool isPostSolve = ( PhysicsWorld::BufferedCollision::kPostSolve == type );
+	DisplayObject::ListenerMask mask = ( isPostSolve ? DisplayObject::kPostCollisionListener : DisplayObject::kCollisionListener );
+
+	if ( object1.HasListener( mask )
+		 || object2.HasListener( mask )
+		 || ( fRuntimeListeners & mask ) )
+	{
+		PhysicsWorld::BufferedCollision collision;
+
+		collision.fObject1 = & object1;
+		collision.fObject2 = & object2;
+		collision.fX = position.x;
+		collision.fY = position.y;
+		collision.fNormalImpulse = Rtt_FloatToReal( normalImpulse );
+		collision.fTangentImpulse = Rtt_FloatToReal( tangentImpulse );
+		collision.fFixtureIndex1 = (S32) fixtureIndex1;
+		collision.fFixtureIndex2 = (S32) fixtureIndex2;
+		collision.fType = type;
+		collision.fIsHandled = false;
+
+		physics.BufferCollision( collision );
+	}
+
+	return true;
+}
+
 void
 PhysicsContactListener::BeginContact(b2Contact* contact)
 {
@@ -117,7 +212,8 @@ PhysicsContactListener::BeginContact(b2Contact* contact)
 	////////////////////////////////////////////////////////////////////////
 
 	if ( object1 && ! object1->IsOrphan()
-		 && object2 && ! object2->IsOrphan() )
+		 && object2 && ! object2->IsOrphan()
+		 && ! BufferCollision( PhysicsWorld::BufferedCollision::kBegan, * object1, * object2, position, fixtureIndex1, fixtureIndex2 ) )
 	{
 		UserdataWrapper *contactWrapper = PhysicsContact::CreateWrapper( fRuntime.VMContext().LuaState(), contact );
 		{
@@ -213,7 +309,8 @@ PhysicsContactListener::EndContact(b2Contact* contact)
 	////////////////////////////////////////////////////////////////////////
 
 	if ( object1 && ! object1->IsOrphan()
-		 && object2 && ! object2->IsOrphan() )
+		 && object2 && ! object2->IsOrphan()
+		 && ! BufferCollision( PhysicsWorld::BufferedCollision::kEnded, * object1, * object2, position, fixtureIndex1, fixtureIndex2 ) )
 	{
 		UserdataWrapper *contactWrapper = PhysicsContact::CreateWrapper( fRuntime.VMContext().LuaState(), contact );
 		{
@@ -411,7 +508,8 @@ PhysicsContactListener::PostSolve(b2Contact* contact, const b2ContactImpulse* im
 	}
 
 	if ( object1 && ! object1->IsOrphan()
-		 && object2 && ! object2->IsOrphan() )
+		 && object2 && ! object2->IsOrphan()
+		 && ! BufferCollision( PhysicsWorld::BufferedCollision::kPostSolve, * object1, * object2, position, fixtureIndex1, fixtureIndex2, maxNormalImpulse, maxTangentImpulse ) )
 	{
 		UserdataWrapper *contactWrapper = PhysicsContact::CreateWrapper( fRuntime.VMContext().LuaState(), contact );
 		{
@@ -14,6 +14,8 @@
 
 #include "Box2D/Box2D.h"
 
+#include "Rtt_PhysicsWorld.h"
+
 // ----------------------------------------------------------------------------
 
 namespace Rtt
@@ -29,6 +31,12 @@ class PhysicsContactListener : public b2ContactListener
 	public:
 		PhysicsContactListener( Runtime& runtime );
 
+	public:
+		// Notes which events the Runtime listens for, so that recording
+		// collisions never calls into Lua; called before each step that may
+		// record them
+		void WillStep();
+
 	public:
 		// b2ContactListener
 		// Fixture <-> Fixture contact.
@@ -45,6 +53,20 @@ class PhysicsContactListener : public b2ContactListener
 									b2ParticleSystem *particleSystem,
 									int32 particleIndex );
 
+	private:
+		bool RuntimeListensFor( const char *eventName ) const;
+
+		// Returns false if collisions are dispatched immediately, else
+		// records the collision if anything will listen for it
+		bool BufferCollision( PhysicsWorld::BufferedCollision::Type type,
+								DisplayObject& object1,
+								DisplayObject& object2,
+								const b2Vec2& position,
+								size_t fixtureIndex1,
+								size_t fixtureIndex2,
+								float32 normalImpulse = 0.0f,
+								float32 tangentImpulse = 0.0f );
+
 	private:
 
 		bool GetCollisionParams( b2Contact* contact,
@@ -55,6 +77,7 @@ class PhysicsContactListener : public b2ContactListener
 									size_t &out_fixtureIndex2 );
 
 		Runtime& fRuntime;
+		U8 fRuntimeListeners;
 };
 
 
@@ -14,13 +14,19 @@
 #include "Box2D/Box2D.h"
 #include "b2GLESDebugDraw.h"
 
+#include "Core/Rtt_TraceRecorder.h"
 #include "Display/Rtt_Display.h"
 #include "Display/Rtt_DisplayObject.h"
+#include "Rtt_Event.h"
 #include "Rtt_LuaAux.h"
 #include "Rtt_LuaLibPhysics.h"
 #include "Rtt_Runtime.h"
 #include "Rtt_PhysicsContactListener.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 // ----------------------------------------------------------------------------
 
 namespace Rtt
@@ -60,14 +66,113 @@ PhysicsDestructionListener::SayGoodbye(b2Fixture* fixture)
 
 // ----------------------------------------------------------------------------
 
+// Runs PhysicsWorld::Simulate() off the main thread, one call at a time
+class PhysicsStepThread
+{
+	Rtt_CLASS_NO_COPIES( PhysicsStepThread )
+
+	public:
+		PhysicsStepThread( PhysicsWorld& physics );
+		~PhysicsStepThread();
+
+	public:
+		void Begin( double elapsedMS );
+		void End();
+
+	private:
+		void Run();
+
+	private:
+		PhysicsWorld& fPhysics;
+		std::mutex fMutex;
+		std::condition_variable fWake;
+		std::condition_variable fDone;
+		double fElapsedMS;
+		bool fIsBusy;
+		bool fShouldQuit;
+		std::thread fThread; // last, so the rest is ready when Run() starts
+};
+
+PhysicsStepThread::PhysicsStepThread( PhysicsWorld& physics )
+:	fPhysics( physics ),
+	fMutex(),
+	fWake(),
+	fDone(),
+	fElapsedMS( 0.0 ),
+	fIsBusy( false ),
+	fShouldQuit( false ),
+	fThread( & PhysicsStepThread::Run, this )
+{
+}
+
+PhysicsStepThread::~PhysicsStepThread()
+{
+	{
+		std::lock_guard< std::mutex > lock( fMutex );
+		fShouldQuit = true;
+	}
+	fWake.notify_one();
+
+	fThread.join();
+}
+
+void
+PhysicsStepThread::Begin( double elapsedMS )
+{
+	{
+		std::lock_guard< std::mutex > lock( fMutex );
+		Rtt_ASSERT( ! fIsBusy );
+
+		fElapsedMS = elapsedMS;
+		fIsBusy = true;
+	}
+	fWake.notify_one();
+}
+
+void
+PhysicsStepThread::End()
+{
+	std::unique_lock< std::mutex > lock( fMutex );
+	fDone.wait( lock, [this]{ return ! fIsBusy; } );
+}
+
+void
+PhysicsStepThread::Run()
+{
+	TraceRecorder::SetThreadName( "Physics" );
+
+	for ( ;; )
+	{
+		double elapsedMS;
+		{
+			std::unique_lock< std::mutex > lock( fMutex );
+			fWake.wait( lock, [this]{ return fShouldQuit || fIsBusy; } );
+
+			if ( fShouldQuit )
+			{
+				break;
+			}
+
+			elapsedMS = fElapsedMS;
+		}
+
+		fPhysics.Simulate( elapsedMS );
+
+		{
+			std::lock_guard< std::mutex > lock( fMutex );
+			fIsBusy = false;
+		}
+		fDone.notify_one();
+	}
+}
+
+// ----------------------------------------------------------------------------
+
 PhysicsWorld::PhysicsWorld( Rtt_Allocator& allocator )
 :	fAllocator( allocator ),
 	fWorldDebugDraw( NULL ),
 	fWorldDestructionListener( NULL ),
 	fWorldContactListener( NULL ),
-	fReportCollisionsInContentCoordinates( false ),
-	fLuaAssertEnabled( false ),
-	fAverageCollisionPositions( false ),
 	fProperties( 0 ),
 	fWorld( NULL ),
 	fPixelsPerMeter( 30.0f ), // default on iPhone
@@ -78,7 +183,15 @@ PhysicsWorld::PhysicsWorld( Rtt_Allocator& allocator )
 	fTimeStep( -1.0f ), // Set time step equal to frame interval
 	fTimeScale( 1.0f ),
 	fTimePrevious( -1.f ),
-	fTimeRemainder( 0.0f )
+	fTimeRemainder( 0.0f ),
+	fReportCollisionsInContentCoordinates( false ),
+	fLuaAssertEnabled( false ),
+	fAverageCollisionPositions( false ),
+	fCollisionDelivery( kImmediateCollisions ),
+	fBufferedCollisions( & allocator ),
+	fStepThread( NULL ),
+	fIsAsyncStep( false ),
+	fHasSteppedAhead( false )
 {
 }
 
@@ -90,6 +203,8 @@ PhysicsWorld::~PhysicsWorld()
 	}
 
 	StopWorld();
+
+	Rtt_DELETE( fStepThread );
 }
 
 void
@@ -128,6 +243,7 @@ PhysicsWorld::StartWorld( Runtime& runtime, bool noSleep )
 		SetTimeStep( -1.f ); // Set time step equal to frame interval
 		fTimePrevious = -1.f;
 		fTimeRemainder = 0.f;
+		DiscardAsyncStep();
 
 		fWorld = Rtt_NEW( Allocator(), b2World( gravity ) );
 		fWorldDestructionListener = Rtt_NEW( Allocator(), PhysicsDestructionListener );
@@ -171,6 +287,8 @@ PhysicsWorld::PauseWorld()
 	{
 		SetProperty( kIsWorldRunning, false );
 	}
+
+	DiscardAsyncStep();
 }
 
 void
@@ -179,6 +297,7 @@ PhysicsWorld::StopWorld()
 	if ( fWorld )
 	{
 		SetProperty( kIsWorldRunning, false );
+		DiscardAsyncStep();
 
 		fWorld->SetContactListener( NULL );
 
@@ -204,6 +323,9 @@ PhysicsWorld::StopWorld()
 		Rtt_DELETE( fWorld );
 		fWorld = NULL;
 
+		// Their objects may go away with the world
+		fBufferedCollisions.Empty();
+
 		// These need to outlive fWorld
 		Rtt_DELETE( fWorldDestructionListener );
 		fWorldDestructionListener = NULL;
@@ -277,6 +399,15 @@ PhysicsWorld::GetAverageCollisionPositions() const
 	return fAverageCollisionPositions;
 }
 
+void
+PhysicsWorld::SetCollisionDelivery( CollisionDelivery newValue )
+{
+	if ( newValue >= kImmediateCollisions && newValue < kNumCollisionDeliveries )
+	{
+		fCollisionDelivery = newValue;
+	}
+}
+
 void
 PhysicsWorld::DebugDraw( Renderer &renderer ) const
 {
@@ -301,106 +432,326 @@ PhysicsWorld::DebugDraw( Renderer &renderer ) const
 void
 PhysicsWorld::StepWorld( double elapsedMS )
 {
+	if ( fHasSteppedAhead )
+	{
+		fHasSteppedAhead = false;
+		return;
+	}
+
 	if ( fWorld && IsProperty( kIsWorldRunning ) )
 	{
-		// These values may be changed on the fly. TODO: make sure this isn't occurring real overhead, or we should drop back to default values only!
-		S32 velocityIterations = GetVelocityIterations();
-		S32 positionIterations = GetPositionIterations();
+		WillSimulate();
+		Simulate( elapsedMS );
+		DidSimulate();
+	}
+}
+
+bool
+PhysicsWorld::BeginAsyncStep( double elapsedMS, const Display& display )
+{
+#if defined( Rtt_EMSCRIPTEN_ENV )
+	return false;
+#else
+	if ( ! fIsAsyncStep
+		 || ! fWorld || ! IsProperty( kIsWorldRunning )
+		 || IsProperty( kPreCollisionListenerExists | kParticleCollisionListenerExists )
+		 || display.GetDrawMode() >= Display::kPhysicsHybridDrawMode
+		 || fLuaAssertEnabled )
+	{
+		return false;
+	}
+
+	if ( ! fStepThread )
+	{
+		fStepThread = Rtt_NEW( Allocator(), PhysicsStepThread( * this ) );
+	}
+
+	SetProperty( kIsWorldSteppingAsync, true );
+	WillSimulate();
+
+	fStepThread->Begin( elapsedMS );
+
+	return true;
+#endif
+}
+
+void
+PhysicsWorld::EndAsyncStep()
+{
+	Rtt_ASSERT( fStepThread && IsProperty( kIsWorldSteppingAsync ) );
+
+	fStepThread->End();
+
+	DidSimulate();
+	SetProperty( kIsWorldSteppingAsync, false );
+
+	// Stands in for the next frame's StepWorld()
+	fHasSteppedAhead = true;
+}
+
+void
+PhysicsWorld::WillSimulate()
+{
+	if ( kImmediateCollisions != fCollisionDelivery || IsProperty( kIsWorldSteppingAsync ) )
+	{
+		fWorldContactListener->WillStep();
+	}
+
+	SetProperty( kIsWorldStepping, true );
+}
+
+void
+PhysicsWorld::Simulate( double elapsedMS )
+{
+	TRACE_SCOPE( simulate, "PhysicsWorld::Simulate" );
+
+	// These values may be changed on the fly. TODO: make sure this isn't occurring real overhead, or we should drop back to default values only!
+	S32 velocityIterations = GetVelocityIterations();
+	S32 positionIterations = GetPositionIterations();
 
-		b2World& world = * fWorld;
+	b2World& world = * fWorld;
 
-		float dt = GetTimeStep();
-		if ( dt > Rtt_REAL_0 )
+	float dt = GetTimeStep();
+	if ( dt > Rtt_REAL_0 )
+	{
+		// Simulation timesteps are driven by the render frame rate
+		world.Step( dt * fTimeScale, velocityIterations, positionIterations );
+	}
+	else
+	{
+		dt = fFrameInterval;
+
+		// Simulation timesteps match actual time with an error <= dt
+		// For more info: http://gafferongames.com/game-physics/fix-your-timestep/
+		// NOTE: times are in seconds, not milliseconds
+		float tCurrent = elapsedMS * 0.001f;
+		float tPrevious = ( fTimePrevious > 0.f
+			? fTimePrevious
+			: ( tCurrent - dt ) );
+		
+		 // time elapsed between current and previous frame plus the remainder from the previous step
+		float tStep = ( tCurrent - tPrevious ) + fTimeRemainder;
+
+		while ( tStep >= dt )
 		{
-			// Simulation timesteps are driven by the render frame rate
 			world.Step( dt * fTimeScale, velocityIterations, positionIterations );
+			tStep -= dt;
 		}
-		else
+
+		fTimePrevious = tCurrent;
+		fTimeRemainder = tStep;
+	}
+}
+
+void
+PhysicsWorld::DidSimulate()
+{
+	SetProperty( kIsWorldStepping, false );
+
+	b2World& world = * fWorld;
+
+	Real scale = GetPixelsPerMeter();
+
+	const void *groundBodyUserdata = LuaLibPhysics::GetGroundBodyUserdata();
+
+	// Iterate over bodies, and update sprites (display objects)
+	for ( b2Body *body = world.GetBodyList(), *nextBody = NULL;
+		  NULL != body;
+		  body = nextBody )
+	{
+		// Prefetch next body in case we delete body
+		nextBody = body->GetNext();
+
+		if ( body->GetUserData() )
 		{
-			dt = fFrameInterval;
-
-			// Simulation timesteps match actual time with an error <= dt
-			// For more info: http://gafferongames.com/game-physics/fix-your-timestep/
-			// NOTE: times are in seconds, not milliseconds
-			float tCurrent = elapsedMS * 0.001f;
-			float tPrevious = ( fTimePrevious > 0.f
-				? fTimePrevious
-				: ( tCurrent - dt ) );
-			
-			 // time elapsed between current and previous frame plus the remainder from the previous step
-			float tStep = ( tCurrent - tPrevious ) + fTimeRemainder;
-
-			while ( tStep >= dt )
+			if ( body->GetUserData() != groundBodyUserdata )
 			{
-				world.Step( dt * fTimeScale, velocityIterations, positionIterations );
-				tStep -= dt;
+				DisplayObject *o = (DisplayObject*)body->GetUserData();
+				if ( ! o->IsOrphan() )
+				{
+					b2Vec2 position = body->GetPosition(); 
+					Rtt_ASSERT(position.IsValid());
+					position *= scale;
+					
+					Real angle = Rtt_RealRadiansToDegrees( Rtt_FloatToReal( body->GetAngle() ) );
+
+					// While updating DisplayObject transform based on Box2d body,
+					// inhibit updates to corresponding Box2d body. Objects whose
+					// bodies did not move, e.g. sleeping ones, stay valid.
+					o->SetExtensionsLocked( true );
+					o->SetOriginAndRotation( position.x, position.y, angle );
+					o->SetExtensionsLocked( false );
+				}
 			}
+		}
+		else 
+		{
+			// We assume that any body with no UserData should be destroyed here, since the UserData initially stores the corresponding 
+			// Corona display object on body construction, and is then set to NULL when the corresponding display object has been deleted.
+			world.DestroyBody( body );
+		}
+	}
+	
+	void *finalizedUserdata = UserdataWrapper::GetFinalizedValue();
+	// Iterate over joints, and remove any that the user has deleted
+	for ( b2Joint *joint = world.GetJointList(), *nextJoint = NULL;
+		  NULL != joint;
+		  joint = nextJoint )
+	{
+		// Prefetch next joint in case we delete joint
+		nextJoint = joint->GetNext();
 
-			fTimePrevious = tCurrent;
-			fTimeRemainder = tStep;
+		if ( finalizedUserdata == joint->GetUserData() )
+		{
+			// We assume that any joint with no UserData should be destroyed here, since the UserData initially stores the corresponding 
+			// UserdataWrapper on joint construction, and is then set to NULL when the user calls joint:removeSelf().
+			world.DestroyJoint( joint );
 		}
+	}
+}
 
-		Real scale = GetPixelsPerMeter();
+// Lists a batch of buffered collisions as the "contacts" of one Runtime event
+class BufferedCollisionsEvent : public VirtualEvent
+{
+	public:
+		typedef VirtualEvent Super;
 
-		const void *groundBodyUserdata = LuaLibPhysics::GetGroundBodyUserdata();
+	public:
+		BufferedCollisionsEvent( const Array< PhysicsWorld::BufferedCollision >& collisions, bool isPostSolve )
+		:	fCollisions( collisions ),
+			fIsPostSolve( isPostSolve )
+		{
+		}
 
-		// Iterate over bodies, and update sprites (display objects)
-		for ( b2Body *body = world.GetBodyList(), *nextBody = NULL;
-			  NULL != body;
-			  body = nextBody )
+	public:
+		virtual const char* Name() const
 		{
-			// Prefetch next body in case we delete body
-			nextBody = body->GetNext();
+			return fIsPostSolve ? PostCollisionEvent::kName : CollisionEvent::kName;
+		}
 
-			if ( body->GetUserData() )
+		virtual int Push( lua_State *L ) const;
+
+	private:
+		const Array< PhysicsWorld::BufferedCollision >& fCollisions;
+		bool fIsPostSolve;
+};
+
+static const char*
+StringForPhase( U8 type )
+{
+	static const char kBeganString[] = "began";
+	static const char kEndedString[] = "ended";
+
+	return PhysicsWorld::BufferedCollision::kBegan == type ? kBeganString : kEndedString;
+}
+
+int
+BufferedCollisionsEvent::Push( lua_State *L ) const
+{
+	if ( Rtt_VERIFY( Super::Push( L ) ) )
+	{
+		lua_newtable( L );
+
+		for ( S32 i = 0, iMax = fCollisions.Length(), n = 0; i < iMax; i++ )
+		{
+			const PhysicsWorld::BufferedCollision& c = fCollisions[i];
+
+			if ( c.fIsHandled
+				 || fIsPostSolve != ( PhysicsWorld::BufferedCollision::kPostSolve == c.fType )
+				 || c.fObject1->IsOrphan() || c.fObject2->IsOrphan() )
 			{
-				if ( body->GetUserData() != groundBodyUserdata )
-				{
-					DisplayObject *o = (DisplayObject*)body->GetUserData();
-					if ( ! o->IsOrphan() )
-					{
-						// While updating DisplayObject transform based on Box2d body,
-						// inhibit updates to corresponding Box2d body.
-						o->SetExtensionsLocked( true );
-
-						b2Vec2 position = body->GetPosition(); 
-						Rtt_ASSERT(position.IsValid());
-						position *= scale;
-						
-						Real angle = Rtt_RealRadiansToDegrees( Rtt_FloatToReal( body->GetAngle() ) );
-						o->SetGeometricProperty( kOriginX, position.x );
-						o->SetGeometricProperty( kOriginY, position.y );
-						o->SetGeometricProperty( kRotation, angle );
-
-						o->SetExtensionsLocked( false );
-					}
-				}
+				continue;
 			}
-			else 
+
+			// Same fields as the Runtime gets for a single contact
+			if ( fIsPostSolve )
 			{
-				// We assume that any body with no UserData should be destroyed here, since the UserData initially stores the corresponding 
-				// Corona display object on body construction, and is then set to NULL when the corresponding display object has been deleted.
-				world.DestroyBody( body );
+				PostCollisionEvent( * c.fObject1, * c.fObject2, c.fX, c.fY, c.fFixtureIndex1, c.fFixtureIndex2, c.fNormalImpulse, c.fTangentImpulse ).PushUnique( L );
 			}
+			else
+			{
+				CollisionEvent( * c.fObject1, * c.fObject2, c.fX, c.fY, c.fFixtureIndex1, c.fFixtureIndex2, StringForPhase( c.fType ) ).PushUnique( L );
+			}
+
+			lua_rawseti( L, -2, ++n );
 		}
-		
-		void *finalizedUserdata = UserdataWrapper::GetFinalizedValue();
-		// Iterate over joints, and remove any that the user has deleted
-		for ( b2Joint *joint = world.GetJointList(), *nextJoint = NULL;
-			  NULL != joint;
-			  joint = nextJoint )
+
+		lua_setfield( L, -2, "contacts" );
+	}
+
+	return 1;
+}
+
+void
+PhysicsWorld::DispatchBufferedCollisions( Runtime& runtime )
+{
+	if ( 0 == fBufferedCollisions.Length() )
+	{
+		return;
+	}
+
+	lua_State *L = runtime.VMContext().L();
+
+	bool isBatched = ( kBatchedCollisions == fCollisionDelivery );
+	bool hasUnhandled[2] = { false, false };
+
+	// Listeners may stop the world, which empties the buffer, so recheck
+	// the length on each pass. Objects they remove stay orphaned, but not
+	// deleted, until the frame ends.
+	for ( S32 i = 0; i < fBufferedCollisions.Length(); i++ )
+	{
+		BufferedCollision& c = fBufferedCollisions[i];
+
+		if ( c.fObject1->IsOrphan() || c.fObject2->IsOrphan() )
+		{
+			c.fIsHandled = true;
+			continue;
+		}
+
+		bool isPostSolve = ( BufferedCollision::kPostSolve == c.fType );
+
+		if ( isPostSolve )
+		{
+			PostCollisionEvent e( * c.fObject1, * c.fObject2, c.fX, c.fY, c.fFixtureIndex1, c.fFixtureIndex2, c.fNormalImpulse, c.fTangentImpulse );
+
+			if ( isBatched )
+			{
+				c.fIsHandled = e.DispatchToObjects( L );
+			}
+			else
+			{
+				runtime.DispatchEvent( e );
+			}
+		}
+		else
 		{
-			// Prefetch next joint in case we delete joint
-			nextJoint = joint->GetNext();
+			CollisionEvent e( * c.fObject1, * c.fObject2, c.fX, c.fY, c.fFixtureIndex1, c.fFixtureIndex2, StringForPhase( c.fType ) );
+
+			if ( isBatched )
+			{
+				c.fIsHandled = e.DispatchToObjects( L );
+			}
+			else
+			{
+				runtime.DispatchEvent( e );
+			}
+		}
+
+		hasUnhandled[isPostSolve] = hasUnhandled[isPostSolve] || ! c.fIsHandled;
+	}
 
-			if ( finalizedUserdata == joint->GetUserData() )
+	if ( isBatched )
+	{
+		for ( int i = 0; i < 2; i++ )
+		{
+			if ( hasUnhandled[i] && fBufferedCollisions.Length() > 0 )
 			{
-				// We assume that any joint with no UserData should be destroyed here, since the UserData initially stores the corresponding 
-				// UserdataWrapper on joint construction, and is then set to NULL when the user calls joint:removeSelf().
-				world.DestroyJoint( joint );
+				runtime.DispatchEvent( BufferedCollisionsEvent( fBufferedCollisions, 1 == i ) );
 			}
 		}
 	}
+
+	fBufferedCollisions.Empty();
 }
 
 // ----------------------------------------------------------------------------
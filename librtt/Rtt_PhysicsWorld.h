@@ -10,6 +10,9 @@
 #ifndef _Rtt_PhysicsWorld_H__
 #define _Rtt_PhysicsWorld_H__
 
+#include "Core/Rtt_Array.h"
+#include "Core/Rtt_Real.h"
+
 // ----------------------------------------------------------------------------
 
 class b2Body;
@@ -21,7 +24,10 @@ namespace Rtt
 {
 
 class b2GLESDebugDraw;
+class Display;
+class DisplayObject;
 class PhysicsContactListener;
+class PhysicsStepThread;
 class Runtime;
 class Renderer;
 
@@ -38,10 +44,55 @@ class PhysicsWorld
 			kPreCollisionListenerExists			= 0x04,
 			kPostCollisionListenerExists		= 0x08,
 			kParticleCollisionListenerExists	= 0x10,
+			kIsWorldStepping					= 0x20,
+			kIsWorldSteppingAsync				= 0x40,
 		};
 
 		typedef U32 Properties;
 
+		// How "collision" and "postCollision" events reach Lua. By default,
+		// they are dispatched from inside b2World::Step(). Otherwise contacts
+		// whose objects, or the Runtime, listen for them are recorded during
+		// the step and dispatched once it is over, without event.contact:
+		// - kBufferedCollisions: one event per contact, as before
+		// - kBatchedCollisions: objects still get one event per contact, but
+		//   contacts no object handled reach the Runtime as a single event
+		//   per name and frame, whose "contacts" array holds one table per
+		//   contact
+		// "preCollision" is always dispatched during the step, since its
+		// listeners may disable the contact.
+		typedef enum _CollisionDelivery
+		{
+			kImmediateCollisions = 0,
+			kBufferedCollisions,
+			kBatchedCollisions,
+
+			kNumCollisionDeliveries
+		}
+		CollisionDelivery;
+
+		struct BufferedCollision
+		{
+			typedef enum _Type
+			{
+				kBegan = 0,
+				kEnded,
+				kPostSolve,
+			}
+			Type;
+
+			DisplayObject *fObject1;
+			DisplayObject *fObject2;
+			Real fX;
+			Real fY;
+			Real fNormalImpulse;
+			Real fTangentImpulse;
+			S32 fFixtureIndex1;
+			S32 fFixtureIndex2;
+			U8 fType;
+			bool fIsHandled;
+		};
+
 	public:
 		PhysicsWorld( Rtt_Allocator& allocator );
 		~PhysicsWorld();
@@ -93,12 +144,50 @@ class PhysicsWorld
 		void SetAverageCollisionPositions( bool enabled );
 		bool GetAverageCollisionPositions() const;
 
+		void SetCollisionDelivery( CollisionDelivery newValue );
+		CollisionDelivery GetCollisionDelivery() const { return fCollisionDelivery; }
+
+		// When enabled, the world steps for the next frame on its own thread
+		// while the current one renders, see BeginAsyncStep()
+		void SetAsyncStep( bool enabled ) { fIsAsyncStep = enabled; }
+		bool GetAsyncStep() const { return fIsAsyncStep; }
+
+	public:
+		// Used by PhysicsContactListener while the world steps
+		void BufferCollision( const BufferedCollision& collision ) { fBufferedCollisions.Append( collision ); }
+
 	public:
 		void DebugDraw( Renderer &renderer ) const;
 
 	public:
+		// Does nothing if an async step already advanced the world this frame
 		void StepWorld( double elapsedMS );
 
+		// Starts the next frame's step on another thread, if async steps are
+		// enabled and nothing in it needs Lua: neither "preCollision" nor
+		// particle collision listeners, nor physics debug drawing. Collisions
+		// are recorded as if buffered. Returns false if it did not start.
+		//
+		// Lua must not run until EndAsyncStep(), since it may touch the world.
+		bool BeginAsyncStep( double elapsedMS, const Display& display );
+		void EndAsyncStep();
+
+		// Lets the next StepWorld() run even after an async step, for when
+		// the frame it stood in for will not come, e.g. on suspend
+		void DiscardAsyncStep() { fHasSteppedAhead = false; }
+
+		// Dispatches the collisions recorded by StepWorld() or an async step,
+		// if any
+		void DispatchBufferedCollisions( Runtime& runtime );
+
+	protected:
+		void WillSimulate();
+		void Simulate( double elapsedMS );
+		void DidSimulate();
+
+	private:
+		friend class PhysicsStepThread;
+
 	private:
 		Rtt_Allocator& fAllocator;
 		b2GLESDebugDraw *fWorldDebugDraw;
@@ -137,6 +226,13 @@ class PhysicsWorld
 		//! false: The point of contact reported is the first one reported by Box2D. The order is arbitrary.
 		//! true: The point of contact reported is the average of all contact points.
 		bool fAverageCollisionPositions;
+
+		CollisionDelivery fCollisionDelivery;
+		Array< BufferedCollision > fBufferedCollisions;
+
+		PhysicsStepThread *fStepThread;
+		bool fIsAsyncStep;
+		bool fHasSteppedAhead;
 };
 
 // ----------------------------------------------------------------------------
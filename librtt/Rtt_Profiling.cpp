@@ -11,8 +11,11 @@
 #include "Core/Rtt_Allocator.h"
 #include "Core/Rtt_String.h"
 #include "Core/Rtt_Time.h"
+#include "Core/Rtt_TraceRecorder.h"
 #include "CoronaLua.h"
 
+#include <mutex>
+
 // ----------------------------------------------------------------------------
 
 namespace Rtt
@@ -185,6 +188,26 @@ int Profiling::VisitEntries( lua_State* L ) const
     return 1;
 }
 
+void Profiling::VisitEntries( EntryVisitor visitor, void* userData ) const
+{
+    const Entry* entries = fArray2->ReadAccess();
+    U64 previous = 0;
+
+    for ( S32 i = 0, length = fArray2->Length(); i < length; ++i )
+    {
+        if ( Entry::SublistTime() == entries[i].fTime )
+        {
+            continue;
+        }
+
+        U64 elapsed = previous ? Rtt_AbsoluteToMicroseconds( entries[i].fTime - previous ) : 0;
+
+        previous = entries[i].fTime;
+
+        visitor( entries[i].fPayload.GetString(), elapsed, userData );
+    }
+}
+
 void Profiling::ResetSums()
 {
     for ( Sum* sum = sFirstSum; sum; sum = sum->fNext )
@@ -227,12 +250,27 @@ int Profiling::VisitSums( lua_State* L)
     return 1;
 }
 
+void Profiling::VisitSums( SumVisitor visitor, void* userData )
+{
+    for ( const Sum* sum = sFirstSum; sum; sum = sum->fNext )
+    {
+        if ( sum->fTimingCount > 0 )
+        {
+            visitor( sum->fName.GetString(), Rtt_AbsoluteToMicroseconds( sum->fTotalTime ), sum->fTimingCount, userData );
+        }
+    }
+}
+
 Profiling::Sum* Profiling::sFirstSum;
 
 Profiling::Sum::Sum( const char* name )
 {
     fName.SetString( name );
 
+    // Function-local sums can first be reached from a worker thread
+    static std::mutex sLinkMutex;
+    std::lock_guard< std::mutex > lock( sLinkMutex );
+
     fNext = sFirstSum;
     sFirstSum = this;
 }
@@ -291,7 +329,7 @@ void Profiling::Sum::Reset()
     fTimingCount = 0;
 }
 			
-bool Profiling::Sum::fEnabled;
+thread_local bool Profiling::Sum::fEnabled;
 
 Profiling::SumRAII::SumRAII( Sum& sum )
 :   fSum( sum )
@@ -312,10 +350,12 @@ Profiling::SumRAII::~SumRAII()
 
 ProfilingState::ProfilingState( Rtt_Allocator* allocator )
 :   fLists( allocator ),
-    fTopList( NULL )
+    fTopList( NULL ),
+    fEventProfilesEnabled( false )
 {
 	fUpdateID = Create( "update" );
 	fRenderID = Create( "render" );
+	fGCID = Create( "gc" );
 }
 
 bool ProfilingState::Find( const Profiling* profiling )
@@ -458,6 +498,11 @@ ProfilingEntryRAII::~ProfilingEntryRAII()
 void ProfilingEntryRAII::Add( const Profiling::Payload& payload ) const
 {
     fProfiling->AddEntry( payload );
+
+    if ( payload.GetString() )
+    {
+        TraceRecorder::Mark( payload.GetString() );
+    }
 }
 
 // ----------------------------------------------------------------------------
@@ -77,9 +77,19 @@ class Profiling {
 		void AddEntry( const Payload& payload, bool isListName = false );
 		int VisitEntries( lua_State* L ) const;
 
+	public:
+		// Native counterparts of the visitors above, e.g. for benchmarks. Entry
+		// times are in microseconds since the previous entry; listener entries
+		// are reported with a NULL name.
+		typedef void (*EntryVisitor)( const char* name, U64 elapsed, void* userData );
+		typedef void (*SumVisitor)( const char* name, U64 total, U32 count, void* userData );
+
+		void VisitEntries( EntryVisitor visitor, void* userData ) const;
+
 	public:
 		static void ResetSums();
 		static int VisitSums( lua_State* L );
+		static void VisitSums( SumVisitor visitor, void* userData );
 
 	private:
 		struct Entry {
@@ -103,7 +113,7 @@ class Profiling {
 		private:
 			void Reset();
 			
-			static bool fEnabled; // make sums no-op in not-yet-profiled scopes (not ideal)
+			static thread_local bool fEnabled; // make sums no-op in not-yet-profiled scopes (not ideal), and on worker threads
 
 		private:
 			Sum* fNext;
@@ -159,12 +169,21 @@ class ProfilingState {
 	public:
 		int GetUpdateID() const { return fUpdateID; }
 		int GetRenderID() const { return fRenderID; }
+		int GetGCID() const { return fGCID; }
+
+	public:
+		// Event dispatches record per-listener timings only once something
+		// has asked for timings, since nothing else reads them
+		void EnableEventProfiles() { fEventProfilesEnabled = true; }
+		bool AreEventProfilesEnabled() const { return fEventProfilesEnabled; }
 	
 	private:
 		PtrArray<Profiling> fLists;
 		Profiling* fTopList;
 		int fUpdateID;
 		int fRenderID;
+		int fGCID;
+		bool fEventProfilesEnabled;
 };
 
 class ProfilingEntryRAII {
@@ -182,7 +201,9 @@ class ProfilingEntryRAII {
 		Profiling* fProfiling;
 };
 
-#define PROFILE_SUMS 0 // include sums in profiling?
+#ifndef PROFILE_SUMS
+	#define PROFILE_SUMS 0 // include sums in profiling?
+#endif
 
 // see https://stackoverflow.com/a/8075408 for ensuring string literals, and thus static lifetimes
 
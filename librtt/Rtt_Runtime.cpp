@@ -14,8 +14,10 @@
 
 #include "Core/Rtt_Allocator.h"
 #include "Core/Rtt_String.h"
+#include "Core/Rtt_TraceRecorder.h"
 #include "Display/Rtt_Display.h"
 #include "Display/Rtt_GroupObject.h"
+#include "Display/Rtt_Scene.h"
 #include "Display/Rtt_SpritePlayer.h"
 #include "Display/Rtt_StageObject.h"
 #include "Rtt_Archive.h"
@@ -31,6 +33,7 @@
 #include "Rtt_PhysicsWorld.h"
 #include "Rtt_PlatformExitCallback.h"
 #include "Rtt_PlatformTimer.h"
+#include "Rtt_Profiling.h"
 #include "Rtt_Scheduler.h"
 #include "Display/Rtt_TextObject.h"
 #include "Rtt_LuaFrameworks.h"
@@ -177,6 +180,8 @@ Runtime::Runtime(const MPlatform& platform, MCallback* viewCallback)
 	fProperties(0),
 	fSuspendOverrideProperties(kSuspendAll),
 	fFrame(0),
+	fTraceSpikeThreshold(0),
+	fLastTraceFrame(0),
 	fLaunchArgsRef(LUA_NOREF),
 	fSimulatorPlatformName(NULL),
 	fDownloadablePluginsRef(LUA_NOREF),
@@ -919,6 +924,62 @@ Runtime::ReadConfig( lua_State *L )
 		SetProperty( kUseExitOnErrorHandler, true );
 	}
 	lua_pop( L, 1 );
+
+	// Opt-in, see VirtualEvent::EnableTableReuse()
+	lua_getfield( L, -1, "reuseEventTables" );
+	if ( lua_toboolean( L, -1 ) )
+	{
+		VirtualEvent::EnableTableReuse( L );
+	}
+	lua_pop( L, 1 );
+
+	// Percentages, as Lua's collectgarbage( "setpause" / "setstepmul" )
+	lua_getfield( L, -1, "luaGCPause" );
+	if ( lua_type( L, -1 ) == LUA_TNUMBER )
+	{
+		fVMContext->GetGCScheduler().SetPause( L, (int) lua_tointeger( L, -1 ) );
+	}
+	lua_pop( L, 1 );
+
+	lua_getfield( L, -1, "luaGCStepMul" );
+	if ( lua_type( L, -1 ) == LUA_TNUMBER )
+	{
+		fVMContext->GetGCScheduler().SetStepMul( L, (int) lua_tointeger( L, -1 ) );
+	}
+	lua_pop( L, 1 );
+
+	// Opt-in, in milliseconds per frame, see LuaGCScheduler
+	lua_getfield( L, -1, "luaGCBudget" );
+	if ( lua_type( L, -1 ) == LUA_TNUMBER )
+	{
+		fVMContext->GetGCScheduler().SetBudget( L, lua_tonumber( L, -1 ) );
+	}
+	lua_pop( L, 1 );
+
+	// In milliseconds; samples Lua from launch, see display.writeProfile()
+	lua_getfield( L, -1, "luaProfilerInterval" );
+	if ( lua_type( L, -1 ) == LUA_TNUMBER && lua_tonumber( L, -1 ) > 0 )
+	{
+		fVMContext->GetSampler().Start( Max< U32 >( (U32)( lua_tonumber( L, -1 ) * 1000 ), 1 ) );
+	}
+	lua_pop( L, 1 );
+
+	// Opt-in, see TraceRecorder and display.writeTrace()
+	lua_getfield( L, -1, "trace" );
+	if ( lua_toboolean( L, -1 ) )
+	{
+		TraceRecorder::SetEnabled( true );
+	}
+	lua_pop( L, 1 );
+
+	// In milliseconds; frames taking longer write a trace to the documents directory
+	lua_getfield( L, -1, "traceSpikeThreshold" );
+	if ( lua_type( L, -1 ) == LUA_TNUMBER && lua_tonumber( L, -1 ) > 0 )
+	{
+		fTraceSpikeThreshold = (U32)( lua_tonumber( L, -1 ) * 1000 );
+		TraceRecorder::SetEnabled( true );
+	}
+	lua_pop( L, 1 );
 	
 #ifdef Rtt_USE_ALMIXER
 	lua_getfield( L, -1, "audioPlayFrequency" );
@@ -1505,6 +1566,9 @@ Runtime::CoronaCoreSuspend()
 		fIsSuspended = 1;
 		fSuspendTime = Rtt_GetAbsoluteTime();
 	}
+
+	// The frame an async step ran ahead for is skipped while suspended
+	fPhysicsWorld->DiscardAsyncStep();
 }
 
 void
@@ -1966,9 +2030,14 @@ Runtime::operator()()
 		return;
 	}
 
+	Rtt_AbsoluteTime frameStart = Rtt_GetAbsoluteTime();
+
+	TraceRecorder::Frame( fFrame );
+
 	const bool wasSuspended = IsSuspended();
 	fScheduler->Run();
 	const bool isSuspended = IsSuspended();
+	bool didUpdate = false;
 	if( wasSuspended != isSuspended && isSuspended )
 	{
 		// This condition is written inverse for better understanding
@@ -1985,13 +2054,75 @@ Runtime::operator()()
 		fDisplay->Update();
 
 		++fFrame;
+		didUpdate = true;
 	}
 
 	if ( ! IsProperty( kRenderAsync ) )
 	{
+		// Let physics step ahead for the next frame while this one renders.
+		// Collecting orphaned objects dispatches "finalize" events and deletes
+		// objects the step may still be reading, so the scene holds it until
+		// the step has ended and its collisions are dispatched.
+		bool isSteppingAhead = didUpdate && fPhysicsWorld->BeginAsyncStep( GetElapsedMS(), * fDisplay );
+
+		Scene& scene = fDisplay->GetScene();
+		scene.SetCollectDeferred( isSteppingAhead );
+
 		fDisplay->Render();
+
+		if ( isSteppingAhead )
+		{
+			fPhysicsWorld->EndAsyncStep();
+			fPhysicsWorld->DispatchBufferedCollisions( * this );
+
+			scene.SetCollectDeferred( false );
+			scene.Collect();
+		}
+	}
+
+	LuaGCScheduler& gcScheduler = fVMContext->GetGCScheduler();
+
+	if ( gcScheduler.IsEnabled() )
+	{
+		// Collect garbage in whatever is left of this frame
+		U64 frameTime = Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - frameStart );
+		U64 frameInterval = 1000000 / fFPS;
+
+		TRACE_SCOPE( gc, "Lua GC" );
+		PROFILING_BEGIN( * fDisplay->GetProfilingState(), gp, GC );
+
+		gp.Add( "Lua GC Begin" );
+
+		bool isFinished = gcScheduler.Step( fVMContext->L(), frameInterval > frameTime ? frameInterval - frameTime : 0 );
+
+		gp.Add( isFinished ? "Lua GC Cycle Finished" : "Lua GC Steps" );
+	}
+
+	if ( fTraceSpikeThreshold > 0 )
+	{
+		// Writing a trace makes a spike of its own, so give the rings time to
+		// fill with ordinary frames before writing another; this also skips
+		// the slow frames while the app launches
+		const U32 kTraceCooldown = 10 * fFPS;
+
+		U64 frameTime = Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - frameStart );
+
+		if ( frameTime > fTraceSpikeThreshold && fFrame - fLastTraceFrame >= kTraceCooldown )
+		{
+			char filename[32];
+			snprintf( filename, sizeof( filename ), "trace-%u.json", fFrame );
+
+			String path( & fAllocator );
+			fPlatform.PathForFile( filename, MPlatform::kDocumentsDir, MPlatform::kDefaultPathFlags, path );
+
+			if ( TraceRecorder::WriteChromeTrace( path.GetString() ) )
+			{
+				Rtt_LogException( "WARNING: Frame %u took %.1f ms; wrote %s\n", fFrame, frameTime / 1000.0, path.GetString() );
+			}
+
+			fLastTraceFrame = fFrame;
+		}
 	}
-	
 }
 void
 Runtime::Render()
@@ -2030,6 +2161,7 @@ void
 Runtime::WillDispatchFrameEvent( const Display& sender )
 {
 	fPhysicsWorld->StepWorld( GetElapsedMS() );
+	fPhysicsWorld->DispatchBufferedCollisions( * this );
 }
 
 // ----------------------------------------------------------------------------
@@ -386,6 +386,8 @@ class Runtime : public MCallback,
 		U16 fProperties;
 		U32 fSuspendOverrideProperties;
 		U32 fFrame;
+		U32 fTraceSpikeThreshold; // microseconds; 0 never writes a trace
+		U32 fLastTraceFrame;
 		int fLaunchArgsRef;
 		const char *fSimulatorPlatformName;
 		int fDownloadablePluginsRef;
@@ -13,6 +13,7 @@
 #include "Rtt_EmscriptenFont.h"
 #include "Rtt_PlatformFont.h"
 #include "Display/Rtt_Display.h"
+#include "Display/Rtt_PixelConversion.h"
 #include "Core/Rtt_Types.h"
 #include "Rtt_BitmapUtils.h"
 #include <SDL2/SDL.h>
@@ -94,23 +95,8 @@ namespace Rtt
 	{
 		int size = fHeight * fWidth * 4;
 		fData = (U8*)Rtt_MALLOC(&context, size);
-		memset(fData, 0, size);
-		
-		U8* dst = fData;
-		for (int y = 0; y < h; y++)
-		{
-			for (int x = 0; x < w; x++)
-			{
-				// premultiple alpha
-				dst[0] = (rgba[0] * rgba[3]) >> 8;
-				dst[1] = (rgba[1] * rgba[3]) >> 8;
-				dst[2] = (rgba[2] * rgba[3]) >> 8;
-				dst[3] = rgba[3];
-
-				dst += 4;
-				rgba += 4;
-			}
-		}
+		memcpy(fData, rgba, size);
+		PixelConversion::Premultiply(fData, (size_t)w * h);
 		
 		fFormat = kRGBA;
 	}
@@ -214,20 +200,7 @@ namespace Rtt
 					fData = (uint8_t*) malloc(fWidth * fHeight * 4);
 					fFormat = kRGBA;
 
-					U8* src = img;
-					U8* dst = fData;
-					for (int y = 0; y < fHeight; y++)
-					{
-						for (int x = 0; x < fWidth; x++)
-						{
-							dst[0] = src[0];
-							dst[1] = src[1];
-							dst[2] = src[2];
-							dst[3] = 255;
-							dst += 4;
-							src += 3;
-						}
-					}
+					PixelConversion::RGBToRGBA(img, fData, (size_t)fWidth * fHeight);
 					free(img);
 				}
 				fclose(f);
@@ -237,21 +210,7 @@ namespace Rtt
 
 		if (fData && fFormat == kRGBA)
 		{
-			U8* dst = fData;
-			for (int y = 0; y < fHeight; y++)
-			{
-				for (int x = 0; x < fWidth; x++)
-				{
-					// premultiple alpha
-					if (dst[3] < 255)
-					{
-						dst[0] = (dst[0] * dst[3]) >> 8;
-						dst[1] = (dst[1] * dst[3]) >> 8;
-						dst[2] = (dst[2] * dst[3]) >> 8;
-					}
-					dst += 4;
-				}
-			}
+			PixelConversion::Premultiply(fData, (size_t)fWidth * fHeight);
 		}
 
 		return fData != NULL;
@@ -358,20 +317,9 @@ namespace Rtt
 		fHeight = h;
 
 		fData = (U8*)Rtt_MALLOC(&context, fHeight * fWidth);
-		memset(fData, 0, fHeight * fWidth);
 
 		// extract alpha component
-		int pitch = w * 4;		// rgba
-		int bpp = 4;
-		for (int y = 0; y < h; y++)
-		{
-			for (int x = 0; x < w; x++)
-			{
-				// Here p is the address to the pixel we want to retrieve
-				uint8_t *p = image + y * pitch + x * bpp;
-				fData[y*w + x] = (isSafari == 1) ? p[0] : p[3];
-			}
-		}
+		PixelConversion::ExtractChannel(image, fData, (size_t)w * h, (isSafari == 1) ? 0 : 3);
 	}
 
 	EmscriptenTextBitmap::~EmscriptenTextBitmap()
@@ -15,6 +15,7 @@
 #include "Rtt_LinuxContainer.h"
 #include "Rtt_Freetype.h"
 #include "Display/Rtt_Display.h"
+#include "Display/Rtt_PixelConversion.h"
 #include "Core/Rtt_Types.h"
 #include "Rtt_BitmapUtils.h"
 
@@ -33,22 +34,10 @@ namespace Rtt
 		fData = (U8 *)Rtt_MALLOC(&context, size);
 		memset(fData, 0, size);
 
-		U8 *dst = fData;
-
 		if (rgba)
-		for (int y = 0; y < h; y++)
 		{
-			for (int x = 0; x < w; x++)
-			{
-				// premultiple alpha
-				dst[0] = (rgba[0] * rgba[3]) >> 8;
-				dst[1] = (rgba[1] * rgba[3]) >> 8;
-				dst[2] = (rgba[2] * rgba[3]) >> 8;
-				dst[3] = rgba[3];
-
-				dst += 4;
-				rgba += 4;
-			}
+			memcpy(fData, rgba, size);
+			PixelConversion::Premultiply(fData, (size_t)w * h);
 		}
 
 		fFormat = kRGBA;
@@ -159,21 +148,7 @@ namespace Rtt
 
 		if (fData && fFormat == kRGBA)
 		{
-			U8* dst = fData;
-			for (int y = 0; y < fHeight; y++)
-			{
-				for (int x = 0; x < fWidth; x++)
-				{
-					// premultiple alpha
-					if (dst[3] < 255)
-					{
-						dst[0] = (dst[0] * dst[3]) >> 8;
-						dst[1] = (dst[1] * dst[3]) >> 8;
-						dst[2] = (dst[2] * dst[3]) >> 8;
-					}
-					dst += 4;
-				}
-			}
+			PixelConversion::Premultiply(fData, (size_t)fWidth * fHeight);
 		}
 
 		return fData != NULL;
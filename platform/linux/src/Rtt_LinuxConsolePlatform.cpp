@@ -50,7 +50,9 @@ namespace Rtt
 		  fCachesDir(fAllocator),
 		  fSystemCachesDir(fAllocator),
 		  fInstallDir(fAllocator),
-		  fSkinDir(fAllocator)
+		  fSkinDir(fAllocator),
+		  fSurfaceWidth(320),
+		  fSurfaceHeight(480)
 	{
 		fResourceDir.Set(resourceDir);
 		fDocumentsDir.Set(documentsDir);
@@ -65,6 +67,39 @@ namespace Rtt
 	{
 	}
 
+	PlatformSurface* LinuxConsolePlatform::CreateScreenSurface() const
+	{
+		return Rtt_NEW(fAllocator, LinuxHeadlessSurface(fSurfaceWidth, fSurfaceHeight));
+	}
+
+	LinuxHeadlessSurface::LinuxHeadlessSurface(S32 width, S32 height)
+		: fWidth(width),
+		  fHeight(height)
+	{
+	}
+
+	LinuxHeadlessSurface::~LinuxHeadlessSurface()
+	{
+	}
+
+	void LinuxHeadlessSurface::SetCurrent() const
+	{
+	}
+
+	void LinuxHeadlessSurface::Flush() const
+	{
+	}
+
+	S32 LinuxHeadlessSurface::Width() const
+	{
+		return fWidth;
+	}
+
+	S32 LinuxHeadlessSurface::Height() const
+	{
+		return fHeight;
+	}
+
 	FontMetricsMap LinuxConsolePlatform::GetFontMetrics(const PlatformFont &font) const
 	{
 		FontMetricsMap ret;
@@ -14,11 +14,31 @@
 #include "Rtt_LinuxCrypto.h"
 #include "Core/Rtt_String.h"
 #include "Rtt_PlatformSimulator.h"
+#include "Rtt_PlatformSurface.h"
 
 #undef CreateFont
 
 namespace Rtt
 {
+	// Fixed-size surface with no window or context behind it. Used together
+	// with the "nullBackend" renderer to run scenes headless.
+	class LinuxHeadlessSurface : public PlatformSurface
+	{
+		Rtt_CLASS_NO_COPIES(LinuxHeadlessSurface)
+
+	public:
+		LinuxHeadlessSurface(S32 width, S32 height);
+		virtual ~LinuxHeadlessSurface();
+		virtual void SetCurrent() const;
+		virtual void Flush() const;
+		virtual S32 Width() const;
+		virtual S32 Height() const;
+
+	private:
+		S32 fWidth;
+		S32 fHeight;
+	};
+
 	class LinuxConsolePlatform : public MPlatform
 	{
 	Rtt_CLASS_NO_COPIES(LinuxConsolePlatform) public :
@@ -52,7 +72,7 @@ namespace Rtt
 		virtual Rtt_Allocator& GetAllocator() const;
 		virtual MPlatformDevice& GetDevice() const;
 		virtual RenderingStream* CreateRenderingStream(bool antialias) const { return NULL; };
-		virtual PlatformSurface* CreateScreenSurface() const { return NULL; };
+		virtual PlatformSurface* CreateScreenSurface() const;
 		virtual PlatformSurface* CreateOffscreenSurface(const PlatformSurface& parent) const { return NULL; };
 		virtual PlatformTimer* CreateTimerWithCallback(MCallback& callback) const { return NULL; };
 		virtual PlatformBitmap* CreateBitmap(const char* filename, bool convertToGrayscale) const { return NULL; };
@@ -139,6 +159,8 @@ namespace Rtt
 		virtual int RunSystemCommand(std::string command) const;
 		virtual const std::string GetDirectoryPath() const;
 
+		void SetHeadlessSurfaceSize(S32 width, S32 height) { fSurfaceWidth = width; fSurfaceHeight = height; }
+
 	protected:
 		void PathForFile(const char *filename, const char *baseDir, String &result) const;
 
@@ -155,5 +177,7 @@ namespace Rtt
 		String fInstallDir;
 		String fSkinDir;
 		LinuxCrypto fCrypto;
+		S32 fSurfaceWidth;
+		S32 fSurfaceHeight;
 	};
 }; // namespace Rtt
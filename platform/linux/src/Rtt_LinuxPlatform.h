@@ -63,6 +63,7 @@ namespace Rtt
 		virtual RenderingStream *CreateRenderingStream(bool antialias) const;
 		virtual PlatformTimer *CreateTimerWithCallback(MCallback &callback) const;
 		virtual PlatformBitmap *CreateBitmap(const char *filename, bool convertToGrayscale) const;
+		virtual bool CanCreateBitmapsConcurrently() const { return true; }
 		virtual void HttpPost(const char *url, const char *key, const char *value) const;
 		virtual PlatformEventSound *CreateEventSound(const ResourceHandle<lua_State> &handle, const char *filePath) const;
 		virtual void ReleaseEventSound(PlatformEventSound *soundID) const;
@@ -706,7 +706,15 @@ function json.use_lpeg ()
   return json -- so you can get the module using json = require "dkjson".use_lpeg()
 end
 
-if always_try_using_lpeg then
+-- Prefer the runtime's native encoder and decoder. They take the same
+-- arguments and options and report errors the same way as the code above.
+local hasnative, native = pcall (require, "json.native")
+if hasnative then
+  json.null = native.null
+  json.encode = native.encode
+  json.decode = native.decode
+  json.using_native = true
+elseif always_try_using_lpeg then
   pcall (json.use_lpeg)
 end
 
@@ -106,18 +106,11 @@ end
 --			"enterFrame" = { func4, func5, func6, ... },
 --		}
 --
-function EventDispatcher:addEventListener( eventName, listener )
-    -- assume 'self' if listener not specified
-    if not listener and self[eventName] then listener = self; end
-
-	-- get table for either function or table listeners
-	local listenerType = type( listener )
-	local t = self:getOrCreateTable( eventName, listenerType )
-	if t then
-		table.insert( t, listener )
-	end
-	return (t ~= nil)
-end
+-- addEventListener, removeEventListener, hasEventListener and dispatchEvent
+-- are implemented natively, see Rtt_LuaEventDispatcher.cpp. Removing a listener
+-- replaces its event's array instead of modifying it, so a dispatch in progress
+-- can keep walking the array it started with.
+EventDispatcher.addEventListener = system.__addEventListener
 
 -- luacheck: push
 -- luacheck: ignore 212 -- Unused argument.
@@ -125,59 +118,8 @@ function EventDispatcher:didRemoveListener( eventName )
 end
 -- luacheck: pop
 
-function EventDispatcher:removeEventListener( eventName, listener )
-    -- assume 'self' if listener not specified
-    if not listener and self[eventName] then listener = self; end
-
-	-- Find the given event listener in this dispatcher's collection.
-	local wasRemoved = false
-	local k = EventDispatcher._indexForType[ type(listener) ]
-	local listenerTable = self[ k ] -- table either for function or table listeners
-	if listenerTable then
-		local listenerArray = listenerTable[ eventName ]
-		if listenerArray then
-			for index = 1, #listenerArray do
-				if rawequal( listener, listenerArray[index] ) then
-					-- Remove the listener from the event's array of listeners.
-					table.remove( listenerArray, index )
-					wasRemoved = true
-
-					-- If the event's array of listeners is empty, then remove array from dispatcher's collection.
-					if #listenerArray == 0 then
-						listenerTable[ eventName ] = nil
-					end
-
-					-- Signal an EventDispatcher derived object that a listener has been removed.
-					self:didRemoveListener( eventName )
-					break
-				end
-			end
-		end
-	end
-
-	-- Returns true if the listener was found and removed.
-	return wasRemoved or nil
-end
-
-function EventDispatcher:hasEventListener( eventName, listener )
-    -- assume 'self' if listener not specified
-    if not listener and self[eventName] then listener = self; end
-
-	-- Find the given event listener in this dispatcher's collection.
-	local k = EventDispatcher._indexForType[ type(listener) ]
-	local listenerTable = self[ k ] -- table either for function or table listeners
-	if listenerTable then
-		local listenerArray = listenerTable[eventName]
-		if listenerArray then
-			for index = 1, #listenerArray do
-				if rawequal( listener, listenerArray[index] ) then
-					return true
-				end
-			end
-		end
-	end
-	return false
-end
+EventDispatcher.removeEventListener = system.__removeEventListener
+EventDispatcher.hasEventListener = system.__hasEventListener
 
 function cloneArray( array )
 	local clone = {}
@@ -189,76 +131,7 @@ end
 
 display._initProfiling()
 
-local profiles, augmentedNameStash = {}, {}
-local _type = type
-
-local function lookupProfile( name )
-	local id = profiles[name]
-
-	if not id and _type( name ) == "string" then
-		local aug = name .. " (event)"
-
-		id = display._allocateProfile( aug )
-		profiles[name] = id
-		augmentedNameStash[#augmentedNameStash + 1] = aug -- prevent collection
-	end
-
-	return display._beginProfile( id )
-end
-
-function EventDispatcher:dispatchEvent( event )
-	local result = false;
-	local eventName = event.name
-	local profile
-
-	-- array of functions is self._functionListeners[eventName]
-	local functionDict = self._functionListeners
-	local functionArray = ( functionDict and functionDict[eventName] ) or nil
-	if ( functionArray ~= nil ) and ( #functionArray > 0 ) then
-	--	local profile = display._beginProfile( functionArray._profileID )
-		profile = lookupProfile( eventName )
-
-		local functionArrayClone = cloneArray( functionArray )
-		for index = 1, #functionArrayClone do
-			local func = functionArrayClone[ index ]
-			display._addProfileEntry( profile, func )
-			if self:hasEventListener( eventName, func ) then
-				-- Dispatch event to function listener.
-				local handled = func( event )
-				result = handled or result
-			end
-		end
-	--	display._endProfile( profile )
-	end
-
-	-- array of table listeners is self._tableListeners[eventName]
-	local tableDict = self._tableListeners
-	local tableArray = ( tableDict and tableDict[eventName] ) or nil
-	if ( tableArray ~= nil ) and ( #tableArray > 0 ) then
-	--	local profile = display._beginProfile( tableArray._profileID )
-		profile = profile or lookupProfile( eventName )
-
-		local tableArrayClone = cloneArray( tableArray )
-		for index = 1, #tableArrayClone do
-			local obj = tableArrayClone[ index ]
-			display._addProfileEntry( profile, obj )
-			if self:hasEventListener( eventName, obj ) then
-				-- Fetch method stored as property of object.
-				local method = obj[eventName]
-				if ( type(method) == "function" ) then
-					-- Dispatch event to table listener.
-					local handled = method( obj, event )
-					result = handled or result
-				end
-			end
-		end
-	--	display._endProfile( profile )
-	end
-	
-	display._endProfile( profile )
-
-	return result
-end
+EventDispatcher.dispatchEvent = system.__dispatchEvent
 
 function EventDispatcher:respondsToEvent( eventName )
 	local t = self._functionListeners
@@ -10,6 +10,7 @@
 #include "Core/Rtt_Types.h"
 #include "Rtt_BitmapUtils.h"
 #include "Rtt_Math.h"
+#include "Display/Rtt_PixelConversion.h"
 #include <png.h>
 #include <jpeglib.h>
 #include <cstring>		// for memcpy
@@ -222,13 +223,7 @@ namespace bitmapUtil
 					Uint32 pixel = getSurfacePixel(img, x, y);
 					SDL_GetRGBA(pixel, img->format, dst, dst + 1, dst + 2, dst + 3);
 
-					// premultiple alpha
-					if (dst[3] < 255)
-					{
-						dst[0] = (dst[0] * dst[3]) >> 8;
-						dst[1] = (dst[1] * dst[3]) >> 8;
-						dst[2] = (dst[2] * dst[3]) >> 8;
-					}
+					// alpha is premultiplied by the caller, like PNGs
 					dst += 4;
 				}
 			}
@@ -378,17 +373,7 @@ namespace bitmapUtil
 		{
 			// BGRA ==> RGBA
 			U8* rgba = (U8*)malloc(width * height * 4);
-			U8* src = data;
-			U8* dst = rgba;
-			for (int i = 0; i < width * height; i++)
-			{
-				dst[0] = src[2];
-				dst[1] = src[1];
-				dst[2] = src[0];
-				dst[3] = src[3];
-				dst += 4;
-				src += 4;
-			}
+			Rtt::PixelConversion::SwapRedBlue(data, rgba, (size_t)width * height);
 			data = rgba;
 			free_data = true;
 		}
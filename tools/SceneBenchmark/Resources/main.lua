@@ -0,0 +1,294 @@
+------------------------------------------------------------------------------
+--
+-- This file is part of the Corona game engine.
+-- For overview and more information on licensing please refer to README.md
+-- Home page: https://github.com/coronalabs/corona
+-- Contact: support@coronalabs.com
+--
+------------------------------------------------------------------------------
+
+-- Synthetic scenes for Solar2DBenchmark. The benchmark passes the scene name
+-- and object count as launch arguments. Each scene builds its objects up front
+-- and may return an enterFrame listener that keeps the scene changing.
+-- No image files are needed: textures are canvas textures drawn at startup.
+
+local args = ... or {}
+local count = args.count or 5000
+
+local W, H = display.contentWidth, display.contentHeight
+
+-- Same sequence on every run, so results are comparable
+math.randomseed( 1234 )
+
+local function newTexture( size )
+	local texture = graphics.newTexture( { type = "canvas", width = size, height = size } )
+	local half = size / 2
+
+	for i = 0, 3 do
+		local cell = display.newRect( ( i % 2 ) * half - half / 2, math.floor( i / 2 ) * half - half / 2, half, half )
+		cell:setFillColor( ( i + 1 ) / 4, 1 - i / 4, 0.5 )
+		texture:draw( cell )
+	end
+	texture:invalidate()
+
+	return texture
+end
+
+local scenes = {}
+
+-- Lots of independent rects, all moving
+function scenes.rects()
+	local rects = {}
+
+	for i = 1, count do
+		local rect = display.newRect( math.random() * W, math.random() * H, 8, 8 )
+		rect:setFillColor( math.random(), math.random(), math.random() )
+		rects[i] = rect
+	end
+
+	return function()
+		for i = 1, #rects do
+			rects[i].rotation = rects[i].rotation + 1
+		end
+	end
+end
+
+-- Deep group nesting; only the roots change, so every child transform is dirty
+function scenes.groups()
+	local kDepth, kPerGroup = 32, 4
+	local roots = {}
+
+	for c = 1, math.max( 1, math.floor( count / ( kDepth * kPerGroup ) ) ) do
+		local root = display.newGroup()
+		root.x, root.y = math.random() * W, math.random() * H
+		roots[c] = root
+
+		local parent = root
+		for d = 1, kDepth do
+			local group = display.newGroup()
+			group.x, group.rotation = 1, 2
+			parent:insert( group )
+
+			for i = 1, kPerGroup do
+				local rect = display.newRect( group, i * 4, d, 4, 4 )
+				rect:setFillColor( d / kDepth, 0.5, 1 - d / kDepth )
+			end
+
+			parent = group
+		end
+	end
+
+	return function()
+		for i = 1, #roots do
+			roots[i].rotation = roots[i].rotation + 1
+		end
+	end
+end
+
+-- Animated sprites sharing one sheet
+function scenes.sprites()
+	local texture = newTexture( 64 )
+	local sheet = graphics.newImageSheet( texture.filename, texture.baseDir, { width = 32, height = 32, numFrames = 4 } )
+	local sequence = { name = "loop", start = 1, count = 4, time = 200 }
+
+	for i = 1, count do
+		local sprite = display.newSprite( sheet, sequence )
+		sprite.x, sprite.y = math.random() * W, math.random() * H
+		sprite:setFrame( 1 + i % 4 )
+		sprite:play()
+	end
+
+	texture:releaseSelf()
+end
+
+-- Bursting emitters; count is the total particle budget
+function scenes.emitters()
+	local texture = newTexture( 16 )
+	local kParticles = 250
+	local emitters = {}
+
+	for i = 1, math.max( 1, math.floor( count / kParticles ) ) do
+		local emitter = display.newEmitter( {
+			textureFileName = texture.filename,
+			maxParticles = kParticles,
+			duration = 0.25,
+			particleLifespan = 1,
+			particleLifespanVariance = 0.5,
+			speed = 60,
+			speedVariance = 30,
+			angleVariance = 360,
+			gravityy = 50,
+			startParticleSize = 8,
+			finishParticleSize = 2,
+			startColorRed = 1, startColorGreen = 0.5, startColorBlue = 0.2, startColorAlpha = 1,
+			finishColorAlpha = 0,
+			blendFuncSource = 770,
+			blendFuncDestination = 1,
+		}, texture.baseDir )
+		emitter.x, emitter.y = math.random() * W, math.random() * H
+		emitters[i] = emitter
+	end
+
+	local frame = 0
+
+	return function()
+		frame = frame + 1
+
+		-- Restart a few emitters each frame so bursts overlap
+		for i = 1 + frame % 15, #emitters, 15 do
+			emitters[i]:start()
+		end
+	end
+end
+
+-- Text objects whose strings change every frame, forcing re-rasterization
+function scenes.text()
+	local labels = {}
+
+	for i = 1, math.max( 1, math.floor( count / 50 ) ) do
+		labels[i] = display.newText( tostring( i ), math.random() * W, math.random() * H, native.systemFont, 12 )
+	end
+
+	local frame = 0
+
+	return function()
+		frame = frame + 1
+
+		for i = 1, #labels, 2 do
+			labels[1 + ( i + frame ) % #labels].text = tostring( frame * i )
+		end
+	end
+end
+
+-- Containers, i.e. masked groups, each with a few moving children
+function scenes.containers()
+	local kChildren = 20
+	local children = {}
+
+	for i = 1, math.max( 1, math.floor( count / kChildren ) ) do
+		local container = display.newContainer( 40, 40 )
+		container.x, container.y = math.random() * W, math.random() * H
+
+		for j = 1, kChildren do
+			local rect = display.newRect( container, math.random( -30, 30 ), math.random( -30, 30 ), 10, 10 )
+			rect:setFillColor( math.random(), math.random(), math.random() )
+			children[#children + 1] = rect
+		end
+	end
+
+	return function()
+		for i = 1, #children do
+			children[i].rotation = children[i].rotation + 2
+		end
+	end
+end
+
+-- Sprites that change frame on every frame, each with a table listener, so a
+-- "sprite" event table is pushed per sprite per frame
+function scenes.events()
+	local texture = newTexture( 64 )
+	local sheet = graphics.newImageSheet( texture.filename, texture.baseDir, { width = 32, height = 32, numFrames = 4 } )
+	local sequence = { name = "loop", start = 1, count = 4 }
+	local phases = 0
+
+	local listener = {}
+	function listener:sprite( event )
+		if event.phase == "next" then
+			phases = phases + 1
+		end
+	end
+
+	for i = 1, math.max( 1, math.floor( count / 10 ) ) do
+		local sprite = display.newSprite( sheet, sequence )
+		sprite.x, sprite.y = math.random() * W, math.random() * H
+		sprite:addEventListener( "sprite", listener )
+		sprite:play()
+	end
+
+	texture:releaseSelf()
+
+	return function( event )
+		phases = phases + event.frame % 2
+	end
+end
+
+-- Deformable grid meshes; count is the total vertex budget. Returns the
+-- meshes and the rest positions of their vertices, as x, y pairs.
+local function newGridMeshes()
+	local kSide, kSpacing = 32, 4
+	local vertices, uvs, indices = {}, {}, {}
+
+	for row = 0, kSide - 1 do
+		for column = 0, kSide - 1 do
+			vertices[#vertices + 1] = column * kSpacing
+			vertices[#vertices + 1] = row * kSpacing
+			uvs[#uvs + 1] = column / ( kSide - 1 )
+			uvs[#uvs + 1] = row / ( kSide - 1 )
+
+			if row > 0 and column > 0 then
+				local i = row * kSide + column + 1
+				local up, left, upLeft = i - kSide, i - 1, i - kSide - 1
+				indices[#indices + 1], indices[#indices + 1], indices[#indices + 1] = upLeft, up, left
+				indices[#indices + 1], indices[#indices + 1], indices[#indices + 1] = up, i, left
+			end
+		end
+	end
+
+	local meshes = {}
+	for i = 1, math.max( 1, math.floor( count / ( kSide * kSide ) ) ) do
+		local mesh = display.newMesh( { mode = "indexed", vertices = vertices, uvs = uvs, indices = indices } )
+		mesh.x, mesh.y = math.random() * W, math.random() * H
+		mesh:setFillColor( math.random(), math.random(), math.random() )
+		meshes[i] = mesh
+	end
+
+	return meshes, vertices
+end
+
+-- Moves each vertex of every mesh on its own, one path:setVertex() call apiece
+function scenes.meshes()
+	local meshes, rest = newGridMeshes()
+	local frame = 0
+
+	return function()
+		frame = frame + 1
+
+		for m = 1, #meshes do
+			local path, phase = meshes[m].path, frame * 0.1 + m
+
+			for i = 1, #rest, 2 do
+				local x, y = rest[i], rest[i + 1]
+				path:setVertex( ( i + 1 ) / 2, x + math.sin( phase + y * 0.05 ) * 3, y + math.cos( phase + x * 0.05 ) * 3 )
+			end
+		end
+	end
+end
+
+-- Same deformation as "meshes", with one path:setVertices() call per mesh
+function scenes.bulkmeshes()
+	local meshes, rest = newGridMeshes()
+	local deformed = {}
+	local frame = 0
+
+	return function()
+		frame = frame + 1
+
+		for m = 1, #meshes do
+			local phase = frame * 0.1 + m
+
+			for i = 1, #rest, 2 do
+				local x, y = rest[i], rest[i + 1]
+				deformed[i], deformed[i + 1] = x + math.sin( phase + y * 0.05 ) * 3, y + math.cos( phase + x * 0.05 ) * 3
+			end
+
+			meshes[m].path:setVertices( deformed )
+		end
+	end
+end
+
+local create = assert( scenes[args.scene or "rects"], "Unknown scene: " .. tostring( args.scene ) )
+local update = create()
+
+if update then
+	Runtime:addEventListener( "enterFrame", update )
+end
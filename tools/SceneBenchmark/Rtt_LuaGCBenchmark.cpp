@@ -0,0 +1,248 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Rtt_LuaGCBenchmark.h"
+
+#include "Core/Rtt_SizeClassAllocator.h"
+#include "Core/Rtt_Time.h"
+#include "Rtt_Lua.h"
+#include "Rtt_LuaGCScheduler.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+namespace /*anonymous*/
+{
+
+// Returns an enterFrame-style callback. A large live set keeps marking and
+// sweeping busy, while each frame builds event tables, strings and closures
+// and replaces some objects, as a game scene would.
+const char kWorkload[] =
+	"local objectCount = ...\n"
+	"local objects = {}\n"
+	"local nextId = 0\n"
+	"local function spawn()\n"
+	"	nextId = nextId + 1\n"
+	"	local object = { id = nextId, name = 'object' .. nextId, x = nextId % 320, y = nextId % 480, tags = { 'enemy', 'visible' } }\n"
+	"	object.update = function( self, event ) self.x = self.x + 1; self.label = self.name .. ':' .. event.frame end\n"
+	"	return object\n"
+	"end\n"
+	"for i = 1, objectCount do objects[i] = spawn() end\n"
+	"return function( frame )\n"
+	"	local event = { name = 'enterFrame', frame = frame, time = frame * 16 }\n"
+	"	for i = 1, 256 do\n"
+	"		objects[( frame * 256 + i ) % objectCount + 1]:update( event )\n"
+	"	end\n"
+	"	for i = 1, 32 do objects[( frame * 32 + i ) % objectCount + 1] = spawn() end\n"
+	"end\n";
+
+struct Result
+{
+	std::vector< U64 > fCallbackTimes;	// microseconds
+	U64 fGCTime;						// microseconds, scheduled only
+	int fMissedFrames;					// callback and collection overran the frame
+	int fPeakKB;
+	LuaGCScheduler::Stats fStats;
+	bool fSucceeded;
+};
+
+// Uses Lua's automatic collector if 'budget' is 0
+void
+Run( int frames, int objectCount, U64 frameInterval, double budget, Result& result )
+{
+	// Over the same heap as LuaContext, since the system allocator adds its
+	// own stalls once a sweep has freed a lot of memory
+	SizeClassAllocator heap( NULL );
+	lua_State* L = lua_newstate( &SizeClassAllocator::LuaAlloc, &heap );
+	luaL_openlibs( L );
+
+	LuaGCScheduler scheduler( heap );
+
+	result.fCallbackTimes.clear();
+	result.fGCTime = 0;
+	result.fMissedFrames = 0;
+	result.fPeakKB = 0;
+	result.fSucceeded = false;
+
+	if ( 0 == luaL_loadbuffer( L, kWorkload, sizeof( kWorkload ) - 1, "luagc" ) )
+	{
+		lua_pushinteger( L, objectCount );
+		result.fSucceeded = ( 0 == lua_pcall( L, 1, 1, 0 ) );
+	}
+
+	if ( result.fSucceeded )
+	{
+		lua_gc( L, LUA_GCCOLLECT, 0 );
+		scheduler.SetBudget( L, budget );
+
+		for ( int frame = 1; frame <= frames && result.fSucceeded; frame++ )
+		{
+			lua_pushvalue( L, -1 );
+			lua_pushinteger( L, frame );
+
+			Rtt_AbsoluteTime start = Rtt_GetAbsoluteTime();
+			result.fSucceeded = ( 0 == lua_pcall( L, 1, 0, 0 ) );
+			U64 callbackTime = Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - start );
+
+			result.fCallbackTimes.push_back( callbackTime );
+			result.fPeakKB = std::max( result.fPeakKB, lua_gc( L, LUA_GCCOUNT, 0 ) );
+
+			if ( scheduler.IsEnabled() )
+			{
+				scheduler.Step( L, frameInterval > callbackTime ? frameInterval - callbackTime : 0 );
+			}
+
+			if ( Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - start ) > frameInterval )
+			{
+				++result.fMissedFrames;
+			}
+		}
+	}
+
+	if ( ! result.fSucceeded )
+	{
+		fprintf( stderr, "ERROR: %s\n", lua_tostring( L, -1 ) );
+	}
+
+	result.fStats = scheduler.GetStats();
+	result.fGCTime = result.fStats.fMicroseconds;
+
+	lua_close( L );
+}
+
+// Callback time at 'fraction' of the way through the sorted times, in ms
+double
+Percentile( std::vector< U64 > times, double fraction )
+{
+	std::sort( times.begin(), times.end() );
+
+	size_t index = std::min( times.size() - 1, (size_t)( fraction * times.size() ) );
+
+	return times[index] / 1000.0;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+void
+LuaGCBenchmark::Usage( const char* arg0 )
+{
+	fprintf( stderr,
+		"Usage: Solar2DBenchmark %s [options]\n"
+		"    --frames <n>          Frames to run (default: 3000)\n"
+		"    --objects <n>         Objects kept live (default: 20000)\n"
+		"    --fps <n>             Frame rate the slack is measured against (default: 60)\n"
+		"    --budget <ms>         Per-frame collection budget (default: 2)\n",
+		arg0 );
+}
+
+int
+LuaGCBenchmark::Main( int argc, const char* argv[] )
+{
+	int frames = 3000;
+	int objectCount = 20000;
+	int fps = 60;
+	double budget = 2.;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char* arg = argv[i];
+		const char* value = ( i + 1 < argc ) ? argv[i + 1] : NULL;
+
+		if ( NULL == value )
+		{
+			Usage( argv[0] );
+			return -1;
+		}
+
+		if ( 0 == strcmp( arg, "--frames" ) )
+		{
+			frames = atoi( value );
+		}
+		else if ( 0 == strcmp( arg, "--objects" ) )
+		{
+			objectCount = atoi( value );
+		}
+		else if ( 0 == strcmp( arg, "--fps" ) )
+		{
+			fps = atoi( value );
+		}
+		else if ( 0 == strcmp( arg, "--budget" ) )
+		{
+			budget = atof( value );
+		}
+		else
+		{
+			Usage( argv[0] );
+			return -1;
+		}
+
+		++i;
+	}
+
+	if ( frames <= 0 || objectCount <= 0 || fps <= 0 || budget <= 0. )
+	{
+		Usage( argv[0] );
+		return -1;
+	}
+
+	U64 frameInterval = 1000000 / fps;
+
+	printf( "luagc: %d frames, %d objects, %d fps, %.2f ms budget\n", frames, objectCount, fps, budget );
+	printf( "%-10s %10s %10s %10s %10s %10s %10s\n", "collector", "p50 (ms)", "p99 (ms)", "max (ms)", "gc (ms)", "missed", "peak (KB)" );
+
+	const char* names[] = { "automatic", "scheduled" };
+
+	for ( int variant = 0; variant < 2; variant++ )
+	{
+		Result result;
+
+		Run( frames, objectCount, frameInterval, 1 == variant ? budget : 0., result );
+
+		if ( ! result.fSucceeded )
+		{
+			return -1;
+		}
+
+		printf( "%-10s %10.3f %10.3f %10.3f %10.1f %10d %10d\n",
+			names[variant],
+			Percentile( result.fCallbackTimes, 0.5 ),
+			Percentile( result.fCallbackTimes, 0.99 ),
+			Percentile( result.fCallbackTimes, 1.0 ),
+			result.fGCTime / 1000.0,
+			result.fMissedFrames,
+			result.fPeakKB );
+
+		if ( 1 == variant )
+		{
+			printf( "%u cycles, %u steps, %u overruns\n", result.fStats.fCycles, result.fStats.fSteps, result.fStats.fOverruns );
+		}
+	}
+
+	return 0;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
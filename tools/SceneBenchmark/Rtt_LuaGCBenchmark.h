@@ -0,0 +1,40 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_LuaGCBenchmark_H__
+#define _Rtt_LuaGCBenchmark_H__
+
+#include "Core/Rtt_Types.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Runs a garbage-heavy per-frame Lua callback on a bare lua_State, once with
+// Lua's automatic collector and once with LuaGCScheduler collecting in each
+// frame's slack, and compares how long the callbacks take.
+class LuaGCBenchmark
+{
+	public:
+		static void Usage( const char* arg0 );
+
+		// argv[0] is the "luagc" command
+		static int Main( int argc, const char* argv[] );
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_LuaGCBenchmark_H__
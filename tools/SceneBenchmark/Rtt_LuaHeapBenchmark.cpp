@@ -0,0 +1,306 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Rtt_LuaHeapBenchmark.h"
+
+#include "Core/Rtt_Math.h"
+#include "Core/Rtt_SizeClassAllocator.h"
+#include "Core/Rtt_Time.h"
+#include "Rtt_Lua.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+namespace /*anonymous*/
+{
+
+// Each frame dispatches touch and enterFrame events to a set of listeners,
+// which build strings and closures, while objects come and go so that the
+// live set churns like a game scene's. The objects are returned, so they
+// can be measured live and then released, as when a scene ends.
+const char kWorkload[] =
+	"local frames, objectCount = ...\n"
+	"local objects, listeners = {}, {}\n"
+	"local nextId = 0\n"
+	"local function spawn()\n"
+	"	nextId = nextId + 1\n"
+	"	local object = { id = nextId, name = 'object' .. nextId, x = nextId % 320, y = nextId % 480, tags = { 'enemy', 'visible' } }\n"
+	"	object.touch = function( self, event ) self.x = event.x; self.label = self.name .. ':' .. event.phase; return true end\n"
+	"	return object\n"
+	"end\n"
+	"for i = 1, objectCount do objects[i] = spawn() end\n"
+	"for i = 1, 16 do\n"
+	"	listeners[i] = function( event ) local key = event.name .. i; return { key = key, time = event.time } end\n"
+	"end\n"
+	"local phases = { 'began', 'moved', 'ended' }\n"
+	"for frame = 1, frames do\n"
+	"	local enterFrame = { name = 'enterFrame', time = frame * 16, frame = frame }\n"
+	"	for i = 1, #listeners do listeners[i]( enterFrame ) end\n"
+	"	for i = 1, 64 do\n"
+	"		local object = objects[( frame * 64 + i ) % objectCount + 1]\n"
+	"		local event = { name = 'touch', phase = phases[i % 3 + 1], x = i, y = frame, target = object, id = tostring( object ) }\n"
+	"		object:touch( event )\n"
+	"	end\n"
+	"	for i = 1, 8 do objects[( frame * 8 + i ) % objectCount + 1] = spawn() end\n"
+	"end\n"
+	"return objects, listeners\n";
+
+// Resident set size in bytes, or 0 if unknown
+size_t
+ResidentBytes()
+{
+	size_t result = 0;
+	FILE* f = fopen( "/proc/self/statm", "r" );
+
+	if ( f )
+	{
+		unsigned long size = 0, resident = 0;
+
+		if ( 2 == fscanf( f, "%lu %lu", &size, &resident ) )
+		{
+			result = resident * (size_t)sysconf( _SC_PAGESIZE );
+		}
+
+		fclose( f );
+	}
+
+	return result;
+}
+
+void*
+SystemAlloc( void*, void* ptr, size_t, size_t nsize )
+{
+	if ( 0 == nsize )
+	{
+		free( ptr );
+		return NULL;
+	}
+
+	return realloc( ptr, nsize );
+}
+
+struct Result
+{
+	U64 fTime;				// microseconds
+	size_t fLiveRSS;		// bytes added, after a full collection with the objects live
+	size_t fReleasedRSS;	// bytes added, after a full collection once they are released
+	size_t fLiveBytes;		// requested by Lua, with the objects live
+	size_t fPooledBytes;	// pool pages, with the objects live
+	bool fSucceeded;
+};
+
+// Runs over malloc if 'usePool' is false
+Result
+Run( bool usePool, int frames, int objectCount )
+{
+	Result result = { 0, 0, 0, 0, 0, false };
+	size_t rssBefore = ResidentBytes();
+
+	SizeClassAllocator heap( NULL );
+	lua_State* L = usePool ? lua_newstate( &SizeClassAllocator::LuaAlloc, &heap ) : lua_newstate( &SystemAlloc, NULL );
+	luaL_openlibs( L );
+
+	if ( 0 == luaL_loadbuffer( L, kWorkload, sizeof( kWorkload ) - 1, "luaheap" ) )
+	{
+		lua_pushinteger( L, frames );
+		lua_pushinteger( L, objectCount );
+
+		Rtt_AbsoluteTime start = Rtt_GetAbsoluteTime();
+		result.fSucceeded = ( 0 == lua_pcall( L, 2, 2, 0 ) );
+		result.fTime = Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - start );
+	}
+
+	if ( ! result.fSucceeded )
+	{
+		fprintf( stderr, "ERROR: %s\n", lua_tostring( L, -1 ) );
+	}
+
+	lua_gc( L, LUA_GCCOLLECT, 0 );
+	result.fLiveRSS = ResidentBytes() - rssBefore;
+	result.fLiveBytes = (size_t)lua_gc( L, LUA_GCCOUNT, 0 ) * 1024 + lua_gc( L, LUA_GCCOUNTB, 0 );
+	result.fPooledBytes = heap.GetStats().fPooledBytes;
+
+	lua_settop( L, 0 );
+	lua_gc( L, LUA_GCCOLLECT, 0 );
+	result.fReleasedRSS = ResidentBytes() - rssBefore;
+
+	lua_close( L );
+
+	return result;
+}
+
+// Each run gets a fresh process, so neither allocator inherits the other's
+// heap
+bool
+RunInChild( bool usePool, int frames, int objectCount, Result& result )
+{
+	int fds[2];
+
+	if ( 0 != pipe( fds ) )
+	{
+		return false;
+	}
+
+	pid_t pid = fork();
+
+	if ( 0 == pid )
+	{
+		close( fds[0] );
+
+		Result childResult = Run( usePool, frames, objectCount );
+		ssize_t written = write( fds[1], &childResult, sizeof( childResult ) );
+
+		close( fds[1] );
+		_exit( sizeof( childResult ) == written ? 0 : 1 );
+	}
+
+	close( fds[1] );
+
+	bool succeeded = ( pid > 0 && sizeof( result ) == read( fds[0], &result, sizeof( result ) ) );
+
+	close( fds[0] );
+
+	if ( pid > 0 )
+	{
+		waitpid( pid, NULL, 0 );
+	}
+
+	return succeeded && result.fSucceeded;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+void
+LuaHeapBenchmark::Usage( const char* arg0 )
+{
+	fprintf( stderr,
+		"Usage: Solar2DBenchmark %s [options]\n"
+		"    --frames <n>          Frames of events to dispatch (default: 2000)\n"
+		"    --objects <n>         Objects kept live (default: 5000)\n"
+		"    --iterations <n>      Runs per allocator; the best is reported (default: 5)\n",
+		arg0 );
+}
+
+int
+LuaHeapBenchmark::Main( int argc, const char* argv[] )
+{
+	int frames = 2000;
+	int objectCount = 5000;
+	int iterations = 5;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char* arg = argv[i];
+		const char* value = ( i + 1 < argc ) ? argv[i + 1] : NULL;
+
+		if ( NULL == value )
+		{
+			Usage( argv[0] );
+			return -1;
+		}
+
+		if ( 0 == strcmp( arg, "--frames" ) )
+		{
+			frames = atoi( value );
+		}
+		else if ( 0 == strcmp( arg, "--objects" ) )
+		{
+			objectCount = atoi( value );
+		}
+		else if ( 0 == strcmp( arg, "--iterations" ) )
+		{
+			iterations = atoi( value );
+		}
+		else
+		{
+			Usage( argv[0] );
+			return -1;
+		}
+
+		++i;
+	}
+
+	if ( frames <= 0 || objectCount <= 0 || iterations <= 0 )
+	{
+		Usage( argv[0] );
+		return -1;
+	}
+
+	printf( "luaheap: %d frames, %d objects, best of %d\n", frames, objectCount, iterations );
+	printf( "%-10s %12s %14s %14s %12s %12s\n", "allocator", "time (ms)", "live RSS (KB)", "released (KB)", "lua (KB)", "pool (KB)" );
+
+	Result best[2];
+	const char* names[] = { "malloc", "pool" };
+
+	for ( int variant = 0; variant < 2; variant++ )
+	{
+		best[variant].fTime = (U64)-1;
+		best[variant].fLiveRSS = (size_t)-1;
+		best[variant].fReleasedRSS = (size_t)-1;
+
+		for ( int i = 0; i < iterations; i++ )
+		{
+			Result result;
+
+			if ( ! RunInChild( 1 == variant, frames, objectCount, result ) )
+			{
+				return -1;
+			}
+
+			best[variant].fTime = Min( best[variant].fTime, result.fTime );
+			best[variant].fLiveRSS = Min( best[variant].fLiveRSS, result.fLiveRSS );
+			best[variant].fReleasedRSS = Min( best[variant].fReleasedRSS, result.fReleasedRSS );
+			best[variant].fLiveBytes = result.fLiveBytes;
+			best[variant].fPooledBytes = result.fPooledBytes;
+		}
+
+		char pool[32] = "-";
+
+		if ( 1 == variant )
+		{
+			snprintf( pool, sizeof( pool ), "%.1f", best[variant].fPooledBytes / 1024.0 );
+		}
+
+		printf( "%-10s %12.3f %14.1f %14.1f %12.1f %12s\n",
+			names[variant],
+			best[variant].fTime / 1000.0,
+			best[variant].fLiveRSS / 1024.0,
+			best[variant].fReleasedRSS / 1024.0,
+			best[variant].fLiveBytes / 1024.0,
+			pool );
+	}
+
+	printf( "speedup %.2fx, live RSS %.1f%% of malloc, released RSS %.1f%% of malloc\n",
+		best[1].fTime > 0 ? best[0].fTime / (double)best[1].fTime : 0.0,
+		best[0].fLiveRSS > 0 ? 100.0 * best[1].fLiveRSS / best[0].fLiveRSS : 0.0,
+		best[0].fReleasedRSS > 0 ? 100.0 * best[1].fReleasedRSS / best[0].fReleasedRSS : 0.0 );
+
+	return 0;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
@@ -0,0 +1,39 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_LuaHeapBenchmark_H__
+#define _Rtt_LuaHeapBenchmark_H__
+
+#include "Core/Rtt_Types.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Runs an event-heavy Lua workload on a bare lua_State, once over malloc and
+// once over SizeClassAllocator, and compares time and heap footprint.
+class LuaHeapBenchmark
+{
+	public:
+		static void Usage( const char* arg0 );
+
+		// argv[0] is the "luaheap" command
+		static int Main( int argc, const char* argv[] );
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_LuaHeapBenchmark_H__
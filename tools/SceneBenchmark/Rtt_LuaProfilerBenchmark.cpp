@@ -0,0 +1,229 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Rtt_LuaProfilerBenchmark.h"
+
+#include "Core/Rtt_Time.h"
+#include "Rtt_Lua.h"
+#include "Rtt_LuaSampler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+namespace /*anonymous*/
+{
+
+// Returns an enterFrame-style callback whose time splits unevenly between a
+// few functions, some of them nested and some calling into C, so the folded
+// output has a recognizable shape.
+const char kWorkload[] =
+	"local objects = {}\n"
+	"for i = 1, 2000 do objects[i] = { x = i, y = -i, vx = i % 7, vy = i % 5 } end\n"
+	"local function integrate( object, dt )\n"
+	"	object.x = object.x + object.vx * dt\n"
+	"	object.y = object.y + object.vy * dt\n"
+	"end\n"
+	"local function collide( object )\n"
+	"	local d = math.sqrt( object.x * object.x + object.y * object.y )\n"
+	"	if d > 1000 then object.vx, object.vy = -object.vx, -object.vy end\n"
+	"end\n"
+	"local function physics( dt )\n"
+	"	for i = 1, #objects do integrate( objects[i], dt ); collide( objects[i] ) end\n"
+	"end\n"
+	"local function label( frame )\n"
+	"	local parts = {}\n"
+	"	for i = 1, 200 do parts[i] = string.format( '%d:%d', frame, i ) end\n"
+	"	return table.concat( parts, ',' )\n"
+	"end\n"
+	"return function( frame )\n"
+	"	physics( 1 / 60 )\n"
+	"	label( frame )\n"
+	"end\n";
+
+// Seconds to run 'frames' callbacks; negative on error
+double
+Run( lua_State* L, int frames )
+{
+	Rtt_AbsoluteTime start = Rtt_GetAbsoluteTime();
+
+	for ( int frame = 1; frame <= frames; frame++ )
+	{
+		lua_pushvalue( L, -1 );
+		lua_pushinteger( L, frame );
+
+		if ( 0 != lua_pcall( L, 1, 0, 0 ) )
+		{
+			fprintf( stderr, "ERROR: %s\n", lua_tostring( L, -1 ) );
+			return -1.;
+		}
+	}
+
+	return Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - start ) / 1000000.0;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+void
+LuaProfilerBenchmark::Usage( const char* arg0 )
+{
+	fprintf( stderr,
+		"Usage: Solar2DBenchmark %s [options]\n"
+		"    --frames <n>          Callbacks per run (default: 600)\n"
+		"    --interval <ms>       Sampling interval (default: 1)\n"
+		"    --iterations <n>      Runs of each variant; best is reported (default: 5)\n"
+		"    --output <path>       Write the folded stacks of the last sampled run\n",
+		arg0 );
+}
+
+int
+LuaProfilerBenchmark::Main( int argc, const char* argv[] )
+{
+	int frames = 600;
+	double interval = 1.;
+	int iterations = 5;
+	const char* output = NULL;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char* arg = argv[i];
+		const char* value = ( i + 1 < argc ) ? argv[i + 1] : NULL;
+
+		if ( NULL == value )
+		{
+			Usage( argv[0] );
+			return -1;
+		}
+
+		if ( 0 == strcmp( arg, "--frames" ) )
+		{
+			frames = atoi( value );
+		}
+		else if ( 0 == strcmp( arg, "--interval" ) )
+		{
+			interval = atof( value );
+		}
+		else if ( 0 == strcmp( arg, "--iterations" ) )
+		{
+			iterations = atoi( value );
+		}
+		else if ( 0 == strcmp( arg, "--output" ) )
+		{
+			output = value;
+		}
+		else
+		{
+			Usage( argv[0] );
+			return -1;
+		}
+
+		++i;
+	}
+
+	U32 microseconds = (U32)( interval * 1000 );
+
+	if ( frames <= 0 || 0 == microseconds || iterations <= 0 )
+	{
+		Usage( argv[0] );
+		return -1;
+	}
+
+	lua_State* L = luaL_newstate();
+	luaL_openlibs( L );
+
+	if ( 0 != luaL_loadbuffer( L, kWorkload, sizeof( kWorkload ) - 1, "luaprofile" ) || 0 != lua_pcall( L, 0, 1, 0 ) )
+	{
+		fprintf( stderr, "ERROR: %s\n", lua_tostring( L, -1 ) );
+		lua_close( L );
+		return -1;
+	}
+
+	LuaSampler sampler( L );
+	double best[2] = { 0., 0. };
+	double lastSampled = 0.;
+	int result = 0;
+
+	// Alternate the variants, so drift in clock speed affects both alike
+	for ( int i = 0; i < iterations * 2 && 0 == result; i++ )
+	{
+		int variant = i % 2;
+
+		if ( 1 == variant && ! sampler.Start( microseconds ) )
+		{
+			fprintf( stderr, "ERROR: Could not start sampling\n" );
+			result = -1;
+			break;
+		}
+
+		double seconds = Run( L, frames );
+
+		sampler.Stop();
+
+		if ( seconds < 0. )
+		{
+			result = -1;
+		}
+		else
+		{
+			if ( i < 2 || seconds < best[variant] )
+			{
+				best[variant] = seconds;
+			}
+
+			if ( 1 == variant )
+			{
+				lastSampled = seconds;
+			}
+		}
+	}
+
+	if ( 0 == result )
+	{
+		const LuaSampler::Stats& stats = sampler.GetStats();
+
+		printf( "luaprofile: %d frames, %.2f ms interval, best of %d\n", frames, interval, iterations );
+		printf( "%-10s %10s %10s\n", "variant", "time (ms)", "overhead" );
+		printf( "%-10s %10.1f\n", "unsampled", best[0] * 1000. );
+		printf( "%-10s %10.1f %9.2f%%\n", "sampled", best[1] * 1000., ( best[1] / best[0] - 1. ) * 100. );
+
+		// The hook's own time is steadier than the difference of two runs
+		U32 count = stats.fSamples + stats.fIdle;
+		printf( "last run: %u samples, %u idle, %u dropped, %u functions\n", stats.fSamples, stats.fIdle, stats.fDropped, stats.fFrames );
+		printf( "in hook: %.2f us per sample, %.3f%% of the run\n",
+			count > 0 ? (double)stats.fMicroseconds / count : 0.,
+			stats.fMicroseconds / ( lastSampled * 10000. ) );
+
+		if ( output && ! sampler.Write( output ) )
+		{
+			fprintf( stderr, "ERROR: Could not write %s\n", output );
+			result = -1;
+		}
+	}
+
+	lua_close( L );
+
+	return result;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
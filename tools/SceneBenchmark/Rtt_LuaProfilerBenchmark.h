@@ -0,0 +1,40 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_LuaProfilerBenchmark_H__
+#define _Rtt_LuaProfilerBenchmark_H__
+
+#include "Core/Rtt_Types.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Runs a per-frame Lua callback on a bare lua_State with and without
+// LuaSampler sampling it, to measure what sampling costs, and optionally
+// writes the folded stacks.
+class LuaProfilerBenchmark
+{
+	public:
+		static void Usage( const char* arg0 );
+
+		// argv[0] is the "luaprofile" command
+		static int Main( int argc, const char* argv[] );
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_LuaProfilerBenchmark_H__
@@ -0,0 +1,531 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Rtt_MeshBenchmark.h"
+
+#include "Core/Rtt_Math.h"
+#include "Core/Rtt_Time.h"
+#include "Display/Rtt_MeshStream.h"
+#include "Rtt_Lua.h"
+#include "Rtt_LuaAux.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+namespace /*anonymous*/
+{
+
+// Per-vertex loops, as setVertex() and setFillVertexColor() do the work
+
+void
+ReferenceSubtractOffset( Vertex2* vertices, U32 count, const Vertex2& offset )
+{
+	for ( U32 i = 0; i < count; i++ )
+	{
+		vertices[i].x -= offset.x;
+		vertices[i].y -= offset.y;
+	}
+}
+
+void
+ReferencePackColors( U32* to, const float* from, U32 count, float scale )
+{
+	for ( U32 i = 0; i < count; i++, from += 4 )
+	{
+		U8* bytes = (U8*)( to + i );
+
+		for ( int j = 0; j < 4; j++ )
+		{
+			bytes[j] = U8( Clamp( from[j] * scale, 0.f, 255.f ) );
+		}
+	}
+}
+
+// Best time of 'iterations' runs of 'kernel', in microseconds. 'Setup' puts
+// the inputs back in place beforehand.
+template < typename Setup, typename Kernel >
+U64
+Time( Setup setup, Kernel kernel, int iterations )
+{
+	U64 best = (U64)-1;
+
+	for ( int i = 0; i < iterations; i++ )
+	{
+		setup();
+
+		Rtt_AbsoluteTime start = Rtt_GetAbsoluteTime();
+		kernel();
+		U64 elapsed = Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - start );
+
+		best = Min( best, elapsed );
+	}
+
+	return best;
+}
+
+void
+PrintKernel( const char* name, U64 loopTime, U64 kernelTime, bool isMatch )
+{
+	printf( "%-16s %12.3f %12.3f %7.2fx%s\n",
+		name,
+		loopTime / 1000.0,
+		kernelTime / 1000.0,
+		kernelTime > 0 ? loopTime / (double)kernelTime : 0.0,
+		isMatch ? "" : "  MISMATCH" );
+}
+
+// Returns false on a mismatch
+bool
+RunKernels( U32 numVertices, int iterations )
+{
+	// Colors stray out of range, to exercise the clamping
+	std::vector< Vertex2 > vertices( numVertices );
+	std::vector< float > channels( numVertices * 4 );
+	U32 seed = 12345;
+
+	for ( U32 i = 0; i < numVertices; i++ )
+	{
+		seed = seed * 1664525 + 1013904223;
+		vertices[i].x = (float)( seed >> 8 ) / ( 1 << 16 ) - 128.f;
+		vertices[i].y = (float)( seed & 0xFFFF ) / 64.f - 512.f;
+
+		for ( int j = 0; j < 4; j++ )
+		{
+			seed = seed * 1664525 + 1013904223;
+			channels[i * 4 + j] = (float)( seed >> 8 ) / ( 1 << 23 ) - 0.5f;
+		}
+	}
+
+	const Vertex2 offset = { 12.25f, -3.5f };
+	std::vector< Vertex2 > expectedVertices( numVertices ), actualVertices( numVertices );
+	std::vector< U32 > expectedColors( numVertices ), actualColors( numVertices );
+	Vertex2* expectedV = &expectedVertices[0];
+	Vertex2* actualV = &actualVertices[0];
+	const Vertex2* sourceV = &vertices[0];
+	size_t vertexBytes = numVertices * sizeof( Vertex2 );
+
+	U64 loopTime = Time(
+		[=]{ memcpy( expectedV, sourceV, vertexBytes ); },
+		[=]{ ReferenceSubtractOffset( expectedV, numVertices, offset ); },
+		iterations );
+	U64 kernelTime = Time(
+		[=]{ memcpy( actualV, sourceV, vertexBytes ); },
+		[=]{ MeshStream::SubtractOffset( actualV, numVertices, offset ); },
+		iterations );
+	bool vertexMatch = ( 0 == memcmp( expectedV, actualV, vertexBytes ) );
+
+	PrintKernel( "subtractOffset", loopTime, kernelTime, vertexMatch );
+
+	U32* expectedC = &expectedColors[0];
+	U32* actualC = &actualColors[0];
+	const float* sourceC = &channels[0];
+
+	loopTime = Time( []{}, [=]{ ReferencePackColors( expectedC, sourceC, numVertices, 255.f ); }, iterations );
+	kernelTime = Time( []{}, [=]{ MeshStream::PackColors( actualC, sourceC, numVertices, 255.f ); }, iterations );
+	bool colorMatch = ( expectedColors == actualColors );
+
+	PrintKernel( "packColors", loopTime, kernelTime, colorMatch );
+
+	return vertexMatch && colorMatch;
+}
+
+// Reads vertices from a Lua string, which serves as a raw buffer, and from a
+// table describing it. Returns false on a mismatch.
+bool
+CheckBuffers( U32 numVertices )
+{
+	std::vector< Vertex2 > source( numVertices ), output( numVertices );
+
+	for ( U32 i = 0; i < numVertices; i++ )
+	{
+		source[i].x = (float)i;
+		source[i].y = -(float)i;
+	}
+
+	lua_State* L = luaL_newstate();
+
+	lua_pushlstring( L, (const char*)&source[0], numVertices * sizeof( Vertex2 ) );
+
+	const unsigned char* bytes = (const unsigned char*)lua_tostring( L, -1 );
+	U32 n = 0;
+	size_t stride = 0;
+
+	// Raw: every value, one after another
+	bool isMatch = ( bytes == MeshStream::GetBuffer( L, sizeof( Vertex2 ), 0, n, stride, &numVertices )
+		&& numVertices == n && sizeof( Vertex2 ) == stride );
+
+	// Described: the same, less the skipped value
+	lua_createtable( L, 0, 2 );
+	lua_pushvalue( L, -2 );
+	lua_setfield( L, -2, "buffer" );
+	lua_pushinteger( L, sizeof( Vertex2 ) );
+	lua_setfield( L, -2, "offset" );
+
+	isMatch = isMatch && ( bytes + sizeof( Vertex2 ) == MeshStream::GetBuffer( L, sizeof( Vertex2 ), 0, n, stride, &numVertices )
+		&& numVertices - 1 == n && sizeof( Vertex2 ) == stride );
+
+	lua_pop( L, 1 );
+
+	// Raw, through the setVertices() reader
+	U32 first = 0;
+
+	isMatch = isMatch && ( numVertices == MeshStream::ReadPairs( L, 1, &output[0], numVertices, first )
+		&& 0 == first
+		&& 0 == memcmp( &source[0], &output[0], numVertices * sizeof( Vertex2 ) ) );
+
+	lua_close( L );
+
+	printf( "%-16s %s\n", "buffers", isMatch ? "ok" : "MISMATCH" );
+
+	return isMatch;
+}
+
+// ----------------------------------------------------------------------------
+
+// Stands in for a mesh path; the functions below take it as an upvalue
+struct Mesh
+{
+	std::vector< Vertex2 > fVertices;
+	std::vector< U32 > fColors;
+	Vertex2 fOffset;
+	U32 fNumInvalidations;
+};
+
+Mesh&
+ToMesh( lua_State* L )
+{
+	return * static_cast< Mesh* >( lua_touserdata( L, lua_upvalueindex( 1 ) ) );
+}
+
+// setVertex( index, x, y ), as ShapeAdapterMesh::setVertex()
+int
+SetVertex( lua_State* L )
+{
+	Mesh& mesh = ToMesh( L );
+
+	int vertIndex = luaL_checkint( L, 1 ) - 1;
+	Real x = luaL_checkreal( L, 2 );
+	Real y = luaL_checkreal( L, 3 );
+
+	if ( vertIndex >= (int)mesh.fVertices.size() || vertIndex < 0 )
+	{
+		luaL_argerror( L, 1, "index is out of bounds" );
+	}
+
+	x -= mesh.fOffset.x;
+	y -= mesh.fOffset.y;
+
+	Vertex2& orig = mesh.fVertices[vertIndex];
+
+	if ( ! Rtt_RealEqual( x, orig.x ) || ! Rtt_RealEqual( y, orig.y ) )
+	{
+		orig.x = x;
+		orig.y = y;
+
+		++mesh.fNumInvalidations;
+	}
+
+	return 0;
+}
+
+// setVertices( vertices [, first] ), as ShapeAdapterMesh::setVertices()
+int
+SetVertices( lua_State* L )
+{
+	Mesh& mesh = ToMesh( L );
+	U32 first;
+	U32 n = MeshStream::ReadPairs( L, 1, &mesh.fVertices[0], (U32)mesh.fVertices.size(), first );
+
+	if ( n > 0 )
+	{
+		MeshStream::SubtractOffset( &mesh.fVertices[0] + first, n, mesh.fOffset );
+
+		++mesh.fNumInvalidations;
+	}
+
+	return 0;
+}
+
+// setFillVertexColor( index, r, g, b, a ), as the ShapeObject method, with
+// colors in the 0-1 range
+int
+SetFillVertexColor( lua_State* L )
+{
+	Mesh& mesh = ToMesh( L );
+
+	U32 index = (U32)lua_tointeger( L, 1 ) - 1U;
+	float channels[4];
+
+	for ( int j = 0; j < 4; j++ )
+	{
+		channels[j] = (float)luaL_checknumber( L, j + 2 );
+	}
+
+	if ( index < mesh.fColors.size() )
+	{
+		U32 color;
+		ReferencePackColors( &color, channels, 1, 255.f );
+
+		if ( color != mesh.fColors[index] )
+		{
+			mesh.fColors[index] = color;
+
+			++mesh.fNumInvalidations;
+		}
+	}
+
+	return 0;
+}
+
+// setColors( colors [, first] ), as ShapeAdapterMesh::setColors()
+int
+SetColors( lua_State* L )
+{
+	Mesh& mesh = ToMesh( L );
+	U32 first;
+	U32 n = MeshStream::ReadColors( L, 1, &mesh.fColors[0], (U32)mesh.fColors.size(), first, 255.f );
+
+	if ( n > 0 )
+	{
+		++mesh.fNumInvalidations;
+	}
+
+	return 0;
+}
+
+// Moves every vertex and recolors it each frame, through the setter named
+// by 'mode'. The bulk setters are fed from one table, refilled per frame.
+// If 'fixed' is set, the table is filled once and the per-vertex setters
+// read from it too, so mostly the setters themselves are timed.
+const char kWorkload[] =
+	"local frames, count, mode, fixed = ...\n"
+	"local sin, cos = math.sin, math.cos\n"
+	"local setVertex, setVertices, setFillVertexColor, setColors = setVertex, setVertices, setFillVertexColor, setColors\n"
+	"local isVertices = ( 'setVertex' == mode or 'setVertices' == mode )\n"
+	"local values = {}\n"
+	"local function fill( phase )\n"
+	"	if isVertices then\n"
+	"		for i = 1, count do values[2 * i - 1] = i + sin( phase + i ); values[2 * i] = i + cos( phase + i ) end\n"
+	"	else\n"
+	"		for i = 1, count do\n"
+	"			local c, j = 0.5 + 0.5 * sin( phase + i ), 4 * i\n"
+	"			values[j - 3] = c; values[j - 2] = 1 - c; values[j - 1] = 0.5; values[j] = 1\n"
+	"		end\n"
+	"	end\n"
+	"end\n"
+	"if fixed then fill( 0 ) end\n"
+	"for frame = 1, frames do\n"
+	"	local phase = frame * 0.01\n"
+	"	if 'setVertex' == mode then\n"
+	"		if fixed then\n"
+	"			for i = 1, count do setVertex( i, values[2 * i - 1], values[2 * i] ) end\n"
+	"		else\n"
+	"			for i = 1, count do setVertex( i, i + sin( phase + i ), i + cos( phase + i ) ) end\n"
+	"		end\n"
+	"	elseif 'setFillVertexColor' == mode then\n"
+	"		if fixed then\n"
+	"			for i = 1, count do local j = 4 * i; setFillVertexColor( i, values[j - 3], values[j - 2], values[j - 1], values[j] ) end\n"
+	"		else\n"
+	"			for i = 1, count do local c = 0.5 + 0.5 * sin( phase + i ); setFillVertexColor( i, c, 1 - c, 0.5, 1 ) end\n"
+	"		end\n"
+	"	else\n"
+	"		if not fixed then fill( phase ) end\n"
+	"		if isVertices then setVertices( values ) else setColors( values ) end\n"
+	"	end\n"
+	"end\n";
+
+// Best time of 'iterations' runs, in microseconds, or 0 on error. 'mesh' is
+// left as the last run leaves it.
+U64
+RunLua( const char* mode, bool fixed, int frames, U32 numVertices, int iterations, Mesh& mesh )
+{
+	U64 best = (U64)-1;
+
+	for ( int i = 0; i < iterations; i++ )
+	{
+		mesh.fVertices.assign( numVertices, Vertex2() );
+		mesh.fColors.assign( numVertices, 0 );
+		mesh.fOffset.x = 0.5f * numVertices;
+		mesh.fOffset.y = 0.25f * numVertices;
+		mesh.fNumInvalidations = 0;
+
+		lua_State* L = luaL_newstate();
+		luaL_openlibs( L );
+
+		const lua_CFunction functions[] = { SetVertex, SetVertices, SetFillVertexColor, SetColors };
+		const char* names[] = { "setVertex", "setVertices", "setFillVertexColor", "setColors" };
+
+		for ( int f = 0; f < 4; f++ )
+		{
+			lua_pushlightuserdata( L, & mesh );
+			lua_pushcclosure( L, functions[f], 1 );
+			lua_setglobal( L, names[f] );
+		}
+
+		bool succeeded = false;
+
+		if ( 0 == luaL_loadbuffer( L, kWorkload, sizeof( kWorkload ) - 1, "meshes" ) )
+		{
+			lua_pushinteger( L, frames );
+			lua_pushinteger( L, numVertices );
+			lua_pushstring( L, mode );
+			lua_pushboolean( L, fixed );
+
+			Rtt_AbsoluteTime start = Rtt_GetAbsoluteTime();
+			succeeded = ( 0 == lua_pcall( L, 4, 0, 0 ) );
+			best = Min( best, Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - start ) );
+		}
+
+		if ( ! succeeded )
+		{
+			fprintf( stderr, "ERROR: %s\n", lua_tostring( L, -1 ) );
+		}
+
+		lua_close( L );
+
+		if ( ! succeeded )
+		{
+			return 0;
+		}
+	}
+
+	return best;
+}
+
+void
+PrintLua( const char* name, U64 perVertexTime, U64 bulkTime, bool isMatch )
+{
+	printf( "%-16s %12.3f %12.3f %7.2fx%s\n",
+		name,
+		perVertexTime / 1000.0,
+		bulkTime / 1000.0,
+		bulkTime > 0 ? perVertexTime / (double)bulkTime : 0.0,
+		isMatch ? "" : "  MISMATCH" );
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+void
+MeshBenchmark::Usage( const char* arg0 )
+{
+	fprintf( stderr,
+		"Usage: Solar2DBenchmark %s [options]\n"
+		"    --vertices <n>        Vertices per mesh (default: 4096)\n"
+		"    --frames <n>          Frames of updates from Lua (default: 100)\n"
+		"    --iterations <n>      Runs per path; the best is reported (default: 5)\n",
+		arg0 );
+}
+
+int
+MeshBenchmark::Main( int argc, const char* argv[] )
+{
+	int numVertices = 4096;
+	int frames = 100;
+	int iterations = 5;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char* arg = argv[i];
+		const char* value = ( i + 1 < argc ) ? argv[i + 1] : NULL;
+
+		if ( NULL == value )
+		{
+			Usage( argv[0] );
+			return -1;
+		}
+
+		if ( 0 == strcmp( arg, "--vertices" ) )
+		{
+			numVertices = atoi( value );
+		}
+		else if ( 0 == strcmp( arg, "--frames" ) )
+		{
+			frames = atoi( value );
+		}
+		else if ( 0 == strcmp( arg, "--iterations" ) )
+		{
+			iterations = atoi( value );
+		}
+		else
+		{
+			Usage( argv[0] );
+			return -1;
+		}
+
+		++i;
+	}
+
+	if ( numVertices <= 0 || frames <= 0 || iterations <= 0 )
+	{
+		Usage( argv[0] );
+		return -1;
+	}
+
+	printf( "meshes: %d vertices, %d frames, %s, best of %d\n", numVertices, frames, MeshStream::InstructionSet(), iterations );
+	printf( "%-16s %12s %12s %8s\n", "kernel", "loop (ms)", "kernel (ms)", "speedup" );
+
+	int result = 0;
+
+	// Many frames' worth of vertices, so the kernels run long enough to time
+	if ( ! RunKernels( (U32)numVertices * frames, iterations ) )
+	{
+		result = -1;
+	}
+
+	if ( ! CheckBuffers( (U32)numVertices ) )
+	{
+		result = -1;
+	}
+
+	printf( "%-16s %12s %12s %8s\n", "lua", "vertex (ms)", "bulk (ms)", "speedup" );
+
+	// Each update computed in Lua, then with the setters alone
+	const char* rows[] = { "vertices", "vertices, set", "colors", "colors, set" };
+
+	for ( int row = 0; row < 4; row++ )
+	{
+		bool isVertices = ( row < 2 );
+		bool fixed = ( 1 == ( row & 1 ) );
+		Mesh perVertex, bulk;
+
+		U64 perVertexTime = RunLua( isVertices ? "setVertex" : "setFillVertexColor", fixed, frames, numVertices, iterations, perVertex );
+		U64 bulkTime = RunLua( isVertices ? "setVertices" : "setColors", fixed, frames, numVertices, iterations, bulk );
+		bool isMatch = ( perVertexTime > 0 && bulkTime > 0
+			&& 0 == memcmp( &perVertex.fVertices[0], &bulk.fVertices[0], numVertices * sizeof( Vertex2 ) )
+			&& perVertex.fColors == bulk.fColors );
+
+		PrintLua( rows[row], perVertexTime, bulkTime, isMatch );
+
+		if ( ! isMatch )
+		{
+			result = -1;
+		}
+	}
+
+	return result;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
@@ -0,0 +1,45 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_MeshBenchmark_H__
+#define _Rtt_MeshBenchmark_H__
+
+#include "Core/Rtt_Types.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Checks the MeshStream kernels against plain loops and times both, and
+// checks that raw and described buffers are read in full. Then
+// times Lua updating a mesh one vertex per call, as setVertex() and
+// setFillVertexColor() do, against one setVertices() or setColors() call,
+// and checks that both leave the same mesh. The ", set" rows fill the values
+// once up front, to time mostly the setters. Runs on a bare lua_State, so
+// the per-vertex calls skip the proxy lookup and invalidation of the real
+// methods, which understates their cost.
+class MeshBenchmark
+{
+	public:
+		static void Usage( const char* arg0 );
+
+		// argv[0] is the "meshes" command
+		static int Main( int argc, const char* argv[] );
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_MeshBenchmark_H__
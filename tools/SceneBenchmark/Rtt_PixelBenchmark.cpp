@@ -0,0 +1,288 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Rtt_PixelBenchmark.h"
+
+#include "Core/Rtt_Time.h"
+#include "Display/Rtt_PixelConversion.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+namespace /*anonymous*/
+{
+
+// Per-byte loops, as the bitmap loaders used to do it. Premultiplying rounds
+// like PixelConversion so the results can be compared.
+
+void
+ReferencePremultiply( const U8*, U8* dst, size_t numPixels )
+{
+	for ( size_t i = 0; i < numPixels; i++, dst += 4 )
+	{
+		dst[0] = (U8)( ( dst[0] * dst[3] + 127 ) / 255 );
+		dst[1] = (U8)( ( dst[1] * dst[3] + 127 ) / 255 );
+		dst[2] = (U8)( ( dst[2] * dst[3] + 127 ) / 255 );
+	}
+}
+
+void
+ReferenceUnpremultiply( const U8*, U8* dst, size_t numPixels )
+{
+	for ( size_t i = 0; i < numPixels; i++, dst += 4 )
+	{
+		if ( dst[3] > 0 )
+		{
+			float invAlpha = 255.f / (float)dst[3];
+
+			for ( int k = 0; k < 3; k++ )
+			{
+				float c = invAlpha * dst[k];
+				dst[k] = (U8)( c < 255.f ? c : 255.f );
+			}
+		}
+	}
+}
+
+void
+ReferenceRGBToRGBA( const U8* src, U8* dst, size_t numPixels )
+{
+	for ( size_t i = 0; i < numPixels; i++ )
+	{
+		*dst++ = *src++;
+		*dst++ = *src++;
+		*dst++ = *src++;
+		*dst++ = 255;
+	}
+}
+
+void
+ReferenceSwapRedBlue( const U8* src, U8* dst, size_t numPixels )
+{
+	for ( size_t i = 0; i < numPixels; i++, src += 4, dst += 4 )
+	{
+		dst[0] = src[2];
+		dst[1] = src[1];
+		dst[2] = src[0];
+		dst[3] = src[3];
+	}
+}
+
+void
+ReferenceExtractAlpha( const U8* src, U8* dst, size_t numPixels )
+{
+	for ( size_t i = 0; i < numPixels; i++, src += 4 )
+	{
+		*dst++ = src[3];
+	}
+}
+
+void
+Premultiply( const U8*, U8* dst, size_t numPixels )
+{
+	PixelConversion::Premultiply( dst, numPixels );
+}
+
+void
+Unpremultiply( const U8*, U8* dst, size_t numPixels )
+{
+	PixelConversion::Unpremultiply( dst, numPixels );
+}
+
+void
+ExtractAlpha( const U8* src, U8* dst, size_t numPixels )
+{
+	PixelConversion::ExtractChannel( src, dst, numPixels, 3 );
+}
+
+typedef void (*Kernel)( const U8* src, U8* dst, size_t numPixels );
+
+struct KernelInfo
+{
+	const char* name;
+	Kernel reference;
+	Kernel kernel;
+	int dstBytesPerPixel;
+	bool inPlace;	// dst starts as a copy of src
+};
+
+const KernelInfo kKernels[] =
+{
+	{ "premultiply", ReferencePremultiply, Premultiply, 4, true },
+	{ "unpremultiply", ReferenceUnpremultiply, Unpremultiply, 4, true },
+	{ "rgbToRGBA", ReferenceRGBToRGBA, PixelConversion::RGBToRGBA, 4, false },
+	{ "swapRedBlue", ReferenceSwapRedBlue, PixelConversion::SwapRedBlue, 4, false },
+	{ "extractAlpha", ReferenceExtractAlpha, ExtractAlpha, 1, false },
+	{ NULL, NULL, NULL, 0, false }
+};
+
+// Best time of 'iterations' runs, in microseconds
+U64
+Time( const KernelInfo& info, Kernel kernel, const std::vector< U8 >& src, std::vector< U8 >& dst, size_t numPixels, int iterations )
+{
+	U64 best = (U64)-1;
+
+	for ( int i = 0; i < iterations; i++ )
+	{
+		if ( info.inPlace )
+		{
+			memcpy( &dst[0], &src[0], dst.size() );
+		}
+
+		Rtt_AbsoluteTime start = Rtt_GetAbsoluteTime();
+		kernel( &src[0], &dst[0], numPixels );
+		U64 elapsed = Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - start );
+
+		if ( elapsed < best )
+		{
+			best = elapsed;
+		}
+	}
+
+	return best;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+void
+PixelBenchmark::Usage( const char* arg0 )
+{
+	fprintf( stderr,
+		"Usage: Solar2DBenchmark %s [options]\n"
+		"    --size <w>x<h>        Image size in pixels (default: 2048x2048)\n"
+		"    --iterations <n>      Runs per kernel; the best is reported (default: 20)\n",
+		arg0 );
+}
+
+int
+PixelBenchmark::Main( int argc, const char* argv[] )
+{
+	int width = 2048;
+	int height = 2048;
+	int iterations = 20;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char* arg = argv[i];
+		const char* value = ( i + 1 < argc ) ? argv[i + 1] : NULL;
+
+		if ( NULL == value )
+		{
+			Usage( argv[0] );
+			return -1;
+		}
+
+		if ( 0 == strcmp( arg, "--size" ) )
+		{
+			if ( 2 != sscanf( value, "%dx%d", &width, &height ) )
+			{
+				Usage( argv[0] );
+				return -1;
+			}
+		}
+		else if ( 0 == strcmp( arg, "--iterations" ) )
+		{
+			iterations = atoi( value );
+		}
+		else
+		{
+			Usage( argv[0] );
+			return -1;
+		}
+
+		++i;
+	}
+
+	if ( width <= 0 || height <= 0 || iterations <= 0 )
+	{
+		Usage( argv[0] );
+		return -1;
+	}
+
+	// Sprite atlases are mostly opaque or empty, with soft edges in between
+	size_t numPixels = (size_t)width * height;
+	std::vector< U8 > src( numPixels * 4 );
+	U32 seed = 12345;
+
+	for ( size_t i = 0; i < numPixels; i++ )
+	{
+		seed = seed * 1664525 + 1013904223;
+
+		U8* p = &src[i * 4];
+		U8 alpha = (U8)( seed >> 24 );
+
+		switch ( ( seed >> 8 ) % 3 )
+		{
+			case 0: alpha = 0; break;
+			case 1: alpha = 255; break;
+			default: break;
+		}
+
+		p[0] = (U8)( seed >> 16 );
+		p[1] = (U8)( seed >> 10 );
+		p[2] = (U8)( seed >> 4 );
+		p[3] = alpha;
+
+		// Keep unpremultiply inputs valid premultiplied colors
+		for ( int k = 0; k < 3; k++ )
+		{
+			p[k] = p[k] <= alpha ? p[k] : alpha;
+		}
+	}
+
+	printf( "pixels: %dx%d, %s, best of %d\n", width, height, PixelConversion::InstructionSet(), iterations );
+	printf( "%-16s %12s %12s %12s %8s\n", "kernel", "loop (ms)", "kernel (ms)", "Mpixel/s", "speedup" );
+
+	int result = 0;
+
+	for ( const KernelInfo* info = kKernels; info->name; ++info )
+	{
+		std::vector< U8 > expected( numPixels * info->dstBytesPerPixel );
+		std::vector< U8 > actual( numPixels * info->dstBytesPerPixel );
+
+		U64 loopTime = Time( *info, info->reference, src, expected, numPixels, iterations );
+		U64 kernelTime = Time( *info, info->kernel, src, actual, numPixels, iterations );
+		bool isMatch = ( expected == actual );
+
+		printf( "%-16s %12.3f %12.3f %12.1f %7.2fx%s\n",
+			info->name,
+			loopTime / 1000.0,
+			kernelTime / 1000.0,
+			kernelTime > 0 ? numPixels / (double)kernelTime : 0.0,
+			kernelTime > 0 ? loopTime / (double)kernelTime : 0.0,
+			isMatch ? "" : "  MISMATCH" );
+
+		if ( ! isMatch )
+		{
+			result = -1;
+		}
+	}
+
+	return result;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
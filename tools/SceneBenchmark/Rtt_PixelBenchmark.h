@@ -0,0 +1,39 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_PixelBenchmark_H__
+#define _Rtt_PixelBenchmark_H__
+
+#include "Core/Rtt_Types.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Times the PixelConversion kernels against plain per-byte loops on a
+// synthetic image, and checks that both produce the same pixels.
+class PixelBenchmark
+{
+	public:
+		static void Usage( const char* arg0 );
+
+		// argv[0] is the "pixels" command
+		static int Main( int argc, const char* argv[] );
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_PixelBenchmark_H__
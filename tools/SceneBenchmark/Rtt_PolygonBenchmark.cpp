@@ -0,0 +1,279 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Rtt_PolygonBenchmark.h"
+
+#include "Core/Rtt_Time.h"
+#include "Display/Rtt_TesselatorPolygon.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+namespace /*anonymous*/
+{
+
+// Ear clipping that tests every remaining vertex against each candidate ear,
+// as TesselatorPolygon used to do it.
+
+bool
+ReferenceInsideTriangle( float Ax, float Ay, float Bx, float By, float Cx, float Cy, float Px, float Py )
+{
+	float aCROSSbp = ( Cx - Bx ) * ( Py - By ) - ( Cy - By ) * ( Px - Bx );
+	float cCROSSap = ( Bx - Ax ) * ( Py - Ay ) - ( By - Ay ) * ( Px - Ax );
+	float bCROSScp = ( Ax - Cx ) * ( Py - Cy ) - ( Ay - Cy ) * ( Px - Cx );
+
+	return aCROSSbp >= 0.0f && bCROSScp >= 0.0f && cCROSSap >= 0.0f;
+}
+
+bool
+ReferenceSnip( const std::vector< Vertex2 >& contour, int u, int v, int w, int n, const int *V )
+{
+	float Ax = contour[V[u]].x, Ay = contour[V[u]].y;
+	float Bx = contour[V[v]].x, By = contour[V[v]].y;
+	float Cx = contour[V[w]].x, Cy = contour[V[w]].y;
+
+	if ( 0.0000000001f > ( ( Bx - Ax ) * ( Cy - Ay ) ) - ( ( By - Ay ) * ( Cx - Ax ) ) ) { return false; }
+
+	for ( int p = 0; p < n; p++ )
+	{
+		if ( p == u || p == v || p == w ) { continue; }
+
+		if ( ReferenceInsideTriangle( Ax, Ay, Bx, By, Cx, Cy, contour[V[p]].x, contour[V[p]].y ) ) { return false; }
+	}
+
+	return true;
+}
+
+bool
+ReferenceTriangulate( const std::vector< Vertex2 >& contour, std::vector< Vertex2 >& result )
+{
+	int n = (int)contour.size();
+	if ( n < 3 ) { return false; }
+
+	float area = 0.0f;
+	for ( int p = n - 1, q = 0; q < n; p = q++ )
+	{
+		area += contour[p].x * contour[q].y - contour[q].x * contour[p].y;
+	}
+
+	// counter-clockwise polygon in V
+	std::vector< int > V( n );
+	for ( int v = 0; v < n; v++ )
+	{
+		V[v] = ( area > 0.0f ? v : ( n - 1 ) - v );
+	}
+
+	int nv = n;
+	int count = 2 * nv;
+
+	for ( int v = nv - 1; nv > 2; )
+	{
+		if ( 0 >= ( count-- ) )
+		{
+			return false;
+		}
+
+		int u = v;   if ( nv <= u ) { u = 0; }
+		v = u + 1;   if ( nv <= v ) { v = 0; }
+		int w = v + 1; if ( nv <= w ) { w = 0; }
+
+		if ( ReferenceSnip( contour, u, v, w, nv, &V[0] ) )
+		{
+			result.push_back( contour[V[u]] );
+			result.push_back( contour[V[v]] );
+			result.push_back( contour[V[w]] );
+
+			V.erase( V.begin() + v );
+			nv--;
+
+			count = 2 * nv;
+		}
+	}
+
+	return true;
+}
+
+// Circle with every other vertex pulled in, so half the vertices are reflex.
+// The notches are about as deep as the vertices are far apart, like a traced
+// outline, rather than spikes spanning the whole shape.
+void
+MakeJaggedCircle( int numVertices, std::vector< Vertex2 >& contour )
+{
+	const double kPi = 3.14159265358979323846;
+	const double kRadius = 500.0;
+
+	contour.resize( numVertices );
+
+	for ( int i = 0; i < numVertices; i++ )
+	{
+		double angle = 2.0 * kPi * i / numVertices;
+		double radius = ( i & 1 ) ? kRadius * ( 1.0 - 2.0 * kPi / numVertices ) : kRadius;
+
+		contour[i].x = (Real)( radius * cos( angle ) );
+		contour[i].y = (Real)( radius * sin( angle ) );
+	}
+}
+
+double
+TriangleArea( const Vertex2* vertices, size_t numVertices )
+{
+	double area = 0.0;
+
+	for ( size_t i = 0; i + 2 < numVertices; i += 3 )
+	{
+		const Vertex2& a = vertices[i];
+		const Vertex2& b = vertices[i + 1];
+		const Vertex2& c = vertices[i + 2];
+
+		area += fabs( ( (double)b.x - a.x ) * ( (double)c.y - a.y ) - ( (double)c.x - a.x ) * ( (double)b.y - a.y ) ) * 0.5;
+	}
+
+	return area;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+void
+PolygonBenchmark::Usage( const char* arg0 )
+{
+	fprintf( stderr,
+		"Usage: Solar2DBenchmark %s [options]\n"
+		"    --vertices <n>        Largest outline; sizes double up to it from 16 (default: 4096)\n"
+		"    --iterations <n>      Runs per size; the best is reported (default: 5)\n",
+		arg0 );
+}
+
+int
+PolygonBenchmark::Main( int argc, const char* argv[] )
+{
+	int maxVertices = 4096;
+	int iterations = 5;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char* arg = argv[i];
+		const char* value = ( i + 1 < argc ) ? argv[i + 1] : NULL;
+
+		if ( NULL == value )
+		{
+			Usage( argv[0] );
+			return -1;
+		}
+
+		if ( 0 == strcmp( arg, "--vertices" ) )
+		{
+			maxVertices = atoi( value );
+		}
+		else if ( 0 == strcmp( arg, "--iterations" ) )
+		{
+			iterations = atoi( value );
+		}
+		else
+		{
+			Usage( argv[0] );
+			return -1;
+		}
+
+		++i;
+	}
+
+	// Triangulation indices are 16 bit
+	if ( maxVertices < 16 || maxVertices > 65535 || iterations <= 0 )
+	{
+		Usage( argv[0] );
+		return -1;
+	}
+
+	printf( "polygon: jagged circles, best of %d\n", iterations );
+	printf( "%-10s %14s %14s %10s\n", "vertices", "reference (ms)", "earcut (ms)", "speedup" );
+
+	int result = 0;
+
+	for ( int numVertices = 16; numVertices <= maxVertices; numVertices *= 2 )
+	{
+		std::vector< Vertex2 > contour;
+		MakeJaggedCircle( numVertices, contour );
+
+		U64 referenceTime = (U64)-1;
+		U64 earcutTime = (U64)-1;
+		double referenceArea = 0.0;
+		double earcutArea = 0.0;
+
+		for ( int i = 0; i < iterations; i++ )
+		{
+			std::vector< Vertex2 > triangles;
+			triangles.reserve( 3 * numVertices );
+
+			Rtt_AbsoluteTime start = Rtt_GetAbsoluteTime();
+			ReferenceTriangulate( contour, triangles );
+			U64 elapsed = Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - start );
+
+			referenceTime = Min( referenceTime, elapsed );
+			referenceArea = TriangleArea( triangles.empty() ? NULL : &triangles[0], triangles.size() );
+		}
+
+		for ( int i = 0; i < iterations; i++ )
+		{
+			TesselatorPolygon tesselator( NULL );
+			ArrayVertex2& polygon = tesselator.GetContour();
+
+			polygon.Reserve( numVertices );
+			for ( int j = 0; j < numVertices; j++ )
+			{
+				polygon.Append( contour[j] );
+			}
+
+			ArrayVertex2 triangles( NULL );
+
+			Rtt_AbsoluteTime start = Rtt_GetAbsoluteTime();
+			tesselator.GenerateFill( triangles );
+			U64 elapsed = Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - start );
+
+			earcutTime = Min( earcutTime, elapsed );
+			earcutArea = TriangleArea( triangles.ReadAccess(), triangles.Length() );
+		}
+
+		bool isMatch = fabs( referenceArea - earcutArea ) <= 1e-4 * referenceArea;
+
+		printf( "%-10d %14.3f %14.3f %9.1fx%s\n",
+			numVertices,
+			referenceTime / 1000.0,
+			earcutTime / 1000.0,
+			earcutTime > 0 ? referenceTime / (double)earcutTime : 0.0,
+			isMatch ? "" : "  MISMATCH" );
+
+		if ( ! isMatch )
+		{
+			result = -1;
+		}
+	}
+
+	return result;
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
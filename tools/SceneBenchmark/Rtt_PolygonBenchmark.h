@@ -0,0 +1,39 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_PolygonBenchmark_H__
+#define _Rtt_PolygonBenchmark_H__
+
+#include "Core/Rtt_Types.h"
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+// Times TesselatorPolygon's triangulation against the O(n^3) ear clipper it
+// replaced, on jagged circles, and checks that both cover the same area.
+class PolygonBenchmark
+{
+	public:
+		static void Usage( const char* arg0 );
+
+		// argv[0] is the "polygon" command
+		static int Main( int argc, const char* argv[] );
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_PolygonBenchmark_H__
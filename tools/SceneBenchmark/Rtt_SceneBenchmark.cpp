@@ -0,0 +1,520 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+
+#include "Rtt_SceneBenchmark.h"
+
+#include "Core/Rtt_FileSystem.h"
+#include "Core/Rtt_SizeClassAllocator.h"
+#include "Core/Rtt_Time.h"
+#include "Display/Rtt_Display.h"
+#include "Renderer/Rtt_RecordingRenderer.h"
+#include "Rtt_Event.h"
+#include "Rtt_Freetype.h"
+#include "Rtt_LinuxBitmap.h"
+#include "Rtt_LinuxConsolePlatform.h"
+#include "Rtt_LinuxFont.h"
+#include "Rtt_LuaContext.h"
+#include "Rtt_PlatformTimer.h"
+#include "Rtt_Profiling.h"
+#include "Rtt_Runtime.h"
+#include "Rtt_RuntimeDelegate.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+// ----------------------------------------------------------------------------
+
+namespace /*anonymous*/
+{
+
+class BenchmarkTimer : public PlatformTimer
+{
+	public:
+		BenchmarkTimer( MCallback& callback ) : PlatformTimer( callback ), fIsRunning( false ) {}
+
+	public:
+		virtual void Start() { fIsRunning = true; }
+		virtual void Stop() { fIsRunning = false; }
+		virtual void SetInterval( U32 milliseconds ) {}
+		virtual bool IsRunning() const { return fIsRunning; }
+
+	private:
+		bool fIsRunning;
+};
+
+// The console platform has no timer or fonts. The runtime is stepped by hand,
+// so a timer that never fires is sufficient; text goes through the same
+// FreeType rasterizer as the Linux player so that text churn is realistic.
+class BenchmarkPlatform : public LinuxConsolePlatform
+{
+	public:
+		typedef LinuxConsolePlatform Super;
+
+	public:
+		BenchmarkPlatform( const char* resourceDir, const char* scratchDir, const char* documentsDir, const char* temporaryDir, const char* cachesDir, const char* systemCachesDir )
+		:	Super( resourceDir, documentsDir, temporaryDir, cachesDir, systemCachesDir, scratchDir, scratchDir )
+		{
+		}
+
+	public:
+		virtual PlatformTimer* CreateTimerWithCallback( MCallback& callback ) const
+		{
+			return Rtt_NEW( fAllocator, BenchmarkTimer( callback ) );
+		}
+
+		virtual PlatformFont* CreateFont( PlatformFont::SystemFont fontType, Rtt_Real size ) const
+		{
+			return Rtt_NEW( fAllocator, LinuxFont( *fAllocator, fontType, size ) );
+		}
+
+		virtual PlatformFont* CreateFont( const char* fontName, Rtt_Real size ) const
+		{
+			return Rtt_NEW( fAllocator, LinuxFont( *fAllocator, fontName, size, false ) );
+		}
+
+		virtual PlatformBitmap* CreateBitmapMask( const char str[], const PlatformFont& font, Real w, Real h, const char alignment[], Real& baselineOffset ) const
+		{
+			return Rtt_NEW( fAllocator, LinuxTextBitmap( *fAllocator, str, font, (int)( w + 0.5f ), (int)( h + 0.5f ), alignment, baselineOffset ) );
+		}
+};
+
+// Hands the scene name and object count to main.lua as launch arguments.
+class BenchmarkDelegate : public RuntimeDelegate
+{
+	public:
+		BenchmarkDelegate( const SceneBenchmark::Options& options )
+		:	fOptions( options )
+		{
+		}
+
+	public:
+		virtual void WillLoadMain( const Runtime& sender ) const
+		{
+			lua_State* L = sender.VMContext().L();
+
+			if ( Rtt_VERIFY( const_cast< Runtime& >( sender ).PushLaunchArgs( true ) > 0 ) )
+			{
+				lua_pushstring( L, fOptions.scene );
+				lua_setfield( L, -2, "scene" );
+				lua_pushinteger( L, fOptions.count );
+				lua_setfield( L, -2, "count" );
+				lua_pop( L, 1 );
+			}
+		}
+
+	private:
+		const SceneBenchmark::Options& fOptions;
+};
+
+const char* kSceneNames[] =
+{
+	"rects",
+	"groups",
+	"sprites",
+	"emitters",
+	"text",
+	"containers",
+	"events",
+	"meshes",
+	"bulkmeshes",
+	NULL
+};
+
+double
+ToMilliseconds( U64 microseconds, U32 count )
+{
+	return count > 0 ? ( microseconds / 1000.0 ) / count : 0.0;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+
+SceneBenchmark::Options::Options()
+:	scene( kSceneNames[0] ),
+	count( 5000 ),
+	frames( 300 ),
+	warmupFrames( 30 ),
+	width( 320 ),
+	height( 480 ),
+	sortedBatching( false ),
+	concurrentTraversal( false ),
+	reuseEventTables( false )
+{
+}
+
+SceneBenchmark::Totals::Totals()
+:	fTime( 0 ),
+	fCount( 0 )
+{
+}
+
+SceneBenchmark::SceneBenchmark( const char* resourceDir, const char* scratchDir )
+:	fResourceDir( resourceDir ),
+	fScratchDir( scratchDir ),
+	fPhasePrefix( "" )
+{
+	Reset();
+}
+
+SceneBenchmark::~SceneBenchmark()
+{
+}
+
+const char**
+SceneBenchmark::SceneNames()
+{
+	return kSceneNames;
+}
+
+void
+SceneBenchmark::Usage( const char* arg0 )
+{
+	fprintf( stderr,
+		"Usage: %s [options]\n"
+		"       %s pixels [options]    Time the bitmap conversion kernels instead\n"
+		"       %s polygon [options]   Time polygon triangulation instead\n"
+		"       %s luaheap [options]   Compare Lua heap allocators instead\n"
+		"       %s luagc [options]     Compare Lua collection scheduling instead\n"
+		"       %s luaprofile [options]  Measure Lua sampling overhead instead\n"
+		"    --scene <name|all>    Scene to run (default: all)\n"
+		"    --count <n>           Object count for the scene (default: 5000)\n"
+		"    --frames <n>          Measured frames (default: 300)\n"
+		"    --warmup <n>          Frames run before measuring (default: 30)\n"
+		"    --size <w>x<h>        Surface size in pixels (default: 320x480)\n"
+		"    --sorted-batching <on|off>  Reorder draws by state (default: off)\n"
+		"    --concurrent-traversal <on|off>  Update large groups on worker threads (default: off)\n"
+		"    --reuse-event-tables <on|off>  Overwrite one table per event name (default: off)\n"
+		"    --resources <dir>     Directory containing the benchmark main.lua\n"
+		"Scenes:",
+		arg0, arg0, arg0, arg0, arg0, arg0 );
+
+	for ( const char** name = kSceneNames; *name; ++name )
+	{
+		fprintf( stderr, " %s", *name );
+	}
+
+	fprintf( stderr, "\n" );
+}
+
+int
+SceneBenchmark::Main( int argc, const char* argv[] )
+{
+	Options options;
+	bool runAll = true;
+
+	for ( int i = 1; i < argc; i++ )
+	{
+		const char* arg = argv[i];
+		const char* value = ( i + 1 < argc ) ? argv[i + 1] : NULL;
+
+		if ( NULL == value )
+		{
+			Usage( argv[0] );
+			return -1;
+		}
+
+		if ( 0 == strcmp( arg, "--scene" ) )
+		{
+			runAll = ( 0 == strcmp( value, "all" ) );
+			options.scene = value;
+		}
+		else if ( 0 == strcmp( arg, "--count" ) )
+		{
+			options.count = atoi( value );
+		}
+		else if ( 0 == strcmp( arg, "--frames" ) )
+		{
+			options.frames = atoi( value );
+		}
+		else if ( 0 == strcmp( arg, "--warmup" ) )
+		{
+			options.warmupFrames = atoi( value );
+		}
+		else if ( 0 == strcmp( arg, "--size" ) )
+		{
+			if ( 2 != sscanf( value, "%dx%d", &options.width, &options.height ) )
+			{
+				Usage( argv[0] );
+				return -1;
+			}
+		}
+		else if ( 0 == strcmp( arg, "--sorted-batching" ) )
+		{
+			options.sortedBatching = ( 0 == strcmp( value, "on" ) );
+		}
+		else if ( 0 == strcmp( arg, "--concurrent-traversal" ) )
+		{
+			options.concurrentTraversal = ( 0 == strcmp( value, "on" ) );
+		}
+		else if ( 0 == strcmp( arg, "--reuse-event-tables" ) )
+		{
+			options.reuseEventTables = ( 0 == strcmp( value, "on" ) );
+		}
+		else if ( 0 == strcmp( arg, "--resources" ) )
+		{
+			fResourceDir = value;
+		}
+		else
+		{
+			Usage( argv[0] );
+			return -1;
+		}
+
+		++i;
+	}
+
+	if ( options.frames <= 0 || options.width <= 0 || options.height <= 0 )
+	{
+		Usage( argv[0] );
+		return -1;
+	}
+
+	setGlyphProvider( new glyph_freetype_provider( fResourceDir.c_str() ) );
+
+	int result = 0;
+
+	for ( const char** name = kSceneNames; *name; ++name )
+	{
+		if ( runAll )
+		{
+			options.scene = *name;
+		}
+
+		if ( Run( options ) )
+		{
+			Report( stdout );
+		}
+		else
+		{
+			fprintf( stderr, "ERROR: Could not run scene '%s' from %s\n", options.scene, fResourceDir.c_str() );
+			result = -1;
+		}
+
+		if ( ! runAll )
+		{
+			break;
+		}
+	}
+
+	return result;
+}
+
+bool
+SceneBenchmark::Run( const Options& options )
+{
+	Reset();
+
+	fOptions = options;
+
+	std::string documentsDir = fScratchDir + "/Documents";
+	std::string temporaryDir = fScratchDir + "/TemporaryFiles";
+	std::string cachesDir = fScratchDir + "/CachedFiles";
+	std::string systemCachesDir = fScratchDir + "/.system";
+
+	Rtt_MakeDirectory( documentsDir.c_str() );
+	Rtt_MakeDirectory( temporaryDir.c_str() );
+	Rtt_MakeDirectory( cachesDir.c_str() );
+	Rtt_MakeDirectory( systemCachesDir.c_str() );
+
+	BenchmarkPlatform* platform = new BenchmarkPlatform( fResourceDir.c_str(), fScratchDir.c_str(), documentsDir.c_str(), temporaryDir.c_str(), cachesDir.c_str(), systemCachesDir.c_str() );
+	platform->SetHeadlessSurfaceSize( options.width, options.height );
+
+	BenchmarkDelegate delegate( fOptions );
+	Runtime* runtime = new Runtime( *platform );
+	runtime->SetDelegate( &delegate );
+	runtime->SetBackend( "nullBackend", NULL );
+	runtime->SetProperty( Runtime::kLinuxMaskSet | Runtime::kIsApplicationNotArchived, true );
+
+	Runtime::LoadParameters parameters;
+	parameters.launchOptions = Runtime::kLinuxLaunchOption;
+	parameters.contentWidth = options.width;
+	parameters.contentHeight = options.height;
+
+	bool result = ( Runtime::kSuccess == runtime->LoadApplication( parameters ) );
+
+	if ( result )
+	{
+		lua_State* L = runtime->VMContext().L();
+
+		if ( options.reuseEventTables )
+		{
+			VirtualEvent::EnableTableReuse( L );
+		}
+
+		// Loads main.lua, i.e. builds the scene
+		runtime->BeginRunLoop();
+
+		Display& display = runtime->GetDisplay();
+		display.GetRenderer().SetStatisticsEnabled( true );
+		display.GetRenderer().SetBatchSortingEnabled( options.sortedBatching );
+		display.SetConcurrentTraversal( options.concurrentTraversal );
+
+		for ( S32 i = 0; i < options.warmupFrames; i++ )
+		{
+			(*runtime)();
+		}
+
+		for ( S32 i = 0; i < options.frames; i++ )
+		{
+			SizeClassAllocator::Stats heapBefore = LuaContext::GetHeap( L ).GetStats();
+			U64 began = Rtt_GetAbsoluteTime();
+
+			(*runtime)();
+
+			const SizeClassAllocator::Stats& heapAfter = LuaContext::GetHeap( L ).GetStats();
+			fLuaAllocations += heapAfter.fNumAllocations - heapBefore.fNumAllocations;
+			fLuaAllocatedBytes += heapAfter.fAllocatedBytes - heapBefore.fAllocatedBytes;
+
+			Sample( *runtime, Rtt_AbsoluteToMicroseconds( Rtt_GetAbsoluteTime() - began ) );
+		}
+	}
+
+	delete runtime;
+	delete platform;
+
+	return result;
+}
+
+void
+SceneBenchmark::Reset()
+{
+	fPhases.clear();
+	fSums.clear();
+
+	fFrames = 0;
+	fFrameTime = 0;
+	fMinFrameTime = ~0ULL;
+	fMaxFrameTime = 0;
+	fDrawCalls = 0;
+	fTriangles = 0;
+	fCommandBytes = 0;
+	fVertexBytes = 0;
+	fUniformBytes = 0;
+	fUploadBytes = 0;
+	fMaxDrawCalls = 0;
+	fMaxCommandBytes = 0;
+	fLuaAllocations = 0;
+	fLuaAllocatedBytes = 0;
+}
+
+void
+SceneBenchmark::Sample( Runtime& runtime, U64 frameTime )
+{
+	Display& display = runtime.GetDisplay();
+	const RecordingRenderer& renderer = static_cast< const RecordingRenderer& >( display.GetRenderer() );
+	const Renderer::Statistics& statistics = renderer.GetFrameStatistics();
+	const NullCommandBuffer::Recording& recording = renderer.GetRecording();
+	const RecordingRenderer::Uploads& uploads = renderer.GetUploads();
+
+	++fFrames;
+	fFrameTime += frameTime;
+	fMinFrameTime = Min( fMinFrameTime, frameTime );
+	fMaxFrameTime = Max( fMaxFrameTime, frameTime );
+
+	fDrawCalls += statistics.fDrawCallCount;
+	fTriangles += statistics.fTriangleCount;
+	fCommandBytes += recording.fCommandBytes;
+	fVertexBytes += recording.fVertexBytes;
+	fUniformBytes += recording.fUniformBytes;
+	fUploadBytes += uploads.fGeometryBytes + uploads.fTextureBytes;
+	fMaxDrawCalls = Max( fMaxDrawCalls, statistics.fDrawCallCount );
+	fMaxCommandBytes = Max( fMaxCommandBytes, recording.fCommandBytes );
+
+	ProfilingState& state = *display.GetProfilingState();
+
+	fPhasePrefix = "update";
+	state.GetByID( state.GetUpdateID() )->VisitEntries( &AddEntry, this );
+
+	fPhasePrefix = "render";
+	state.GetByID( state.GetRenderID() )->VisitEntries( &AddEntry, this );
+
+	// Only non-empty when built with PROFILE_SUMS
+	Profiling::VisitSums( &AddSum, this );
+}
+
+void
+SceneBenchmark::AddEntry( const char* name, U64 elapsed, void* userData )
+{
+	Self* self = static_cast< Self* >( userData );
+
+	std::string key( self->fPhasePrefix );
+	key += ": ";
+	key += name ? name : "(listeners)";
+
+	Totals& totals = self->fPhases[key];
+	totals.fTime += elapsed;
+	++totals.fCount;
+}
+
+void
+SceneBenchmark::AddSum( const char* name, U64 total, U32 count, void* userData )
+{
+	Self* self = static_cast< Self* >( userData );
+
+	Totals& totals = self->fSums[name];
+	totals.fTime += total;
+	totals.fCount += count;
+}
+
+void
+SceneBenchmark::Report( FILE* out ) const
+{
+	const U32 frames = fFrames;
+
+	fprintf( out, "\n== %s (count %d, %dx%d, %u frames%s%s%s) ==\n", fOptions.scene, fOptions.count, fOptions.width, fOptions.height, frames,
+		fOptions.sortedBatching ? ", sorted batching" : "",
+		fOptions.concurrentTraversal ? ", concurrent traversal" : "",
+		fOptions.reuseEventTables ? ", reused event tables" : "" );
+
+	if ( 0 == frames )
+	{
+		return;
+	}
+
+	fprintf( out, "frame ms:        avg %.3f  min %.3f  max %.3f\n",
+		ToMilliseconds( fFrameTime, frames ), fMinFrameTime / 1000.0, fMaxFrameTime / 1000.0 );
+	fprintf( out, "draw calls:      avg %.1f  max %u\n", (double)fDrawCalls / frames, fMaxDrawCalls );
+	fprintf( out, "triangles:       avg %.1f\n", (double)fTriangles / frames );
+	fprintf( out, "command bytes:   avg %.1f  max %u\n", (double)fCommandBytes / frames, fMaxCommandBytes );
+	fprintf( out, "vertex bytes:    avg %.1f\n", (double)fVertexBytes / frames );
+	fprintf( out, "uniform bytes:   avg %.1f\n", (double)fUniformBytes / frames );
+	fprintf( out, "upload bytes:    avg %.1f\n", (double)fUploadBytes / frames );
+	fprintf( out, "lua allocs:      avg %.1f  (%.1f bytes)\n", (double)fLuaAllocations / frames, (double)fLuaAllocatedBytes / frames );
+
+	// Each entry's time is the time since the entry before it
+	fprintf( out, "phases (avg ms per frame):\n" );
+	for ( TotalsMap::const_iterator iter = fPhases.begin(); iter != fPhases.end(); ++iter )
+	{
+		fprintf( out, "    %-48s %8.3f\n", iter->first.c_str(), ToMilliseconds( iter->second.fTime, frames ) );
+	}
+
+	if ( ! fSums.empty() )
+	{
+		fprintf( out, "sums (avg ms per frame, calls per frame):\n" );
+		for ( TotalsMap::const_iterator iter = fSums.begin(); iter != fSums.end(); ++iter )
+		{
+			fprintf( out, "    %-48s %8.3f %8.1f\n", iter->first.c_str(), ToMilliseconds( iter->second.fTime, frames ), (double)iter->second.fCount / frames );
+		}
+	}
+}
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
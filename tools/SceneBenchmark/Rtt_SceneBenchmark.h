@@ -0,0 +1,119 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _Rtt_SceneBenchmark_H__
+#define _Rtt_SceneBenchmark_H__
+
+#include "Core/Rtt_Types.h"
+
+#include <stdio.h>
+#include <map>
+#include <string>
+
+// ----------------------------------------------------------------------------
+
+namespace Rtt
+{
+
+class Runtime;
+
+// ----------------------------------------------------------------------------
+
+// Runs one of the synthetic scenes in Resources/main.lua through
+// Display::Update() and Display::Render() on the "nullBackend" renderer, then
+// reports where the frame time went and what was submitted to the
+// CommandBuffer.
+class SceneBenchmark
+{
+	public:
+		typedef SceneBenchmark Self;
+
+	public:
+		struct Options
+		{
+			Options();
+
+			const char* scene;
+			S32 count;			// Scene-dependent object count
+			S32 frames;			// Measured frames
+			S32 warmupFrames;	// Frames run before measuring
+			S32 width;
+			S32 height;
+			bool sortedBatching;	// See Renderer::SetBatchSortingEnabled()
+			bool concurrentTraversal;	// See Display::SetConcurrentTraversal()
+			bool reuseEventTables;	// See VirtualEvent::EnableTableReuse()
+		};
+
+	public:
+		SceneBenchmark( const char* resourceDir, const char* scratchDir );
+		~SceneBenchmark();
+
+	public:
+		static const char** SceneNames();
+		static void Usage( const char* arg0 );
+
+	public:
+		int Main( int argc, const char* argv[] );
+
+		// Returns false if the scene could not be loaded
+		bool Run( const Options& options );
+		void Report( FILE* out ) const;
+
+	protected:
+		void Reset();
+		void Sample( Runtime& runtime, U64 frameTime );
+
+	private:
+		static void AddEntry( const char* name, U64 elapsed, void* userData );
+		static void AddSum( const char* name, U64 total, U32 count, void* userData );
+
+	private:
+		struct Totals
+		{
+			Totals();
+
+			U64 fTime;
+			U32 fCount;
+		};
+
+		typedef std::map< std::string, Totals > TotalsMap;
+
+		std::string fResourceDir;
+		std::string fScratchDir;
+		Options fOptions;
+		const char* fPhasePrefix;
+
+		TotalsMap fPhases;
+		TotalsMap fSums;
+
+		U32 fFrames;
+		U64 fFrameTime;
+		U64 fMinFrameTime;
+		U64 fMaxFrameTime;
+		U64 fDrawCalls;
+		U64 fTriangles;
+		U64 fCommandBytes;
+		U64 fVertexBytes;
+		U64 fUniformBytes;
+		U64 fUploadBytes;
+		U32 fMaxDrawCalls;
+		U32 fMaxCommandBytes;
+
+		// Lua heap traffic while measuring, from the heap's counters
+		U64 fLuaAllocations;
+		U64 fLuaAllocatedBytes;
+};
+
+// ----------------------------------------------------------------------------
+
+} // namespace Rtt
+
+// ----------------------------------------------------------------------------
+
+#endif // _Rtt_SceneBenchmark_H__
@@ -0,0 +1,80 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the Corona game engine.
+// For overview and more information on licensing please refer to README.md
+// Home page: https://github.com/coronalabs/corona
+// Contact: support@coronalabs.com
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "Core/Rtt_Build.h"
+#include "Rtt_LuaGCBenchmark.h"
+#include "Rtt_LuaHeapBenchmark.h"
+#include "Rtt_LuaProfilerBenchmark.h"
+#include "Rtt_MeshBenchmark.h"
+#include "Rtt_PixelBenchmark.h"
+#include "Rtt_PolygonBenchmark.h"
+#include "Rtt_SceneBenchmark.h"
+#include "Rtt_LinuxUtils.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+using namespace std;
+
+int main(int argc, const char *argv[])
+{
+	// Bitmap conversion kernels only, no runtime
+	if (argc > 1 && 0 == strcmp(argv[1], "pixels"))
+	{
+		return Rtt::PixelBenchmark::Main(argc - 1, argv + 1);
+	}
+
+	// Lua heap allocators only, no runtime
+	if (argc > 1 && 0 == strcmp(argv[1], "luaheap"))
+	{
+		return Rtt::LuaHeapBenchmark::Main(argc - 1, argv + 1);
+	}
+
+	// Lua collection scheduling only, no runtime
+	if (argc > 1 && 0 == strcmp(argv[1], "luagc"))
+	{
+		return Rtt::LuaGCBenchmark::Main(argc - 1, argv + 1);
+	}
+
+	// Lua sampling profiler overhead only, no runtime
+	if (argc > 1 && 0 == strcmp(argv[1], "luaprofile"))
+	{
+		return Rtt::LuaProfilerBenchmark::Main(argc - 1, argv + 1);
+	}
+
+	// Mesh stream kernels and bulk setters only, no runtime
+	if (argc > 1 && 0 == strcmp(argv[1], "meshes"))
+	{
+		return Rtt::MeshBenchmark::Main(argc - 1, argv + 1);
+	}
+
+	// Polygon triangulation only, no runtime
+	if (argc > 1 && 0 == strcmp(argv[1], "polygon"))
+	{
+		return Rtt::PolygonBenchmark::Main(argc - 1, argv + 1);
+	}
+
+	// Scene scripts live next to the executable unless overridden by --resources
+	string resourceDir(GetStartupPath(NULL));
+	resourceDir.append("/Resources/SceneBenchmark");
+
+	char scratchTemplate[] = "/tmp/Solar2DBenchmark.XXXXXX";
+	const char *scratchDir = mkdtemp(scratchTemplate);
+
+	if (NULL == scratchDir)
+	{
+		fprintf(stderr, "ERROR: Could not create a scratch directory\n");
+		return -1;
+	}
+
+	Rtt::SceneBenchmark benchmark(resourceDir.c_str(), scratchDir);
+
+	return benchmark.Main(argc, argv);
+}